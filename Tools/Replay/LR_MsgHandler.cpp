@@ -1,6 +1,7 @@
 #include "LR_MsgHandler.h"
 #include "LogReader.h"
 #include "Replay.h"
+#include "ReplayChecksum.h"
 
 #include <AP_DAL/AP_DAL.h>
 
@@ -39,6 +40,7 @@ void LR_MsgHandler_RFRF::process_message(uint8_t *msgbytes)
     }
 #undef MAP_FLAG
     AP::dal().handle_message(msg, ekf2, ekf3);
+    replay_checksum.update(msg.frame_types, ekf2, ekf3);
 }
 
 void LR_MsgHandler_RFRN::process_message(uint8_t *msgbytes)
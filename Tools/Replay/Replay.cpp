@@ -16,6 +16,7 @@
 #include "Replay.h"
 
 #include "LogReader.h"
+#include "ReplayChecksum.h"
 
 #include <stdio.h>
 #include <AP_HAL/utility/getopt_cpp.h>
@@ -135,11 +136,17 @@ void Replay::usage(void)
     ::printf("\t--param-file FILENAME  load parameters from a file\n");
     ::printf("\t--force-ekf2 force enable EKF2\n");
     ::printf("\t--force-ekf3 force enable EKF3\n");
+    ::printf("\t--checksum-out FILENAME  record EKF states and covariances after each update\n");
+    ::printf("\t--checksum-in FILENAME  compare EKF states and covariances against a recording and report the first divergence\n");
+    ::printf("\t--checksum-tolerance VALUE  allowed relative error when comparing against a recording (default 0)\n");
 }
 
 enum param_key : uint8_t {
     FORCE_EKF2 = 1,
     FORCE_EKF3,
+    CHECKSUM_OUT,
+    CHECKSUM_IN,
+    CHECKSUM_TOLERANCE,
 };
 
 void Replay::_parse_command_line(uint8_t argc, char * const argv[])
@@ -151,6 +158,9 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
         {"param-file",      true,   0, 'F'},
         {"force-ekf2",      false,  0, param_key::FORCE_EKF2},
         {"force-ekf3",      false,  0, param_key::FORCE_EKF3},
+        {"checksum-out",    true,   0, param_key::CHECKSUM_OUT},
+        {"checksum-in",     true,   0, param_key::CHECKSUM_IN},
+        {"checksum-tolerance", true, 0, param_key::CHECKSUM_TOLERANCE},
         {"help",            false,  0, 'h'},
         {0, false, 0, 0}
     };
@@ -186,6 +196,24 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
             replay_force_ekf3 = true;
             break;
 
+        case param_key::CHECKSUM_OUT:
+            if (!replay_checksum.open_output(gopt.optarg)) {
+                ::printf("open(%s): %m\n", gopt.optarg);
+                exit(1);
+            }
+            break;
+
+        case param_key::CHECKSUM_IN:
+            if (!replay_checksum.open_reference(gopt.optarg)) {
+                ::printf("open(%s): %m\n", gopt.optarg);
+                exit(1);
+            }
+            break;
+
+        case param_key::CHECKSUM_TOLERANCE:
+            replay_checksum.set_tolerance(atof(gopt.optarg));
+            break;
+
         case 'h':
         default:
             usage();
@@ -249,12 +277,13 @@ void Replay::setup()
 void Replay::loop()
 {
     if (!reader.update()) {
+        const bool checksum_ok = replay_checksum.finish();
 #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
     // If we don't tear down the threads then they continue to access
     // global state during object destruction.
         ((Linux::Scheduler*)hal.scheduler)->teardown();
 #endif
-        exit(0);
+        exit(checksum_ok ? 0 : 1);
     }
 }
 
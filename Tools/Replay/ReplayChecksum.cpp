@@ -0,0 +1,194 @@
+#include "ReplayChecksum.h"
+
+#include <AP_DAL/AP_DAL.h>
+
+#include <cinttypes>
+
+ReplayChecksum replay_checksum;
+
+bool ReplayChecksum::open_output(const char *filename)
+{
+    output = fopen(filename, "wb");
+    return output != nullptr;
+}
+
+bool ReplayChecksum::open_reference(const char *filename)
+{
+    reference = fopen(filename, "rb");
+    return reference != nullptr;
+}
+
+/*
+  called after each frame, recording the state of every core of each
+  filter that was updated in the frame
+ */
+void ReplayChecksum::update(uint8_t frame_types, const NavEKF2 &ekf2, const NavEKF3 &ekf3)
+{
+    if (!enabled()) {
+        return;
+    }
+    if (frame_types & uint8_t(AP_DAL::FrameType::UpdateFilterEKF2)) {
+        check_ekf(2, ekf2);
+    }
+    if (frame_types & uint8_t(AP_DAL::FrameType::UpdateFilterEKF3)) {
+        check_ekf(3, ekf3);
+    }
+    step++;
+}
+
+template <typename EKF>
+void ReplayChecksum::check_ekf(uint8_t ekf_type, const EKF &ekf)
+{
+    for (uint8_t core=0; core<ekf.activeCores(); core++) {
+        const uint8_t num_states = ekf.getStatesAndCovariance(core, states, covariance);
+        if (num_states == 0) {
+            continue;
+        }
+        rec.hdr.magic = RECORD_MAGIC;
+        rec.hdr.ekf_type = ekf_type;
+        rec.hdr.core = core;
+        rec.hdr.num_states = num_states;
+        rec.hdr.step = step;
+        rec.hdr.time_us = AP::dal().micros64();
+
+        // values are always recorded as double so that float and
+        // double builds of the filters can be compared
+        uint16_t n = 0;
+        for (uint8_t i=0; i<num_states; i++) {
+            rec.values[n++] = states[i];
+        }
+        for (uint8_t i=0; i<24; i++) {
+            for (uint8_t j=i; j<24; j++) {
+                rec.values[n++] = covariance[i][j];
+            }
+        }
+
+        uint64_t hash = FNV_1_OFFSET_BASIS_64;
+        hash_fnv_1a(n * sizeof(double), (const uint8_t *)rec.values, &hash);
+        hash_fnv_1a(sizeof(hash), (const uint8_t *)&hash, &total_hash);
+        rec.hdr.hash = hash;
+        num_records++;
+
+        if (output != nullptr) {
+            fwrite(&rec.hdr, sizeof(rec.hdr), 1, output);
+            fwrite(rec.values, sizeof(double), n, output);
+        }
+        if (reference != nullptr && !diverged) {
+            check_record();
+        }
+    }
+}
+
+bool ReplayChecksum::read_reference()
+{
+    if (fread(&ref.hdr, sizeof(ref.hdr), 1, reference) != 1 ||
+        ref.hdr.magic != RECORD_MAGIC ||
+        ref.hdr.num_states > ARRAY_SIZE(states)) {
+        return false;
+    }
+    return fread(ref.values, sizeof(double), num_values(ref), reference) == num_values(ref);
+}
+
+void ReplayChecksum::report_divergence(const char *name, double value, double ref_value, double error)
+{
+    ::printf("Replay diverged at step %" PRIu32 " time %" PRIu64 "us: EKF%u core %u %s=%.9g reference=%.9g error=%.3g\n",
+             rec.hdr.step, rec.hdr.time_us, rec.hdr.ekf_type, rec.hdr.core,
+             name, value, ref_value, error);
+    diverged = true;
+}
+
+/*
+  compare the current record against the next reference record. The
+  error in a state is relative to the larger of the state and its
+  standard deviation, and the error in a covariance is relative to
+  the product of the two standard deviations, so that the tolerance
+  means the same thing for every element
+ */
+void ReplayChecksum::check_record()
+{
+    if (!read_reference()) {
+        ::printf("Replay diverged at step %" PRIu32 ": reference ended\n", rec.hdr.step);
+        diverged = true;
+        return;
+    }
+    if (ref.hdr.step != rec.hdr.step ||
+        ref.hdr.time_us != rec.hdr.time_us ||
+        ref.hdr.ekf_type != rec.hdr.ekf_type ||
+        ref.hdr.core != rec.hdr.core ||
+        ref.hdr.num_states != rec.hdr.num_states) {
+        ::printf("Replay diverged at step %" PRIu32 " time %" PRIu64 "us: EKF%u core %u updated, reference has step %" PRIu32 " time %" PRIu64 "us EKF%u core %u\n",
+                 rec.hdr.step, rec.hdr.time_us, rec.hdr.ekf_type, rec.hdr.core,
+                 ref.hdr.step, ref.hdr.time_us, ref.hdr.ekf_type, ref.hdr.core);
+        diverged = true;
+        return;
+    }
+    if (ref.hdr.hash == rec.hdr.hash) {
+        num_exact++;
+        return;
+    }
+
+    const uint8_t num_states = rec.hdr.num_states;
+    // standard deviations from the reference covariance diagonal
+    double sigma[24];
+    uint16_t n = num_states;
+    for (uint8_t i=0; i<24; i++) {
+        sigma[i] = sqrt(fabs(ref.values[n]));
+        n += 24 - i;
+    }
+
+    char name[16];
+    for (uint8_t i=0; i<num_states; i++) {
+        const double value = rec.values[i];
+        const double ref_value = ref.values[i];
+        const double scale = MAX(MAX(fabs(value), fabs(ref_value)), i < 24 ? sigma[i] : 0);
+        const double error = value == ref_value ? 0 : (scale > 0 ? fabs(value - ref_value) / scale : INFINITY);
+        max_error = MAX(max_error, error);
+        if (!(error <= tolerance)) {
+            snprintf(name, sizeof(name), "state[%u]", i);
+            report_divergence(name, value, ref_value, error);
+            return;
+        }
+    }
+    n = num_states;
+    for (uint8_t i=0; i<24; i++) {
+        for (uint8_t j=i; j<24; j++, n++) {
+            const double value = rec.values[n];
+            const double ref_value = ref.values[n];
+            const double scale = sigma[i] * sigma[j];
+            const double error = value == ref_value ? 0 : (scale > 0 ? fabs(value - ref_value) / scale : INFINITY);
+            max_error = MAX(max_error, error);
+            if (!(error <= tolerance)) {
+                snprintf(name, sizeof(name), "P[%u][%u]", i, j);
+                report_divergence(name, value, ref_value, error);
+                return;
+            }
+        }
+    }
+}
+
+bool ReplayChecksum::finish()
+{
+    if (!enabled()) {
+        return true;
+    }
+    ::printf("Replay checksum 0x%016" PRIx64 " over %" PRIu32 " filter updates\n", total_hash, num_records);
+    if (output != nullptr) {
+        fclose(output);
+        output = nullptr;
+    }
+    if (reference == nullptr) {
+        return true;
+    }
+    if (!diverged && read_reference()) {
+        ::printf("Replay diverged: reference continues after step %" PRIu32 "\n", rec.hdr.step);
+        diverged = true;
+    }
+    fclose(reference);
+    reference = nullptr;
+    if (diverged) {
+        return false;
+    }
+    ::printf("Replay matched reference: %" PRIu32 " identical, %" PRIu32 " within tolerance, max error %.3g\n",
+             num_exact, num_records - num_exact, max_error);
+    return true;
+}
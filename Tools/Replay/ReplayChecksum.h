@@ -0,0 +1,82 @@
+#pragma once
+
+#include <AP_NavEKF2/AP_NavEKF2.h>
+#include <AP_NavEKF3/AP_NavEKF3.h>
+
+#include <stdio.h>
+
+/*
+  record or check the EKF2 and EKF3 state vectors and covariance
+  matrices after every filter update. This allows a change to the
+  estimators to be checked for identical (or near identical) output
+  against a replay from before the change
+ */
+class ReplayChecksum {
+public:
+    // write a record of each filter update to filename
+    bool open_output(const char *filename);
+
+    // compare each filter update against a record from open_output()
+    bool open_reference(const char *filename);
+
+    // maximum difference between a value and the reference, relative
+    // to the larger of the value and its standard deviation
+    void set_tolerance(double tol) { tolerance = tol; }
+
+    bool enabled() const { return output != nullptr || reference != nullptr; }
+
+    // called after each replayed frame
+    void update(uint8_t frame_types, const NavEKF2 &ekf2, const NavEKF3 &ekf3);
+
+    // print a summary, returning false if the replay diverged from
+    // the reference
+    bool finish();
+
+private:
+    static const uint16_t RECORD_MAGIC = 0x5243;
+    // upper triangle of the 24x24 covariance matrix
+    static const uint16_t NUM_COVARIANCES = 24*25/2;
+
+    struct PACKED record_header {
+        uint16_t magic;
+        uint8_t ekf_type;
+        uint8_t core;
+        uint8_t num_states;
+        uint32_t step;
+        uint64_t time_us;
+        uint64_t hash;
+    };
+
+    struct record {
+        struct record_header hdr;
+        double values[28 + NUM_COVARIANCES];
+    };
+
+    FILE *output;
+    FILE *reference;
+    double tolerance;
+
+    uint32_t step;
+    uint32_t num_records;
+    uint32_t num_exact;
+    double max_error;
+    uint64_t total_hash = FNV_1_OFFSET_BASIS_64;
+    bool diverged;
+
+    ftype states[28];
+    ftype covariance[24][24];
+    struct record rec;
+    struct record ref;
+
+    template <typename EKF>
+    void check_ekf(uint8_t ekf_type, const EKF &ekf);
+    void check_record();
+    bool read_reference();
+    void report_divergence(const char *name, double value, double ref_value, double error);
+
+    static uint16_t num_values(const struct record &r) {
+        return r.hdr.num_states + NUM_COVARIANCES;
+    }
+};
+
+extern ReplayChecksum replay_checksum;
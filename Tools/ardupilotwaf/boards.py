@@ -518,6 +518,11 @@ class Board:
 
     def pre_build(self, bld):
         '''pre-build hook that gets called before dynamic sources'''
+        if bld.env.LUA_BYTECODE_SCRIPTS:
+            # must be done before the scripts are embedded
+            import lua_bytecode
+            if lua_bytecode.precompile(bld.srcnode.abspath(), bld.bldnode.abspath(), bld.env.LUA_BYTECODE_SCRIPTS) is None:
+                bld.fatal("Failed to precompile lua scripts")
         if bld.env.ROMFS_FILES:
             self.embed_ROMFS_files(bld)
 
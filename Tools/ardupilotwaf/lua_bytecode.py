@@ -0,0 +1,63 @@
+#!/usr/bin/env python
+
+'''
+precompile lua scripts to bytecode for embedding in ROMFS
+
+The host compiler is built from the lua sources in AP_Scripting and
+writes a header holding a checksum of the scripting bindings, so the
+firmware only loads bytecode built against its own bindings. See
+lua_scripts::load_bytecode()
+'''
+
+import os, subprocess
+
+LUA_CORE = ['lapi', 'lcode', 'lctype', 'ldebug', 'ldo', 'ldump', 'lfunc', 'lgc',
+            'llex', 'lmem', 'lobject', 'lopcodes', 'lparser', 'lstate', 'lstring',
+            'ltable', 'ltm', 'lundump', 'lvm', 'lzio', 'lauxlib']
+
+def romfs_name(script):
+    '''name of the precompiled script in ROMFS'''
+    return 'scripts/' + os.path.splitext(os.path.basename(script))[0] + '.lbc'
+
+def output_path(bldroot, script):
+    '''path the precompiled script is written to under the board's build directory'''
+    return os.path.join(bldroot, 'lua_bytecode', os.path.basename(romfs_name(script)))
+
+def build_compiler(srcroot, output, cc='gcc'):
+    '''build the lua_precompile host tool'''
+    lua_src = os.path.join(srcroot, 'libraries/AP_Scripting/lua/src')
+    sources = [os.path.join(srcroot, 'libraries/AP_Scripting/generator/src/lua_precompile.c')]
+    sources += [os.path.join(lua_src, f + '.c') for f in LUA_CORE]
+    if os.path.exists(output):
+        mtime = os.path.getmtime(output)
+        if all(os.path.getmtime(s) < mtime for s in sources):
+            return
+    # must match the number types of the firmware, see boards.py
+    cmd = [cc, '-std=c99', '-O2', '-DLUA_32BITS=1', '-DLUA_HOST_TOOL', '-o', output] + sources + ['-lm']
+    subprocess.check_call(cmd)
+
+def precompile(srcroot, bldroot, scripts, cc='gcc'):
+    '''precompile scripts into bldroot, returns list of (romfs name, path) to embed or None on failure'''
+    compiler = os.path.join(bldroot, 'lua_precompile')
+    bindings = os.path.join(srcroot, 'libraries/AP_Scripting/generator/description/bindings.desc')
+    files = []
+    try:
+        build_compiler(srcroot, compiler, cc)
+        for script in scripts:
+            name = romfs_name(script)
+            output = output_path(bldroot, script)
+            if not os.path.exists(os.path.dirname(output)):
+                os.makedirs(os.path.dirname(output))
+            subprocess.check_call([compiler, '-a', bindings, '-o', output, script])
+            print("Precompiled %s to %s (%u bytes from %u)" % (script, name, os.path.getsize(output), os.path.getsize(script)))
+            files.append((name, output))
+    except (OSError, subprocess.CalledProcessError) as e:
+        print("Failed to precompile lua scripts: %s" % e)
+        return None
+    return files
+
+if __name__ == '__main__':
+    import sys
+    srcroot = os.path.abspath(os.path.join(os.path.dirname(__file__), '../..'))
+    if precompile(srcroot, '/tmp', sys.argv[1:]) is None:
+        sys.exit(1)
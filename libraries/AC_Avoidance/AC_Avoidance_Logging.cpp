@@ -5,6 +5,7 @@
 #include "AC_Avoid.h"
 #include "AP_OADijkstra.h"
 #include "AP_OABendyRuler.h"
+#include "AP_OADatabase.h"
 #include <AP_Logger/AP_Logger.h>
 
 void AP_OABendyRuler::Write_OABendyRuler(const uint8_t type, const bool active, const float target_yaw, const float target_pitch, const bool resist_chg, const float margin, const Location &final_dest, const Location &oa_dest) const
@@ -33,7 +34,7 @@ void AP_OABendyRuler::Write_OABendyRuler(const uint8_t type, const bool active,
     AP::logger().WriteBlock(&pkt, sizeof(pkt));
 }
 
-void AP_OADijkstra::Write_OADijkstra(const uint8_t state, const uint8_t error_id, const uint8_t curr_point, const uint8_t tot_points, const Location &final_dest, const Location &oa_dest) const
+void AP_OADijkstra::Write_OADijkstra(const uint8_t state, const uint8_t error_id, const uint16_t curr_point, const uint16_t tot_points, const Location &final_dest, const Location &oa_dest) const
 {
     const struct log_OADijkstra pkt{
         LOG_PACKET_HEADER_INIT(LOG_OA_DIJKSTRA_MSG),
@@ -50,7 +51,7 @@ void AP_OADijkstra::Write_OADijkstra(const uint8_t state, const uint8_t error_id
     AP::logger().WriteBlock(&pkt, sizeof(pkt));
 }
 
-void AP_OADijkstra::Write_Visgraph_point(const uint8_t version, const uint8_t point_num, const int32_t Lat, const int32_t Lon) const
+void AP_OADijkstra::Write_Visgraph_point(const uint8_t version, const uint16_t point_num, const int32_t Lat, const int32_t Lon) const
 {
     const struct log_OD_Visgraph pkt{
         LOG_PACKET_HEADER_INIT(LOG_OD_VISGRAPH_MSG),
@@ -81,4 +82,21 @@ void AC_Avoid::Write_SimpleAvoidance(const uint8_t state, const Vector3f& desire
     AP::logger().WriteBlock(&pkt, sizeof(pkt));
 }
 
+void AP_OADatabase::Write_OADatabase()
+{
+    const struct log_OADatabase pkt{
+        LOG_PACKET_HEADER_INIT(LOG_OA_DATABASE_MSG),
+        time_us          : AP_HAL::micros64(),
+        count            : _database.count,
+        queue_depth_max  : _stats.queue_depth_max,
+        processed        : _stats.processed,
+        queue_full       : _stats.queue_full,
+        database_full    : _stats.database_full,
+        expired          : _stats.expired,
+        process_us_max   : _stats.process_us_max,
+        process_us_total : _stats.process_us_total,
+    };
+    AP::logger().WriteBlock(&pkt, sizeof(pkt));
+}
+
 #endif  // HAL_LOGGING_ENABLED
@@ -36,6 +36,13 @@ extern const AP_HAL::HAL& hal;
     #define AP_OADATABASE_DISTANCE_FROM_HOME 3
 #endif
 
+#ifndef AP_OADATABASE_GRID_CELL_SIZE
+    #define AP_OADATABASE_GRID_CELL_SIZE 2.0f       // size (in meters) of the horizontal grid cells used to index database items
+#endif
+
+#define AP_OADATABASE_INDEX_NONE    UINT16_MAX      // index used to indicate the end of a list
+#define AP_OADATABASE_QUEUE_BATCH   16              // maximum number of items popped from the queue each time the semaphore is taken
+
 const AP_Param::GroupInfo AP_OADatabase::var_info[] = {
 
     // @Param: SIZE
@@ -127,7 +134,13 @@ void AP_OADatabase::init()
     if (!healthy()) {
         GCS_SEND_TEXT(MAV_SEVERITY_INFO, "DB init failed . Sizes queue:%u, db:%u", (unsigned int)_queue.size, (unsigned int)_database.size);
         delete _queue.items;
+        _queue.items = nullptr;
         delete[] _database.items;
+        _database.items = nullptr;
+        delete[] _index.buckets;
+        _index.buckets = nullptr;
+        delete[] _index.links;
+        _index.links = nullptr;
         return;
     }
 }
@@ -140,6 +153,19 @@ void AP_OADatabase::update()
 
     process_queue();
     database_items_remove_all_expired();
+    update_radius_max();
+
+    // queue_push() counts dropped items under the queue semaphore, take
+    // it so no drops are lost between logging and clearing the stats
+    WITH_SEMAPHORE(_queue.sem);
+    // only log while there are obstacles or items were queued, dropped
+    // or expired, the update that empties the database counts the
+    // expired items so it is always logged
+    if ((_database.count > 0) || (_stats.queue_depth_max > 0) ||
+        (_stats.queue_full > 0) || (_stats.expired > 0)) {
+        Write_OADatabase();
+    }
+    memset(&_stats, 0, sizeof(_stats));
 }
 
 // push a location into the database
@@ -175,7 +201,9 @@ void AP_OADatabase::queue_push(const Vector3f &pos, uint32_t timestamp_ms, float
     const OA_DbItem item = {pos, timestamp_ms, MAX(_radius_min, distance * dist_to_radius_scalar), 0, AP_OADatabase::OA_DbItemImportance::Normal};
     {
         WITH_SEMAPHORE(_queue.sem);
-        _queue.items->push(item);
+        if (!_queue.items->push(item)) {
+            _stats.queue_full++;
+        }
     }
 }
 
@@ -202,6 +230,37 @@ void AP_OADatabase::init_database()
     }
 
     _database.items = new OA_DbItem[_database.size];
+
+    if (!init_index()) {
+        delete[] _database.items;
+        _database.items = nullptr;
+    }
+}
+
+// allocate spatial and expiry index, returns true on success
+bool AP_OADatabase::init_index()
+{
+    // use roughly one bucket per item, rounded up to a power of two so the hash can be masked
+    uint32_t num_buckets = 16;
+    while (num_buckets < _database.size) {
+        num_buckets <<= 1;
+    }
+    _index.bucket_mask = num_buckets - 1;
+    _index.buckets = new uint16_t[num_buckets];
+    _index.links = new ItemLinks[_database.size];
+    if ((_index.buckets == nullptr) || (_index.links == nullptr)) {
+        delete[] _index.buckets;
+        _index.buckets = nullptr;
+        delete[] _index.links;
+        _index.links = nullptr;
+        return false;
+    }
+    for (uint32_t i = 0; i < num_buckets; i++) {
+        _index.buckets[i] = AP_OADATABASE_INDEX_NONE;
+    }
+    _index.oldest = AP_OADATABASE_INDEX_NONE;
+    _index.newest = AP_OADATABASE_INDEX_NONE;
+    return true;
 }
 
 // get bitmask of gcs channels item should be sent to based on its importance
@@ -242,49 +301,63 @@ bool AP_OADatabase::process_queue()
     // while could get us stuck here longer than expected if we're getting
     // a lot of values pushing into it while we're trying to empty it. With
     // the for we know we will exit at an expected time
-    const uint16_t queue_available = MIN(_queue.items->available(), 100U);
+    const uint16_t queue_depth = _queue.items->available();
+    _stats.queue_depth_max = MAX(_stats.queue_depth_max, queue_depth);
+    const uint16_t queue_available = MIN(queue_depth, 100U);
     if (queue_available == 0) {
         return false;
     }
 
-    for (uint16_t queue_index=0; queue_index<queue_available; queue_index++) {
-        OA_DbItem item;
+    const uint32_t start_us = AP_HAL::micros();
 
-        bool pop_success;
+    uint16_t queue_index = 0;
+    while (queue_index < queue_available) {
+        // pop a batch of items to avoid taking the semaphore for every item
+        OA_DbItem batch[AP_OADATABASE_QUEUE_BATCH];
+        uint16_t batch_count = 0;
         {
             WITH_SEMAPHORE(_queue.sem);
-            pop_success = _queue.items->pop(item);
+            while ((batch_count < ARRAY_SIZE(batch)) && (queue_index + batch_count < queue_available) && _queue.items->pop(batch[batch_count])) {
+                batch_count++;
+            }
         }
-        if (!pop_success) {
-            return false;
+        if (batch_count == 0) {
+            break;
         }
-
-        item.send_to_gcs = get_send_to_gcs_flags(item.importance);
-
-        // compare item to all items in database. If found a similar item, update the existing, else add it as a new one
-        bool found = false;
-        for (uint16_t i=0; i<_database.count; i++) {
-            if (is_close_to_item_in_database(i, item)) {
-                database_item_refresh(i, item.timestamp_ms, item.radius);
-                found = true;
-                break;
+        queue_index += batch_count;
+
+        for (uint16_t b = 0; b < batch_count; b++) {
+            OA_DbItem &item = batch[b];
+            item.send_to_gcs = get_send_to_gcs_flags(item.importance);
+
+            // look for a similar item nearby in the database. If found update the existing, else add it as a new one
+            const uint16_t close_index = find_close_item_in_database(item);
+            if (close_index != AP_OADATABASE_INDEX_NONE) {
+                database_item_refresh(close_index, item.timestamp_ms, item.radius);
+            } else {
+                database_item_add(item);
             }
         }
-
-        if (!found) {
-            database_item_add(item);
-        }
+        _stats.processed += batch_count;
     }
+
+    const uint32_t dt_us = AP_HAL::micros() - start_us;
+    _stats.process_us_max = MAX(_stats.process_us_max, dt_us);
+    _stats.process_us_total += dt_us;
+
     return (_queue.items->available() > 0);
 }
 
 void AP_OADatabase::database_item_add(const OA_DbItem &item)
 {
     if (_database.count >= _database.size) {
+        _stats.database_full++;
         return;
     }
     _database.items[_database.count] = item;
     _database.items[_database.count].send_to_gcs = get_send_to_gcs_flags(_database.items[_database.count].importance);
+    index_insert(_database.count);
+    _index.radius_max = MAX(_index.radius_max, item.radius);
     _database.count++;
 }
 
@@ -295,6 +368,11 @@ void AP_OADatabase::database_item_remove(const uint16_t index)
         return;
     }
 
+    index_remove(index);
+    if (_database.items[index].radius >= _index.radius_max) {
+        _index.radius_max_stale = true;
+    }
+
     // radius of 0 tells the GCS we don't care about it any more (aka it expired)
     _database.items[index].radius = 0;
     _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
@@ -308,6 +386,7 @@ void AP_OADatabase::database_item_remove(const uint16_t index)
         // copy last object in array over expired object
         _database.items[index] = _database.items[_database.count];
         _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
+        index_move(_database.count, index);
     }
 }
 
@@ -323,17 +402,26 @@ void AP_OADatabase::database_item_refresh(const uint16_t index, const uint32_t t
             (timestamp_ms - _database.items[index].timestamp_ms >= 500);
 
     if (is_different) {
+        if (_database.items[index].radius >= _index.radius_max) {
+            _index.radius_max_stale = true;
+        }
+        _index.radius_max = MAX(_index.radius_max, radius);
+
         // update timestamp and radius on close object so it stays around longer
         // and trigger resending to GCS
         _database.items[index].timestamp_ms = timestamp_ms;
         _database.items[index].radius = radius;
         _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
+
+        // move to its new place in the expiry list
+        expiry_list_remove(index);
+        expiry_list_insert(index);
     }
 }
 
 void AP_OADatabase::database_items_remove_all_expired()
 {
-    // calculate age of all items in the _database
+    // remove items from the oldest end of the expiry list until one has not expired
 
     if (_database_expiry_seconds <= 0) {
         // zero means never expire. This is not normal behavior but perhaps you could send a static
@@ -343,13 +431,217 @@ void AP_OADatabase::database_items_remove_all_expired()
 
     const uint32_t now_ms = AP_HAL::millis();
     const uint32_t expiry_ms = (uint32_t)_database_expiry_seconds * 1000;
-    uint16_t index = 0;
-    while (index < _database.count) {
-        if (now_ms - _database.items[index].timestamp_ms > expiry_ms) {
-            database_item_remove(index);
-        } else {
-            index++;
+    while ((_index.oldest != AP_OADATABASE_INDEX_NONE) && (now_ms - _database.items[_index.oldest].timestamp_ms > expiry_ms)) {
+        database_item_remove(_index.oldest);
+        _stats.expired++;
+    }
+}
+
+// recalculate the largest item radius if items with the largest radius have been removed or shrunk
+void AP_OADatabase::update_radius_max()
+{
+    if (!_index.radius_max_stale) {
+        return;
+    }
+    float radius_max = 0;
+    for (uint16_t i = 0; i < _database.count; i++) {
+        radius_max = MAX(radius_max, _database.items[i].radius);
+    }
+    _index.radius_max = radius_max;
+    _index.radius_max_stale = false;
+}
+
+// convert a horizontal position (in meters) to a grid cell coordinate
+int32_t AP_OADatabase::grid_cell(float pos) const
+{
+    // constrain to keep cell coordinates within int32 range for any position
+    return (int32_t)floorf(constrain_float(pos * (1.0f / AP_OADATABASE_GRID_CELL_SIZE), -1.0e6f, 1.0e6f));
+}
+
+// hash a grid cell to a bucket
+uint16_t AP_OADatabase::bucket_from_cell(int32_t cell_x, int32_t cell_y) const
+{
+    return (((uint32_t)cell_x * 73856093U) ^ ((uint32_t)cell_y * 19349663U)) & _index.bucket_mask;
+}
+
+// add database item "index" to its bucket and the expiry list
+void AP_OADatabase::index_insert(const uint16_t index)
+{
+    const uint16_t bucket = bucket_from_pos(_database.items[index].pos);
+    ItemLinks &links = _index.links[index];
+    links.bucket_prev = AP_OADATABASE_INDEX_NONE;
+    links.bucket_next = _index.buckets[bucket];
+    if (links.bucket_next != AP_OADATABASE_INDEX_NONE) {
+        _index.links[links.bucket_next].bucket_prev = index;
+    }
+    _index.buckets[bucket] = index;
+
+    expiry_list_insert(index);
+}
+
+// remove database item "index" from its bucket and the expiry list
+void AP_OADatabase::index_remove(const uint16_t index)
+{
+    const ItemLinks &links = _index.links[index];
+    if (links.bucket_prev != AP_OADATABASE_INDEX_NONE) {
+        _index.links[links.bucket_prev].bucket_next = links.bucket_next;
+    } else {
+        _index.buckets[bucket_from_pos(_database.items[index].pos)] = links.bucket_next;
+    }
+    if (links.bucket_next != AP_OADATABASE_INDEX_NONE) {
+        _index.links[links.bucket_next].bucket_prev = links.bucket_prev;
+    }
+
+    expiry_list_remove(index);
+}
+
+// update links after a database item has been copied from index "from" to index "to"
+// the item at "to" must already have been removed from the index
+void AP_OADatabase::index_move(const uint16_t from, const uint16_t to)
+{
+    const ItemLinks links = _index.links[from];
+    _index.links[to] = links;
+
+    if (links.bucket_prev != AP_OADATABASE_INDEX_NONE) {
+        _index.links[links.bucket_prev].bucket_next = to;
+    } else {
+        _index.buckets[bucket_from_pos(_database.items[to].pos)] = to;
+    }
+    if (links.bucket_next != AP_OADATABASE_INDEX_NONE) {
+        _index.links[links.bucket_next].bucket_prev = to;
+    }
+
+    if (links.expiry_older != AP_OADATABASE_INDEX_NONE) {
+        _index.links[links.expiry_older].expiry_newer = to;
+    } else {
+        _index.oldest = to;
+    }
+    if (links.expiry_newer != AP_OADATABASE_INDEX_NONE) {
+        _index.links[links.expiry_newer].expiry_older = to;
+    } else {
+        _index.newest = to;
+    }
+}
+
+// insert database item "index" into the expiry list in timestamp order
+// items normally arrive in timestamp order so this rarely needs to search
+void AP_OADatabase::expiry_list_insert(const uint16_t index)
+{
+    const uint32_t timestamp_ms = _database.items[index].timestamp_ms;
+    uint16_t older = _index.newest;
+    while ((older != AP_OADATABASE_INDEX_NONE) && ((int32_t)(_database.items[older].timestamp_ms - timestamp_ms) > 0)) {
+        older = _index.links[older].expiry_older;
+    }
+
+    ItemLinks &links = _index.links[index];
+    links.expiry_older = older;
+    if (older != AP_OADATABASE_INDEX_NONE) {
+        links.expiry_newer = _index.links[older].expiry_newer;
+        _index.links[older].expiry_newer = index;
+    } else {
+        links.expiry_newer = _index.oldest;
+        _index.oldest = index;
+    }
+    if (links.expiry_newer != AP_OADATABASE_INDEX_NONE) {
+        _index.links[links.expiry_newer].expiry_older = index;
+    } else {
+        _index.newest = index;
+    }
+}
+
+// remove database item "index" from the expiry list
+void AP_OADatabase::expiry_list_remove(const uint16_t index)
+{
+    const ItemLinks &links = _index.links[index];
+    if (links.expiry_older != AP_OADATABASE_INDEX_NONE) {
+        _index.links[links.expiry_older].expiry_newer = links.expiry_newer;
+    } else {
+        _index.oldest = links.expiry_newer;
+    }
+    if (links.expiry_newer != AP_OADATABASE_INDEX_NONE) {
+        _index.links[links.expiry_newer].expiry_older = links.expiry_older;
+    } else {
+        _index.newest = links.expiry_older;
+    }
+}
+
+// returns index of a database item close to "item" or AP_OADATABASE_INDEX_NONE if there are none
+uint16_t AP_OADatabase::find_close_item_in_database(const OA_DbItem &item) const
+{
+    // items are close if within either item's radius so search the cells within the larger of
+    // this item's radius and the largest radius in the database
+    const float search_radius = MAX(item.radius, _index.radius_max);
+    const int32_t x_min = grid_cell(item.pos.x - search_radius);
+    const int32_t x_max = grid_cell(item.pos.x + search_radius);
+    const int32_t y_min = grid_cell(item.pos.y - search_radius);
+    const int32_t y_max = grid_cell(item.pos.y + search_radius);
+
+    // searching more buckets than there are items is slower than checking every item
+    if ((float)(x_max - x_min + 1) * (float)(y_max - y_min + 1) >= _database.count) {
+        for (uint16_t i=0; i<_database.count; i++) {
+            if (is_close_to_item_in_database(i, item)) {
+                return i;
+            }
+        }
+        return AP_OADATABASE_INDEX_NONE;
+    }
+
+    for (int32_t x = x_min; x <= x_max; x++) {
+        for (int32_t y = y_min; y <= y_max; y++) {
+            // buckets may hold items from other cells which are checked too, this is harmless
+            for (uint16_t i = _index.buckets[bucket_from_cell(x, y)]; i != AP_OADATABASE_INDEX_NONE; i = _index.links[i].bucket_next) {
+                if (is_close_to_item_in_database(i, item)) {
+                    return i;
+                }
+            }
+        }
+    }
+    return AP_OADATABASE_INDEX_NONE;
+}
+
+// calculate the minimum margin between a line segment and all objects in the database
+// start and end are offsets in meters from the EKF origin, margin is the distance to the closest object's edge in meters
+// returns true on success and updates margin, false if the database is empty
+bool AP_OADatabase::get_margin_to_segment(const Vector3f &start, const Vector3f &end, float &margin) const
+{
+    if (!healthy() || (_database.count == 0)) {
+        return false;
+    }
+
+    // search cells within an increasing distance of the segment.  Any item not searched is
+    // at least search_dist from the segment so once an item's margin is below
+    // search_dist - radius_max no unsearched item can have a smaller margin
+    float search_dist = AP_OADATABASE_GRID_CELL_SIZE;
+    while (true) {
+        const int32_t x_min = grid_cell(MIN(start.x, end.x) - search_dist);
+        const int32_t x_max = grid_cell(MAX(start.x, end.x) + search_dist);
+        const int32_t y_min = grid_cell(MIN(start.y, end.y) - search_dist);
+        const int32_t y_max = grid_cell(MAX(start.y, end.y) + search_dist);
+
+        float margin_min = FLT_MAX;
+        if ((float)(x_max - x_min + 1) * (float)(y_max - y_min + 1) >= _database.count) {
+            // searching more buckets than there are items is slower than checking every item
+            for (uint16_t i=0; i<_database.count; i++) {
+                const OA_DbItem &item = _database.items[i];
+                margin_min = MIN(margin_min, Vector3f::closest_distance_between_line_and_point(start, end, item.pos) - item.radius);
+            }
+            margin = margin_min;
+            return true;
+        }
+
+        for (int32_t x = x_min; x <= x_max; x++) {
+            for (int32_t y = y_min; y <= y_max; y++) {
+                for (uint16_t i = _index.buckets[bucket_from_cell(x, y)]; i != AP_OADATABASE_INDEX_NONE; i = _index.links[i].bucket_next) {
+                    const OA_DbItem &item = _database.items[i];
+                    margin_min = MIN(margin_min, Vector3f::closest_distance_between_line_and_point(start, end, item.pos) - item.radius);
+                }
+            }
+        }
+        if (margin_min <= search_dist - _index.radius_max) {
+            margin = margin_min;
+            return true;
         }
+        search_dist *= 2;
     }
 }
 
@@ -4,6 +4,7 @@
 #include <AP_Math/AP_Math.h>
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include <AP_Param/AP_Param.h>
+#include <AP_Logger/AP_Logger_config.h>
 
 class AP_OADatabase {
 public:
@@ -38,7 +39,7 @@ public:
     void queue_push(const Vector3f &pos, uint32_t timestamp_ms, float distance);
 
     // returns true if database is healthy
-    bool healthy() const { return (_queue.items != nullptr) && (_database.items != nullptr); }
+    bool healthy() const { return (_queue.items != nullptr) && (_database.items != nullptr) && (_index.buckets != nullptr) && (_index.links != nullptr); }
 
     // fetch an item in database. Undefined result when i >= _database.count.
     const OA_DbItem& get_item(uint32_t i) const { return _database.items[i]; }
@@ -46,6 +47,11 @@ public:
     // get number of items in the database
     uint16_t database_count() const { return _database.count; }
 
+    // calculate the minimum margin between a line segment and all objects in the database
+    // start and end are offsets in meters from the EKF origin, margin is the distance to the closest object's edge in meters
+    // returns true on success and updates margin, false if the database is empty
+    bool get_margin_to_segment(const Vector3f &start, const Vector3f &end, float &margin) const;
+
     // empty queue and try and put into database. Return true if there's more work to do
     bool process_queue();
 
@@ -73,6 +79,27 @@ private:
     // returns true if database item "index" is close to "item"
     bool is_close_to_item_in_database(const uint16_t index, const OA_DbItem &item) const;
 
+    // returns index of a database item close to "item" or AP_OADATABASE_INDEX_NONE if there are none
+    uint16_t find_close_item_in_database(const OA_DbItem &item) const;
+
+    // spatial index methods
+    bool init_index();
+    int32_t grid_cell(float pos) const;
+    uint16_t bucket_from_cell(int32_t cell_x, int32_t cell_y) const;
+    uint16_t bucket_from_pos(const Vector3f &pos) const { return bucket_from_cell(grid_cell(pos.x), grid_cell(pos.y)); }
+    void index_insert(const uint16_t index);
+    void index_remove(const uint16_t index);
+    void index_move(const uint16_t from, const uint16_t to);
+    void expiry_list_insert(const uint16_t index);
+    void expiry_list_remove(const uint16_t index);
+    void update_radius_max();
+
+#if HAL_LOGGING_ENABLED
+    void Write_OADatabase();
+#else
+    void Write_OADatabase() {}
+#endif
+
     // enum for use with _OUTPUT parameter
     enum class OutputLevel {
         NONE = 0,
@@ -104,6 +131,36 @@ private:
         uint16_t        size;                               // cached value of _database_size_param that sticks after initialized
     } _database;
 
+    // spatial and expiry index of database items.  Items are hashed into buckets by the
+    // horizontal grid cell holding their position, and also held in a list ordered by
+    // timestamp so expired items can be removed from the oldest end
+    struct ItemLinks {
+        uint16_t bucket_next;       // next item in same bucket
+        uint16_t bucket_prev;       // previous item in same bucket
+        uint16_t expiry_newer;      // next item with a later timestamp
+        uint16_t expiry_older;      // next item with an earlier timestamp
+    };
+    struct {
+        uint16_t        *buckets;                           // first item in each bucket
+        uint16_t        bucket_mask;                        // number of buckets minus one (number of buckets is a power of two)
+        ItemLinks       *links;                             // links for each item in _database.items
+        uint16_t        oldest;                             // item with earliest timestamp
+        uint16_t        newest;                             // item with latest timestamp
+        float           radius_max;                         // upper bound on radius of all items in the database
+        bool            radius_max_stale;                   // true if radius_max may be larger than necessary
+    } _index;
+
+    // statistics on queue and database processing, logged and reset each update
+    struct {
+        uint16_t        queue_depth_max;                    // largest number of items seen waiting in the queue
+        uint16_t        processed;                          // number of items moved from queue to database
+        uint16_t        queue_full;                         // number of items dropped because the queue was full
+        uint16_t        database_full;                      // number of items dropped because the database was full
+        uint16_t        expired;                            // number of items removed because they expired
+        uint32_t        process_us_max;                     // longest time spent in one call to process_queue
+        uint32_t        process_us_total;                   // total time spent in process_queue
+    } _stats;
+
     uint16_t _next_index_to_send[MAVLINK_COMM_NUM_BUFFERS]; // index of next object in _database to send to GCS
     uint16_t _highest_index_sent[MAVLINK_COMM_NUM_BUFFERS]; // highest index in _database sent to GCS
     uint32_t _last_send_to_gcs_ms[MAVLINK_COMM_NUM_BUFFERS];// system time that send_adsb_vehicle was last called
@@ -25,7 +25,7 @@
 #include <GCS_MAVLink/GCS.h>
 
 #define OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK  32      // expanding arrays for fence points and paths to destination will grow in increments of 20 elements
-#define OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX        255     // index use to indicate we do not have a tentative short path for a node
+#define OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX        UINT16_MAX  // index use to indicate we do not have a tentative short path for a node
 #define OA_DIJKSTRA_ERROR_REPORTING_INTERVAL_MS         5000    // failure messages sent to GCS every 5 seconds
 
 /// Constructor
@@ -34,7 +34,9 @@ AP_OADijkstra::AP_OADijkstra(AP_Int16 &options) :
         _inclusion_polygon_pts(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _exclusion_polygon_pts(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _exclusion_circle_pts(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
+        _fence_visgraph_block_start(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _short_path_data(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
+        _open_heap(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _path(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK)
 {
 }
@@ -71,6 +73,7 @@ AP_OADijkstra::AP_OADijkstra_State AP_OADijkstra::update(const Location &current
     // check for inclusion polygon updates
     if (check_inclusion_polygon_updated()) {
         _inclusion_polygon_with_margin_ok = false;
+        _fence_edges_ok = false;
         _polyfence_visgraph_ok = false;
         _shortest_path_ok = false;
     }
@@ -78,6 +81,7 @@ AP_OADijkstra::AP_OADijkstra_State AP_OADijkstra::update(const Location &current
     // check for exclusion polygon updates
     if (check_exclusion_polygon_updated()) {
         _exclusion_polygon_with_margin_ok = false;
+        _fence_edges_ok = false;
         _polyfence_visgraph_ok = false;
         _shortest_path_ok = false;
     }
@@ -179,7 +183,7 @@ AP_OADijkstra::AP_OADijkstra_State AP_OADijkstra::update(const Location &current
 
     // path has been created, return latest point
     Vector2f dest_pos;
-    const uint8_t path_length = get_shortest_path_numpoints() > 0 ? (get_shortest_path_numpoints() - 1) : 0;
+    const uint16_t path_length = get_shortest_path_numpoints() > 0 ? (get_shortest_path_numpoints() - 1) : 0;
     if ((_path_idx_returned < path_length) && get_shortest_path_point(_path_idx_returned, dest_pos)) {
 
         // for the first point return origin as current_loc
@@ -614,25 +618,32 @@ bool AP_OADijkstra::intersects_fence(const Vector2f &seg_start, const Vector2f &
         return false;
     }
 
-    // determine if segment crosses any of the inclusion polygons
-    uint16_t num_points = 0;
-    for (uint8_t i = 0; i < fence->polyfence().get_inclusion_polygon_count(); i++) {
-        const Vector2f* boundary = fence->polyfence().get_inclusion_polygon(i, num_points);
-        if (boundary != nullptr) {
-            Vector2f intersection;
-            if (Polygon_intersects(boundary, num_points, seg_start, seg_end, intersection)) {
-                return true;
+    if (_fence_edges_ok) {
+        // determine if segment crosses any inclusion or exclusion polygon edge using the spatial index
+        if (_fence_edges.intersects(seg_start, seg_end)) {
+            return true;
+        }
+    } else {
+        // determine if segment crosses any of the inclusion polygons
+        uint16_t num_points = 0;
+        for (uint8_t i = 0; i < fence->polyfence().get_inclusion_polygon_count(); i++) {
+            const Vector2f* boundary = fence->polyfence().get_inclusion_polygon(i, num_points);
+            if (boundary != nullptr) {
+                Vector2f intersection;
+                if (Polygon_intersects(boundary, num_points, seg_start, seg_end, intersection)) {
+                    return true;
+                }
             }
         }
-    }
 
-    // determine if segment crosses any of the exclusion polygons
-    for (uint8_t i = 0; i < fence->polyfence().get_exclusion_polygon_count(); i++) {
-        const Vector2f* boundary = fence->polyfence().get_exclusion_polygon(i, num_points);
-        if (boundary != nullptr) {
-            Vector2f intersection;
-            if (Polygon_intersects(boundary, num_points, seg_start, seg_end, intersection)) {
-                return true;
+        // determine if segment crosses any of the exclusion polygons
+        for (uint8_t i = 0; i < fence->polyfence().get_exclusion_polygon_count(); i++) {
+            const Vector2f* boundary = fence->polyfence().get_exclusion_polygon(i, num_points);
+            if (boundary != nullptr) {
+                Vector2f intersection;
+                if (Polygon_intersects(boundary, num_points, seg_start, seg_end, intersection)) {
+                    return true;
+                }
             }
         }
     }
@@ -672,6 +683,39 @@ bool AP_OADijkstra::intersects_fence(const Vector2f &seg_start, const Vector2f &
     return false;
 }
 
+// load the edges of all inclusion and exclusion polygons into _fence_edges
+// on failure intersects_fence falls back to testing each polygon directly
+void AP_OADijkstra::create_fence_edge_index()
+{
+    _fence_edges.clear();
+    _fence_edges_ok = false;
+
+    const AC_Fence *fence = AC_Fence::get_singleton();
+    if (fence == nullptr) {
+        return;
+    }
+
+    uint16_t num_points = 0;
+    for (uint8_t i = 0; i < fence->polyfence().get_inclusion_polygon_count(); i++) {
+        const Vector2f* boundary = fence->polyfence().get_inclusion_polygon(i, num_points);
+        if ((boundary != nullptr) && !_fence_edges.add_polygon(boundary, num_points)) {
+            _fence_edges.clear();
+            return;
+        }
+    }
+    for (uint8_t i = 0; i < fence->polyfence().get_exclusion_polygon_count(); i++) {
+        const Vector2f* boundary = fence->polyfence().get_exclusion_polygon(i, num_points);
+        if ((boundary != nullptr) && !_fence_edges.add_polygon(boundary, num_points)) {
+            _fence_edges.clear();
+            return;
+        }
+    }
+
+    // if the grid cannot be built the edges are still tested, just without the index
+    _fence_edges.build();
+    _fence_edges_ok = true;
+}
+
 // create visibility graph for all fence (with margin) points
 // returns true on success.  returns false on failure and err_id is updated
 // requires these functions to have been run create_inclusion_polygon_with_margin, create_exclusion_polygon_with_margin, create_exclusion_circle_with_margin
@@ -685,19 +729,32 @@ bool AP_OADijkstra::create_fence_visgraph(AP_OADijkstra_Error &err_id)
     }
 
     // fail if more fence points than algorithm can handle
-    if (total_numpoints() >= OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX) {
+    // source and destination are added to the fence points and all node indexes must be below the "not set" index,
+    // in practice the fence visgraph's 65535 item limit is reached well before this
+    if (total_numpoints() + 2 >= OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX) {
         err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_TOO_MANY_FENCE_POINTS;
         return false;
     }
 
+    // destination visgraph must be recreated against the new fence
+    _destination_visgraph_ok = false;
+
+    // rebuild spatial index of fence edges used by intersects_fence
+    create_fence_edge_index();
+
     // clear fence points visibility graph
     _fence_visgraph.clear();
+    if (!_fence_visgraph_block_start.expand_to_hold(total_numpoints() + 1)) {
+        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
+        return false;
+    }
 
     // calculate distance from each point to all other points
-    for (uint8_t i = 0; i < total_numpoints() - 1; i++) {
+    for (uint16_t i = 0; i < total_numpoints(); i++) {
+        _fence_visgraph_block_start[i] = _fence_visgraph.num_items();
         Vector2f start_seg;
         if (get_point(i, start_seg)) {
-            for (uint8_t j = i + 1; j < total_numpoints(); j++) {
+            for (uint16_t j = i + 1; j < total_numpoints(); j++) {
                 Vector2f end_seg;
                 if (get_point(j, end_seg)) {
                     // if line segment does not intersect with any inclusion or exclusion zones add to visgraph
@@ -714,6 +771,7 @@ bool AP_OADijkstra::create_fence_visgraph(AP_OADijkstra_Error &err_id)
             }
         }
     }
+    _fence_visgraph_block_start[total_numpoints()] = _fence_visgraph.num_items();
 
     return true;
 }
@@ -728,7 +786,7 @@ bool AP_OADijkstra::update_visgraph(AP_OAVisGraph& visgraph, const AP_OAVisGraph
     visgraph.clear();
 
     // calculate distance from position to all inclusion/exclusion fence points
-    for (uint8_t i = 0; i < total_numpoints(); i++) {
+    for (uint16_t i = 0; i < total_numpoints(); i++) {
         Vector2f seg_end;
         if (get_point(i, seg_end)) {
             if (!intersects_fence(position, seg_end)) {
@@ -761,39 +819,72 @@ void AP_OADijkstra::update_visible_node_distances(node_index curr_node_idx)
         return;
     }
 
-    // get current node for convenience
-    const ShortPathNode &curr_node = _short_path_data[curr_node_idx];
-
-    // for each visibility graph
-    const AP_OAVisGraph* visgraphs[] = {&_fence_visgraph, &_destination_visgraph};
-    for (uint8_t v=0; v<ARRAY_SIZE(visgraphs); v++) {
-
-        // skip if empty
-        const AP_OAVisGraph &curr_visgraph = *visgraphs[v];
-        if (curr_visgraph.num_items() == 0) {
-            continue;
-        }
-
-        // search visibility graph for items visible from current_node
-        for (uint16_t i = 0; i < curr_visgraph.num_items(); i++) {
-            const AP_OAVisGraph::VisGraphItem &item = curr_visgraph[i];
-            // match if current node's id matches either of the id's in the graph (i.e. either end of the vector)
-            if ((curr_node.id == item.id1) || (curr_node.id == item.id2)) {
-                AP_OAVisGraph::OAItemID matching_id = (curr_node.id == item.id1) ? item.id2 : item.id1;
-                // find item's id in node array
-                node_index item_node_idx;
-                if (find_node_from_id(matching_id, item_node_idx)) {
-                    // if current node's distance + distance to item is less than item's current distance, update item's distance
-                    const float dist_to_item_via_current_node = _short_path_data[curr_node_idx].distance_cm + item.distance_cm;
-                    if (dist_to_item_via_current_node < _short_path_data[item_node_idx].distance_cm) {
-                        // update item's distance and set "distance_from_idx" to current node's index
-                        _short_path_data[item_node_idx].distance_cm = dist_to_item_via_current_node;
-                        _short_path_data[item_node_idx].distance_from_idx = curr_node_idx;
-                    }
+    // get current node's id for convenience
+    const AP_OAVisGraph::OAItemID curr_id = _short_path_data[curr_node_idx].id;
+
+    // search fence visibility graph for fence points visible from current node
+    if ((curr_id.id_type == AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT) && (curr_id.id_num < total_numpoints())) {
+        const uint16_t curr_num = curr_id.id_num;
+
+        // items with current node as id1 are the current node's block
+        for (uint16_t i = _fence_visgraph_block_start[curr_num]; i < _fence_visgraph_block_start[curr_num+1]; i++) {
+            const AP_OAVisGraph::VisGraphItem &item = _fence_visgraph[i];
+            update_node_distance(curr_node_idx, item.id2, item.distance_cm);
+        }
+
+        // items with current node as id2 are in the blocks of lower numbered points
+        // each block is sorted by id2 so binary search for the current node
+        for (uint16_t p = 0; p < curr_num; p++) {
+            uint16_t lo = _fence_visgraph_block_start[p];
+            uint16_t hi = _fence_visgraph_block_start[p+1];
+            while (lo < hi) {
+                const uint16_t mid = lo + (hi - lo) / 2;
+                if (_fence_visgraph[mid].id2.id_num < curr_num) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
                 }
             }
+            if ((lo < _fence_visgraph_block_start[p+1]) && (_fence_visgraph[lo].id2.id_num == curr_num)) {
+                const AP_OAVisGraph::VisGraphItem &item = _fence_visgraph[lo];
+                update_node_distance(curr_node_idx, item.id1, item.distance_cm);
+            }
         }
     }
+
+    // search destination visibility graph for items visible from current node
+    for (uint16_t i = 0; i < _destination_visgraph.num_items(); i++) {
+        const AP_OAVisGraph::VisGraphItem &item = _destination_visgraph[i];
+        // match if current node's id matches either of the id's in the graph (i.e. either end of the vector)
+        if (curr_id == item.id1) {
+            update_node_distance(curr_node_idx, item.id2, item.distance_cm);
+        } else if (curr_id == item.id2) {
+            update_node_distance(curr_node_idx, item.id1, item.distance_cm);
+        }
+    }
+}
+
+// update tentative distance of a node reached from curr_node_idx
+void AP_OADijkstra::update_node_distance(node_index curr_node_idx, const AP_OAVisGraph::OAItemID &id, float distance_cm)
+{
+    // find item's id in node array
+    node_index item_node_idx;
+    if (!find_node_from_id(id, item_node_idx)) {
+        return;
+    }
+    ShortPathNode &item_node = _short_path_data[item_node_idx];
+    if (item_node.visited) {
+        return;
+    }
+
+    // if current node's distance + distance to item is less than item's current distance, update item's distance
+    const float dist_to_item_via_current_node = _short_path_data[curr_node_idx].distance_cm + distance_cm;
+    if (dist_to_item_via_current_node < item_node.distance_cm) {
+        // update item's distance and set "distance_from_idx" to current node's index
+        item_node.distance_cm = dist_to_item_via_current_node;
+        item_node.distance_from_idx = curr_node_idx;
+        heap_push_or_decrease(item_node_idx);
+    }
 }
 
 // find a node's index into _short_path_data array from it's id (i.e. id type and id number)
@@ -828,45 +919,78 @@ bool AP_OADijkstra::find_node_from_id(const AP_OAVisGraph::OAItemID &id, node_in
     return false;
 }
 
-// find index of node with lowest tentative distance (ignore visited nodes)
-// returns true if successful and node_idx argument is updated
-bool AP_OADijkstra::find_closest_node_idx(node_index &node_idx) const
+// add node to heap or move it up after its distance has decreased
+void AP_OADijkstra::heap_push_or_decrease(node_index node_idx)
 {
-    node_index lowest_idx = 0;
-    float lowest_dist = FLT_MAX;
+    node_index pos = _short_path_data[node_idx].heap_pos;
+    if (pos == OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX) {
+        pos = _open_heap_numpoints++;
+        _open_heap[pos] = node_idx;
+        _short_path_data[node_idx].heap_pos = pos;
+    }
+    heap_sift_up(pos);
+}
 
-    // scan through all nodes looking for closest
-    for (node_index i=0; i<_short_path_data_numpoints; i++) {
-        const ShortPathNode &node = _short_path_data[i];
-        if (node.visited || is_equal(_short_path_data[i].distance_cm, FLT_MAX)) {
-            // if node is already visited OR cannot be reached yet, we can't use it
-            continue;
+// swap two heap positions, keeping nodes' heap_pos up to date
+void AP_OADijkstra::heap_swap(node_index pos1, node_index pos2)
+{
+    const node_index node1 = _open_heap[pos1];
+    _open_heap[pos1] = _open_heap[pos2];
+    _open_heap[pos2] = node1;
+    _short_path_data[_open_heap[pos1]].heap_pos = pos1;
+    _short_path_data[_open_heap[pos2]].heap_pos = pos2;
+}
+
+// move the node at heap position pos up until its parent has a lower key
+void AP_OADijkstra::heap_sift_up(node_index pos)
+{
+    while (pos > 0) {
+        const node_index parent = (pos - 1) / 2;
+        if (heap_key(_open_heap[pos]) >= heap_key(_open_heap[parent])) {
+            break;
         }
-        // figure out the pos of this node
-        Vector2f node_pos;
-        float dist_with_heuristics = FLT_MAX;
-        if (convert_node_to_point(node.id, node_pos)) {
-            // heuristics is is simple Euclidean distance from the node to the destination
-            // This should be admissible, therefore optimal path is guaranteed
-            const float heuristics = (node_pos-_path_destination).length();
-            dist_with_heuristics = node.distance_cm + heuristics;
-        } else {
-            // shouldn't happen
-            return false;
+        heap_swap(pos, parent);
+        pos = parent;
+    }
+}
+
+// move the node at heap position pos down until its children have higher keys
+void AP_OADijkstra::heap_sift_down(node_index pos)
+{
+    while (true) {
+        const uint32_t left = 2 * uint32_t(pos) + 1;
+        if (left >= _open_heap_numpoints) {
+            break;
         }
-        if (dist_with_heuristics < lowest_dist) {
-            // for NOW, this is the closest node
-            lowest_idx = i;
-            lowest_dist = dist_with_heuristics;
+        node_index smallest = left;
+        const uint32_t right = left + 1;
+        if ((right < _open_heap_numpoints) && (heap_key(_open_heap[right]) < heap_key(_open_heap[left]))) {
+            smallest = right;
         }
+        if (heap_key(_open_heap[smallest]) >= heap_key(_open_heap[pos])) {
+            break;
+        }
+        heap_swap(pos, smallest);
+        pos = smallest;
     }
+}
 
-    if (lowest_dist < FLT_MAX) {
-        // found the closest node
-        node_idx = lowest_idx;
-        return true;
+// remove the unvisited node with lowest tentative distance plus heuristic from the heap
+// returns true if successful and node_idx argument is updated
+bool AP_OADijkstra::pop_closest_node_idx(node_index &node_idx)
+{
+    if (_open_heap_numpoints == 0) {
+        return false;
     }
-    return false;
+    node_idx = _open_heap[0];
+    _short_path_data[node_idx].heap_pos = OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX;
+    _open_heap_numpoints--;
+    if (_open_heap_numpoints > 0) {
+        _open_heap[0] = _open_heap[_open_heap_numpoints];
+        _short_path_data[_open_heap[0]].heap_pos = 0;
+        heap_sift_down(0);
+    }
+    return true;
 }
 
 // calculate shortest path from origin to destination
@@ -886,26 +1010,39 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
         err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
         return false;
     }
-    if (!update_visgraph(_destination_visgraph, {AP_OAVisGraph::OATYPE_DESTINATION, 0}, _path_destination)) {
-        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
-        return false;
+    // destination visgraph only depends on the destination and fence so is reused if neither has changed
+    if (!_destination_visgraph_ok || !(_destination_visgraph_pos == _path_destination)) {
+        _destination_visgraph_ok = update_visgraph(_destination_visgraph, {AP_OAVisGraph::OATYPE_DESTINATION, 0}, _path_destination);
+        if (!_destination_visgraph_ok) {
+            err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
+            return false;
+        }
+        _destination_visgraph_pos = _path_destination;
     }
 
-    // expand _short_path_data if necessary
-    if (!_short_path_data.expand_to_hold(2 + total_numpoints())) {
+    // expand _short_path_data and _open_heap if necessary
+    if (!_short_path_data.expand_to_hold(2 + total_numpoints()) || !_open_heap.expand_to_hold(2 + total_numpoints())) {
         err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
         return false;
     }
 
-    // add origin and destination (node_type, id, visited, distance_from_idx, distance_cm) to short_path_data array
-    _short_path_data[0] = {{AP_OAVisGraph::OATYPE_SOURCE, 0}, false, 0, 0};
-    _short_path_data[1] = {{AP_OAVisGraph::OATYPE_DESTINATION, 0}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
+    // add origin and destination (node_type, id, visited, distance_from_idx, distance_cm, heuristic_cm, heap_pos) to short_path_data array
+    // heuristic is the simple Euclidean distance from the node to the destination which is admissible, therefore optimal path is guaranteed
+    _short_path_data[0] = {{AP_OAVisGraph::OATYPE_SOURCE, 0}, false, 0, 0, (_path_source - _path_destination).length(), OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX};
+    _short_path_data[1] = {{AP_OAVisGraph::OATYPE_DESTINATION, 0}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX, 0, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX};
     _short_path_data_numpoints = 2;
 
-    // add all inclusion and exclusion fence points to short_path_data array (node_type, id, visited, distance_from_idx, distance_cm)
-    for (uint8_t i=0; i<total_numpoints(); i++) {
-        _short_path_data[_short_path_data_numpoints++] = {{AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
+    // add all inclusion and exclusion fence points to short_path_data array
+    for (uint16_t i=0; i<total_numpoints(); i++) {
+        Vector2f node_pos;
+        if (!get_point(i, node_pos)) {
+            // shouldn't happen
+            err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
+            return false;
+        }
+        _short_path_data[_short_path_data_numpoints++] = {{AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX, (node_pos - _path_destination).length(), OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX};
     }
+    _open_heap_numpoints = 0;
 
     // start algorithm from source point
     node_index current_node_idx = 0;
@@ -916,6 +1053,7 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
         if (find_node_from_id(_source_visgraph[i].id2, node_idx)) {
             _short_path_data[node_idx].distance_cm = _source_visgraph[i].distance_cm;
             _short_path_data[node_idx].distance_from_idx = current_node_idx;
+            heap_push_or_decrease(node_idx);
         } else {
             err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
             return false;
@@ -925,7 +1063,7 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
     _short_path_data[current_node_idx].visited = true;
 
     // move current_node_idx to node with lowest distance
-    while (find_closest_node_idx(current_node_idx)) {
+    while (pop_closest_node_idx(current_node_idx)) {
         node_index dest_node;
         // See if this next "closest" node is actually the destination
         if (find_node_from_id({AP_OAVisGraph::OATYPE_DESTINATION,0}, dest_node) && current_node_idx == dest_node) {
@@ -980,7 +1118,7 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
 }
 
 // return point from final path as an offset (in cm) from the ekf origin
-bool AP_OADijkstra::get_shortest_path_point(uint8_t point_num, Vector2f& pos) const
+bool AP_OADijkstra::get_shortest_path_point(uint16_t point_num, Vector2f& pos) const
 {
     if ((_path_numpoints == 0) || (point_num >= _path_numpoints)) {
         return false;
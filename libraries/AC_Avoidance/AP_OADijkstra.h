@@ -3,6 +3,7 @@
 #include <AP_Common/AP_Common.h>
 #include <AP_Common/Location.h>
 #include <AP_Math/AP_Math.h>
+#include <AP_Math/AP_SegmentGrid.h>
 #include "AP_OAVisGraph.h"
 #include <AP_Logger/AP_Logger_config.h>
 
@@ -115,6 +116,10 @@ private:
     // returns true if line segment intersects polygon or circular fence
     bool intersects_fence(const Vector2f &seg_start, const Vector2f &seg_end) const;
 
+    // load the edges of all inclusion and exclusion polygons into _fence_edges
+    // on failure intersects_fence falls back to testing each polygon directly
+    void create_fence_edge_index();
+
     // create visibility graph for all fence (with margin) points
     // returns true on success.  returns false on failure and err_id is updated
     bool create_fence_visgraph(AP_OADijkstra_Error &err_id);
@@ -134,29 +139,40 @@ private:
 
     Location _destination_prev;     // destination of previous iterations (used to determine if path should be re-calculated)
     Location _next_destination_prev;// next_destination of previous iterations (used to determine if path should be re-calculated)
-    uint8_t _path_idx_returned;     // index into _path array which gives location vehicle should be currently moving towards
+    uint16_t _path_idx_returned;    // index into _path array which gives location vehicle should be currently moving towards
     bool _dest_to_next_dest_clear;  // true if path from dest to next_dest is clear (i.e. does not intersects a fence)
 
     // inclusion polygon (with margin) related variables
     float _polyfence_margin = 10;           // margin around polygon defaults to 10m but is overriden with set_fence_margin
     AP_ExpandingArray<Vector2f> _inclusion_polygon_pts; // array of nodes corresponding to inclusion polygon points plus a margin
-    uint8_t _inclusion_polygon_numpoints;   // number of points held in above array
+    uint16_t _inclusion_polygon_numpoints;  // number of points held in above array
     uint32_t _inclusion_polygon_update_ms;  // system time of boundary update from AC_Fence (used to detect changes to polygon fence)
 
     // exclusion polygon related variables
     AP_ExpandingArray<Vector2f> _exclusion_polygon_pts; // array of nodes corresponding to exclusion polygon points plus a margin
-    uint8_t _exclusion_polygon_numpoints;   // number of points held in above array
+    uint16_t _exclusion_polygon_numpoints;  // number of points held in above array
     uint32_t _exclusion_polygon_update_ms;  // system time exclusion polygon was updated (used to detect changes)
 
     // exclusion circle related variables
     AP_ExpandingArray<Vector2f> _exclusion_circle_pts; // array of nodes surrounding exclusion circles plus a margin
-    uint8_t _exclusion_circle_numpoints;    // number of points held in above array
+    uint16_t _exclusion_circle_numpoints;   // number of points held in above array
     uint32_t _exclusion_circle_update_ms;   // system time exclusion circles were updated (used to detect changes)
 
+    // spatial index of inclusion and exclusion polygon edges used by intersects_fence
+    AP_SegmentGrid _fence_edges;
+    bool _fence_edges_ok;                   // true if _fence_edges holds all polygon edges
+
     // visibility graphs
     AP_OAVisGraph _fence_visgraph;          // holds distances between all inclusion/exclusion fence points (with margin)
     AP_OAVisGraph _source_visgraph;         // holds distances from source point to all other nodes
     AP_OAVisGraph _destination_visgraph;    // holds distances from the destination to all other nodes
+    bool _destination_visgraph_ok;          // true if _destination_visgraph is valid for _destination_visgraph_pos and the current fence
+    Vector2f _destination_visgraph_pos;     // destination position used to create _destination_visgraph
+
+    // _fence_visgraph items are created in order of id1 then id2 so the items for
+    // each point form a contiguous block.  Entry i holds the index of the first item
+    // whose id1 is fence point i, entry total_numpoints() holds num_items()
+    AP_ExpandingArray<uint16_t> _fence_visgraph_block_start;
 
     // updates visibility graph for a given position which is an offset (in cm) from the ekf origin
     // to add an additional position (i.e. the destination) set add_extra_position = true and provide the position in the extra_position argument
@@ -164,39 +180,61 @@ private:
     // returns true on success
     bool update_visgraph(AP_OAVisGraph& visgraph, const AP_OAVisGraph::OAItemID& oaid, const Vector2f &position, bool add_extra_position = false, Vector2f extra_position = Vector2f(0,0));
 
-    typedef uint8_t node_index;         // indices into short path data
+    typedef uint16_t node_index;        // indices into short path data
     struct ShortPathNode {
         AP_OAVisGraph::OAItemID id;     // unique id for node (combination of type and id number)
         bool visited;                   // true if all this node's neighbour's distances have been updated
-        node_index distance_from_idx;   // index into _short_path_data from where distance was updated (or 255 if not set)
+        node_index distance_from_idx;   // index into _short_path_data from where distance was updated (or UINT16_MAX if not set)
         float distance_cm;              // distance from source (number is tentative until this node is the current node and/or visited = true)
+        float heuristic_cm;             // straight line distance from node to destination
+        node_index heap_pos;            // position of node in _open_heap (or UINT16_MAX if not in heap)
     };
     AP_ExpandingArray<ShortPathNode> _short_path_data;
     node_index _short_path_data_numpoints;  // number of elements in _short_path_data array
 
+    // binary min-heap of reached but unvisited nodes keyed on distance_cm + heuristic_cm
+    AP_ExpandingArray<node_index> _open_heap;
+    node_index _open_heap_numpoints;        // number of elements in _open_heap array
+
+    // returns the heap key of a node
+    float heap_key(node_index node_idx) const { return _short_path_data[node_idx].distance_cm + _short_path_data[node_idx].heuristic_cm; }
+
+    // add node to heap or move it up after its distance has decreased
+    void heap_push_or_decrease(node_index node_idx);
+
+    // move the node at heap position pos up or down to restore heap order
+    void heap_sift_up(node_index pos);
+    void heap_sift_down(node_index pos);
+
+    // swap two heap positions, keeping nodes' heap_pos up to date
+    void heap_swap(node_index pos1, node_index pos2);
+
     // update total distance for all nodes visible from current node
     // curr_node_idx is an index into the _short_path_data array
     void update_visible_node_distances(node_index curr_node_idx);
 
+    // update tentative distance of a node reached from curr_node_idx
+    void update_node_distance(node_index curr_node_idx, const AP_OAVisGraph::OAItemID &id, float distance_cm);
+
     // find a node's index into _short_path_data array from it's id (i.e. id type and id number)
     // returns true if successful and node_idx is updated
     bool find_node_from_id(const AP_OAVisGraph::OAItemID &id, node_index &node_idx) const;
 
-    // find index of node with lowest tentative distance (ignore visited nodes)
+    // remove the unvisited node with lowest tentative distance plus heuristic from the heap
     // returns true if successful and node_idx argument is updated
-    bool find_closest_node_idx(node_index &node_idx) const;
+    bool pop_closest_node_idx(node_index &node_idx);
 
     // final path variables and functions
     AP_ExpandingArray<AP_OAVisGraph::OAItemID> _path;   // ids of points on return path in reverse order (i.e. destination is first element)
-    uint8_t _path_numpoints;                            // number of points on return path
+    uint16_t _path_numpoints;                           // number of points on return path
     Vector2f _path_source;                              // source point used in shortest path calculations (offset in cm from EKF origin)
     Vector2f _path_destination;                         // destination position used in shortest path calculations (offset in cm from EKF origin)
 
     // return number of points on path
-    uint8_t get_shortest_path_numpoints() const { return _path_numpoints; }
+    uint16_t get_shortest_path_numpoints() const { return _path_numpoints; }
 
     // return point from final path as an offset (in cm) from the ekf origin
-    bool get_shortest_path_point(uint8_t point_num, Vector2f& pos) const;
+    bool get_shortest_path_point(uint16_t point_num, Vector2f& pos) const;
 
     // find the position of a node as an offset (in cm) from the ekf origin
     // returns true if successful and pos is updated
@@ -207,13 +245,13 @@ private:
 
 #if HAL_LOGGING_ENABLED
     // Logging functions
-    void Write_OADijkstra(const uint8_t state, const uint8_t error_id, const uint8_t curr_point, const uint8_t tot_points, const Location &final_dest, const Location &oa_dest) const;
-    void Write_Visgraph_point(const uint8_t version, const uint8_t point_num, const int32_t Lat, const int32_t Lon) const;
+    void Write_OADijkstra(const uint8_t state, const uint8_t error_id, const uint16_t curr_point, const uint16_t tot_points, const Location &final_dest, const Location &oa_dest) const;
+    void Write_Visgraph_point(const uint8_t version, const uint16_t point_num, const int32_t Lat, const int32_t Lon) const;
 #else
-    void Write_OADijkstra(const uint8_t state, const uint8_t error_id, const uint8_t curr_point, const uint8_t tot_points, const Location &final_dest, const Location &oa_dest) const {}
-    void Write_Visgraph_point(const uint8_t version, const uint8_t point_num, const int32_t Lat, const int32_t Lon) const {}
+    void Write_OADijkstra(const uint8_t state, const uint8_t error_id, const uint16_t curr_point, const uint16_t tot_points, const Location &final_dest, const Location &oa_dest) const {}
+    void Write_Visgraph_point(const uint8_t version, const uint16_t point_num, const int32_t Lat, const int32_t Lon) const {}
 #endif
-    uint8_t _log_num_points;
+    uint16_t _log_num_points;
     uint8_t _log_visgraph_version;
 
     // reference to AP_OAPathPlanner options param
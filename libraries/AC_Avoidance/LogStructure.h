@@ -6,7 +6,8 @@
     LOG_OA_BENDYRULER_MSG, \
     LOG_OA_DIJKSTRA_MSG, \
     LOG_SIMPLE_AVOID_MSG, \
-    LOG_OD_VISGRAPH_MSG
+    LOG_OD_VISGRAPH_MSG, \
+    LOG_OA_DATABASE_MSG
 
 // @LoggerMessage: OABR
 // @Description: Object avoidance (Bendy Ruler) diagnostics
@@ -58,8 +59,8 @@ struct PACKED log_OADijkstra {
     uint64_t time_us;
     uint8_t state;
     uint8_t error_id;
-    uint8_t curr_point;
-    uint8_t tot_points;
+    uint16_t curr_point;
+    uint16_t tot_points;
     int32_t final_lat;
     int32_t final_lng;
     int32_t oa_lat;
@@ -101,17 +102,43 @@ struct PACKED log_OD_Visgraph {
   LOG_PACKET_HEADER;
   uint64_t time_us;
   uint8_t version;
-  uint8_t point_num;
+  uint16_t point_num;
   int32_t Lat;
   int32_t Lon;
 };
 
+// @LoggerMessage: OADB
+// @Description: Object avoidance database statistics, logged while the database holds objects or items are queued, dropped or expired
+// @Field: TimeUS: Time since system startup
+// @Field: Cnt: Number of objects in the database
+// @Field: QMax: Largest number of objects waiting in the queue since the last message
+// @Field: Proc: Number of objects moved from the queue to the database since the last message
+// @Field: QDrop: Number of objects dropped because the queue was full since the last message
+// @Field: DDrop: Number of objects dropped because the database was full since the last message
+// @Field: Exp: Number of objects expired since the last message
+// @Field: PMax: Longest time spent processing the queue in one call since the last message
+// @Field: PTot: Total time spent processing the queue since the last message
+struct PACKED log_OADatabase {
+  LOG_PACKET_HEADER;
+  uint64_t time_us;
+  uint16_t count;
+  uint16_t queue_depth_max;
+  uint16_t processed;
+  uint16_t queue_full;
+  uint16_t database_full;
+  uint16_t expired;
+  uint32_t process_us_max;
+  uint32_t process_us_total;
+};
+
 #define LOG_STRUCTURE_FROM_AVOIDANCE \
     { LOG_OA_BENDYRULER_MSG, sizeof(log_OABendyRuler), \
       "OABR","QBBHHHBfLLiLLi","TimeUS,Type,Act,DYaw,Yaw,DP,RChg,Mar,DLt,DLg,DAlt,OLt,OLg,OAlt", "s--ddd-mDUmDUm", "F-------GGBGGB" , true }, \
     { LOG_OA_DIJKSTRA_MSG, sizeof(log_OADijkstra), \
-      "OADJ","QBBBBLLLL","TimeUS,State,Err,CurrPoint,TotPoints,DLat,DLng,OALat,OALng", "s----DUDU", "F----GGGG" , true }, \
+      "OADJ","QBBHHLLLL","TimeUS,State,Err,CurrPoint,TotPoints,DLat,DLng,OALat,OALng", "s----DUDU", "F----GGGG" , true }, \
     { LOG_SIMPLE_AVOID_MSG, sizeof(log_SimpleAvoid), \
       "SA",  "QBffffffB","TimeUS,State,DVelX,DVelY,DVelZ,MVelX,MVelY,MVelZ,Back", "s-nnnnnn-", "F--------", true }, \
      { LOG_OD_VISGRAPH_MSG, sizeof(log_OD_Visgraph), \
-      "OAVG", "QBBLL", "TimeUS,version,point_num,Lat,Lon", "s--DU", "F--GG", true},
+      "OAVG", "QBHLL", "TimeUS,version,point_num,Lat,Lon", "s--DU", "F--GG", true}, \
+    { LOG_OA_DATABASE_MSG, sizeof(log_OADatabase), \
+      "OADB", "QHHHHHHII", "TimeUS,Cnt,QMax,Proc,QDrop,DDrop,Exp,PMax,PTot", "s------ss", "F------FF", true},
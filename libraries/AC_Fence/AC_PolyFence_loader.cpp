@@ -241,7 +241,7 @@ bool AC_PolyFence_loader::breached(const Location& loc) const
     // check we are inside each inclusion zone:
     for (uint8_t i=0; i<_num_loaded_inclusion_boundaries; i++) {
         const InclusionBoundary &boundary = _loaded_inclusion_boundary[i];
-        if (Polygon_outside(pos, boundary.points_lla, boundary.count)) {
+        if (boundary.index.outside(pos)) {
             num_inclusion_outside++;
         }
     }
@@ -249,17 +249,15 @@ bool AC_PolyFence_loader::breached(const Location& loc) const
     // check we are outside each exclusion zone:
     for (uint8_t i=0; i<_num_loaded_exclusion_boundaries; i++) {
         const ExclusionBoundary &boundary = _loaded_exclusion_boundary[i];
-        if (!Polygon_outside(pos, boundary.points_lla, boundary.count)) {
+        if (!boundary.index.outside(pos)) {
             return true;
         }
     }
 
+    const LocalProjection proj{loc};
     for (uint8_t i=0; i<_num_loaded_circle_exclusion_boundaries; i++) {
         const ExclusionCircle &circle = _loaded_circle_exclusion_boundary[i];
-        Location circle_center;
-        circle_center.lat = circle.point.x;
-        circle_center.lng = circle.point.y;
-        const float diff_cm = loc.get_distance(circle_center)*100.0f;
+        const float diff_cm = proj.get_distance_NE(circle.point.x, circle.point.y).length()*100.0f;
         if (diff_cm < circle.radius * 100.0f) {
             return true;
         }
@@ -267,10 +265,7 @@ bool AC_PolyFence_loader::breached(const Location& loc) const
 
     for (uint8_t i=0; i<_num_loaded_circle_inclusion_boundaries; i++) {
         const InclusionCircle &circle = _loaded_circle_inclusion_boundary[i];
-        Location circle_center;
-        circle_center.lat = circle.point.x;
-        circle_center.lng = circle.point.y;
-        const float diff_cm = loc.get_distance(circle_center)*100.0f;
+        const float diff_cm = proj.get_distance_NE(circle.point.x, circle.point.y).length()*100.0f;
         if (diff_cm > circle.radius * 100.0f) {
             num_inclusion_outside++;
         }
@@ -321,30 +316,29 @@ bool AC_PolyFence_loader::format()
     return write_eos_to_storage(offset);
 }
 
-bool AC_PolyFence_loader::scale_latlon_from_origin(const Location &origin, const Vector2l &point, Vector2f &pos_cm)
+bool AC_PolyFence_loader::scale_latlon_from_origin(const LocalProjection &origin, const Vector2l &point, Vector2f &pos_cm)
 {
-    Location tmp_loc;
-    tmp_loc.lat = point.x;
-    tmp_loc.lng = point.y;
-    pos_cm = origin.get_distance_NE(tmp_loc) * 100.0f;
+    pos_cm = origin.get_distance_NE(point.x, point.y) * 100.0f;
     return true;
 }
 
-bool AC_PolyFence_loader::read_polygon_from_storage(const Location &origin, uint16_t &read_offset, const uint8_t vertex_count, Vector2f *&next_storage_point, Vector2l *&next_storage_point_lla)
+bool AC_PolyFence_loader::read_polygon_from_storage(const LocalProjection &origin, uint16_t &read_offset, const uint8_t vertex_count, Vector2f *&next_storage_point, Vector2l *&next_storage_point_lla)
 {
     for (uint8_t i=0; i<vertex_count; i++) {
         // read from storage to lat/lon
-        if (!read_latlon_from_storage(read_offset, *next_storage_point_lla)) {
+        if (!read_latlon_from_storage(read_offset, next_storage_point_lla[i])) {
             return false;
         }
-        // convert lat/lon to position in cm from origin
-        if (!scale_latlon_from_origin(origin, *next_storage_point_lla, *next_storage_point)) {
-            return false;
-        }
-        
-        next_storage_point_lla++;
-        next_storage_point++;
     }
+
+    // convert lat/lon to position in cm from origin
+    origin.get_distance_NE(next_storage_point_lla, next_storage_point, vertex_count);
+    for (uint8_t i=0; i<vertex_count; i++) {
+        next_storage_point[i] *= 100.0f;
+    }
+
+    next_storage_point_lla += vertex_count;
+    next_storage_point += vertex_count;
     return true;
 }
 
@@ -562,6 +556,36 @@ void AC_PolyFence_loader::unload()
     _load_time_ms = 0;
 }
 
+// build point-in-polygon indexes for the loaded polygons and report their cost
+void AC_PolyFence_loader::index_loaded_polygons()
+{
+    uint32_t memory_used = 0;
+    uint16_t total_edges = 0;
+    float edges_tested = 0;
+    bool all_built = true;
+    for (uint8_t i=0; i<_num_loaded_inclusion_boundaries; i++) {
+        InclusionBoundary &boundary = _loaded_inclusion_boundary[i];
+        all_built &= boundary.index.build(boundary.points_lla, boundary.count);
+        memory_used += boundary.index.memory_used();
+        total_edges += boundary.count;
+        edges_tested += boundary.index.edges_tested_average();
+    }
+    for (uint8_t i=0; i<_num_loaded_exclusion_boundaries; i++) {
+        ExclusionBoundary &boundary = _loaded_exclusion_boundary[i];
+        all_built &= boundary.index.build(boundary.points_lla, boundary.count);
+        memory_used += boundary.index.memory_used();
+        total_edges += boundary.count;
+        edges_tested += boundary.index.edges_tested_average();
+    }
+    if (total_edges == 0) {
+        return;
+    }
+    // without an index each breach check would test every edge
+    gcs().send_text(all_built ? MAV_SEVERITY_INFO : MAV_SEVERITY_WARNING,
+                    "PolyFence: index %uB, %u of %u edges per check",
+                    (unsigned)memory_used, (unsigned)ceilf(edges_tested), (unsigned)total_edges);
+}
+
 // return the number of fences of type type in the index:
 uint16_t AC_PolyFence_loader::index_fence_count(const AC_PolyFenceType type)
 {
@@ -616,6 +640,7 @@ bool AC_PolyFence_loader::load_from_eeprom()
 //        Debug("fence load requires origin");
         return false;
     }
+    const LocalProjection origin_proj{ekf_origin};
 
     // find indexes of each fence:
     if (!get_loaded_fence_semaphore().take_nonblocking()) {
@@ -728,7 +753,7 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 break;
             }
             storage_offset += 1; // skip vertex count
-            if (!read_polygon_from_storage(ekf_origin, storage_offset, index.count, next_storage_point, next_storage_point_lla)) {
+            if (!read_polygon_from_storage(origin_proj, storage_offset, index.count, next_storage_point, next_storage_point_lla)) {
                 gcs().send_text(MAV_SEVERITY_WARNING, "AC_Fence: polygon read failed");
                 storage_valid = false;
                 break;
@@ -747,7 +772,7 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 break;
             }
             storage_offset += 1; // skip vertex count
-            if (!read_polygon_from_storage(ekf_origin, storage_offset, index.count, next_storage_point, next_storage_point_lla)) {
+            if (!read_polygon_from_storage(origin_proj, storage_offset, index.count, next_storage_point, next_storage_point_lla)) {
                 gcs().send_text(MAV_SEVERITY_WARNING, "AC_Fence: polygon read failed");
                 storage_valid = false;
                 break;
@@ -763,7 +788,7 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 storage_valid = false;
                 break;
             }
-            if (!scale_latlon_from_origin(ekf_origin, circle.point, circle.pos_cm)) {
+            if (!scale_latlon_from_origin(origin_proj, circle.point, circle.pos_cm)) {
                 gcs().send_text(MAV_SEVERITY_WARNING, "AC_Fence: latlon read failed");
                 storage_valid = false;
                 break;
@@ -790,7 +815,7 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 storage_valid = false;
                 break;
             }
-            if (!scale_latlon_from_origin(ekf_origin, circle.point, circle.pos_cm)){
+            if (!scale_latlon_from_origin(origin_proj, circle.point, circle.pos_cm)){
                 gcs().send_text(MAV_SEVERITY_WARNING, "AC_Fence: latlon read failed");
                 storage_valid = false;
                 break;
@@ -828,7 +853,7 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 gcs().send_text(MAV_SEVERITY_WARNING, "PolyFence: latlon read failed");
                 break;
             }
-            if (!scale_latlon_from_origin(ekf_origin, *next_storage_point_lla, *next_storage_point)) {
+            if (!scale_latlon_from_origin(origin_proj, *next_storage_point_lla, *next_storage_point)) {
                 storage_valid = false;
                 gcs().send_text(MAV_SEVERITY_WARNING, "PolyFence: latlon read failed");
                 break;
@@ -845,6 +870,8 @@ bool AC_PolyFence_loader::load_from_eeprom()
         return false;
     }
 
+    index_loaded_polygons();
+
     _load_time_ms = AP_HAL::millis();
 
     get_loaded_fence_semaphore().give();
@@ -37,6 +37,7 @@ public:
 
 #include <AP_Common/AP_Common.h>
 #include <AP_Common/Location.h>
+#include <AP_Math/AP_PolygonIndex.h>
 #include <GCS_MAVLink/GCS_MAVLink.h>
 
 class AC_PolyFence_loader
@@ -287,6 +288,7 @@ private:
         Vector2f *points; // pointer into the _loaded_offsets_from_origin array
         Vector2l *points_lla; // pointer into the _loaded_points_lla array
         uint8_t count; // count of points in the boundary
+        AP_PolygonIndex<int32_t> index; // point-in-polygon index over points_lla
     };
     InclusionBoundary *_loaded_inclusion_boundary;
 
@@ -297,6 +299,7 @@ private:
         Vector2f *points; // pointer into the _loaded_offsets_from_origin array
         Vector2l *points_lla; // pointer into the _loaded_points_lla_lla array
         uint8_t count; // count of points in the boundary
+        AP_PolygonIndex<int32_t> index; // point-in-polygon index over points_lla
     };
     ExclusionBoundary *_loaded_exclusion_boundary;
 
@@ -338,10 +341,13 @@ private:
     // succeeded.  Will be zero if fences are not loaded
     uint32_t _load_time_ms;
 
+    // build point-in-polygon indexes for the loaded polygons and report their cost
+    void index_loaded_polygons();
+
     // scale_latlon_from_origin - given a latitude/longitude
     // transforms the point to an offset-from-origin and deposits
     // the result into pos_cm.
-    bool scale_latlon_from_origin(const Location &origin,
+    bool scale_latlon_from_origin(const LocalProjection &origin,
                                   const Vector2l &point,
                                   Vector2f &pos_cm) WARN_IF_UNUSED;
    
@@ -349,7 +355,7 @@ private:
     // latitude/longitude points from offset in permanent storage,
     // transforms them into an offset-from-origin and deposits the
     // results into next_storage_point.
-    bool read_polygon_from_storage(const Location &origin,
+    bool read_polygon_from_storage(const LocalProjection &origin,
                                    uint16_t &read_offset,
                                    const uint8_t vertex_count,
                                    Vector2f *&next_storage_point,
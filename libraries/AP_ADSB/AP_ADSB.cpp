@@ -446,12 +446,13 @@ void AP_ADSB::determine_furthest_aircraft(void)
 {
     float max_distance = 0;
     uint16_t max_distance_index = 0;
+    const LocalProjection my_proj{_my_loc};
 
     for (uint16_t index = 0; index < in_state.vehicle_count; index++) {
         if (is_special_vehicle(in_state.vehicle_list[index].info.ICAO_address)) {
             continue;
         }
-        const float distance = _my_loc.get_distance(get_location(in_state.vehicle_list[index]));
+        const float distance = my_proj.get_distance(get_location(in_state.vehicle_list[index]));
         if (max_distance < distance || index == 0) {
             max_distance = distance;
             max_distance_index = index;
@@ -358,6 +358,33 @@ void AP_AHRS::update_state(void)
     _getCorrectedDeltaVelocityNED(state.corrected_dv, state.corrected_dv_dt);
     state.origin_ok = _get_origin(state.origin);
     state.velocity_NED_ok = _get_velocity_NED(state.velocity_NED);
+
+    publish_snapshot();
+}
+
+/*
+  publish the snapshot for readers in other threads
+ */
+void AP_AHRS::publish_snapshot(void)
+{
+    Snapshot snap;
+    snap.time_us = AP_HAL::micros64();
+    snap.quat = state.quat;
+    snap.quat_ok = state.quat_ok;
+    snap.roll = roll;
+    snap.pitch = pitch;
+    snap.yaw = yaw;
+    snap.gyro = state.gyro_estimate;
+    snap.location = state.location;
+    snap.location_ok = state.location_ok;
+    snap.relpos_NED_home_ok = get_relative_position_NED_home(snap.relpos_NED_home);
+    snap.velocity_NED = state.velocity_NED;
+    snap.velocity_NED_ok = state.velocity_NED_ok;
+    snap.wind_estimate = state.wind_estimate;
+    snap.wind_estimate_ok = state.wind_estimate_ok;
+    snap.origin = state.origin;
+    snap.origin_ok = state.origin_ok;
+    _snapshot.write(snap);
 }
 
 void AP_AHRS::update(bool skip_ins_update)
@@ -24,6 +24,7 @@
 #include "AP_AHRS_config.h"
 
 #include <AP_HAL/Semaphores.h>
+#include <AP_HAL/utility/SeqLock.h>
 
 #include "AP_AHRS_Backend.h"
 #include <AP_NavEKF2/AP_NavEKF2.h>
@@ -76,6 +77,37 @@ public:
         return _rsem;
     }
 
+    /*
+      copy of the main AHRS outputs published at the end of each
+      update(). Other threads can read this without taking the AHRS
+      semaphore and will always get values from a single update
+     */
+    struct Snapshot {
+        uint64_t time_us;
+        Quaternion quat;
+        bool quat_ok;
+        float roll;
+        float pitch;
+        float yaw;
+        Vector3f gyro;
+        Location location;
+        bool location_ok;
+        Vector3f relpos_NED_home;
+        bool relpos_NED_home_ok;
+        Vector3f velocity_NED;
+        bool velocity_NED_ok;
+        Vector3f wind_estimate;
+        bool wind_estimate_ok;
+        Location origin;
+        bool origin_ok;
+    };
+
+    // get the snapshot from the last update(), returns false before
+    // the first update
+    bool get_snapshot(Snapshot &snap) const WARN_IF_UNUSED {
+        return _snapshot.read(snap);
+    }
+
     // return the smoothed gyro vector corrected for drift
     const Vector3f &get_gyro(void) const { return state.gyro_estimate; }
 
@@ -987,6 +1019,10 @@ private:
         bool velocity_NED_ok;
     } state;
 
+    // outputs published for lock-free readers
+    SeqLockBuffer<Snapshot> _snapshot;
+    void publish_snapshot(void);
+
     /*
      *  backends (and their results)
      */
@@ -172,6 +172,7 @@ private:
 
     void check_for_threats();
     void update_threat_level(const Location &my_loc,
+                             const LocalProjection &my_proj,
                              const Vector3f &my_vel,
                              AP_Avoidance::Obstacle &obstacle);
 
@@ -214,9 +215,8 @@ private:
     static AP_Avoidance *_singleton;
 };
 
-float closest_approach_xy(const Location &my_loc,
+float closest_approach_xy(const Vector2f &delta_pos_ne,
                           const Vector3f &my_vel,
-                          const Location &obstacle_loc,
                           const Vector3f &obstacle_vel,
                           uint8_t time_horizon);
 
@@ -349,8 +349,8 @@ const AP_Param::GroupInfo AP_BoardConfig::var_info[] = {
 #if AP_SDCARD_STORAGE_ENABLED
     // @Param: SD_MISSION
     // @DisplayName:  SDCard Mission size
-    // @Description: This sets the amount of storage in kilobytes reserved on the microsd card in mission.stg for waypoint storage. Each waypoint uses 15 bytes.
-    // @Range: 0 64
+    // @Description: This sets the amount of storage in kilobytes reserved on the microsd card in mission.stg for waypoint storage. Each waypoint uses 15 bytes, up to a maximum of 32767 waypoints. Up to 64 kilobytes is held in RAM, larger missions are read from the card as they are needed.
+    // @Range: 0 480
     // @RebootRequired: True
     // @User: Advanced
     AP_GROUPINFO("SD_MISSION", 24, AP_BoardConfig, sdcard_storage.mission_kb, 0),
@@ -505,3 +505,41 @@ void Location::linearly_interpolate_alt(const Location &point1, const Location &
     // new target's distance along the original track and then linear interpolate between the original origin and destination altitudes
     set_alt_cm(point1.alt + (point2.alt - point1.alt) * constrain_float(line_path_proportion(point1, point2), 0.0f, 1.0f), point2.get_alt_frame());
 }
+
+// set the reference latitude/longitude in 1E7 degrees
+void LocalProjection::set_reference(int32_t lat, int32_t lng)
+{
+    ref_lat = lat;
+    ref_lng = lng;
+    const float lat_rad = lat * (1.0e-7 * DEG_TO_RAD);
+    cos_ref_lat = cosf(lat_rad);
+    sin_ref_lat = sinf(lat_rad);
+}
+
+// convert count lat/lng points to N/E offsets from the reference
+void LocalProjection::get_distance_NE(const Vector2l *points, Vector2f *ne, uint16_t count) const
+{
+    for (uint16_t i=0; i<count; i++) {
+        ne[i] = get_distance_NE(points[i].x, points[i].y);
+    }
+}
+
+// return bearing in radians from the reference to loc, 0 to 2*Pi
+float LocalProjection::get_bearing(const Location &loc) const
+{
+    const Vector2f ne = get_distance_NE(loc);
+    float bearing = atan2f(ne.y, ne.x);
+    if (bearing < 0) {
+        bearing += M_2PI;
+    }
+    return bearing;
+}
+
+// return the latitude/longitude given distances north and east of the reference
+void LocalProjection::offset_latlng(int32_t &lat, int32_t &lng, float ofs_north, float ofs_east) const
+{
+    const int32_t dlat = ofs_north * LOCATION_SCALING_FACTOR_INV;
+    const int64_t dlng = (ofs_east * LOCATION_SCALING_FACTOR_INV) / longitude_scale(dlat);
+    lat = Location::limit_lattitude(ref_lat + dlat);
+    lng = Location::wrap_longitude(dlng + ref_lng);
+}
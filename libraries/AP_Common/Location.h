@@ -165,3 +165,75 @@ private:
     // inverse of LOCATION_SCALING_FACTOR
     static constexpr float LOCATION_SCALING_FACTOR_INV = LATLON_TO_M_INV;
 };
+
+/*
+  convert between Locations and North/East offsets in meters from a
+  fixed reference point. This gives the same results as
+  Location::get_distance_NE() and Location::offset() from the
+  reference, but the sine and cosine of the reference latitude are
+  computed once so each conversion needs no trigonometry. Use this
+  when many locations are compared against the same point. Results
+  match to float precision for points within about 1000km of the
+  reference
+ */
+class LocalProjection
+{
+public:
+    LocalProjection() {}
+    LocalProjection(const Location &ref) { set_reference(ref.lat, ref.lng); }
+
+    // set the reference latitude/longitude in 1E7 degrees
+    void set_reference(int32_t lat, int32_t lng);
+
+    int32_t get_ref_lat() const { return ref_lat; }
+    int32_t get_ref_lng() const { return ref_lng; }
+
+    // return the distance in meters in North/East plane as a N/E vector
+    // from the reference to lat/lng
+    Vector2f get_distance_NE(int32_t lat, int32_t lng) const {
+        const int32_t dlat = lat - ref_lat;
+        return Vector2f(dlat * LOCATION_SCALING_FACTOR,
+                        Location::diff_longitude(lng, ref_lng) * LOCATION_SCALING_FACTOR * longitude_scale(dlat));
+    }
+    Vector2f get_distance_NE(const Location &loc) const {
+        return get_distance_NE(loc.lat, loc.lng);
+    }
+
+    // convert count lat/lng points in 1E7 degrees to N/E offsets in
+    // meters from the reference. points and ne may not overlap
+    void get_distance_NE(const Vector2l *points, Vector2f *ne, uint16_t count) const;
+
+    // return horizontal distance in meters from the reference to loc
+    float get_distance(const Location &loc) const {
+        return get_distance_NE(loc).length();
+    }
+
+    // return bearing in radians from the reference to loc, 0 to 2*Pi
+    float get_bearing(const Location &loc) const;
+
+    // return the latitude/longitude given distances (in meters) north
+    // and east of the reference
+    void offset_latlng(int32_t &lat, int32_t &lng, float ofs_north, float ofs_east) const;
+
+private:
+    int32_t ref_lat;
+    int32_t ref_lng;
+    float cos_ref_lat = 1;
+    float sin_ref_lat;
+
+    static constexpr float LOCATION_SCALING_FACTOR = LATLON_TO_M;
+    static constexpr float LOCATION_SCALING_FACTOR_INV = LATLON_TO_M_INV;
+    static constexpr float HALF_LATLON_TO_RAD = 0.5e-7 * DEG_TO_RAD;
+
+    // the same as Location::longitude_scale() at the latitude half way
+    // between the reference and a point dlat north of it, using the
+    // angle sum identity with a series expansion of the small angle
+    float longitude_scale(int32_t dlat) const {
+        const float h = dlat * HALF_LATLON_TO_RAD;
+        const float h2 = h * h;
+        const float cos_h = 1 - h2 * (0.5f - h2 * (1.0f/24));
+        const float sin_h = h * (1 - h2 * (1.0f/6));
+        const float scale = cos_ref_lat * cos_h - sin_ref_lat * sin_h;
+        return MAX(scale, 0.01f);
+    }
+};
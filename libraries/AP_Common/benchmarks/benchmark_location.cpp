@@ -0,0 +1,131 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Common/Location.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// points scattered within about 10km of the reference, like the
+// vertices of a fence or a list of ADSB vehicles
+#define BENCHMARK_NUM_POINTS 64
+
+static const Location ref_loc{-353629380, 1491650850, 0, Location::AltFrame::ABSOLUTE};
+
+static void make_points(Location *locs, Vector2l *points)
+{
+    for (uint16_t i = 0; i < BENCHMARK_NUM_POINTS; i++) {
+        locs[i] = ref_loc;
+        locs[i].lat += int32_t(((i * 7919) % 1801) - 900) * 1000;
+        locs[i].lng += int32_t(((i * 6151) % 1801) - 900) * 1000;
+        points[i].x = locs[i].lat;
+        points[i].y = locs[i].lng;
+    }
+}
+
+static void BM_LocationDistanceNE(benchmark::State& state)
+{
+    Location locs[BENCHMARK_NUM_POINTS];
+    Vector2l points[BENCHMARK_NUM_POINTS];
+    Vector2f ne[BENCHMARK_NUM_POINTS];
+    make_points(locs, points);
+
+    while (state.KeepRunning()) {
+        for (uint16_t i = 0; i < BENCHMARK_NUM_POINTS; i++) {
+            ne[i] = ref_loc.get_distance_NE(locs[i]);
+        }
+        gbenchmark_escape(ne);
+    }
+}
+
+static void BM_LocalProjectionDistanceNE(benchmark::State& state)
+{
+    Location locs[BENCHMARK_NUM_POINTS];
+    Vector2l points[BENCHMARK_NUM_POINTS];
+    Vector2f ne[BENCHMARK_NUM_POINTS];
+    make_points(locs, points);
+    const LocalProjection proj{ref_loc};
+
+    while (state.KeepRunning()) {
+        for (uint16_t i = 0; i < BENCHMARK_NUM_POINTS; i++) {
+            ne[i] = proj.get_distance_NE(locs[i]);
+        }
+        gbenchmark_escape(ne);
+    }
+}
+
+// batch conversion, including setting up the projection
+static void BM_LocalProjectionBatchNE(benchmark::State& state)
+{
+    Location locs[BENCHMARK_NUM_POINTS];
+    Vector2l points[BENCHMARK_NUM_POINTS];
+    Vector2f ne[BENCHMARK_NUM_POINTS];
+    make_points(locs, points);
+
+    while (state.KeepRunning()) {
+        const LocalProjection proj{ref_loc};
+        proj.get_distance_NE(points, ne, BENCHMARK_NUM_POINTS);
+        gbenchmark_escape(ne);
+    }
+}
+
+static void BM_LocationDistance(benchmark::State& state)
+{
+    Location locs[BENCHMARK_NUM_POINTS];
+    Vector2l points[BENCHMARK_NUM_POINTS];
+    make_points(locs, points);
+
+    while (state.KeepRunning()) {
+        float max_dist = 0;
+        for (uint16_t i = 0; i < BENCHMARK_NUM_POINTS; i++) {
+            max_dist = MAX(max_dist, ref_loc.get_distance(locs[i]));
+        }
+        gbenchmark_escape(&max_dist);
+    }
+}
+
+static void BM_LocalProjectionDistance(benchmark::State& state)
+{
+    Location locs[BENCHMARK_NUM_POINTS];
+    Vector2l points[BENCHMARK_NUM_POINTS];
+    make_points(locs, points);
+    const LocalProjection proj{ref_loc};
+
+    while (state.KeepRunning()) {
+        float max_dist = 0;
+        for (uint16_t i = 0; i < BENCHMARK_NUM_POINTS; i++) {
+            max_dist = MAX(max_dist, proj.get_distance(locs[i]));
+        }
+        gbenchmark_escape(&max_dist);
+    }
+}
+
+static void BM_LocationOffset(benchmark::State& state)
+{
+    while (state.KeepRunning()) {
+        int32_t lat = ref_loc.lat, lng = ref_loc.lng;
+        Location::offset_latlng(lat, lng, 1234.5, -6789.0);
+        gbenchmark_escape(&lat);
+        gbenchmark_escape(&lng);
+    }
+}
+
+static void BM_LocalProjectionOffset(benchmark::State& state)
+{
+    const LocalProjection proj{ref_loc};
+
+    while (state.KeepRunning()) {
+        int32_t lat, lng;
+        proj.offset_latlng(lat, lng, 1234.5, -6789.0);
+        gbenchmark_escape(&lat);
+        gbenchmark_escape(&lng);
+    }
+}
+
+BENCHMARK(BM_LocationDistanceNE);
+BENCHMARK(BM_LocalProjectionDistanceNE);
+BENCHMARK(BM_LocalProjectionBatchNE);
+BENCHMARK(BM_LocationDistance);
+BENCHMARK(BM_LocalProjectionDistance);
+BENCHMARK(BM_LocationOffset);
+BENCHMARK(BM_LocalProjectionOffset);
+
+BENCHMARK_MAIN();
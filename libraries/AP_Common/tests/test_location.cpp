@@ -389,4 +389,55 @@ TEST(Location, OffsetError)
     }
 }
 
+/*
+  check the projection gives the same results as the Location
+  functions it replaces, for points up to 100km from the reference
+ */
+TEST(Location, LocalProjection)
+{
+    const Location refs[] {
+        {-35362938, 149165085, 0, Location::AltFrame::ABSOLUTE},
+        {515000000, -1000000, 0, Location::AltFrame::ABSOLUTE},
+        {0, 1799990000, 0, Location::AltFrame::ABSOLUTE},
+        {-849000000, -1799990000, 0, Location::AltFrame::ABSOLUTE},
+    };
+    for (const auto &ref : refs) {
+        const LocalProjection proj{ref};
+        for (int32_t dlat = -9000000; dlat <= 9000000; dlat += 900000) {
+            for (int32_t dlng = -9000000; dlng <= 9000000; dlng += 900000) {
+                Location loc = ref;
+                loc.lat = Location::limit_lattitude(ref.lat + dlat);
+                loc.lng = Location::wrap_longitude(int64_t(ref.lng) + dlng);
+                const Vector2f ne = ref.get_distance_NE(loc);
+                const float tol = MAX(ne.length() * 1e-6, 1e-3);
+                EXPECT_VECTOR2F_NEAR(ne, proj.get_distance_NE(loc), tol);
+                EXPECT_NEAR(ref.get_distance(loc), proj.get_distance(loc), tol);
+                if (ne.length() > 1000) {
+                    EXPECT_NEAR(wrap_PI(ref.get_bearing(loc) - proj.get_bearing(loc)), 0, 1e-3);
+                }
+
+                int32_t lat = ref.lat, lng = ref.lng;
+                Location::offset_latlng(lat, lng, ne.x, ne.y);
+                int32_t proj_lat, proj_lng;
+                proj.offset_latlng(proj_lat, proj_lng, ne.x, ne.y);
+                // offsets are in float so allow for rounding
+                EXPECT_NEAR(lat, proj_lat, 2);
+                EXPECT_NEAR(Location::diff_longitude(lng, proj_lng), 0, MAX(abs(dlng) * 1e-6, 2));
+            }
+        }
+
+        // batch conversion
+        Vector2l points[5];
+        Vector2f ne[ARRAY_SIZE(points)];
+        for (uint8_t i=0; i<ARRAY_SIZE(points); i++) {
+            points[i].x = ref.lat + (i - 2) * 12345;
+            points[i].y = Location::wrap_longitude(int64_t(ref.lng) - i * 54321);
+        }
+        proj.get_distance_NE(points, ne, ARRAY_SIZE(points));
+        for (uint8_t i=0; i<ARRAY_SIZE(points); i++) {
+            EXPECT_VECTOR2F_EQ(proj.get_distance_NE(points[i].x, points[i].y), ne[i]);
+        }
+    }
+}
+
 AP_GTEST_MAIN()
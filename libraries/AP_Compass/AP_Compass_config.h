@@ -22,6 +22,12 @@
 #define AP_COMPASS_CALIBRATION_FIXED_YAW_ENABLED AP_GPS_ENABLED
 #endif
 
+// run the calibration of each compass in its own thread so that the
+// fits of several compasses can run on separate cores
+#ifndef AP_COMPASS_CAL_THREAD_PER_COMPASS_ENABLED
+#define AP_COMPASS_CAL_THREAD_PER_COMPASS_ENABLED (COMPASS_CAL_ENABLED && CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
 #define COMPASS_MAX_SCALE_FACTOR 1.5
 #define COMPASS_MIN_SCALE_FACTOR (1.0/COMPASS_MAX_SCALE_FACTOR)
 
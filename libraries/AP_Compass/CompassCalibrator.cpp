@@ -190,35 +190,86 @@ void CompassCalibrator::update()
         return;
     }
 
+    if (!run_fit_step() && _status == Status::RUNNING_STEP_TWO) {
+        if (fit_acceptable() && fix_radius() && calculate_orientation()) {
+            set_status(Status::SUCCESS);
+        } else {
+            set_status(Status::FAILED);
+        }
+    }
+}
+
+// run the next step of the fits, moving from step one to step two
+// returns false when there are no more steps, which in step two means
+// the fit is ready for the acceptance checks
+bool CompassCalibrator::run_fit_step()
+{
     if (_status == Status::RUNNING_STEP_ONE) {
         if (_fit_step >= 10) {
             if (is_equal(_fitness, _initial_fitness) || isnan(_fitness)) {  // if true, means that fitness is diverging instead of converging
                 set_status(Status::FAILED);
-            } else {
-                set_status(Status::RUNNING_STEP_TWO);
-            }
-        } else {
-            if (_fit_step == 0) {
-                calc_initial_offset();
+                return false;
             }
-            run_sphere_fit();
-            _fit_step++;
+            set_status(Status::RUNNING_STEP_TWO);
+            return true;
+        }
+        if (_fit_step == 0) {
+            calc_initial_offset();
         }
+        run_sphere_fit();
     } else if (_status == Status::RUNNING_STEP_TWO) {
         if (_fit_step >= 35) {
-            if (fit_acceptable() && fix_radius() && calculate_orientation()) {
-                set_status(Status::SUCCESS);
-            } else {
-                set_status(Status::FAILED);
-            }
-        } else if (_fit_step < 15) {
+            return false;
+        }
+        if (_fit_step < 15) {
             run_sphere_fit();
-            _fit_step++;
         } else {
             run_ellipsoid_fit();
-            _fit_step++;
         }
+    } else {
+        return false;
     }
+    _fit_step++;
+    return true;
+}
+
+#if AP_COMPASS_CAL_THREAD_PER_COMPASS_ENABLED
+bool CompassCalibrator::start_thread()
+{
+    if (_thread_started) {
+        return true;
+    }
+    _thread_started = hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&CompassCalibrator::update_thread, void), "compasscal", 2048, AP_HAL::Scheduler::PRIORITY_IO, 0);
+    return _thread_started;
+}
+
+void CompassCalibrator::update_thread()
+{
+    while (true) {
+        update();
+        hal.scheduler->delay(1);
+    }
+}
+#endif
+
+/*
+  start a calibration with a full buffer of recorded samples and run
+  the same fit steps as update(), stopping before the acceptance checks
+ */
+float CompassCalibrator::fit_samples(const Vector3f *samples, uint16_t num_samples)
+{
+    set_status(Status::WAITING_TO_START);
+    if (_status != Status::RUNNING_STEP_ONE) {
+        return 1.0e30f;
+    }
+    _samples_collected = MIN(num_samples, COMPASS_CAL_NUM_SAMPLES);
+    for (uint16_t i = 0; i < _samples_collected; i++) {
+        _sample_buffer[i].set(samples[i]);
+    }
+
+    while (run_fit_step()) {
+    }
+    return _fitness;
 }
 
 void CompassCalibrator::pull_sample()
@@ -557,27 +608,21 @@ bool CompassCalibrator::accept_sample(const CompassSample& sample, uint16_t skip
     return accept_sample(sample.get(), skip_index);
 }
 
-float CompassCalibrator::calc_residual(const Vector3f& sample, const param_t& params) const
-{
-    Matrix3f softiron(
-        params.diag.x    , params.offdiag.x , params.offdiag.y,
-        params.offdiag.x , params.diag.y    , params.offdiag.z,
-        params.offdiag.y , params.offdiag.z , params.diag.z
-    );
-    return params.radius - (softiron*(sample+params.offset)).length();
-}
-
 // calc the fitness given a set of parameters (offsets, diagonals, off diagonals)
 float CompassCalibrator::calc_mean_squared_residuals(const param_t& params) const
 {
     if (_sample_buffer == nullptr || _samples_collected == 0) {
         return 1.0e30f;
     }
+    const Matrix3f softiron(
+        params.diag.x    , params.offdiag.x , params.offdiag.y,
+        params.offdiag.x , params.diag.y    , params.offdiag.z,
+        params.offdiag.y , params.offdiag.z , params.diag.z
+    );
     float sum = 0.0f;
     for (uint16_t i=0; i < _samples_collected; i++) {
-        Vector3f sample = _sample_buffer[i].get();
-        float resid = calc_residual(sample, params);
-        sum += sq(resid);
+        const Vector3f sample = _sample_buffer[i].get();
+        sum += sq(params.radius - (softiron*(sample+params.offset)).length());
     }
     sum /= _samples_collected;
     return sum;
@@ -594,28 +639,96 @@ void CompassCalibrator::calc_initial_offset()
     _params.offset /= _samples_collected;
 }
 
-void CompassCalibrator::calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const
+/*
+  calculate the residual of a sample and its partial derivatives wrt
+  the parameters of the sphere fit (radius then offsets) or of the
+  ellipsoid fit (offsets, diagonals then off diagonals). The soft iron
+  correction and its length are shared by the residual and all of the
+  derivatives
+ */
+template <uint8_t N>
+float CompassCalibrator::calc_jacob(const Vector3f& sample, const param_t& params, float* ret) const
 {
-    const Vector3f &offset = params.offset;
     const Vector3f &diag = params.diag;
     const Vector3f &offdiag = params.offdiag;
-    Matrix3f softiron(
-        diag.x    , offdiag.x , offdiag.y,
-        offdiag.x , diag.y    , offdiag.z,
-        offdiag.y , offdiag.z , diag.z
-    );
+    const Vector3f v = sample + params.offset;
+
+    const float A = (diag.x    * v.x) + (offdiag.x * v.y) + (offdiag.y * v.z);
+    const float B = (offdiag.x * v.x) + (diag.y    * v.y) + (offdiag.z * v.z);
+    const float C = (offdiag.y * v.x) + (offdiag.z * v.y) + (diag.z    * v.z);
+    const float length = norm(A, B, C);
+    const float scale = -1.0f / length;
+
+    // partial derivative (offsets wrt fitness fn) fn operated on sample
+    float *ret_offset = ret;
+    if (N == COMPASS_CAL_NUM_SPHERE_PARAMS) {
+        // partial derivative (radius wrt fitness fn) fn operated on sample
+        ret[0] = 1.0f;
+        ret_offset = &ret[1];
+    }
+    ret_offset[0] = ((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C)) * scale;
+    ret_offset[1] = ((offdiag.x * A) + (diag.y    * B) + (offdiag.z * C)) * scale;
+    ret_offset[2] = ((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C)) * scale;
+    if (N == COMPASS_CAL_NUM_ELLIPSOID_PARAMS) {
+        // 3-5: partial derivative (diag offset wrt fitness fn) fn operated on sample
+        ret_offset[3] = (v.x * A) * scale;
+        ret_offset[4] = (v.y * B) * scale;
+        ret_offset[5] = (v.z * C) * scale;
+        // 6-8: partial derivative (off-diag offset wrt fitness fn) fn operated on sample
+        ret_offset[6] = ((v.y * A) + (v.x * B)) * scale;
+        ret_offset[7] = ((v.z * A) + (v.x * C)) * scale;
+        ret_offset[8] = ((v.z * B) + (v.y * C)) * scale;
+    }
+
+    return params.radius - length;
+}
+
+/*
+  accumulate J^T.J and J^T.residual over all samples. The Jacobians of
+  a block of samples are stored parameter by parameter so that the sums
+  over the block are contiguous and can be vectorised, and as J^T.J is
+  symmetric only its upper triangle is summed
+ */
+template <uint8_t N>
+void CompassCalibrator::calc_normal_equations(const param_t& params, float* JTJ, float* JTFI) const
+{
+    float J[N][COMPASS_CAL_FIT_BLOCK_SIZE];
+    float resid[COMPASS_CAL_FIT_BLOCK_SIZE];
+
+    for (uint16_t start = 0; start < _samples_collected; start += COMPASS_CAL_FIT_BLOCK_SIZE) {
+        for (uint8_t k = 0; k < COMPASS_CAL_FIT_BLOCK_SIZE; k++) {
+            // the last block is padded with zeros, which add nothing to the sums
+            float jacob[N] {};
+            resid[k] = 0.0f;
+            if (start + k < _samples_collected) {
+                resid[k] = calc_jacob<N>(_sample_buffer[start + k].get(), params, jacob);
+            }
+            for (uint8_t i = 0; i < N; i++) {
+                J[i][k] = jacob[i];
+            }
+        }
+
+        for (uint8_t i = 0; i < N; i++) {
+            for (uint8_t j = i; j < N; j++) {
+                float sum = 0.0f;
+                for (uint8_t k = 0; k < COMPASS_CAL_FIT_BLOCK_SIZE; k++) {
+                    sum += J[i][k] * J[j][k];
+                }
+                JTJ[i*N+j] += sum;
+            }
+            float sum = 0.0f;
+            for (uint8_t k = 0; k < COMPASS_CAL_FIT_BLOCK_SIZE; k++) {
+                sum += J[i][k] * resid[k];
+            }
+            JTFI[i] += sum;
+        }
+    }
 
-    float A =  (diag.x    * (sample.x + offset.x)) + (offdiag.x * (sample.y + offset.y)) + (offdiag.y * (sample.z + offset.z));
-    float B =  (offdiag.x * (sample.x + offset.x)) + (diag.y    * (sample.y + offset.y)) + (offdiag.z * (sample.z + offset.z));
-    float C =  (offdiag.y * (sample.x + offset.x)) + (offdiag.z * (sample.y + offset.y)) + (diag.z    * (sample.z + offset.z));
-    float length = (softiron*(sample+offset)).length();
-
-    // 0: partial derivative (radius wrt fitness fn) fn operated on sample
-    ret[0] = 1.0f;
-    // 1-3: partial derivative (offsets wrt fitness fn) fn operated on sample
-    ret[1] = -1.0f * (((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C))/length);
-    ret[2] = -1.0f * (((offdiag.x * A) + (diag.y    * B) + (offdiag.z * C))/length);
-    ret[3] = -1.0f * (((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C))/length);
+    for (uint8_t i = 1; i < N; i++) {
+        for (uint8_t j = 0; j < i; j++) {
+            JTJ[i*N+j] = JTJ[j*N+i];
+        }
+    }
 }
 
 // run sphere fit to calculate diagonals and offdiagonals
@@ -634,27 +747,12 @@ void CompassCalibrator::run_sphere_fit()
     fit1_params = fit2_params = _params;
 
     float JTJ[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
-    float JTJ2[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
+    float JTJ2[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS];
     float JTFI[COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
 
     // Gauss Newton Part common for all kind of extensions including LM
-    for (uint16_t k = 0; k<_samples_collected; k++) {
-        Vector3f sample = _sample_buffer[k].get();
-
-        float sphere_jacob[COMPASS_CAL_NUM_SPHERE_PARAMS];
-
-        calc_sphere_jacob(sample, fit1_params, sphere_jacob);
-
-        for (uint8_t i = 0;i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
-            // compute JTJ
-            for (uint8_t j = 0; j < COMPASS_CAL_NUM_SPHERE_PARAMS; j++) {
-                JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];   //a backup JTJ for LM
-            }
-            // compute JTFI
-            JTFI[i] += sphere_jacob[i] * calc_residual(sample, fit1_params);
-        }
-    }
+    calc_normal_equations<COMPASS_CAL_NUM_SPHERE_PARAMS>(fit1_params, JTJ, JTFI);
+    memcpy(JTJ2, JTJ, sizeof(JTJ2));    //a backup JTJ for LM
 
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
     // refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
@@ -705,36 +803,6 @@ void CompassCalibrator::run_sphere_fit()
     }
 }
 
-void CompassCalibrator::calc_ellipsoid_jacob(const Vector3f& sample, const param_t& params, float* ret) const
-{
-    const Vector3f &offset = params.offset;
-    const Vector3f &diag = params.diag;
-    const Vector3f &offdiag = params.offdiag;
-    Matrix3f softiron(
-        diag.x    , offdiag.x , offdiag.y,
-        offdiag.x , diag.y    , offdiag.z,
-        offdiag.y , offdiag.z , diag.z
-    );
-
-    float A =  (diag.x    * (sample.x + offset.x)) + (offdiag.x * (sample.y + offset.y)) + (offdiag.y * (sample.z + offset.z));
-    float B =  (offdiag.x * (sample.x + offset.x)) + (diag.y    * (sample.y + offset.y)) + (offdiag.z * (sample.z + offset.z));
-    float C =  (offdiag.y * (sample.x + offset.x)) + (offdiag.z * (sample.y + offset.y)) + (diag.z    * (sample.z + offset.z));
-    float length = (softiron*(sample+offset)).length();
-
-    // 0-2: partial derivative (offset wrt fitness fn) fn operated on sample
-    ret[0] = -1.0f * (((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C))/length);
-    ret[1] = -1.0f * (((offdiag.x * A) + (diag.y    * B) + (offdiag.z * C))/length);
-    ret[2] = -1.0f * (((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C))/length);
-    // 3-5: partial derivative (diag offset wrt fitness fn) fn operated on sample
-    ret[3] = -1.0f * ((sample.x + offset.x) * A)/length;
-    ret[4] = -1.0f * ((sample.y + offset.y) * B)/length;
-    ret[5] = -1.0f * ((sample.z + offset.z) * C)/length;
-    // 6-8: partial derivative (off-diag offset wrt fitness fn) fn operated on sample
-    ret[6] = -1.0f * (((sample.y + offset.y) * A) + ((sample.x + offset.x) * B))/length;
-    ret[7] = -1.0f * (((sample.z + offset.z) * A) + ((sample.x + offset.x) * C))/length;
-    ret[8] = -1.0f * (((sample.z + offset.z) * B) + ((sample.y + offset.y) * C))/length;
-}
-
 void CompassCalibrator::run_ellipsoid_fit()
 {
     if (_sample_buffer == nullptr) {
@@ -750,27 +818,12 @@ void CompassCalibrator::run_ellipsoid_fit()
     fit1_params = fit2_params = _params;
 
     float JTJ[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
-    float JTJ2[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
+    float JTJ2[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
     float JTFI[COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
 
     // Gauss Newton Part common for all kind of extensions including LM
-    for (uint16_t k = 0; k<_samples_collected; k++) {
-        Vector3f sample = _sample_buffer[k].get();
-
-        float ellipsoid_jacob[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
-
-        calc_ellipsoid_jacob(sample, fit1_params, ellipsoid_jacob);
-
-        for (uint8_t i = 0;i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
-            // compute JTJ
-            for (uint8_t j = 0; j < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; j++) {
-                JTJ [i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
-            }
-            // compute JTFI
-            JTFI[i] += ellipsoid_jacob[i] * calc_residual(sample, fit1_params);
-        }
-    }
+    calc_normal_equations<COMPASS_CAL_NUM_ELLIPSOID_PARAMS>(fit1_params, JTJ, JTFI);
+    memcpy(JTJ2, JTJ, sizeof(JTJ2));
 
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
     //refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
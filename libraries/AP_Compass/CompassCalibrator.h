@@ -9,6 +9,7 @@
 #define COMPASS_CAL_NUM_SPHERE_PARAMS       4
 #define COMPASS_CAL_NUM_ELLIPSOID_PARAMS    9
 #define COMPASS_CAL_NUM_SAMPLES             300     // number of samples required before fitting begins
+#define COMPASS_CAL_FIT_BLOCK_SIZE          4       // number of samples evaluated together by the fits
 
 class CompassCalibrator {
 public:
@@ -34,6 +35,12 @@ public:
     // update the state machine and calculate offsets, diagonals and offdiagonals
     void update();
 
+#if AP_COMPASS_CAL_THREAD_PER_COMPASS_ENABLED
+    // start a thread which calls update() for this calibrator only,
+    // returns true if the thread is running
+    bool start_thread();
+#endif
+
     // compass calibration states
     enum class Status {
         NOT_STARTED = 0,
@@ -102,6 +109,11 @@ protected:
     // return true if this is a right angle rotation
     bool right_angle_rotation(Rotation r) const;
 
+    // run the fit steps of update() over a set of recorded samples,
+    // returning the fitness
+    // protected so the calibration benchmark can replay samples
+    float fit_samples(const Vector3f *samples, uint16_t num_samples);
+
 private:
 
     // results
@@ -167,11 +179,22 @@ private:
     // true if enough samples have been collected and fitting has begun (aka runniong())
     bool _fitting() const;
 
+    // run the next sphere or ellipsoid fit step, returns false when
+    // there are no more steps for the current status
+    bool run_fit_step();
+
     // thins out samples between step one and step two
     void thin_samples();
 
-    // calc the fitness of a single sample vs a set of parameters (offsets, diagonals, off diagonals)
-    float calc_residual(const Vector3f& sample, const param_t& params) const;
+    // calc the residual of a single sample and its partial derivatives
+    // wrt the N parameters of the sphere or ellipsoid fit
+    template <uint8_t N>
+    float calc_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
+
+    // accumulate J^T.J and J^T.residual over all the samples for the
+    // sphere or ellipsoid fit
+    template <uint8_t N>
+    void calc_normal_equations(const param_t& params, float* JTJ, float* JTFI) const;
 
     // calc the fitness of the parameters (offsets, diagonals, off diagonals) vs all the samples collected
     // returns 1.0e30f if the sample buffer is empty
@@ -181,11 +204,9 @@ private:
     void calc_initial_offset();
 
     // run sphere fit to calculate diagonals and offdiagonals
-    void calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
     void run_sphere_fit();
 
     // run ellipsoid fit to calculate diagonals and offdiagonals
-    void calc_ellipsoid_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
     void run_ellipsoid_fit();
 
     // update the completion mask based on a single sample
@@ -209,6 +230,12 @@ private:
     // running method for use in thread
     bool _running() const;
 
+#if AP_COMPASS_CAL_THREAD_PER_COMPASS_ENABLED
+    // loop calling update(), run by start_thread()
+    void update_thread();
+    bool _thread_started;
+#endif
+
     uint8_t _compass_idx;                   // index of the compass providing data
     Status _status;                         // current state of calibrator
 
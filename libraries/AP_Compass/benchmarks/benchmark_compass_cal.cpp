@@ -0,0 +1,96 @@
+#include <AP_gbenchmark.h>
+
+#include <thread>
+#include <AP_Compass/CompassCalibrator.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if COMPASS_CAL_ENABLED
+
+class CompassCalibratorAccess : public CompassCalibrator {
+public:
+    float fit_samples_test(const Vector3f *samples, uint16_t num_samples) { return fit_samples(samples, num_samples); }
+};
+
+/*
+  a full sample buffer as recorded from a compass with offsets and
+  soft iron errors, rotated evenly over the sphere with some noise
+ */
+static void make_samples(Vector3f *samples, const Vector3f &offset, const Matrix3f &distortion)
+{
+    const float golden_angle = M_PI * (3 - sqrtf(5));
+    for (uint16_t i = 0; i < COMPASS_CAL_NUM_SAMPLES; i++) {
+        const float z = 1 - (2 * i + 1) / float(COMPASS_CAL_NUM_SAMPLES);
+        const float r = sqrtf(1 - sq(z));
+        const Vector3f field = Vector3f(r * cosf(golden_angle * i), r * sinf(golden_angle * i), z) * 400;
+        const Vector3f noise(((i * 7919) % 101) - 50, ((i * 6151) % 101) - 50, ((i * 3571) % 101) - 50);
+        samples[i] = distortion * field - offset + noise * 0.05;
+    }
+}
+
+static Vector3f samples[3][COMPASS_CAL_NUM_SAMPLES];
+
+// the calibrator expects to start from zeroed memory, as when allocated with new
+static CompassCalibratorAccess cal[3];
+
+static void setup_samples()
+{
+    make_samples(samples[0], Vector3f(120, -80, 45),
+                 Matrix3f(1.05, 0.02, -0.03, 0.02, 0.97, 0.01, -0.03, 0.01, 1.02));
+    make_samples(samples[1], Vector3f(-30, 210, -150),
+                 Matrix3f(0.92, -0.05, 0.04, -0.05, 1.08, 0.02, 0.04, 0.02, 0.99));
+    make_samples(samples[2], Vector3f(5, -15, 300),
+                 Matrix3f(1.10, 0.07, 0.00, 0.07, 0.95, -0.06, 0.00, -0.06, 0.96));
+}
+
+// the sphere and ellipsoid fits of one compass
+static void BM_CompassCalFit(benchmark::State& state)
+{
+    setup_samples();
+
+    while (state.KeepRunning()) {
+        float fitness = cal[0].fit_samples_test(samples[0], COMPASS_CAL_NUM_SAMPLES);
+        gbenchmark_escape(&fitness);
+    }
+}
+
+// three compasses fitted one after the other, as a single calibration thread would
+static void BM_CompassCalFitThreeSerial(benchmark::State& state)
+{
+    setup_samples();
+
+    while (state.KeepRunning()) {
+        for (uint8_t i = 0; i < 3; i++) {
+            float fitness = cal[i].fit_samples_test(samples[i], COMPASS_CAL_NUM_SAMPLES);
+            gbenchmark_escape(&fitness);
+        }
+    }
+}
+
+// three compasses fitted in a thread each
+static void BM_CompassCalFitThreeParallel(benchmark::State& state)
+{
+    setup_samples();
+
+    while (state.KeepRunning()) {
+        float fitness[3];
+        std::thread threads[3];
+        for (uint8_t i = 0; i < 3; i++) {
+            threads[i] = std::thread([&, i]() {
+                fitness[i] = cal[i].fit_samples_test(samples[i], COMPASS_CAL_NUM_SAMPLES);
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+        gbenchmark_escape(fitness);
+    }
+}
+
+BENCHMARK(BM_CompassCalFit);
+BENCHMARK(BM_CompassCalFitThreeSerial);
+BENCHMARK(BM_CompassCalFitThreeParallel)->UseRealTime();
+
+#endif  // COMPASS_CAL_ENABLED
+
+BENCHMARK_MAIN();
@@ -136,6 +136,14 @@ Vector3f AP_Declination::get_earth_field_ga(const Location &loc)
     float declination_deg=0, inclination_deg=0, intensity_gauss=0;
     get_mag_field_ef(loc.lat*1.0e-7f, loc.lng*1.0e-7f, intensity_gauss, declination_deg, inclination_deg);
 
+    return earth_field_ga(intensity_gauss, declination_deg, inclination_deg);
+}
+
+/*
+  get earth field as a Vector3f in Gauss from intensity and orientation
+*/
+Vector3f AP_Declination::earth_field_ga(float intensity_gauss, float declination_deg, float inclination_deg)
+{
     // create earth field
     Vector3f mag_ef = Vector3f(intensity_gauss, 0.0, 0.0);
     Matrix3f R;
@@ -144,3 +152,75 @@ Vector3f AP_Declination::get_earth_field_ga(const Location &loc)
     mag_ef = R * mag_ef;
     return mag_ef;
 }
+
+/*
+  load the bilinear interpolation coefficients for a table cell
+*/
+void AP_Declination::Interpolator::load_cell(uint32_t lat_index, uint32_t lon_index)
+{
+    const struct {
+        const float (*table)[LON_TABLE_SIZE];
+        float *c;
+    } fields[] {
+        { intensity_table, intensity.c },
+        { declination_table, declination.c },
+        { inclination_table, inclination.c },
+    };
+    for (const auto &f : fields) {
+        const float data_sw = f.table[lat_index][lon_index];
+        const float data_se = f.table[lat_index][lon_index + 1];
+        const float data_ne = f.table[lat_index + 1][lon_index + 1];
+        const float data_nw = f.table[lat_index + 1][lon_index];
+        f.c[0] = data_sw;
+        f.c[1] = data_se - data_sw;
+        f.c[2] = data_nw - data_sw;
+        f.c[3] = (data_ne - data_nw) - (data_se - data_sw);
+    }
+}
+
+/*
+  calculate magnetic field intensity and orientation, only going to
+  the tables when the position moves to a new cell
+*/
+bool AP_Declination::Interpolator::get_mag_field_ef(float latitude_deg, float longitude_deg, float &intensity_gauss, float &declination_deg, float &inclination_deg)
+{
+    if (!cell_valid ||
+        latitude_deg < cell_min_lat || latitude_deg >= cell_min_lat + SAMPLING_RES ||
+        longitude_deg < cell_min_lon || longitude_deg >= cell_min_lon + SAMPLING_RES) {
+        if (latitude_deg <= SAMPLING_MIN_LAT || latitude_deg >= SAMPLING_MAX_LAT ||
+            longitude_deg <= SAMPLING_MIN_LON || longitude_deg >= SAMPLING_MAX_LON) {
+            // outside the tables, this is rare enough not to cache
+            cell_valid = false;
+            return AP_Declination::get_mag_field_ef(latitude_deg, longitude_deg, intensity_gauss, declination_deg, inclination_deg);
+        }
+        const uint32_t lat_index = constrain_int32(int32_t(floorf((latitude_deg - SAMPLING_MIN_LAT) / SAMPLING_RES)), 0, LAT_TABLE_SIZE - 2);
+        const uint32_t lon_index = constrain_int32(int32_t(floorf((longitude_deg - SAMPLING_MIN_LON) / SAMPLING_RES)), 0, LON_TABLE_SIZE - 2);
+        cell_min_lat = SAMPLING_MIN_LAT + lat_index * SAMPLING_RES;
+        cell_min_lon = SAMPLING_MIN_LON + lon_index * SAMPLING_RES;
+        load_cell(lat_index, lon_index);
+        cell_valid = true;
+    }
+
+    // position within the cell
+    const float x = (longitude_deg - cell_min_lon) * (1.0f / SAMPLING_RES);
+    const float y = (latitude_deg - cell_min_lat) * (1.0f / SAMPLING_RES);
+
+    intensity_gauss = intensity.c[0] + x * (intensity.c[1] + y * intensity.c[3]) + y * intensity.c[2];
+    declination_deg = declination.c[0] + x * (declination.c[1] + y * declination.c[3]) + y * declination.c[2];
+    inclination_deg = inclination.c[0] + x * (inclination.c[1] + y * inclination.c[3]) + y * inclination.c[2];
+
+    return true;
+}
+
+/*
+  get earth field as a Vector3f in Gauss given a Location, also
+  returning the declination in degrees
+*/
+Vector3f AP_Declination::Interpolator::get_earth_field_ga(const Location &loc, float &declination_deg)
+{
+    float inclination_deg=0, intensity_gauss=0;
+    declination_deg = 0;
+    get_mag_field_ef(loc.lat*1.0e-7f, loc.lng*1.0e-7f, intensity_gauss, declination_deg, inclination_deg);
+
+    return earth_field_ga(intensity_gauss, declination_deg, inclination_deg);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "AP_Declination_config.h"
+
 #include <AP_Common/Location.h>
 
 /*
@@ -27,16 +29,50 @@ public:
       get declination in degrees for a given latitude_deg and longitude_deg
      */
     static float get_declination(float latitude_deg, float longitude_deg);
-    
+
+    /*
+      get earth field as a Vector3f in Gauss from the intensity,
+      declination and inclination
+     */
+    static Vector3f earth_field_ga(float intensity_gauss, float declination_deg, float inclination_deg);
+
+    /*
+      interpolate in the tables, remembering the table cell of the last
+      lookup. While the position stays in the same cell a lookup is a
+      few multiplies and adds. Each caller should have its own
+      Interpolator as it is not thread safe
+     */
+    class Interpolator {
+    public:
+        // same as AP_Declination::get_mag_field_ef()
+        bool get_mag_field_ef(float latitude_deg, float longitude_deg, float &intensity_gauss, float &declination_deg, float &inclination_deg);
+
+        // same as AP_Declination::get_earth_field_ga(), also returning declination
+        Vector3f get_earth_field_ga(const Location &loc, float &declination_deg);
+
+    private:
+        bool cell_valid = false;
+        float cell_min_lat;
+        float cell_min_lon;
+
+        // value = c[0] + c[1]*x + c[2]*y + c[3]*x*y where x and y are
+        // the position within the cell from 0 to 1
+        struct {
+            float c[4];
+        } intensity, declination, inclination;
+
+        void load_cell(uint32_t lat_index, uint32_t lon_index);
+    };
+
 private:
-    static const float SAMPLING_RES;
-    static const float SAMPLING_MIN_LAT;
-    static const float SAMPLING_MAX_LAT;
-    static const float SAMPLING_MIN_LON;
-    static const float SAMPLING_MAX_LON;
-
-    static const uint32_t LAT_TABLE_SIZE = 19;
-    static const uint32_t LON_TABLE_SIZE = 37;
+    static constexpr float SAMPLING_RES = AP_DECLINATION_SAMPLING_RES;
+    static constexpr float SAMPLING_MIN_LAT = -90;
+    static constexpr float SAMPLING_MAX_LAT = 90;
+    static constexpr float SAMPLING_MIN_LON = -180;
+    static constexpr float SAMPLING_MAX_LON = 180;
+
+    static const uint32_t LAT_TABLE_SIZE = 180 / AP_DECLINATION_SAMPLING_RES + 1;
+    static const uint32_t LON_TABLE_SIZE = 360 / AP_DECLINATION_SAMPLING_RES + 1;
 
     static const float declination_table[LAT_TABLE_SIZE][LON_TABLE_SIZE];
     static const float inclination_table[LAT_TABLE_SIZE][LON_TABLE_SIZE];
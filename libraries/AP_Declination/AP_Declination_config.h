@@ -0,0 +1,11 @@
+#pragma once
+
+#include <AP_HAL/AP_HAL_Boards.h>
+
+// resolution in degrees of the field tables. Tables for resolutions
+// other than 10 degrees must first be generated with
+// generate/generate.py --sampling-res, a 5 degree table uses about
+// four times the flash of the default
+#ifndef AP_DECLINATION_SAMPLING_RES
+#define AP_DECLINATION_SAMPLING_RES 10
+#endif
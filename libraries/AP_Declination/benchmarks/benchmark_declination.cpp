@@ -0,0 +1,99 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Declination/AP_Declination.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// a vehicle track of 64 positions moving slowly across a few cells
+#define BENCHMARK_NUM_POINTS 64
+
+static void make_track(float *lat, float *lon)
+{
+    for (uint16_t i = 0; i < BENCHMARK_NUM_POINTS; i++) {
+        lat[i] = -35.3 + i * 0.01;
+        lon[i] = 149.1 + i * 0.02;
+    }
+}
+
+static void BM_GetMagFieldEF(benchmark::State& state)
+{
+    float lat[BENCHMARK_NUM_POINTS], lon[BENCHMARK_NUM_POINTS];
+    make_track(lat, lon);
+
+    while (state.KeepRunning()) {
+        for (uint16_t i = 0; i < BENCHMARK_NUM_POINTS; i++) {
+            float intensity, declination, inclination;
+            AP_Declination::get_mag_field_ef(lat[i], lon[i], intensity, declination, inclination);
+            gbenchmark_escape(&intensity);
+            gbenchmark_escape(&declination);
+            gbenchmark_escape(&inclination);
+        }
+    }
+}
+
+static void BM_InterpolatorGetMagFieldEF(benchmark::State& state)
+{
+    float lat[BENCHMARK_NUM_POINTS], lon[BENCHMARK_NUM_POINTS];
+    make_track(lat, lon);
+    AP_Declination::Interpolator interp;
+
+    while (state.KeepRunning()) {
+        for (uint16_t i = 0; i < BENCHMARK_NUM_POINTS; i++) {
+            float intensity, declination, inclination;
+            interp.get_mag_field_ef(lat[i], lon[i], intensity, declination, inclination);
+            gbenchmark_escape(&intensity);
+            gbenchmark_escape(&declination);
+            gbenchmark_escape(&inclination);
+        }
+    }
+}
+
+// a new cell on every lookup, the worst case for the interpolator
+static void BM_InterpolatorCellChange(benchmark::State& state)
+{
+    AP_Declination::Interpolator interp;
+    float lon = 0;
+
+    while (state.KeepRunning()) {
+        float intensity, declination, inclination;
+        lon = lon > 170 ? -175 : lon + 10;
+        interp.get_mag_field_ef(-35.3, lon, intensity, declination, inclination);
+        gbenchmark_escape(&intensity);
+        gbenchmark_escape(&declination);
+        gbenchmark_escape(&inclination);
+    }
+}
+
+// the two lookups done by the EKF each time it updates the table field
+static void BM_EarthFieldAndDeclination(benchmark::State& state)
+{
+    const Location loc{-353000000, 1491000000, 0, Location::AltFrame::ABSOLUTE};
+
+    while (state.KeepRunning()) {
+        Vector3f field = AP_Declination::get_earth_field_ga(loc);
+        float declination = AP_Declination::get_declination(loc.lat*1.0e-7, loc.lng*1.0e-7);
+        gbenchmark_escape(&field);
+        gbenchmark_escape(&declination);
+    }
+}
+
+static void BM_InterpolatorEarthField(benchmark::State& state)
+{
+    const Location loc{-353000000, 1491000000, 0, Location::AltFrame::ABSOLUTE};
+    AP_Declination::Interpolator interp;
+
+    while (state.KeepRunning()) {
+        float declination;
+        Vector3f field = interp.get_earth_field_ga(loc, declination);
+        gbenchmark_escape(&field);
+        gbenchmark_escape(&declination);
+    }
+}
+
+BENCHMARK(BM_GetMagFieldEF);
+BENCHMARK(BM_InterpolatorGetMagFieldEF);
+BENCHMARK(BM_InterpolatorCellChange);
+BENCHMARK(BM_EarthFieldAndDeclination);
+BENCHMARK(BM_InterpolatorEarthField);
+
+BENCHMARK_MAIN();
@@ -14,10 +14,16 @@ import argparse
 parser = argparse.ArgumentParser(description='generate mag tables')
 parser.add_argument('--sampling-res', type=int, default=10, help='sampling resolution, degrees')
 parser.add_argument('--check-error', action='store_true', help='check max error')
-parser.add_argument('--filename', type=str, default='tables.cpp', help='tables file')
+parser.add_argument('--filename', type=str, default=None, help='tables file')
 
 args = parser.parse_args()
 
+if args.filename is None:
+    if args.sampling_res == 10:
+        args.filename = 'tables.cpp'
+    else:
+        args.filename = 'tables_%udeg.cpp' % args.sampling_res
+
 if not Path("AP_Declination.h").is_file():
     raise OSError("Please run this tool from the AP_Declination directory")
 
@@ -59,6 +65,8 @@ declination_table = np.empty((NUM_LAT, NUM_LON))
 max_error = 0
 max_error_pos = None
 max_error_field = None
+sum_sq_error = 0
+num_error = 0
 
 def get_igrf(lat, lon):
     '''return field as [declination_deg, inclination_deg, intensity_gauss]'''
@@ -123,12 +131,14 @@ def field_to_Vector3(mag):
 
 def test_error(lat, lon):
     '''check for error from lat,lon'''
-    global max_error, max_error_pos, max_error_field
+    global max_error, max_error_pos, max_error_field, sum_sq_error, num_error
     mag1 = get_igrf(lat, lon)
     mag2 = interpolate_field(lat, lon)
     ef1 = field_to_Vector3(mag1)
     ef2 = field_to_Vector3(mag2)
     err = (ef1 - ef2).length()
+    sum_sq_error += err**2
+    num_error += 1
     if err > max_error or err > 100:
         print(lat, lon, err, ef1, ef2)
         max_error = err
@@ -164,23 +174,17 @@ with open(args.filename, 'w') as f:
 
 ''')
 
-    f.write('''const float AP_Declination::SAMPLING_RES = %u;
-const float AP_Declination::SAMPLING_MIN_LAT = %u;
-const float AP_Declination::SAMPLING_MAX_LAT = %u;
-const float AP_Declination::SAMPLING_MIN_LON = %u;
-const float AP_Declination::SAMPLING_MAX_LON = %u;
-
-''' % (SAMPLING_RES,
-           SAMPLING_MIN_LAT,
-           SAMPLING_MAX_LAT,
-           SAMPLING_MIN_LON,
-           SAMPLING_MAX_LON))
+    f.write('''#if AP_DECLINATION_SAMPLING_RES == %u
 
+''' % SAMPLING_RES)
 
     write_table(f,'declination_table', declination_table)
     write_table(f,'inclination_table', inclination_table)
     write_table(f,'intensity_table', intensity_table)
 
+    f.write('''#endif // AP_DECLINATION_SAMPLING_RES == %u
+''' % SAMPLING_RES)
+
 if args.check_error:
     print("Checking for maximum error")
     for lat in range(-60,60,1):
@@ -188,5 +192,6 @@ if args.check_error:
             test_max_error(lat, lon)
     print("Generated with max error %.2f %s at (%.2f,%.2f)" % (
         max_error, max_error_field, max_error_pos[0], max_error_pos[1]))
+    print("RMS error %.2f mGauss over %u points" % (math.sqrt(sum_sq_error/num_error), num_error))
 
 print("Table generated in %s" % args.filename)
@@ -3,11 +3,7 @@
 
 #include "AP_Declination.h"
 
-const float AP_Declination::SAMPLING_RES = 10;
-const float AP_Declination::SAMPLING_MIN_LAT = -90;
-const float AP_Declination::SAMPLING_MAX_LAT = 90;
-const float AP_Declination::SAMPLING_MIN_LON = -180;
-const float AP_Declination::SAMPLING_MAX_LON = 180;
+#if AP_DECLINATION_SAMPLING_RES == 10
 
 const float AP_Declination::declination_table[LAT_TABLE_SIZE][LON_TABLE_SIZE] = {
     {148.83402f,138.83401f,128.83401f,118.83402f,108.83402f,98.83402f,88.83402f,78.83402f,68.83402f,58.83402f,48.83402f,38.83402f,28.83402f,18.83402f,8.83402f,-1.16598f,-11.16598f,-21.16598f,-31.16598f,-41.16598f,-51.16598f,-61.16598f,-71.16598f,-81.16598f,-91.16598f,-101.16598f,-111.16598f,-121.16598f,-131.16598f,-141.16598f,-151.16598f,-161.16598f,-171.16598f,178.83402f,168.83402f,158.83402f,148.83402f},
@@ -75,3 +71,4 @@ const float AP_Declination::intensity_table[LAT_TABLE_SIZE][LON_TABLE_SIZE] = {
     {0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f}
 };
 
+#endif // AP_DECLINATION_SAMPLING_RES == 10
@@ -123,6 +123,36 @@ TEST(MagField, test_field_error)
     }
 }
 
+/*
+  the cached interpolator should match the direct lookup, including
+  when moving between cells and outside the tables
+ */
+TEST(MagField, interpolator)
+{
+    AP_Declination::Interpolator interp;
+    for (float lat = -95; lat <= 95; lat += 0.7) {
+        for (float lon = -185; lon <= 185; lon += 0.9) {
+            float intensity1, declination1, inclination1;
+            float intensity2, declination2, inclination2;
+            const bool ok1 = AP_Declination::get_mag_field_ef(lat, lon, intensity1, declination1, inclination1);
+            const bool ok2 = interp.get_mag_field_ef(lat, lon, intensity2, declination2, inclination2);
+            EXPECT_EQ(ok1, ok2);
+            EXPECT_NEAR(intensity1, intensity2, 1.0e-5);
+            EXPECT_NEAR(declination1, declination2, 1.0e-3);
+            EXPECT_NEAR(inclination1, inclination2, 1.0e-3);
+        }
+    }
+
+    for (const auto &d : test_data) {
+        Location loc(d.lat*1.0e7, d.lon*1.0e7, 0, Location::AltFrame::ABSOLUTE);
+        float declination_deg;
+        const Vector3f m = interp.get_earth_field_ga(loc, declination_deg);
+        EXPECT_NEAR(declination_deg, AP_Declination::get_declination(loc.lat*1.0e-7f, loc.lng*1.0e-7f), 1.0e-3);
+        EXPECT_NEAR(m.x*1000, d.field.x, 0.5);
+        EXPECT_NEAR(m.y*1000, d.field.y, 0.5);
+        EXPECT_NEAR(m.z*1000, d.field.z, 0.5);
+    }
+}
 
 AP_GTEST_MAIN()
 int hal = 0;
@@ -169,8 +169,8 @@ const AP_Param::GroupInfo AP_GyroFFT::var_info[] = {
 
     // @Param: OPTIONS
     // @DisplayName: FFT options
-    // @Description: FFT configuration options. Values: 1:Apply the FFT *after* the filter bank,2:Check noise at the motor frequencies using ESC data as a reference
-    // @Bitmask: 0:Enable post-filter FFT,1:Check motor noise
+    // @Description: FFT configuration options. Values: 1:Apply the FFT *after* the filter bank,2:Check noise at the motor frequencies using ESC data as a reference,4:Analyse the gyros of all IMUs rather than only the primary gyro, which requires memory for an FFT engine per IMU
+    // @Bitmask: 0:Enable post-filter FFT,1:Check motor noise,2:Analyse all IMUs
     // @User: Advanced
     // @RebootRequired: True
     AP_GROUPINFO("OPTIONS", 15, AP_GyroFFT, _options, 0),
@@ -190,7 +190,6 @@ const extern AP_HAL::HAL& hal;
 
 AP_GyroFFT::AP_GyroFFT()
 {
-    _thread_state._noise_needs_calibration = 0x07; // all axes need calibration
     AP_Param::setup_object_defaults(this, var_info);
 
     if (_singleton != nullptr) {
@@ -232,9 +231,19 @@ void AP_GyroFFT::init(uint16_t loop_rate_hz)
         _num_frames.set(constrain_int16(_num_frames, 2, AP_HAL::DSP::MAX_SLIDING_WINDOW_SIZE));
     }
 
+    // analysing all IMUs needs the gyros to share a sample rate, so that they can share the FFT configuration
+    _analyse_all_imus = (_options & uint32_t(Options::AllIMUs)) != 0 && _ins->get_gyro_count() > 1;
+    for (uint8_t i = 1; i < _ins->get_gyro_count() && _analyse_all_imus && _sample_mode == 0; i++) {
+        if (_ins->get_raw_gyro_rate_hz(i) != _ins->get_raw_gyro_rate_hz(0)) {
+            gcs().send_text(MAV_SEVERITY_WARNING, "AP_GyroFFT: gyro rates differ, analysing primary only");
+            _analyse_all_imus = false;
+        }
+    }
+    const uint8_t num_engines = _analyse_all_imus ? _ins->get_gyro_count() : 1;
+
     // check that we have enough memory for the window size requested
-    // INS: XYZ_AXIS_COUNT * INS_MAX_INSTANCES * _window_size, DSP: 3 * _window_size, FFT: XYZ_AXIS_COUNT + 3 * _window_size
-    const uint32_t allocation_count = (XYZ_AXIS_COUNT * INS_MAX_INSTANCES + 3 + XYZ_AXIS_COUNT + 3 + _num_frames) * sizeof(float);
+    // INS: XYZ_AXIS_COUNT * INS_MAX_INSTANCES * _window_size, per IMU DSP: 3 * _window_size, FFT: XYZ_AXIS_COUNT + 3 * _window_size
+    const uint32_t allocation_count = (XYZ_AXIS_COUNT * INS_MAX_INSTANCES + (3 + XYZ_AXIS_COUNT + 3 + _num_frames) * num_engines) * sizeof(float);
     if (allocation_count * FFT_DEFAULT_WINDOW_SIZE > hal.util->available_memory() / 2) {
         gcs().send_text(MAV_SEVERITY_WARNING, "AP_GyroFFT: disabled, required %u bytes", (unsigned int)allocation_count * FFT_DEFAULT_WINDOW_SIZE);
         return;
@@ -245,24 +254,35 @@ void AP_GyroFFT::init(uint16_t loop_rate_hz)
     // save any changes that were made
     _window_size.save();
 
+    _engines = new IMUEngine[num_engines];
+    if (_engines == nullptr) {
+        gcs().send_text(MAV_SEVERITY_WARNING, "Failed to allocate AP_GyroFFT");
+        return;
+    }
+    _num_engines = num_engines;
+
     // determine the FFT sample rate based on the gyro rate, loop rate and configuration
     if (_sample_mode == 0) {
         _fft_sampling_rate_hz = _ins->get_raw_gyro_rate_hz();
     } else {
         _fft_sampling_rate_hz = loop_rate_hz / _sample_mode;
-        for (uint8_t axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            if (!_downsampled_gyro_data[axis].set_size(_window_size + _samples_per_frame)) {
-                gcs().send_text(MAV_SEVERITY_WARNING, "Failed to allocate window for AP_GyroFFT");
-                return;
+        for (uint8_t i = 0; i < _num_engines; i++) {
+            for (uint8_t axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                if (!_engines[i]._downsampled_gyro_data[axis].set_size(_window_size + _samples_per_frame)) {
+                    gcs().send_text(MAV_SEVERITY_WARNING, "Failed to allocate window for AP_GyroFFT");
+                    return;
+                }
             }
         }
     }
     _current_sample_mode = _sample_mode;
 
-    _ref_energy = new Vector3f[_window_size];
-    if (_ref_energy == nullptr) {
-        gcs().send_text(MAV_SEVERITY_WARNING, "Failed to allocate window for AP_GyroFFT");
-        return;
+    for (uint8_t i = 0; i < _num_engines; i++) {
+        _engines[i]._ref_energy = new Vector3f[_window_size];
+        if (_engines[i]._ref_energy == nullptr) {
+            gcs().send_text(MAV_SEVERITY_WARNING, "Failed to allocate window for AP_GyroFFT");
+            return;
+        }
     }
 
     // make the gyro window match the window size plus a buffer to cope with the backend
@@ -310,39 +330,49 @@ void AP_GyroFFT::init(uint16_t loop_rate_hz)
     }
 
     // initialise the HAL DSP subsystem
-    _state = hal.dsp->fft_init(_window_size, _fft_sampling_rate_hz, _num_frames);
-    if (_state == nullptr) {
-        gcs().send_text(MAV_SEVERITY_WARNING, "Failed to initialize DSP engine");
-        return;
+    for (uint8_t i = 0; i < _num_engines; i++) {
+        _engines[i]._state = hal.dsp->fft_init(_window_size, _fft_sampling_rate_hz, _num_frames);
+        if (_engines[i]._state == nullptr) {
+            gcs().send_text(MAV_SEVERITY_WARNING, "Failed to initialize DSP engine");
+            return;
+        }
     }
 
     // per-axis frame time
     _frame_time_ms = _samples_per_frame * 1000 / _fft_sampling_rate_hz;
     // The update rate for the output, defaults are 1Khz / (1 - 0.5) * 32 == 62hz
     const float output_rate = static_cast<float>(_fft_sampling_rate_hz) / static_cast<float>(_samples_per_frame);
-    // establish suitable defaults for the detected values
-    for (uint8_t axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        _thread_state._center_freq_hz[axis] = _fft_min_hz;
+    // filter more aggressively post-filter since the noise is harder to detect
+    const float scale_factor = using_post_filter_samples() ? 0.1f : 1.0f;
+
+    for (uint8_t i = 0; i < _num_engines; i++) {
+        IMUEngine& engine = _engines[i];
+        engine._thread_state._noise_needs_calibration = 0x07; // all axes need calibration
+        // establish suitable defaults for the detected values
+        for (uint8_t axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            engine._thread_state._center_freq_hz[axis] = _fft_min_hz;
 
+            for (uint8_t peak = 0; peak < FrequencyPeak::MAX_TRACKED_PEAKS; peak++) {
+                engine._thread_state._center_freq_hz_filtered[peak][axis] = _fft_min_hz;
+            }
+            // number of cycles to average over, two complete windows to be sure
+            engine._noise_calibration_cycles[axis] = (_window_size / _samples_per_frame) * 2;
+            // harmonic frequency fit should change relatively slowly
+            engine._harmonic_fit_filter[axis].set_cutoff_frequency(output_rate, MIN(output_rate * 0.48f, FFT_HARMONIC_FIT_FILTER_HZ));
+        }
+
+        // configure a filter for frequency, bandwidth and energy for each of the three tracked noise peaks
         for (uint8_t peak = 0; peak < FrequencyPeak::MAX_TRACKED_PEAKS; peak++) {
-            _thread_state._center_freq_hz_filtered[axis][peak] = _fft_min_hz;
+            // calculate low-pass filter characteristics based on window size and overlap
+            engine._center_freq_filter[peak].set_cutoff_frequency(output_rate, output_rate * 0.48f * scale_factor);
+            // the bin energy jumps around a lot so requires more filtering
+            engine._center_freq_energy_filter[peak].set_cutoff_frequency(output_rate, output_rate * 0.25f * scale_factor);
+            // smooth the bandwidth output more aggressively
+            engine._center_bandwidth_filter[peak].set_cutoff_frequency(output_rate, output_rate * 0.25f * scale_factor);
         }
-        // number of cycles to average over, two complete windows to be sure
-        _noise_calibration_cycles[axis] = (_window_size / _samples_per_frame) * 2;
-        // harmonic frequency fit should change relatively slowly
-        _harmonic_fit_filter[axis].set_cutoff_frequency(output_rate, MIN(output_rate * 0.48f, FFT_HARMONIC_FIT_FILTER_HZ));
-    }
 
-    // configure a filter for frequency, bandwidth and energy for each of the three tracked noise peaks
-    // filter more aggressively post-filter since the noise is harder to detect
-    const float scale_factor = using_post_filter_samples() ? 0.1f : 1.0f;
-    for (uint8_t peak = 0; peak < FrequencyPeak::MAX_TRACKED_PEAKS; peak++) {
-        // calculate low-pass filter characteristics based on window size and overlap
-        _center_freq_filter[peak].set_cutoff_frequency(output_rate, output_rate * 0.48f * scale_factor);
-        // the bin energy jumps around a lot so requires more filtering
-        _center_freq_energy_filter[peak].set_cutoff_frequency(output_rate, output_rate * 0.25f * scale_factor);
-        // smooth the bandwidth output more aggressively
-        _center_bandwidth_filter[peak].set_cutoff_frequency(output_rate, output_rate * 0.25f * scale_factor);
+        // the number of cycles required to have a proper noise reference
+        engine._noise_cycles = (_window_size / _samples_per_frame) * XYZ_AXIS_COUNT;
     }
 
     // turn down the SNR threshold if examining post-filter
@@ -350,9 +380,6 @@ void AP_GyroFFT::init(uint16_t loop_rate_hz)
         _snr_threshold_db.set_default(FFT_SNR_PFILT_DEFAULT);
     }
 
-    // the number of cycles required to have a proper noise reference
-    _noise_cycles = (_window_size / _samples_per_frame) * XYZ_AXIS_COUNT;
-
     // finally we are done
     _initialized = true;
     update_parameters(true);
@@ -373,18 +400,23 @@ void AP_GyroFFT::sample_gyros()
     // update counters for gyro window
     if (_current_sample_mode > 0) {
         // for loop rate sampling accumulate and average gyro samples
-        _oversampled_gyro_accum += _ins->get_gyro_for_fft();
+        for (uint8_t i = 0; i < _num_engines; i++) {
+            _engines[i]._oversampled_gyro_accum += _analyse_all_imus ? _ins->get_gyro_for_fft(i) : _ins->get_gyro_for_fft();
+        }
         _oversampled_gyro_count++;
 
         if ((_oversampled_gyro_count % _current_sample_mode) == 0) {
-            // calculate mean value of accumulated samples
-            Vector3f sample = _oversampled_gyro_accum / _current_sample_mode;
-            // fast sampling means that the raw gyro values have already been averaged over 8 samples
-            _downsampled_gyro_data[0].push(sample.x);
-            _downsampled_gyro_data[1].push(sample.y);
-            _downsampled_gyro_data[2].push(sample.z);
-
-            _oversampled_gyro_accum.zero();
+            for (uint8_t i = 0; i < _num_engines; i++) {
+                IMUEngine& engine = _engines[i];
+                // calculate mean value of accumulated samples
+                Vector3f sample = engine._oversampled_gyro_accum / _current_sample_mode;
+                // fast sampling means that the raw gyro values have already been averaged over 8 samples
+                engine._downsampled_gyro_data[0].push(sample.x);
+                engine._downsampled_gyro_data[1].push(sample.y);
+                engine._downsampled_gyro_data[2].push(sample.z);
+
+                engine._oversampled_gyro_accum.zero();
+            }
             _oversampled_gyro_count = 0;
         }
     }
@@ -401,7 +433,6 @@ void AP_GyroFFT::update()
     WITH_SEMAPHORE(_sem);
 
     _config._analysis_enabled = _analysis_enabled;
-    _global_state = _thread_state;
 
     // calculate health based on being 5 frames behind, SITL needs longer
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
@@ -410,19 +441,25 @@ void AP_GyroFFT::update()
     const uint32_t output_delay = _frame_time_ms * FFT_MAX_MISSED_UPDATES;
 #endif
     uint32_t now = AP_HAL::millis();
-    _rpy_health.x = (now - _global_state._health_ms.x <= output_delay);
-    _rpy_health.y = (now - _global_state._health_ms.y <= output_delay);
-    _rpy_health.z = (now - _global_state._health_ms.z <= output_delay);
 
-    _health = _global_state._health;
-    if (!_rpy_health.x) {
-        _health.x = 0;
-    }
-    if (!_rpy_health.y) {
-        _health.y = 0;
-    }
-    if (!_rpy_health.z) {
-        _health.z = 0;
+    for (uint8_t i = 0; i < _num_engines; i++) {
+        IMUEngine& engine = _engines[i];
+        engine._global_state = engine._thread_state;
+
+        engine._rpy_health.x = (now - engine._global_state._health_ms.x <= output_delay);
+        engine._rpy_health.y = (now - engine._global_state._health_ms.y <= output_delay);
+        engine._rpy_health.z = (now - engine._global_state._health_ms.z <= output_delay);
+
+        engine._health = engine._global_state._health;
+        if (!engine._rpy_health.x) {
+            engine._health.x = 0;
+        }
+        if (!engine._rpy_health.y) {
+            engine._health.y = 0;
+        }
+        if (!engine._rpy_health.z) {
+            engine._health.z = 0;
+        }
     }
 }
 
@@ -451,56 +488,62 @@ uint16_t AP_GyroFFT::run_cycle()
     _sem.give();
 
     uint32_t now = AP_HAL::micros();
+    IMUEngine& engine = tl_engine();
+    AP_HAL::DSP::FFTWindowState* state = engine._state;
 
     // get the appropriate gyro buffer
-    FloatBuffer& gyro_buffer = (_sample_mode == 0 ?_ins->get_raw_gyro_window(_update_axis) : _downsampled_gyro_data[_update_axis]);
+    FloatBuffer& gyro_buffer = get_gyro_window(_update_axis);
     // if we have many more samples than the window size then we are struggling to 
     // stay ahead of the gyro loop so drop samples so that this cycle will use all available samples
-    if (gyro_buffer.available() > uint32_t(_state->_window_size + uint16_t(_samples_per_frame >> 1))) { // half the frame size is a heuristic
-        gyro_buffer.advance(gyro_buffer.available() - _state->_window_size);
+    if (gyro_buffer.available() > uint32_t(state->_window_size + uint16_t(_samples_per_frame >> 1))) { // half the frame size is a heuristic
+        gyro_buffer.advance(gyro_buffer.available() - state->_window_size);
     }
     // let's go!
-    hal.dsp->fft_start(_state, gyro_buffer, _samples_per_frame);
+    hal.dsp->fft_start(state, gyro_buffer, _samples_per_frame);
 
     // calculate FFT and update filters outside the semaphore
-    uint16_t bin_max = hal.dsp->fft_analyse(_state, config._fft_start_bin, config._fft_end_bin, config._attenuation_cutoff);
+    uint16_t bin_max = hal.dsp->fft_analyse(state, config._fft_start_bin, config._fft_end_bin, config._attenuation_cutoff);
 
     // something has been detected, update the peak frequency and associated metrics
     update_ref_energy(bin_max);
     calculate_noise(false, config);
 
     // record how we are doing
-    _thread_state._last_output_us[_update_axis] = AP_HAL::micros();
-    _output_cycle_micros = _thread_state._last_output_us[_update_axis] - now;
+    engine._thread_state._last_output_us[_update_axis] = AP_HAL::micros();
+    _output_cycle_micros = engine._thread_state._last_output_us[_update_axis] - now;
 
 #if AP_SIM_ENABLED && HAL_LOGGING_ENABLED
     // extra logging when running simulations
     AP::logger().WriteStreaming(
         "FTN3",
-        "TimeUS,Id,Pk1,Pk2,Pk3,Bw1,Bw2,Bw3,En1,En2,En3",
-        "s#zzzzzz---",
-        "F----------",
-        "QBfffffffff",
+        "TimeUS,I,Id,Pk1,Pk2,Pk3,Bw1,Bw2,Bw3,En1,En2,En3",
+        "s##zzzzzz---",
+        "F-----------",
+        "QBBfffffffff",
         AP_HAL::micros64(),
+        _update_imu,
         _update_axis,
-        _state->_peak_data[0]._freq_hz,
-        _state->_peak_data[1]._freq_hz,
-        _state->_peak_data[2]._freq_hz,
-        _state->_peak_data[0]._noise_width_hz,
-        _state->_peak_data[1]._noise_width_hz,
-        _state->_peak_data[2]._noise_width_hz,
-        _state->_freq_bins[_state->_peak_data[0]._bin],
-        _state->_freq_bins[_state->_peak_data[1]._bin],
-        _state->_freq_bins[_state->_peak_data[2]._bin]);
+        state->_peak_data[0]._freq_hz,
+        state->_peak_data[1]._freq_hz,
+        state->_peak_data[2]._freq_hz,
+        state->_peak_data[0]._noise_width_hz,
+        state->_peak_data[1]._noise_width_hz,
+        state->_peak_data[2]._noise_width_hz,
+        state->_freq_bins[state->_peak_data[0]._bin],
+        state->_freq_bins[state->_peak_data[1]._bin],
+        state->_freq_bins[state->_peak_data[2]._bin]);
 #endif
 
-    // move onto the next axis
-    _update_axis = (_update_axis + 1) % XYZ_AXIS_COUNT;
-
     // ready to receive another frame, because lock contention is so expensive we don't lock
     // around this flag but rather rely on the semaphore at the beginning of the loop to
     // ensure eventual visibility to the main loop
-    _thread_state._analysis_started = false;
+    engine._thread_state._analysis_started = false;
+
+    // move onto the next axis, and onto the next IMU after the last axis
+    _update_axis = (_update_axis + 1) % XYZ_AXIS_COUNT;
+    if (_update_axis == 0) {
+        _update_imu = (_update_imu + 1) % _num_engines;
+    }
 
     // samples remaining in the next axis
     return get_available_samples(_update_axis);
@@ -509,16 +552,23 @@ uint16_t AP_GyroFFT::run_cycle()
 // whether analysis can be run again or not
 // called from FFT thread with the semaphore held
 bool AP_GyroFFT::start_analysis() {
-    if (_thread_state._analysis_started) {
+    if (tl_engine()._thread_state._analysis_started) {
         return false;
     }
-    // don't run any more gyro cycles once noise is calibrated and the self-test is running
-    if (!_thread_state._noise_needs_calibration && !_calibrated) {
-        return false;
+    // don't run any more gyro cycles on an IMU once noise is calibrated and the self-test is running,
+    // but move on to any other IMU that is still calibrating
+    if (!_calibrated) {
+        for (uint8_t i = 0; i < _num_engines && !tl_engine()._thread_state._noise_needs_calibration; i++) {
+            _update_imu = (_update_imu + 1) % _num_engines;
+            _update_axis = 0;
+        }
+        if (!tl_engine()._thread_state._noise_needs_calibration) {
+            return false;
+        }
     }
 
-    if (get_available_samples(_update_axis) >= _state->_window_size) {
-        _thread_state._analysis_started = true;
+    if (get_available_samples(_update_axis) >= tl_engine()._state->_window_size) {
+        tl_engine()._thread_state._analysis_started = true;
         return true;
     }
     return false;
@@ -539,10 +589,11 @@ void AP_GyroFFT::update_parameters(bool force)
     _config._snr_threshold_db = _snr_threshold_db;
     _config._fft_min_hz = _fft_min_hz;
     _config._fft_max_hz = _fft_max_hz;
-    // determine the start FFT bin for all frequency detection
-    _config._fft_start_bin = MAX(floorf(_fft_min_hz.get() / _state->_bin_resolution), 1);
+    // determine the start FFT bin for all frequency detection, all IMUs share the FFT configuration
+    const AP_HAL::DSP::FFTWindowState* state = _engines[0]._state;
+    _config._fft_start_bin = MAX(floorf(_fft_min_hz.get() / state->_bin_resolution), 1);
     // determine the endt FFT bin for all frequency detection
-    _config._fft_end_bin = MIN(ceilf(_fft_max_hz.get() / _state->_bin_resolution), _state->_bin_count);
+    _config._fft_end_bin = MIN(ceilf(_fft_max_hz.get() / state->_bin_resolution), state->_bin_count);
     // actual attenuation from the db value
     _config._attenuation_cutoff = powf(10.0f, -_attenuation_power_db * 0.1f);
 }
@@ -551,11 +602,17 @@ void AP_GyroFFT::update_parameters(bool force)
 void AP_GyroFFT::update_thread(void)
 {
     while (true) {
+        const uint16_t window_size = _engines[0]._state->_window_size;
+        // analyse every frame that is ready in one pass, at most one per axis of each IMU, so
+        // that when analysing several IMUs the thread does not sleep between frames that are already due
         uint16_t remaining_samples = run_cycle();
+        for (uint8_t i = 1; i < XYZ_AXIS_COUNT * _num_engines && remaining_samples >= window_size; i++) {
+            remaining_samples = run_cycle();
+        }
         // this is to stop us burning CPU while waiting for samples, the reduction by _samples_per_frame is a heuristic to prevent waiting too long
         // and missing frames (easy to see in SITL because the noise will keep calibrating)
         // we always delay by at least 1us to give logging a chance to run at the same priority
-        uint32_t delay = constrain_int32((int16_t)_state->_window_size - (int16_t)remaining_samples, 0, _samples_per_frame)
+        uint32_t delay = constrain_int32((int16_t)window_size - (int16_t)remaining_samples, 0, _samples_per_frame)
             * 1e6 / _fft_sampling_rate_hz;
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
         // in SITL the gyros do not run in a different thread
@@ -599,18 +656,22 @@ bool AP_GyroFFT::pre_arm_check(char *failure_msg, const uint8_t failure_msg_len)
         return true;
     }
 
-    // analysis is started in the main thread, don't trample on in-flight analysis
-    if (_global_state._analysis_started) {
-        hal.util->snprintf(failure_msg, failure_msg_len, "FFT still analyzing");
-        return false;
-    }
+    for (uint8_t i = 0; i < _num_engines; i++) {
+        // analysis is started in the main thread, don't trample on in-flight analysis
+        if (_engines[i]._global_state._analysis_started) {
+            hal.util->snprintf(failure_msg, failure_msg_len, "FFT still analyzing");
+            return false;
+        }
 
-    // still calibrating noise so not ready
-    if (_global_state._noise_needs_calibration) {
-        hal.util->snprintf(failure_msg, failure_msg_len, "FFT calibrating noise");
-        return false;
+        // still calibrating noise so not ready
+        if (_engines[i]._global_state._noise_needs_calibration) {
+            hal.util->snprintf(failure_msg, failure_msg_len, "FFT calibrating noise");
+            return false;
+        }
     }
 
+    const AP_HAL::DSP::FFTWindowState* state = _engines[0]._state;
+
     // make sure the frequency maximum is below Nyquist
     if (_fft_max_hz > _fft_sampling_rate_hz * 0.5f) {
         hal.util->snprintf(failure_msg, failure_msg_len, "FFT config MAXHZ %dHz > %dHz", _fft_max_hz.get(), _fft_sampling_rate_hz / 2);
@@ -618,8 +679,8 @@ bool AP_GyroFFT::pre_arm_check(char *failure_msg, const uint8_t failure_msg_len)
     }
 
     // check for sane frequency resolution - for 1k backends with length 32 this will be 32Hz
-    if (_state->_bin_resolution > 50.0f) {
-        gcs().send_text(MAV_SEVERITY_WARNING, "FFT: resolution is %.1fHz, increase length", _state->_bin_resolution);
+    if (state->_bin_resolution > 50.0f) {
+        gcs().send_text(MAV_SEVERITY_WARNING, "FFT: resolution is %.1fHz, increase length", state->_bin_resolution);
         return true; // a low resolution is not fatal
     }
 #if 0 // these calculations do not result in a long enough expected delay
@@ -635,16 +696,16 @@ bool AP_GyroFFT::pre_arm_check(char *failure_msg, const uint8_t failure_msg_len)
 
     float max_divergence = self_test_bin_frequencies();
     // for longer FFT lengths the resolution gets below 1Hz
-    if (max_divergence > MAX(_state->_bin_resolution * 0.5f, 1)) {
+    if (max_divergence > MAX(state->_bin_resolution * 0.5f, 1)) {
         hal.util->snprintf(failure_msg, failure_msg_len, "FFT self-test failed, max error %fHz", max_divergence);
     }
 
-    _calibrated =  max_divergence <= MAX(_state->_bin_resolution * 0.5f, 1);
+    _calibrated =  max_divergence <= MAX(state->_bin_resolution * 0.5f, 1);
 
     if (_calibrated) {
         // provide the user with some useful information about what they have configured
         gcs().send_text(MAV_SEVERITY_INFO, "FFT: calibrated %.1fKHz/%.1fHz/%.1fHz", _fft_sampling_rate_hz * 0.001f,
-             _state->_bin_resolution * 0.5, 1000.0f * XYZ_AXIS_COUNT / _frame_time_ms);
+             state->_bin_resolution * 0.5, 1000.0f * XYZ_AXIS_COUNT / _frame_time_ms);
     }
 
     return _calibrated;
@@ -698,7 +759,8 @@ void AP_GyroFFT::start_notch_tune()
         return;
     }
 
-    if (!hal.dsp->fft_start_average(_state)) {
+    // the throttle notch is configured from the primary gyro
+    if (!hal.dsp->fft_start_average(primary_engine()._state)) {
         gcs().send_text(MAV_SEVERITY_WARNING, "FFT: Unable to start FFT averaging");
     }
     // throttle averaging for average fft calculation
@@ -745,7 +807,7 @@ void AP_GyroFFT::stop_notch_tune()
 
     float freqs[FrequencyPeak::MAX_TRACKED_PEAKS] {};
 
-    uint16_t numpeaks = hal.dsp->fft_stop_average(_state, _config._fft_start_bin, _config._fft_end_bin, freqs);
+    uint16_t numpeaks = hal.dsp->fft_stop_average(primary_engine()._state, _config._fft_start_bin, _config._fft_end_bin, freqs);
 
     if (numpeaks == 0) {
         return;
@@ -779,19 +841,20 @@ void AP_GyroFFT::stop_notch_tune()
 
 // return the noise peak that is being tracked
 // called from main thread
-AP_GyroFFT::FrequencyPeak AP_GyroFFT::get_tracked_noise_peak() const
+AP_GyroFFT::FrequencyPeak AP_GyroFFT::get_tracked_noise_peak(const IMUEngine& engine) const
 {
+    const EngineState& global_state = engine._global_state;
     // if the user has specified a specific axis to track then use that
     if (_harmonic_peak > FrequencyPeak::MAX_TRACKED_PEAKS) {
         switch (_harmonic_peak) {
         case FFT_HARMONIC_FIT_TRACK_ROLL:
-            if (_global_state._harmonic_fit.x < _harmonic_fit) {
-                return FrequencyPeak(_global_state._tracked_peak.x);
+            if (global_state._harmonic_fit.x < _harmonic_fit) {
+                return FrequencyPeak(global_state._tracked_peak.x);
             }
             break;
         case FFT_HARMONIC_FIT_TRACK_PITCH:
-            if (_global_state._harmonic_fit.y < _harmonic_fit) {
-                return FrequencyPeak(_global_state._tracked_peak.y);
+            if (global_state._harmonic_fit.y < _harmonic_fit) {
+                return FrequencyPeak(global_state._tracked_peak.y);
             }
             break;
         default:
@@ -806,18 +869,18 @@ AP_GyroFFT::FrequencyPeak AP_GyroFFT::get_tracked_noise_peak() const
 
     // required fit of 10% is fairly conservative when testing in SITL, testing shows that it's safer to
     // require both tracked axes to fit - biasing towards the highest energy peak
-    if (_global_state._harmonic_fit.x < _harmonic_fit && _global_state._harmonic_fit.y < _harmonic_fit) {
-        return FrequencyPeak(_global_state._tracked_peak.x);
+    if (global_state._harmonic_fit.x < _harmonic_fit && global_state._harmonic_fit.y < _harmonic_fit) {
+        return FrequencyPeak(global_state._tracked_peak.x);
     }
 
     return FrequencyPeak::CENTER;
 }
 
 // weighted center frequency
-float AP_GyroFFT::get_weighted_freq_hz(FrequencyPeak peak) const
+float AP_GyroFFT::get_weighted_freq_hz(const IMUEngine& engine, FrequencyPeak peak) const
 {
-    const Vector3f& energy = get_center_freq_energy(peak);
-    const Vector3f& freq = get_noise_center_freq_hz(peak);
+    const Vector3f& energy = get_center_freq_energy(engine, peak);
+    const Vector3f& freq = get_noise_center_freq_hz(engine, peak);
 
     if (!energy.is_nan() && !is_zero(energy.x) && !is_zero(energy.y)) {
         return (freq.x * energy.x + freq.y * energy.y) / (energy.x + energy.y);
@@ -828,13 +891,20 @@ float AP_GyroFFT::get_weighted_freq_hz(FrequencyPeak peak) const
 
 // return an average center frequency weighted by bin energy
 // called from main thread
-float AP_GyroFFT::get_weighted_noise_center_freq_hz() const
+float AP_GyroFFT::get_weighted_noise_center_freq_hz(uint8_t instance) const
 {
     if (!analysis_enabled()) {
         return _fft_min_hz;
     }
 
-    if (_health.is_zero()) {
+    return get_weighted_noise_center_freq_hz(_engines[engine_index(instance)]);
+}
+
+float AP_GyroFFT::get_weighted_noise_center_freq_hz(const IMUEngine& engine) const
+{
+    const Vector3<uint8_t>& health = engine._health;
+
+    if (health.is_zero()) {
 #if APM_BUILD_COPTER_OR_HELI || APM_BUILD_TYPE(APM_BUILD_ArduPlane)
         // if we are post-filter sampling then throttle estimate will be useless
         if (using_post_filter_samples()) {
@@ -848,29 +918,36 @@ float AP_GyroFFT::get_weighted_noise_center_freq_hz() const
 #endif
     }
 
-    const FrequencyPeak peak = get_tracked_noise_peak();
+    const FrequencyPeak peak = get_tracked_noise_peak(engine);
     // pitch was good or required, roll was not, use pitch only
-    if (!_health.x || _harmonic_peak == FFT_HARMONIC_FIT_TRACK_PITCH) {
-        return get_noise_center_freq_hz(peak).y;    // Y-axis
+    if (!health.x || _harmonic_peak == FFT_HARMONIC_FIT_TRACK_PITCH) {
+        return get_noise_center_freq_hz(engine, peak).y;    // Y-axis
     }
     // roll was good or required, pitch was not, use roll only
-    if (!_health.y || _harmonic_peak == FFT_HARMONIC_FIT_TRACK_ROLL) {
-        return get_noise_center_freq_hz(peak).x;    // X-axis
+    if (!health.y || _harmonic_peak == FFT_HARMONIC_FIT_TRACK_ROLL) {
+        return get_noise_center_freq_hz(engine, peak).x;    // X-axis
     }
 
-    return get_weighted_freq_hz(peak);
+    return get_weighted_freq_hz(engine, peak);
 }
 
 // return all the center frequencies weighted by bin energy
 // called from main thread
-uint8_t AP_GyroFFT::get_weighted_noise_center_frequencies_hz(uint8_t num_freqs, float* freqs) const
+uint8_t AP_GyroFFT::get_weighted_noise_center_frequencies_hz(uint8_t instance, uint8_t num_freqs, float* freqs) const
 {
     if (!analysis_enabled()) {
         freqs[0] = _fft_min_hz;
         return 1;
     }
 
-    if (_health.is_zero()) {
+    return get_weighted_noise_center_frequencies_hz(_engines[engine_index(instance)], num_freqs, freqs);
+}
+
+uint8_t AP_GyroFFT::get_weighted_noise_center_frequencies_hz(const IMUEngine& engine, uint8_t num_freqs, float* freqs) const
+{
+    const Vector3<uint8_t>& health = engine._health;
+
+    if (health.is_zero()) {
 #if APM_BUILD_COPTER_OR_HELI || APM_BUILD_TYPE(APM_BUILD_ArduPlane)
         // if we are post-filter sampling then throttle estimate will be useless
         if (using_post_filter_samples()) {
@@ -886,25 +963,25 @@ uint8_t AP_GyroFFT::get_weighted_noise_center_frequencies_hz(uint8_t num_freqs,
     }
 
     // pitch was good or required, roll was not, use pitch only
-    if (!_health.x || _harmonic_peak == FFT_HARMONIC_FIT_TRACK_PITCH) {
-        const uint8_t tracked_peaks = MIN(_health.y, num_freqs);
+    if (!health.x || _harmonic_peak == FFT_HARMONIC_FIT_TRACK_PITCH) {
+        const uint8_t tracked_peaks = MIN(health.y, num_freqs);
         for (uint8_t i = 0; i < tracked_peaks; i++) {
-            freqs[i] = get_noise_center_freq_hz(FrequencyPeak(i)).y;    // Y-axis
+            freqs[i] = get_noise_center_freq_hz(engine, FrequencyPeak(i)).y;    // Y-axis
         }
         return tracked_peaks;
     }
     // roll was good or required, pitch was not, use roll only
-    if (!_health.y || _harmonic_peak == FFT_HARMONIC_FIT_TRACK_ROLL) {
-        const uint8_t tracked_peaks = MIN(_health.x, num_freqs);
+    if (!health.y || _harmonic_peak == FFT_HARMONIC_FIT_TRACK_ROLL) {
+        const uint8_t tracked_peaks = MIN(health.x, num_freqs);
         for (uint8_t i = 0; i < tracked_peaks; i++) {
-            freqs[i] = get_noise_center_freq_hz(FrequencyPeak(i)).x;    // X-axis
+            freqs[i] = get_noise_center_freq_hz(engine, FrequencyPeak(i)).x;    // X-axis
         }
         return tracked_peaks;
     }
 
-    const uint8_t tracked_peaks = MIN(MAX(_health.x, _health.y), num_freqs);
+    const uint8_t tracked_peaks = MIN(MAX(health.x, health.y), num_freqs);
     for (uint8_t i = 0; i < tracked_peaks; i++) {
-        freqs[i] = get_weighted_freq_hz(FrequencyPeak(i));
+        freqs[i] = get_weighted_freq_hz(engine, FrequencyPeak(i));
     }
     return tracked_peaks;
 }
@@ -918,19 +995,24 @@ float AP_GyroFFT::has_noise_at_frequency_hz(float freq) const
 
     float max_energy = 0.0f;
 
-    // check each axis of each peak to see if it contains the pass frequency
-    for (uint8_t i = 0; i < _tracked_peaks; i++) {
-        const Vector3f& noise = get_noise_center_freq_hz(FrequencyPeak(i));
-        const Vector3f& snr = get_noise_signal_to_noise_db(FrequencyPeak(i));
+    // check each axis of each peak of each IMU to see if it contains the pass frequency
+    for (uint8_t e = 0; e < _num_engines; e++) {
+        const IMUEngine& engine = _engines[e];
+        const float bin_resolution = engine._state->_bin_resolution;
 
-        for (uint8_t j = 0; j < XYZ_AXIS_COUNT; j++) {
-            if (!_rpy_health[j]) {
-                continue;
-            }
+        for (uint8_t i = 0; i < _tracked_peaks; i++) {
+            const Vector3f& noise = get_noise_center_freq_hz(engine, FrequencyPeak(i));
+            const Vector3f& snr = get_noise_signal_to_noise_db(engine, FrequencyPeak(i));
 
-            // only check one bin either side of the frequency
-            if ((noise[j] - _state->_bin_resolution) < freq && (noise[j] + _state->_bin_resolution) > freq) {
-                max_energy = MAX(snr[j], max_energy);
+            for (uint8_t j = 0; j < XYZ_AXIS_COUNT; j++) {
+                if (!engine._rpy_health[j]) {
+                    continue;
+                }
+
+                // only check one bin either side of the frequency
+                if ((noise[j] - bin_resolution) < freq && (noise[j] + bin_resolution) > freq) {
+                    max_energy = MAX(snr[j], max_energy);
+                }
             }
         }
     }
@@ -975,6 +1057,7 @@ void AP_GyroFFT::write_log_messages()
         return;
     }
 
+    const Vector3<uint8_t>& health = primary_engine()._health;
     AP::logger().WriteStreaming(
         "FTN1",
         "TimeUS,PkAvg,BwAvg,SnX,SnY,SnZ,FtX,FtY,FtZ,FHX,FHY,FHZ,Tc",
@@ -990,7 +1073,7 @@ void AP_GyroFFT::write_log_messages()
         get_raw_noise_harmonic_fit().x,
         get_raw_noise_harmonic_fit().y,
         get_raw_noise_harmonic_fit().z,
-        _health.x, _health.y, _health.z, _output_cycle_micros);
+        health.x, health.y, health.z, _output_cycle_micros);
 
     log_noise_peak(0, FrequencyPeak::CENTER);
     if (_tracked_peaks> 1) {
@@ -998,6 +1081,12 @@ void AP_GyroFFT::write_log_messages()
         log_noise_peak(2, FrequencyPeak::UPPER_SHOULDER);
     }
 
+    if (_analyse_all_imus) {
+        for (uint8_t i = 0; i < _num_engines; i++) {
+            log_imu_noise(i);
+        }
+    }
+
 #if DEBUG_FFT
     const uint32_t now = AP_HAL::millis();
     // output at 1hz
@@ -1007,7 +1096,7 @@ void AP_GyroFFT::write_log_messages()
         gcs().send_text(MAV_SEVERITY_WARNING, "FFT: f:%.1f, fr:%.1f, b:%u, fd:%.1f",
                         _debug_state._center_freq_hz_filtered[FrequencyPeak::CENTER][_update_axis], _debug_state._center_freq_hz[_update_axis], _debug_max_bin, _debug_max_bin_freq);
         gcs().send_text(MAV_SEVERITY_WARNING, "FFT: bw:%.1f, e:%.1f, r:%.1f, snr:%.1f",
-                        _debug_state._center_bandwidth_hz_filtered[FrequencyPeak::CENTER][_update_axis], _debug_max_freq_bin, _ref_energy[_debug_max_bin][_update_axis], _debug_snr);
+                        _debug_state._center_bandwidth_hz_filtered[FrequencyPeak::CENTER][_update_axis], _debug_max_freq_bin, tl_engine()._ref_energy[_debug_max_bin][_update_axis], _debug_snr);
         _last_output_ms = now;
     }
 #endif
@@ -1050,6 +1139,35 @@ void AP_GyroFFT::log_noise_peak(uint8_t id, FrequencyPeak peak) const
         get_center_freq_energy(peak).z);
 }
 
+// @LoggerMessage: FTN4
+// @Description: FFT Filter Tuning of each IMU, when analysing all IMUs
+// @Field: TimeUS: microseconds since system startup
+// @Field: I: IMU instance
+// @Field: PkAvg: peak noise frequency as an energy-weighted average of roll and pitch peak frequencies
+// @Field: BwAvg: bandwidth of weighted peak frequency where edges are determined by FFT_ATT_REF
+// @Field: SnX: signal-to-noise ratio on the roll axis
+// @Field: SnY: signal-to-noise ratio on the pitch axis
+// @Field: SnZ: signal-to-noise ratio on the yaw axis
+// @Field: FHX: FFT health, X-axis
+// @Field: FHY: FFT health, Y-axis
+// @Field: FHZ: FFT health, Z-axis
+
+// write the noise summary of a single IMU
+void AP_GyroFFT::log_imu_noise(uint8_t instance) const
+{
+    const IMUEngine& engine = _engines[instance];
+    const FrequencyPeak peak = get_tracked_noise_peak(engine);
+    const Vector3f& snr = get_noise_signal_to_noise_db(engine, FrequencyPeak::CENTER);
+
+    AP::logger().WriteStreaming("FTN4", "TimeUS,I,PkAvg,BwAvg,SnX,SnY,SnZ,FHX,FHY,FHZ", "s#zz------", "F---------", "QBfffffBBB",
+        AP_HAL::micros64(),
+        instance,
+        get_weighted_noise_center_freq_hz(engine),
+        calculate_weighted_freq_hz(get_center_freq_energy(engine, peak), get_noise_center_bandwidth_hz(engine, peak)),
+        snr.x, snr.y, snr.z,
+        engine._health.x, engine._health.y, engine._health.z);
+}
+
 #endif
 
 // return an average noise bandwidth weighted by bin energy
@@ -1060,9 +1178,10 @@ float AP_GyroFFT::get_weighted_noise_center_bandwidth_hz() const
         return 0.0f;
     }
 
-    const FrequencyPeak peak = get_tracked_noise_peak();
+    const IMUEngine& engine = primary_engine();
+    const FrequencyPeak peak = get_tracked_noise_peak(engine);
 
-    return calculate_weighted_freq_hz(get_center_freq_energy(peak), get_noise_center_bandwidth_hz(peak));
+    return calculate_weighted_freq_hz(get_center_freq_energy(engine, peak), get_noise_center_bandwidth_hz(engine, peak));
 }
 
 // calculate noise frequencies from FFT data provided by the HAL subsystem
@@ -1074,15 +1193,18 @@ void AP_GyroFFT::calculate_noise(bool calibrating, const EngineConfig& config)
 
     uint8_t num_peaks = calculate_tracking_peaks(weighted_center_freq_hz, calibrating, config);
 
-    _thread_state._center_freq_bin[_update_axis] = _state->_peak_data[_thread_state._center_peak[_update_axis]]._bin;
-    _thread_state._center_freq_hz[_update_axis] = weighted_center_freq_hz;
+    IMUEngine& engine = tl_engine();
+    EngineState& thread_state = engine._thread_state;
+
+    thread_state._center_freq_bin[_update_axis] = engine._state->_peak_data[thread_state._center_peak[_update_axis]]._bin;
+    thread_state._center_freq_hz[_update_axis] = weighted_center_freq_hz;
     // record the last time we had a good signal on this axis
     if (num_peaks > 0) {
-        _thread_state._health_ms[_update_axis] = AP_HAL::millis();
+        thread_state._health_ms[_update_axis] = AP_HAL::millis();
     } else {
-        _thread_state._health_ms[_update_axis] = 0;
+        thread_state._health_ms[_update_axis] = 0;
     }
-    _thread_state._health[_update_axis] = num_peaks;
+    thread_state._health[_update_axis] = num_peaks;
     FrequencyPeak tracked_peak = FrequencyPeak::CENTER;
 
     // record the tracked peak for harmonic fit, but only if we have more than one noise peak
@@ -1099,13 +1221,13 @@ void AP_GyroFFT::calculate_noise(bool calibrating, const EngineConfig& config)
         }
     }
 
-    _thread_state._tracked_peak[_update_axis] = tracked_peak;
+    thread_state._tracked_peak[_update_axis] = tracked_peak;
 
     // if targetting more than one harmonic then make sure we get the fundamental
     // on larger copters the second harmonic often has more energy
     // if the highest peak is above the second highest then check for harmonic fit
     // comparisons are made using filter, normalised data
-    if (_thread_state._tracked_peak[_update_axis] != FrequencyPeak::CENTER) {
+    if (thread_state._tracked_peak[_update_axis] != FrequencyPeak::CENTER) {
         // calculate the fit and filter at 10hz
         const float harmonic_fit = 100.0f * fabsf(get_tl_noise_center_freq_hz(FrequencyPeak::CENTER, _update_axis)
             - get_tl_noise_center_freq_hz(tracked_peak, _update_axis) * _harmonic_multiplier)
@@ -1113,18 +1235,18 @@ void AP_GyroFFT::calculate_noise(bool calibrating, const EngineConfig& config)
 
         // calculate the fit and filter at 10hz
         if (isfinite(harmonic_fit)) {
-            _thread_state._harmonic_fit[_update_axis] = _harmonic_fit_filter[_update_axis].apply(harmonic_fit);
+            thread_state._harmonic_fit[_update_axis] = engine._harmonic_fit_filter[_update_axis].apply(harmonic_fit);
         }
     } else {
-        _thread_state._harmonic_fit[_update_axis] = 100.0f;
+        thread_state._harmonic_fit[_update_axis] = 100.0f;
     }
 #if DEBUG_FFT
     WITH_SEMAPHORE(_sem);
-    _debug_state = _thread_state;
-    _debug_max_freq_bin = _state->get_freq_bin(_state->_peak_data[FrequencyPeak::CENTER]._bin);
-    _debug_max_bin_freq = _state->_peak_data[FrequencyPeak::CENTER]._freq_hz;
+    _debug_state = thread_state;
+    _debug_max_freq_bin = engine._state->get_freq_bin(engine._state->_peak_data[FrequencyPeak::CENTER]._bin);
+    _debug_max_bin_freq = engine._state->_peak_data[FrequencyPeak::CENTER]._freq_hz;
     _debug_snr = snr;
-    _debug_max_bin = _state->_peak_data[FrequencyPeak::CENTER]._bin;
+    _debug_max_bin = engine._state->_peak_data[FrequencyPeak::CENTER]._bin;
 #endif
 }
 
@@ -1132,6 +1254,7 @@ void AP_GyroFFT::calculate_noise(bool calibrating, const EngineConfig& config)
 // calculate noise peaks based on the frequencies closest to the recent historical average, switching peaks around as necessary
 uint8_t AP_GyroFFT::calculate_tracking_peaks(float& weighted_center_freq_hz, bool calibrating, const EngineConfig& config)
 {
+    IMUEngine& engine = tl_engine();
     uint8_t num_peaks = 0;
     FrequencyData freqs(*this, config);
 
@@ -1147,13 +1270,13 @@ uint8_t AP_GyroFFT::calculate_tracking_peaks(float& weighted_center_freq_hz, boo
     FrequencyPeak upper = find_closest_peak(FrequencyPeak::UPPER_SHOULDER, distance_matrix, 1 << center | 1 << lower);
 
     // if we have had the maximum number of swapped cycles, force a full calculation
-    if (calibrating || _distorted_cycles[_update_axis] == 0) {
+    if (calibrating || engine._distorted_cycles[_update_axis] == 0) {
         num_peaks = calculate_tracking_peaks(weighted_center_freq_hz, freqs, config);
 #if DEBUG_FFT
         printf("Skipped update, order would have been is %d/%.1f(%.1f) %d/%.1f(%.1f) %d/%.1f(%.1f) n = %d\n",
-            center, _state->_peak_data[center]._freq_hz, get_tl_noise_center_freq_hz(FrequencyPeak::CENTER, _update_axis),
-            lower, _state->_peak_data[lower]._freq_hz, get_tl_noise_center_freq_hz(FrequencyPeak::LOWER_SHOULDER, _update_axis),
-            upper, _state->_peak_data[upper]._freq_hz, get_tl_noise_center_freq_hz(FrequencyPeak::UPPER_SHOULDER, _update_axis), num_peaks);
+            center, engine._state->_peak_data[center]._freq_hz, get_tl_noise_center_freq_hz(FrequencyPeak::CENTER, _update_axis),
+            lower, engine._state->_peak_data[lower]._freq_hz, get_tl_noise_center_freq_hz(FrequencyPeak::LOWER_SHOULDER, _update_axis),
+            upper, engine._state->_peak_data[upper]._freq_hz, get_tl_noise_center_freq_hz(FrequencyPeak::UPPER_SHOULDER, _update_axis), num_peaks);
 #endif
         return num_peaks;
     }
@@ -1176,13 +1299,13 @@ uint8_t AP_GyroFFT::calculate_tracking_peaks(float& weighted_center_freq_hz, boo
             center = FrequencyPeak::NONE;
         }
         weighted_center_freq_hz = freqs.get_weighted_frequency(center);
-        _thread_state._center_peak[_update_axis] = center;
+        engine._thread_state._center_peak[_update_axis] = center;
         update_snr_values(freqs);
         // if two adjacent peaks have simply swapped, we will allow this to continue indefinitely
         // as there is no loss of fidelity
         if (!((center == FrequencyPeak::LOWER_SHOULDER && lower == FrequencyPeak::CENTER)
             || (center == FrequencyPeak::UPPER_SHOULDER && upper == FrequencyPeak::CENTER))) {
-            _distorted_cycles[_update_axis]--;
+            engine._distorted_cycles[_update_axis]--;
         }
         return num_peaks;
     }
@@ -1195,6 +1318,7 @@ uint8_t AP_GyroFFT::calculate_tracking_peaks(float& weighted_center_freq_hz, boo
 // calculate the noise and whether valid for each peak
 uint8_t AP_GyroFFT::calculate_tracking_peaks(float& weighted_center_freq_hz, const FrequencyData& freqs, const EngineConfig& config)
 {
+    IMUEngine& engine = tl_engine();
     uint8_t num_peaks = 0;
     if (calculate_filtered_noise(FrequencyPeak::LOWER_SHOULDER, FrequencyPeak::LOWER_SHOULDER, freqs, config)) {
         num_peaks++;
@@ -1206,9 +1330,9 @@ uint8_t AP_GyroFFT::calculate_tracking_peaks(float& weighted_center_freq_hz, con
         num_peaks++;
     }
     // record the number of cycles where something was tracked
-    _distorted_cycles[_update_axis] = constrain_int16(_distorted_cycles[_update_axis] + 1, 0, FFT_MAX_MISSED_UPDATES);
+    engine._distorted_cycles[_update_axis] = constrain_int16(engine._distorted_cycles[_update_axis] + 1, 0, FFT_MAX_MISSED_UPDATES);
     weighted_center_freq_hz = freqs.get_weighted_frequency(FrequencyPeak::CENTER);
-    _thread_state._center_peak[_update_axis] = FrequencyPeak::CENTER;
+    engine._thread_state._center_peak[_update_axis] = FrequencyPeak::CENTER;
 
     update_snr_values(freqs);
 
@@ -1220,9 +1344,10 @@ uint8_t AP_GyroFFT::calculate_tracking_peaks(float& weighted_center_freq_hz, con
 // called from FFT thread
 bool AP_GyroFFT::calculate_filtered_noise(FrequencyPeak target_peak, FrequencyPeak source_peak, const FrequencyData& freqs, const EngineConfig& config)
 {
+    IMUEngine& engine = tl_engine();
     if (source_peak > FrequencyPeak::MAX_TRACKED_PEAKS) {
         // if we failed to find a signal, carry on using the previous readings
-        if (_missed_cycles[_update_axis][target_peak]++ < FFT_MAX_MISSED_UPDATES) {
+        if (engine._missed_cycles[_update_axis][target_peak]++ < FFT_MAX_MISSED_UPDATES) {
             return true; // the peak is synthetic
         }
         update_tl_center_freq_energy(target_peak, _update_axis, 0.0f);
@@ -1231,26 +1356,26 @@ bool AP_GyroFFT::calculate_filtered_noise(FrequencyPeak target_peak, FrequencyPe
         return false;
     }
 
-    AP_HAL::DSP::FrequencyPeakData* peak_data = &_state->_peak_data[source_peak];
+    AP_HAL::DSP::FrequencyPeakData* peak_data = &engine._state->_peak_data[source_peak];
 
     const uint16_t nb = peak_data->_bin;
 
     if (freqs.is_valid(FrequencyPeak(source_peak))) {
         // total peak energy requires an integration, as an approximation use amplitude * noise width * 5/6
-        update_tl_center_freq_energy(target_peak, _update_axis, _state->get_freq_bin(nb) * peak_data->_noise_width_hz * 0.8333f);
+        update_tl_center_freq_energy(target_peak, _update_axis, engine._state->get_freq_bin(nb) * peak_data->_noise_width_hz * 0.8333f);
         update_tl_noise_center_bandwidth_hz(target_peak, _update_axis, peak_data->_noise_width_hz);
         update_tl_noise_center_freq_hz(target_peak, _update_axis, freqs.get_weighted_frequency(FrequencyPeak(source_peak)));
-        _missed_cycles[_update_axis][target_peak] = 0;
+        engine._missed_cycles[_update_axis][target_peak] = 0;
         return true;
     }
 
     // if we failed to find a signal, carry on using the previous readings
-    if (_missed_cycles[_update_axis][target_peak]++ < FFT_MAX_MISSED_UPDATES) {
+    if (engine._missed_cycles[_update_axis][target_peak]++ < FFT_MAX_MISSED_UPDATES) {
         return true; // the peak is synthetic
     }
 
     // we failed to find a signal for more than FFT_MAX_MISSED_UPDATES cycles
-    update_tl_center_freq_energy(target_peak, _update_axis, _state->get_freq_bin(nb) * peak_data->_noise_width_hz * 0.8333f);     // use the actual energy detected rather than 0
+    update_tl_center_freq_energy(target_peak, _update_axis, engine._state->get_freq_bin(nb) * peak_data->_noise_width_hz * 0.8333f);     // use the actual energy detected rather than 0
     update_tl_noise_center_bandwidth_hz(target_peak, _update_axis, _bandwidth_hover_hz);
     update_tl_noise_center_freq_hz(target_peak, _update_axis, config._fft_min_hz);
 
@@ -1259,9 +1384,10 @@ bool AP_GyroFFT::calculate_filtered_noise(FrequencyPeak target_peak, FrequencyPe
 
 void AP_GyroFFT::update_snr_values(const FrequencyData& freqs)
 {
-    _thread_state._center_freq_snr[FrequencyPeak::CENTER][_update_axis] = freqs.get_signal_to_noise(FrequencyPeak::CENTER);
-    _thread_state._center_freq_snr[FrequencyPeak::LOWER_SHOULDER][_update_axis] = freqs.get_signal_to_noise(FrequencyPeak::LOWER_SHOULDER);
-    _thread_state._center_freq_snr[FrequencyPeak::UPPER_SHOULDER][_update_axis] = freqs.get_signal_to_noise(FrequencyPeak::UPPER_SHOULDER);
+    EngineState& thread_state = tl_engine()._thread_state;
+    thread_state._center_freq_snr[FrequencyPeak::CENTER][_update_axis] = freqs.get_signal_to_noise(FrequencyPeak::CENTER);
+    thread_state._center_freq_snr[FrequencyPeak::LOWER_SHOULDER][_update_axis] = freqs.get_signal_to_noise(FrequencyPeak::LOWER_SHOULDER);
+    thread_state._center_freq_snr[FrequencyPeak::UPPER_SHOULDER][_update_axis] = freqs.get_signal_to_noise(FrequencyPeak::UPPER_SHOULDER);
 }
 
 
@@ -1289,17 +1415,18 @@ AP_GyroFFT::FrequencyData::FrequencyData(const AP_GyroFFT& gyrofft, const Engine
 // calculate noise frequencies from FFT data provided by the HAL subsystem
 bool AP_GyroFFT::get_weighted_frequency(FrequencyPeak peak, float& weighted_peak_freq_hz, float& snr, const EngineConfig& config) const
 {
-    AP_HAL::DSP::FrequencyPeakData* peak_data = &_state->_peak_data[peak];
+    const IMUEngine& engine = tl_engine();
+    AP_HAL::DSP::FrequencyPeakData* peak_data = &engine._state->_peak_data[peak];
 
     const uint16_t bin = peak_data->_bin;
 
     // calculate the SNR and center frequency energy
-    const float max_energy = MAX(1.0f, _state->get_freq_bin(bin));
-    const float ref_energy = MAX(1.0f, _ref_energy[bin][_update_axis]);
+    const float max_energy = MAX(1.0f, engine._state->get_freq_bin(bin));
+    const float ref_energy = MAX(1.0f, engine._ref_energy[bin][_update_axis]);
     snr = 10.f * (log10f(max_energy) - log10f(ref_energy));
 
     // if the bin energy is above the noise threshold then we have a signal
-    if (!_thread_state._noise_needs_calibration && isfinite(_state->get_freq_bin(bin)) && snr > config._snr_threshold_db) {
+    if (!engine._thread_state._noise_needs_calibration && isfinite(engine._state->get_freq_bin(bin)) && snr > config._snr_threshold_db) {
         weighted_peak_freq_hz = constrain_float(peak_data->_freq_hz, (float)config._fft_min_hz, (float)config._fft_max_hz);
         return true;
     }
@@ -1347,29 +1474,30 @@ AP_GyroFFT::FrequencyPeak AP_GyroFFT::find_closest_peak(const FrequencyPeak targ
 // called from FFT thread
 void AP_GyroFFT::update_ref_energy(uint16_t max_bin)
 {
-    if (!_thread_state._noise_needs_calibration) {
+    IMUEngine& engine = tl_engine();
+    if (!engine._thread_state._noise_needs_calibration) {
         return;
     }
 
     // according to https://www.tcd.ie/Physics/research/groups/magnetism/files/lectures/py5021/MagneticSensors3.pdf sensor noise is not necessarily gaussian
     // determine a PS noise reference at each of the possible center frequencies
-    if (_noise_cycles == 0 && _noise_calibration_cycles[_update_axis] > 0) {
-        for (uint16_t i = 1; i < _state->_bin_count; i++) {
-            _ref_energy[i][_update_axis] += _state->get_freq_bin(i);
+    if (engine._noise_cycles == 0 && engine._noise_calibration_cycles[_update_axis] > 0) {
+        for (uint16_t i = 1; i < engine._state->_bin_count; i++) {
+            engine._ref_energy[i][_update_axis] += engine._state->get_freq_bin(i);
         }
-        if (--_noise_calibration_cycles[_update_axis] == 0) {
-            for (uint16_t i = 1; i < _state->_bin_count; i++) {
+        if (--engine._noise_calibration_cycles[_update_axis] == 0) {
+            for (uint16_t i = 1; i < engine._state->_bin_count; i++) {
                 const float cycles = (static_cast<float>(_window_size) / static_cast<float>(_samples_per_frame)) * 2;
                 // overall random noise is reduced by sqrt(N) when averaging periodigrams so adjust for that
-                _ref_energy[i][_update_axis] = (_ref_energy[i][_update_axis] / cycles) * sqrtf(cycles);
+                engine._ref_energy[i][_update_axis] = (engine._ref_energy[i][_update_axis] / cycles) * sqrtf(cycles);
             }
 
             WITH_SEMAPHORE(_sem);
-            _thread_state._noise_needs_calibration &= ~(1 << _update_axis);
+            engine._thread_state._noise_needs_calibration &= ~(1 << _update_axis);
         }
     }
-    else if (_noise_cycles > 0) {
-        _noise_cycles--;
+    else if (engine._noise_cycles > 0) {
+        engine._noise_cycles--;
     }
 }
 
@@ -1377,12 +1505,15 @@ void AP_GyroFFT::update_ref_energy(uint16_t max_bin)
 // called from main thread
 float AP_GyroFFT::self_test_bin_frequencies()
 {
-    if (_state->_window_size * sizeof(float) > hal.util->available_memory() / 2) {
-        gcs().send_text(MAV_SEVERITY_WARNING, "FFT: unable to run self-test, required %u bytes", (unsigned int)(_state->_window_size * sizeof(float)));
+    // the IMUs share the FFT configuration, so only the first engine needs testing
+    _update_imu = 0;
+    IMUEngine& engine = tl_engine();
+    if (engine._state->_window_size * sizeof(float) > hal.util->available_memory() / 2) {
+        gcs().send_text(MAV_SEVERITY_WARNING, "FFT: unable to run self-test, required %u bytes", (unsigned int)(engine._state->_window_size * sizeof(float)));
         return 0.0f;
     }
 
-    FloatBuffer test_window(_state->_window_size);
+    FloatBuffer test_window(engine._state->_window_size);
     // in the unlikely event we can't allocate a test window, skip the checks
     if (test_window.get_size() == 0) {
         return 0.0f;
@@ -1392,9 +1523,9 @@ float AP_GyroFFT::self_test_bin_frequencies()
 
     for (uint16_t bin = _config._fft_start_bin; bin <= _config._fft_end_bin; bin++) {
         // the algorithm will only ever return values in this range
-        float frequency = constrain_float(bin * _state->_bin_resolution, _fft_min_hz, _fft_max_hz);
+        float frequency = constrain_float(bin * engine._state->_bin_resolution, _fft_min_hz, _fft_max_hz);
         max_divergence = MAX(max_divergence, self_test(frequency, test_window)); // test bin centers
-        frequency = constrain_float(bin * _state->_bin_resolution - _state->_bin_resolution / 4, _fft_min_hz, _fft_max_hz);
+        frequency = constrain_float(bin * engine._state->_bin_resolution - engine._state->_bin_resolution / 4, _fft_min_hz, _fft_max_hz);
         max_divergence = MAX(max_divergence, self_test(frequency, test_window)); // test bin off-centers
     }
 
@@ -1405,8 +1536,10 @@ float AP_GyroFFT::self_test_bin_frequencies()
 // called from main thread
 float AP_GyroFFT::self_test(float frequency, FloatBuffer& test_window)
 {
+    _update_imu = 0;
+    IMUEngine& engine = tl_engine();
     test_window.clear();
-    for(uint16_t i = 0; i < _state->_window_size; i++) {
+    for(uint16_t i = 0; i < engine._state->_window_size; i++) {
         if (!test_window.push(sinf(2.0f * M_PI * frequency * i / _fft_sampling_rate_hz) * ToRad(20) * 2000)) {
             AP_HAL::panic("Could not create FFT test window");
         }
@@ -1416,12 +1549,12 @@ float AP_GyroFFT::self_test(float frequency, FloatBuffer& test_window)
 
     // if using averaging we need to process _num_frames in order to not bias the result
     for (uint8_t i = 1; i < _num_frames; i++) {
-        hal.dsp->fft_start(_state, test_window, 0);
-        hal.dsp->fft_analyse(_state, _config._fft_start_bin, _config._fft_end_bin, _config._attenuation_cutoff);
+        hal.dsp->fft_start(engine._state, test_window, 0);
+        hal.dsp->fft_analyse(engine._state, _config._fft_start_bin, _config._fft_end_bin, _config._attenuation_cutoff);
     }
     // final cycle is the one we want
-    hal.dsp->fft_start(_state, test_window, 0);
-    uint16_t max_bin = hal.dsp->fft_analyse(_state, _config._fft_start_bin, _config._fft_end_bin, _config._attenuation_cutoff);
+    hal.dsp->fft_start(engine._state, test_window, 0);
+    uint16_t max_bin = hal.dsp->fft_analyse(engine._state, _config._fft_start_bin, _config._fft_end_bin, _config._attenuation_cutoff);
 
     if (max_bin == 0) {
         gcs().send_text(MAV_SEVERITY_WARNING, "FFT: self-test failed, failed to find frequency %.1f", frequency);
@@ -1431,13 +1564,13 @@ float AP_GyroFFT::self_test(float frequency, FloatBuffer& test_window)
 
     float max_divergence = 0;
     // make sure the selected frequencies are in the right bin
-    max_divergence = MAX(max_divergence, fabsf(frequency - _thread_state._center_freq_hz[0]));
-    if (_thread_state._center_freq_hz[0] < (frequency - MAX(_state->_bin_resolution * 0.5f, 1)) || _thread_state._center_freq_hz[0] > (frequency + MAX(_state->_bin_resolution * 0.5f, 1))) {
-        gcs().send_text(MAV_SEVERITY_WARNING, "FFT: self-test failed: wanted %.1f, had %.1f", frequency, _thread_state._center_freq_hz[0]);
+    max_divergence = MAX(max_divergence, fabsf(frequency - engine._thread_state._center_freq_hz[0]));
+    if (engine._thread_state._center_freq_hz[0] < (frequency - MAX(engine._state->_bin_resolution * 0.5f, 1)) || engine._thread_state._center_freq_hz[0] > (frequency + MAX(engine._state->_bin_resolution * 0.5f, 1))) {
+        gcs().send_text(MAV_SEVERITY_WARNING, "FFT: self-test failed: wanted %.1f, had %.1f", frequency, engine._thread_state._center_freq_hz[0]);
     }
 #if DEBUG_FFT
     else {
-        gcs().send_text(MAV_SEVERITY_INFO, "FFT: self-test succeeded: wanted %.1f, had %.1f", frequency, _thread_state._center_freq_hz[0]);
+        gcs().send_text(MAV_SEVERITY_INFO, "FFT: self-test succeeded: wanted %.1f, had %.1f", frequency, engine._thread_state._center_freq_hz[0]);
     }
 #endif
 
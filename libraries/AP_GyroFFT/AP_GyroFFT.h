@@ -40,7 +40,8 @@ public:
 
     enum class Options : uint32_t {
         FFTPostFilter = 1 << 0,
-        ESCNoiseCheck = 1 << 1
+        ESCNoiseCheck = 1 << 1,
+        AllIMUs = 1 << 2
     };
 
     AP_GyroFFT();
@@ -79,30 +80,36 @@ public:
     void start_notch_tune();
     void stop_notch_tune();
 
+    // the following outputs are for the primary gyro, only valid while analysis is enabled
     // detected peak frequency filtered at 1/3 the update rate
     const Vector3f& get_noise_center_freq_hz() const { return get_noise_center_freq_hz(FrequencyPeak::CENTER); }
-    const Vector3f& get_noise_center_freq_hz(FrequencyPeak peak) const { return _global_state._center_freq_hz_filtered[peak]; }
+    const Vector3f& get_noise_center_freq_hz(FrequencyPeak peak) const { return get_noise_center_freq_hz(primary_engine(), peak); }
     // frequency values
-    float get_weighted_freq_hz(FrequencyPeak peak) const;
+    float get_weighted_freq_hz(FrequencyPeak peak) const { return get_weighted_freq_hz(primary_engine(), peak); }
     // energy of the background noise at the detected center frequency
     const Vector3f& get_noise_signal_to_noise_db() const { return get_noise_signal_to_noise_db(FrequencyPeak::CENTER); }
-    const Vector3f& get_noise_signal_to_noise_db(FrequencyPeak peak) const { return _global_state._center_freq_snr[peak];; }
+    const Vector3f& get_noise_signal_to_noise_db(FrequencyPeak peak) const { return get_noise_signal_to_noise_db(primary_engine(), peak); }
     // detected peak frequency weighted by energy
-    float get_weighted_noise_center_freq_hz() const;
+    float get_weighted_noise_center_freq_hz() const { return get_weighted_noise_center_freq_hz(AP::ins().get_primary_gyro()); }
+    float get_weighted_noise_center_freq_hz(uint8_t instance) const;
     // all detected peak frequencies weighted by energy
-    uint8_t get_weighted_noise_center_frequencies_hz(uint8_t num_freqs, float* freqs) const;
+    uint8_t get_weighted_noise_center_frequencies_hz(uint8_t num_freqs, float* freqs) const {
+        return get_weighted_noise_center_frequencies_hz(AP::ins().get_primary_gyro(), num_freqs, freqs);
+    }
+    // detected peak frequencies of a gyro, which are the primary gyro's unless all IMUs are analysed
+    uint8_t get_weighted_noise_center_frequencies_hz(uint8_t instance, uint8_t num_freqs, float* freqs) const;
     // detected peak frequency
-    const Vector3f& get_raw_noise_center_freq_hz() const { return _global_state._center_freq_hz; }
+    const Vector3f& get_raw_noise_center_freq_hz() const { return primary_engine()._global_state._center_freq_hz; }
     // match between first and second harmonics
-    const Vector3f& get_raw_noise_harmonic_fit() const { return _global_state._harmonic_fit; }
+    const Vector3f& get_raw_noise_harmonic_fit() const { return primary_engine()._global_state._harmonic_fit; }
     // energy of the detected peak frequency
     const Vector3f& get_center_freq_energy() const { return get_center_freq_energy(FrequencyPeak::CENTER); }
-    const Vector3f& get_center_freq_energy(FrequencyPeak peak) const { return _global_state._center_freq_energy_filtered[peak]; }
+    const Vector3f& get_center_freq_energy(FrequencyPeak peak) const { return get_center_freq_energy(primary_engine(), peak); }
     // index of the FFT bin containing the detected peak frequency
-    const Vector3<uint16_t>& get_center_freq_bin() const { return _global_state._center_freq_bin; }
+    const Vector3<uint16_t>& get_center_freq_bin() const { return primary_engine()._global_state._center_freq_bin; }
     // detected peak bandwidth
     const Vector3f& get_noise_center_bandwidth_hz() const { return get_noise_center_bandwidth_hz(FrequencyPeak::CENTER); }
-    const Vector3f& get_noise_center_bandwidth_hz(FrequencyPeak peak) const { return _global_state._center_bandwidth_hz_filtered[peak]; };
+    const Vector3f& get_noise_center_bandwidth_hz(FrequencyPeak peak) const { return get_noise_center_bandwidth_hz(primary_engine(), peak); }
     // weighted detected peak bandwidth
     float get_weighted_noise_center_bandwidth_hz() const;
     // log gyro fft messages
@@ -111,6 +118,8 @@ public:
     bool using_post_filter_samples() const { return (_options & uint32_t(Options::FFTPostFilter)) != 0; }
     // post filter mask of IMUs
     bool check_esc_noise() const { return (_options & uint32_t(Options::ESCNoiseCheck)) != 0; }
+    // whether the gyros of all IMUs are analysed rather than just the primary gyro
+    bool analysing_all_imus() const { return _analyse_all_imus; }
     // look for a frequency in the detected noise
     float has_noise_at_frequency_hz(float freq) const;
     static float calculate_notch_frequency(float* freqs, uint16_t numpeaks, float harmonic_fit, uint8_t& harmonics);
@@ -176,22 +185,114 @@ private:
     // distance matrix between filtered and instantaneous peaks
     typedef float DistanceMatrix[FrequencyPeak::MAX_TRACKED_PEAKS][FrequencyPeak::MAX_TRACKED_PEAKS];
 
+    // data set from the FFT thread but accessible from the main thread protected by the semaphore
+    struct EngineState {
+        // energy of the detected peak frequency in dB
+        Vector3f _center_freq_energy_db;
+        // detected peak frequency
+        Vector3f _center_freq_hz;
+        // fit between first and second harmonics
+        Vector3f _harmonic_fit;
+        // bin of detected peak frequency
+        Vector3ui _center_freq_bin;
+        // fft engine health
+        Vector3<uint8_t> _health;
+        Vector3ul _health_ms;
+        // fft engine output rate
+        uint32_t _output_cycle_ms;
+        // tracked frequency peak for the purposes of notching
+        Vector3<uint8_t> _tracked_peak;
+        // center frequency peak ignoring temporary energy changes / order switching
+        Vector3<uint8_t> _center_peak;
+        // signal to noise ratio of PSD at each of the detected centre frequencies
+        Vector3f _center_freq_snr[FrequencyPeak::MAX_TRACKED_PEAKS];
+        // filtered version of the peak frequency
+        Vector3f _center_freq_hz_filtered[FrequencyPeak::MAX_TRACKED_PEAKS];
+        // when we last calculated a value
+        Vector3ul _last_output_us;
+        // filtered energy of the detected peak frequency
+        Vector3f _center_freq_energy_filtered[FrequencyPeak::MAX_TRACKED_PEAKS];
+        // filtered detected peak width
+        Vector3f _center_bandwidth_hz_filtered[FrequencyPeak::MAX_TRACKED_PEAKS];
+        // axes that still require noise calibration
+        uint8_t _noise_needs_calibration : 3;
+        // whether the analyzer is mid-cycle
+        bool _analysis_started;
+    };
+
+    // FFT engine state, filters and sampled data for the gyro of a single IMU
+    struct IMUEngine {
+        // Shared FFT engine state local to the FFT thread
+        EngineState _thread_state;
+        // Shared FFT engine state accessible by the main thread
+        EngineState _global_state;
+        // state of the FFT engine
+        AP_HAL::DSP::FFTWindowState* _state;
+        // noise base of the gyros
+        Vector3f* _ref_energy;
+        // the number of cycles required to have a proper noise reference
+        uint16_t _noise_cycles;
+        // number of cycles over which to generate noise ensemble averages
+        uint16_t _noise_calibration_cycles[XYZ_AXIS_COUNT];
+        // engine health in tracked peaks per axis
+        Vector3<uint8_t> _health;
+        // engine health on roll/pitch/yaw
+        Vector3<uint8_t> _rpy_health;
+        // downsampled gyro data circular buffer for frequency analysis
+        FloatBuffer _downsampled_gyro_data[XYZ_AXIS_COUNT];
+        // accumulator for sampled gyro data
+        Vector3f _oversampled_gyro_accum;
+        // smoothing filter on the output
+        MedianLowPassFilter3dFloat _center_freq_filter[FrequencyPeak::MAX_TRACKED_PEAKS];
+        // smoothing filter on the energy
+        MedianLowPassFilter3dFloat _center_freq_energy_filter[FrequencyPeak::MAX_TRACKED_PEAKS];
+        // smoothing filter on the bandwidth
+        MedianLowPassFilter3dFloat _center_bandwidth_filter[FrequencyPeak::MAX_TRACKED_PEAKS];
+        // smoothing filter on the frequency fit
+        LowPassFilterFloat _harmonic_fit_filter[XYZ_AXIS_COUNT];
+        // number of cycles without a detected signal
+        uint8_t _missed_cycles[XYZ_AXIS_COUNT][FrequencyPeak::MAX_TRACKED_PEAKS];
+        // number of cycles where peaks have swapped places
+        uint8_t _distorted_cycles[XYZ_AXIS_COUNT];
+    };
+
+    // engine of the IMU being analysed
+    IMUEngine& tl_engine() { return _engines[_update_imu]; }
+    const IMUEngine& tl_engine() const { return _engines[_update_imu]; }
+    // engine analysing the primary gyro
+    const IMUEngine& primary_engine() const { return _engines[engine_index(_ins->get_primary_gyro())]; }
+    // engine analysing a gyro instance, the only engine analyses the primary gyro when not analysing all IMUs
+    uint8_t engine_index(uint8_t instance) const { return _analyse_all_imus ? instance : 0; }
+
+    // accessors of the filtered state of an engine
+    const Vector3f& get_noise_center_freq_hz(const IMUEngine& engine, FrequencyPeak peak) const { return engine._global_state._center_freq_hz_filtered[peak]; }
+    const Vector3f& get_noise_signal_to_noise_db(const IMUEngine& engine, FrequencyPeak peak) const { return engine._global_state._center_freq_snr[peak]; }
+    const Vector3f& get_center_freq_energy(const IMUEngine& engine, FrequencyPeak peak) const { return engine._global_state._center_freq_energy_filtered[peak]; }
+    const Vector3f& get_noise_center_bandwidth_hz(const IMUEngine& engine, FrequencyPeak peak) const { return engine._global_state._center_bandwidth_hz_filtered[peak]; }
+    float get_weighted_freq_hz(const IMUEngine& engine, FrequencyPeak peak) const;
+    float get_weighted_noise_center_freq_hz(const IMUEngine& engine) const;
+    uint8_t get_weighted_noise_center_frequencies_hz(const IMUEngine& engine, uint8_t num_freqs, float* freqs) const;
+
     // thread-local accessors of filtered state
-    float get_tl_noise_center_freq_hz(FrequencyPeak peak, uint8_t axis) const { return _thread_state._center_freq_hz_filtered[peak][axis]; }
-    float get_tl_center_freq_energy(FrequencyPeak peak, uint8_t axis) const { return _thread_state._center_freq_energy_filtered[peak][axis]; }
-    float get_tl_noise_center_bandwidth_hz(FrequencyPeak peak, uint8_t axis) const { return _thread_state._center_bandwidth_hz_filtered[peak][axis]; };
+    float get_tl_noise_center_freq_hz(FrequencyPeak peak, uint8_t axis) const { return tl_engine()._thread_state._center_freq_hz_filtered[peak][axis]; }
+    float get_tl_center_freq_energy(FrequencyPeak peak, uint8_t axis) const { return tl_engine()._thread_state._center_freq_energy_filtered[peak][axis]; }
+    float get_tl_noise_center_bandwidth_hz(FrequencyPeak peak, uint8_t axis) const { return tl_engine()._thread_state._center_bandwidth_hz_filtered[peak][axis]; };
     // thread-local mutators of filtered state
     float update_tl_noise_center_freq_hz(FrequencyPeak peak, uint8_t axis, float value) {
-        return (_thread_state._center_freq_hz_filtered[peak][axis] = _center_freq_filter[peak].apply(axis, value));
+        IMUEngine& engine = tl_engine();
+        return (engine._thread_state._center_freq_hz_filtered[peak][axis] = engine._center_freq_filter[peak].apply(axis, value));
     }
     float update_tl_center_freq_energy(FrequencyPeak peak, uint8_t axis, float value) {
-        return (_thread_state._center_freq_energy_filtered[peak][axis] = _center_freq_energy_filter[peak].apply(axis, value));
+        IMUEngine& engine = tl_engine();
+        return (engine._thread_state._center_freq_energy_filtered[peak][axis] = engine._center_freq_energy_filter[peak].apply(axis, value));
     }
     float update_tl_noise_center_bandwidth_hz(FrequencyPeak peak, uint8_t axis, float value) {
-        return (_thread_state._center_bandwidth_hz_filtered[peak][axis] = _center_bandwidth_filter[peak].apply(axis, value));
+        IMUEngine& engine = tl_engine();
+        return (engine._thread_state._center_bandwidth_hz_filtered[peak][axis] = engine._center_bandwidth_filter[peak].apply(axis, value));
     }
     // write single log messages
     void log_noise_peak(uint8_t id, FrequencyPeak peak) const;
+    void log_imu_noise(uint8_t instance) const;
     // calculate the peak noise frequency
     void calculate_noise(bool calibrating, const EngineConfig& config);
     // calculate noise peaks based on energy and history
@@ -203,7 +304,7 @@ private:
     // get the weighted frequency
     bool get_weighted_frequency(FrequencyPeak peak, float& weighted_peak_freq_hz, float& snr, const EngineConfig& config) const;
     // return the tracked noise peak
-    FrequencyPeak get_tracked_noise_peak() const;
+    FrequencyPeak get_tracked_noise_peak(const IMUEngine& engine) const;
     // calculate the distance matrix between the current estimates and the current cycle
     void find_distance_matrix(DistanceMatrix& distance_matrix, const FrequencyData& freqs, const EngineConfig& config) const;
     // return the instantaneous peak that is closest to the target estimate peak
@@ -220,105 +321,48 @@ private:
     bool analysis_enabled() const { return _initialized && _analysis_enabled && _thread_created; };
     // whether analysis can be run again or not
     bool start_analysis();
-    // return samples available in the gyro window
-    uint16_t get_available_samples(uint8_t axis) {
-        return _sample_mode == 0 ?_ins->get_raw_gyro_window(axis).available() : _downsampled_gyro_data[axis].available();
+    // the gyro window of an axis of the IMU being analysed
+    FloatBuffer& get_gyro_window(uint8_t axis) {
+        if (_sample_mode != 0) {
+            return tl_engine()._downsampled_gyro_data[axis];
+        }
+        return _analyse_all_imus ? _ins->get_raw_gyro_window(_update_imu, axis) : _ins->get_raw_gyro_window(axis);
     }
+    // return samples available in the gyro window
+    uint16_t get_available_samples(uint8_t axis) { return get_gyro_window(axis).available(); }
     void update_parameters(bool force);
     // semaphore for access to shared FFT data
     HAL_Semaphore _sem;
 
-    // data set from the FFT thread but accessible from the main thread protected by the semaphore
-    struct EngineState {
-        // energy of the detected peak frequency in dB
-        Vector3f _center_freq_energy_db;
-        // detected peak frequency
-        Vector3f _center_freq_hz;
-        // fit between first and second harmonics
-        Vector3f _harmonic_fit;
-        // bin of detected peak frequency
-        Vector3ui _center_freq_bin;
-        // fft engine health
-        Vector3<uint8_t> _health;
-        Vector3ul _health_ms;
-        // fft engine output rate
-        uint32_t _output_cycle_ms;
-        // tracked frequency peak for the purposes of notching
-        Vector3<uint8_t> _tracked_peak;
-        // center frequency peak ignoring temporary energy changes / order switching
-        Vector3<uint8_t> _center_peak;
-        // signal to noise ratio of PSD at each of the detected centre frequencies
-        Vector3f _center_freq_snr[FrequencyPeak::MAX_TRACKED_PEAKS];
-        // filtered version of the peak frequency
-        Vector3f _center_freq_hz_filtered[FrequencyPeak::MAX_TRACKED_PEAKS];
-        // when we last calculated a value
-        Vector3ul _last_output_us;
-        // filtered energy of the detected peak frequency
-        Vector3f _center_freq_energy_filtered[FrequencyPeak::MAX_TRACKED_PEAKS];
-        // filtered detected peak width
-        Vector3f _center_bandwidth_hz_filtered[FrequencyPeak::MAX_TRACKED_PEAKS];
-        // axes that still require noise calibration
-        uint8_t _noise_needs_calibration : 3;
-        // whether the analyzer is mid-cycle
-        bool _analysis_started;
-    };
-
-    // Shared FFT engine state local to the FFT thread
-    EngineState _thread_state;
-    // Shared FFT engine state accessible by the main thread
-    EngineState _global_state;
-
     // number of samples needed before a new frame can be processed
     uint16_t _samples_per_frame;
     // number of ms that a frame should take to process to sustain output rate
     uint16_t _frame_time_ms;
     // last cycle time
     uint32_t _output_cycle_micros;
-    // downsampled gyro data circular buffer for frequency analysis
-    FloatBuffer _downsampled_gyro_data[XYZ_AXIS_COUNT];
-    // accumulator for sampled gyro data
-    Vector3f _oversampled_gyro_accum;
     // count of oversamples
     uint16_t _oversampled_gyro_count;
 
-    // state of the FFT engine
-    AP_HAL::DSP::FFTWindowState* _state;
+    // engine for each analysed IMU
+    IMUEngine* _engines;
+    // number of analysed IMUs
+    uint8_t _num_engines;
+    // whether each gyro has its own engine
+    bool _analyse_all_imus;
     // update state machine step information
+    uint8_t _update_imu;
     uint8_t _update_axis;
-    // noise base of the gyros
-    Vector3f* _ref_energy;
-    // the number of cycles required to have a proper noise reference
-    uint16_t _noise_cycles;
-    // number of cycles over which to generate noise ensemble averages
-    uint16_t _noise_calibration_cycles[XYZ_AXIS_COUNT];
     // current _sample_mode
     uint8_t _current_sample_mode : 3;
     // harmonic multiplier for two highest peaks
     float _harmonic_multiplier;
     // number of tracked peaks
     uint8_t _tracked_peaks;
-    // engine health in tracked peaks per axis
-    Vector3<uint8_t> _health;
-    // engine health on roll/pitch/yaw
-    Vector3<uint8_t> _rpy_health;
     // averaged throttle output over averaging period
     float _avg_throttle_out;
 
-    // smoothing filter on the output
-    MedianLowPassFilter3dFloat _center_freq_filter[FrequencyPeak::MAX_TRACKED_PEAKS];
-    // smoothing filter on the energy
-    MedianLowPassFilter3dFloat _center_freq_energy_filter[FrequencyPeak::MAX_TRACKED_PEAKS];
-    // smoothing filter on the bandwidth
-    MedianLowPassFilter3dFloat _center_bandwidth_filter[FrequencyPeak::MAX_TRACKED_PEAKS];
-    // smoothing filter on the frequency fit
-    LowPassFilterFloat _harmonic_fit_filter[XYZ_AXIS_COUNT];
-
     // configured sampling rate
     uint16_t _fft_sampling_rate_hz;
-    // number of cycles without a detected signal
-    uint8_t _missed_cycles[XYZ_AXIS_COUNT][FrequencyPeak::MAX_TRACKED_PEAKS];
-    // number of cycles where peaks have swapped places
-    uint8_t _distorted_cycles[XYZ_AXIS_COUNT];
     // whether the analyzer initialized correctly
     bool _initialized;
 
@@ -0,0 +1,53 @@
+#include <AP_gtest.h>
+#include <AP_HAL/HAL.h>
+#include <AP_HAL/DSP.h>
+#include <AP_HAL/utility/RingBuffer.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_GyroFFT/AP_GyroFFT.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if HAL_GYROFFT_ENABLED
+// find a single sine wave at the center and off the center of each bin, as the GyroFFT self-test does
+static void check_sine_frequencies(uint16_t window_size, uint16_t sample_rate)
+{
+    AP_HAL::DSP::FFTWindowState* state = hal.dsp->fft_init(window_size, sample_rate);
+    if (state == nullptr) {
+        // no DSP support on this board
+        return;
+    }
+
+    FloatBuffer window(window_size);
+    const uint16_t end_bin = state->_bin_count - 2;
+    // 15dB attenuation
+    const float attenuation_cutoff = powf(10.0f, -15 * 0.1f);
+
+    for (uint16_t bin = 2; bin <= end_bin; bin++) {
+        for (float offset : { 0.0f, -0.25f }) {
+            const float frequency = (bin + offset) * state->_bin_resolution;
+            window.clear();
+            for (uint16_t i = 0; i < window_size; i++) {
+                window.push(sinf(2.0f * M_PI * frequency * i / sample_rate) * ToRad(20) * 2000);
+            }
+            hal.dsp->fft_start(state, window, 0);
+            const uint16_t max_bin = hal.dsp->fft_analyse(state, 1, end_bin, attenuation_cutoff);
+
+            EXPECT_EQ(max_bin, bin);
+            EXPECT_NEAR(state->_peak_data[AP_HAL::DSP::CENTER]._freq_hz, frequency, state->_bin_resolution * 0.5f);
+        }
+    }
+
+    delete state;
+}
+#endif
+
+TEST(dsp_fft_Test, SineFrequency)
+{
+#if HAL_GYROFFT_ENABLED
+    check_sine_frequencies(32, 1000);
+    check_sine_frequencies(128, 1000);
+    check_sine_frequencies(512, 2000);
+#endif
+}
+
+AP_GTEST_MAIN()
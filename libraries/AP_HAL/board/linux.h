@@ -409,10 +409,6 @@
 #define HAL_WITH_EKF_DOUBLE HAL_HAVE_HARDWARE_DOUBLE
 #endif
 
-#ifndef HAL_GYROFFT_ENABLED
-#define HAL_GYROFFT_ENABLED 0
-#endif
-
 #if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_NONE
 // we can use virtual CAN on native builds
 #define HAL_LINUX_USE_VIRTUAL_CAN 1
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+/*
+  publish an object from one thread to any number of reader threads
+  without a lock.
+
+  The writer fills whichever of the two buffers was not published
+  last and then publishes it by incrementing a sequence number, so a
+  reader copying the last published buffer is only disturbed if a
+  second publish completes during its copy. In that case the reader
+  retries, so readers never see a partially written object and never
+  block the writer.
+ */
+template <class T>
+class SeqLockBuffer {
+public:
+    // publish a new value. Only one thread may write
+    void write(const T &value) {
+        const uint32_t seq = sequence.load(std::memory_order_relaxed);
+        // keep the previous publish ordered before these writes
+        std::atomic_thread_fence(std::memory_order_release);
+        buffer[(seq+1) & 1] = value;
+        sequence.store(seq+1, std::memory_order_release);
+    }
+
+    // copy the last published value, returns false if nothing has
+    // been published yet
+    bool read(T &value) const {
+        while (true) {
+            const uint32_t seq = sequence.load(std::memory_order_acquire);
+            if (seq == 0) {
+                return false;
+            }
+            value = buffer[seq & 1];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == seq) {
+                return true;
+            }
+        }
+    }
+
+    // number of values published, can be used by readers to detect a new value
+    uint32_t get_sequence(void) const {
+        return sequence.load(std::memory_order_acquire);
+    }
+
+private:
+    T buffer[2];
+    std::atomic<uint32_t> sequence{0};
+};
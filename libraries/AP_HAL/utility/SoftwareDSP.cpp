@@ -0,0 +1,229 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Code by Andy Piper
+ */
+
+#include <AP_HAL/AP_HAL.h>
+#include "SoftwareDSP.h"
+
+#if HAL_WITH_SOFTWARE_DSP
+
+#include <AP_Math/AP_Math.h>
+#include <GCS_MAVLink/GCS.h>
+#include <cmath>
+
+// The algorithms originally came from betaflight but are now substantially modified based on theory and experiment.
+// https://holometer.fnal.gov/GH_FFT.pdf "Spectrum and spectral density estimation by the Discrete Fourier transform (DFT),
+// including a comprehensive list of window functions and some new flat-top windows." - Heinzel et. al is a great reference
+// for understanding the underlying theory although we do not use spectral density here since time resolution is equally
+// important as frequency resolution. Referred to as [Heinz] throughout the code.
+
+// initialize the FFT state machine
+AP_HAL::DSP::FFTWindowState* SoftwareDSP::fft_init(uint16_t window_size, uint16_t sample_rate, uint8_t sliding_window_size)
+{
+    SoftwareDSP::FFTWindowStateSoftware* fft = new SoftwareDSP::FFTWindowStateSoftware(window_size, sample_rate, sliding_window_size);
+    if (fft == nullptr || fft->_hanning_window == nullptr || fft->_rfft_data == nullptr || fft->_freq_bins == nullptr || fft->_derivative_freq_bins == nullptr
+        || fft->buf == nullptr || fft->twiddle == nullptr || fft->bit_reverse == nullptr) {
+        delete fft;
+        return nullptr;
+    }
+    return fft;
+}
+
+// start an FFT analysis
+void SoftwareDSP::fft_start(AP_HAL::DSP::FFTWindowState* state, FloatBuffer& samples, uint16_t advance)
+{
+    step_hanning((FFTWindowStateSoftware*)state, samples, advance);
+}
+
+// perform remaining steps of an FFT analysis
+uint16_t SoftwareDSP::fft_analyse(AP_HAL::DSP::FFTWindowState* state, uint16_t start_bin, uint16_t end_bin, float noise_att_cutoff)
+{
+    FFTWindowStateSoftware* fft = (FFTWindowStateSoftware*)state;
+    step_fft(fft);
+    step_cmplx_mag(fft, start_bin, end_bin, noise_att_cutoff);
+    return step_calc_frequencies(fft, start_bin, end_bin);
+}
+
+// create an instance of the FFT state machine
+SoftwareDSP::FFTWindowStateSoftware::FFTWindowStateSoftware(uint16_t window_size, uint16_t sample_rate, uint8_t sliding_window_size)
+    : AP_HAL::DSP::FFTWindowState::FFTWindowState(window_size, sample_rate, sliding_window_size)
+{
+    if (_freq_bins == nullptr || _hanning_window == nullptr || _rfft_data == nullptr || _derivative_freq_bins == nullptr) {
+        GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "Failed to allocate window for DSP");
+        return;
+    }
+
+    // the real FFT is calculated using a complex FFT of half the size
+    const uint16_t half_size = window_size / 2;
+    buf = new complexf[half_size];
+    twiddle = new complexf[half_size];
+    bit_reverse = new uint16_t[half_size];
+    if (buf == nullptr || twiddle == nullptr || bit_reverse == nullptr) {
+        return;
+    }
+
+    for (uint16_t k = 0; k < half_size; k++) {
+        const float angle = -2 * M_PI * k / window_size;
+        twiddle[k] = complexf(cosf(angle), sinf(angle));
+    }
+
+    uint16_t bits = 0;
+    while ((1U << bits) < half_size) {
+        bits++;
+    }
+    for (uint16_t k = 0; k < half_size; k++) {
+        uint16_t kr = 0;
+        for (uint16_t i = 0; i < bits; i++) {
+            kr = (kr << 1) | ((k >> i) & 1);
+        }
+        bit_reverse[k] = kr;
+    }
+}
+
+SoftwareDSP::FFTWindowStateSoftware::~FFTWindowStateSoftware()
+{
+    delete[] buf;
+    delete[] twiddle;
+    delete[] bit_reverse;
+}
+
+// step 1: filter the incoming samples through a Hanning window
+void SoftwareDSP::step_hanning(FFTWindowStateSoftware* fft, FloatBuffer& samples, uint16_t advance)
+{
+    // 5us
+    // apply hanning window to gyro samples and store result in _freq_bins
+    // hanning starts and ends with 0, could be skipped for minor speed improvement
+    uint32_t read_window = samples.peek(&fft->_freq_bins[0], fft->_window_size);
+    if (read_window != fft->_window_size) {
+        return;
+    }
+    samples.advance(advance);
+    mult_f32(&fft->_freq_bins[0], &fft->_hanning_window[0], &fft->_freq_bins[0], fft->_window_size);
+}
+
+// step 2: perform an FFT on the windowed data
+// the real input is packed into a complex FFT of half the window size, whose output is
+// then split into the spectrum of the real input, see https://www.robinscheibler.org/2013/02/13/real-fft.html
+void SoftwareDSP::step_fft(FFTWindowStateSoftware* fft)
+{
+    const uint16_t half_size = fft->_bin_count;
+
+    // even samples are the real part and odd samples the imaginary part
+    for (uint16_t i = 0; i < half_size; i++) {
+        fft->buf[i] = complexf(fft->_freq_bins[2*i], fft->_freq_bins[2*i+1]);
+    }
+
+    // the twiddle factors of the half size FFT are every other twiddle factor of the full size
+    calculate_fft(fft->buf, half_size, fft->twiddle, 2, fft->bit_reverse);
+
+    // DC and nyquist components are real only
+    const complexf z0 = fft->buf[0];
+    fft->_rfft_data[0] = z0.real() + z0.imag();
+    fft->_rfft_data[1] = 0;
+    fft->_rfft_data[half_size*2] = z0.real() - z0.imag();
+    fft->_rfft_data[half_size*2+1] = 0;
+
+    for (uint16_t k = 1; k < half_size; k++) {
+        const complexf zk = fft->buf[k];
+        const complexf zc = std::conj(fft->buf[half_size - k]);
+        // spectra of the even and odd samples
+        const complexf even = (zk + zc) * 0.5f;
+        const complexf odd = (zk - zc) * complexf(0, -0.5f);
+        const complexf x = even + fft->twiddle[k] * odd;
+        fft->_rfft_data[2*k] = x.real();
+        fft->_rfft_data[2*k+1] = x.imag();
+    }
+
+    for (uint16_t i = 0; i < half_size; i++) {
+        fft->_freq_bins[i] = sq(fft->_rfft_data[2*i]) + sq(fft->_rfft_data[2*i+1]);
+    }
+}
+
+void SoftwareDSP::mult_f32(const float* v1, const float* v2, float* vout, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++) {
+        vout[i] = v1[i] * v2[i];
+    }
+}
+
+void SoftwareDSP::vector_max_float(const float* vin, uint16_t len, float* maxValue, uint16_t* maxIndex) const
+{
+    *maxValue = vin[0];
+    *maxIndex = 0;
+    for (uint16_t i = 1; i < len; i++) {
+        if (vin[i] > *maxValue) {
+            *maxValue = vin[i];
+            *maxIndex = i;
+        }
+    }
+}
+
+void SoftwareDSP::vector_scale_float(const float* vin, float scale, float* vout, uint16_t len) const
+{
+    for (uint16_t i = 0; i < len; i++) {
+        vout[i] = vin[i] * scale;
+    }
+}
+
+void SoftwareDSP::vector_add_float(const float* vin1, const float* vin2, float* vout, uint16_t len) const
+{
+    for (uint16_t i = 0; i < len; i++) {
+        vout[i] = vin1[i] + vin2[i];
+    }
+}
+
+float SoftwareDSP::vector_mean_float(const float* vin, uint16_t len) const
+{
+    float mean_value = 0.0f;
+    for (uint16_t i = 0; i < len; i++) {
+        mean_value += vin[i];
+    }
+    mean_value /= len;
+    return mean_value;
+}
+
+// calculate the in-place FFT of the input using the Cooley–Tukey algorithm, with precalculated
+// twiddle factors exp(-2*pi*i*k/fftlen) at twiddle[k*twiddle_stride] and bit reversed addresses
+void SoftwareDSP::calculate_fft(complexf *samples, uint16_t fftlen, const complexf* twiddle, uint16_t twiddle_stride, const uint16_t* bit_reverse)
+{
+    // shuffle data using bit reversed addressing
+    for (uint16_t k = 0; k < fftlen; k++) {
+        const uint16_t kr = bit_reverse[k];
+        if (kr > k) {
+            complexf t = samples[kr];
+            samples[kr] = samples[k];
+            samples[k] = t;
+        }
+    }
+
+    // do fft butterflys in place
+    for (uint16_t istep = 2; istep <= fftlen; istep <<= 1) { // layers 2,4,8,16, ... ,n
+        const uint16_t is2 = istep / 2;
+        const uint16_t astep = (fftlen / istep) * twiddle_stride;
+        for (uint16_t ki = 0; ki < fftlen; ki += istep) {
+            complexf* top = &samples[ki];
+            complexf* bottom = &samples[ki + is2];
+            for (uint16_t km = 0; km < is2; km++) {
+                const complexf t = twiddle[km * astep] * bottom[km];
+                const complexf q = top[km];
+                bottom[km] = q - t;
+                top[km] = q + t;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Code by Andy Piper
+ */
+#pragma once
+
+#include <AP_HAL/AP_HAL.h>
+
+// the software FFT is used by the HALs without DSP instructions
+#ifndef HAL_WITH_SOFTWARE_DSP
+#define HAL_WITH_SOFTWARE_DSP (HAL_WITH_DSP && (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX))
+#endif
+
+#if HAL_WITH_SOFTWARE_DSP
+
+#include <complex>
+
+typedef std::complex<float> complexf;
+
+// software implementation of FFT analysis, using a real FFT calculated
+// with a complex FFT of half the window size
+class SoftwareDSP : public AP_HAL::DSP {
+public:
+    // initialise an FFT instance
+    virtual FFTWindowState* fft_init(uint16_t window_size, uint16_t sample_rate, uint8_t sliding_window_size) override;
+    // start an FFT analysis with an ObjectBuffer
+    virtual void fft_start(FFTWindowState* state, FloatBuffer& samples, uint16_t advance) override;
+    // perform remaining steps of an FFT analysis
+    virtual uint16_t fft_analyse(FFTWindowState* state, uint16_t start_bin, uint16_t end_bin, float noise_att_cutoff) override;
+
+    // software FFT state
+    class FFTWindowStateSoftware : public AP_HAL::DSP::FFTWindowState {
+        friend class SoftwareDSP;
+
+    public:
+        FFTWindowStateSoftware(uint16_t window_size, uint16_t sample_rate, uint8_t sliding_window_size);
+        virtual ~FFTWindowStateSoftware();
+
+    private:
+        // packed real data and complex FFT of half the window size
+        complexf* buf;
+        // exp(-2*pi*i*k/window_size) for k < window_size/2
+        complexf* twiddle;
+        // bit reversed index for each element of buf
+        uint16_t* bit_reverse;
+    };
+
+private:
+    void step_hanning(FFTWindowStateSoftware* fft, FloatBuffer& samples, uint16_t advance);
+    void step_fft(FFTWindowStateSoftware* fft);
+    void mult_f32(const float* v1, const float* v2, float* vout, uint16_t len);
+    void vector_max_float(const float* vin, uint16_t len, float* maxValue, uint16_t* maxIndex) const override;
+    void vector_scale_float(const float* vin, float scale, float* vout, uint16_t len) const override;
+    float vector_mean_float(const float* vin, uint16_t len) const override;
+    void vector_add_float(const float* vin1, const float* vin2, float* vout, uint16_t len) const override;
+    void calculate_fft(complexf* f, uint16_t length, const complexf* twiddle, uint16_t twiddle_stride, const uint16_t* bit_reverse);
+};
+
+#endif
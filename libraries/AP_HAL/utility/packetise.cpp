@@ -8,6 +8,46 @@
 
 #include "packetise.h"
 
+/*
+  return the length of the complete MAVLink packet starting ofs bytes
+  into the buffer, given n bytes are available there. Returns 0 if
+  the packet isn't complete yet and -1 if there is no MAVLink packet
+  start at ofs
+ */
+static int16_t mavlink_packet_length(ByteBuffer &writebuf, uint16_t ofs, uint16_t n)
+{
+    const int16_t b = writebuf.peek(ofs);
+    if (b != MAVLINK_STX_MAVLINK1 && b != MAVLINK_STX) {
+        return -1;
+    }
+
+    // cope with both MAVLink1 and MAVLink2 packets
+    uint8_t min_length = (b == MAVLINK_STX_MAVLINK1)?8:12;
+
+    // this looks like a MAVLink packet - try to write on
+    // packet boundaries when possible
+    if (n < min_length) {
+        // we need to wait for more data to arrive
+        return 0;
+    }
+
+    // the length of the packet is the 2nd byte
+    int16_t len = writebuf.peek(ofs+1);
+    if (b == MAVLINK_STX) {
+        // This is Mavlink2. Check for signed packet with extra 13 bytes
+        int16_t incompat_flags = writebuf.peek(ofs+2);
+        if (incompat_flags & MAVLINK_IFLAG_SIGNED) {
+            min_length += MAVLINK_SIGNATURE_BLOCK_LEN;
+        }
+    }
+
+    if (n < len+min_length) {
+        // we don't have a full packet yet
+        return 0;
+    }
+    return len+min_length;
+}
+
 /*
   return the number of bytes to send for a packetised connection
  */
@@ -36,36 +76,33 @@ uint16_t mavlink_packetise(ByteBuffer &writebuf, uint16_t n)
         return n;
     }
 
-    // cope with both MAVLink1 and MAVLink2 packets
-    uint8_t min_length = (b == MAVLINK_STX_MAVLINK1)?8:12;
+    // send just 1 packet at a time (so MAVLink packets are aligned on
+    // UDP boundaries)
+    return mavlink_packet_length(writebuf, 0, n);
+}
 
-    // this looks like a MAVLink packet - try to write on
-    // packet boundaries when possible
-    if (n < min_length) {
-        // we need to wait for more data to arrive
-        return 0;
+/*
+  return the number of bytes to send for a packetised connection,
+  packing as many complete MAVLink packets as fit in n bytes into a
+  single datagram
+ */
+uint16_t mavlink_packetise_multi(ByteBuffer &writebuf, uint16_t n)
+{
+    uint16_t ret = mavlink_packetise(writebuf, n);
+    const int16_t b = writebuf.peek(0);
+    if (ret == 0 || (b != MAVLINK_STX_MAVLINK1 && b != MAVLINK_STX)) {
+        // nothing complete to send, or non-MAVLink data
+        return ret;
     }
-
-    // the length of the packet is the 2nd byte
-    int16_t len = writebuf.peek(1);
-    if (b == MAVLINK_STX) {
-        // This is Mavlink2. Check for signed packet with extra 13 bytes
-        int16_t incompat_flags = writebuf.peek(2);
-        if (incompat_flags & MAVLINK_IFLAG_SIGNED) {
-            min_length += MAVLINK_SIGNATURE_BLOCK_LEN;
+    while (ret < n) {
+        const int16_t len = mavlink_packet_length(writebuf, ret, n - ret);
+        if (len <= 0) {
+            // incomplete packet or non-MAVLink data; send that separately
+            break;
         }
+        ret += len;
     }
-
-    if (n < len+min_length) {
-        // we don't have a full packet yet
-        return 0;
-    }
-    if (n > len+min_length) {
-        // send just 1 packet at a time (so MAVLink packets
-        // are aligned on UDP boundaries)
-        n = len+min_length;
-    }
-    return n;
+    return ret;
 }
 
 #endif // HAL_GCS_ENABLED
@@ -5,3 +5,9 @@
 */
 uint16_t mavlink_packetise(ByteBuffer &writebuf, uint16_t n);
 
+
+/*
+  return the number of bytes to send for a packetised connection,
+  packing as many complete MAVLink packets as fit in n bytes
+*/
+uint16_t mavlink_packetise_multi(ByteBuffer &writebuf, uint16_t n);
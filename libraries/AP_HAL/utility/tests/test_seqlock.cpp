@@ -0,0 +1,76 @@
+#include <AP_gtest.h>
+
+#include <thread>
+#include <AP_HAL/utility/SeqLock.h>
+
+struct Sample {
+    uint32_t values[256];
+};
+
+TEST(SeqLockBufferTest, Basic)
+{
+    SeqLockBuffer<Sample> x;
+    Sample s {};
+
+    EXPECT_FALSE(x.read(s));
+    EXPECT_EQ(x.get_sequence(), 0U);
+
+    for (uint32_t i=1; i<5; i++) {
+        for (auto &v : s.values) {
+            v = i;
+        }
+        x.write(s);
+        Sample r {};
+        EXPECT_TRUE(x.read(r));
+        EXPECT_EQ(x.get_sequence(), i);
+        for (const auto &v : r.values) {
+            EXPECT_EQ(v, i);
+        }
+    }
+}
+
+// readers racing a writer must never see a mix of two values
+TEST(SeqLockBufferTest, NoTornReads)
+{
+    SeqLockBuffer<Sample> x;
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> torn{0};
+
+    auto reader = [&]() {
+        uint32_t last = 0;
+        while (!done) {
+            Sample r;
+            if (!x.read(r)) {
+                continue;
+            }
+            for (const auto &v : r.values) {
+                if (v != r.values[0]) {
+                    torn++;
+                    break;
+                }
+            }
+            // values are published in increasing order
+            if (r.values[0] < last) {
+                torn++;
+            }
+            last = r.values[0];
+        }
+    };
+
+    std::thread r1(reader);
+    std::thread r2(reader);
+    Sample s;
+    for (uint32_t i=1; i<1000000; i++) {
+        for (auto &v : s.values) {
+            v = i;
+        }
+        x.write(s);
+    }
+    done = true;
+    r1.join();
+    r2.join();
+
+    EXPECT_EQ(torn, 0U);
+}
+
+AP_GTEST_MAIN()
@@ -46,6 +46,7 @@
 #include "Util.h"
 #include "Util_RPI.h"
 #include "CANSocketIface.h"
+#include "DSP.h"
 
 using namespace Linux;
 
@@ -252,7 +253,7 @@ static Empty::OpticalFlow opticalFlow;
 #endif
 
 #if HAL_WITH_DSP
-static Empty::DSP dspDriver;
+static DSP dspDriver;
 #endif
 static Empty::Flash flashDriver;
 static Empty::WSPIDeviceManager wspi_mgr_instance;
@@ -23,4 +23,10 @@ public:
 
     /* Depends on lower level to implement, most devices are fine with defaults */
     virtual void set_parity(int v) { }
+
+    /*
+     * File descriptor which becomes readable when data arrives, so reads can
+     * be driven by epoll. -1 if the device has to be polled.
+     */
+    virtual int get_read_fd() const { return -1; }
 };
@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
@@ -31,8 +32,13 @@
 
 extern const AP_HAL::HAL& hal;
 
+// same priority as the UART thread which used to do all the reads
+#define APM_LINUX_UART_RX_PRIORITY 14
+
 using namespace Linux;
 
+PollerThread *UARTDriver::_rx_thread;
+
 UARTDriver::UARTDriver(bool default_console) :
     _device{new ConsoleDevice()}
 {
@@ -89,14 +95,86 @@ void UARTDriver::_begin(uint32_t b, uint16_t rxS, uint16_t txS)
         _baudrate = b;
     }
 
-    _allocate_buffers(rxS, txS);
+    {
+        // the rx thread may be part way through filling _readbuf
+        WITH_SEMAPHORE(_read_mutex);
+
+        _allocate_buffers(rxS, txS);
+
+        if (clear_buffers) {
+            _readbuf.clear();
+            _writebuf.clear();
+        }
+    }
 
-    if (clear_buffers) {
-        _readbuf.clear();
-        _writebuf.clear();
+    if (_connected) {
+        _register_rx_pollable();
     }
 }
 
+/*
+  arrange for the device to be read from the shared rx thread whenever
+  it has data, if it has a file descriptor we can wait on
+ */
+void UARTDriver::_register_rx_pollable()
+{
+    if (_rx_pollable != nullptr && _rx_pollable->get_fd() >= 0) {
+        // already registered
+        return;
+    }
+    const int fd = _device->get_read_fd();
+    if (fd < 0) {
+        return;
+    }
+
+    static Linux::Semaphore rx_thread_sem;
+    WITH_SEMAPHORE(rx_thread_sem);
+
+    if (_rx_thread == nullptr) {
+        _rx_thread = new PollerThread();
+        if (_rx_thread == nullptr) {
+            return;
+        }
+        _rx_thread->start("ap-uart-rx", SCHED_FIFO, APM_LINUX_UART_RX_PRIORITY);
+    }
+    if (!_rx_thread->is_started()) {
+        return;
+    }
+
+    // the pollable is never freed as the rx thread may still hold a
+    // pointer to it from an earlier epoll_wait()
+    if (_rx_pollable == nullptr) {
+        _rx_pollable = new RxPollable(*this, fd);
+        if (_rx_pollable == nullptr) {
+            return;
+        }
+    } else {
+        _rx_pollable->set_fd(fd);
+    }
+
+    // edge-triggered: _fill_read_buffer() reads until the device
+    // would block, which re-arms the event
+    if (!_rx_thread->register_pollable(_rx_pollable, EPOLLIN | EPOLLET)) {
+        _rx_pollable->set_fd(-1);
+        return;
+    }
+
+    // pick up anything which arrived before we were registered
+    _fill_read_buffer();
+}
+
+void UARTDriver::_unregister_rx_pollable()
+{
+    if (_rx_pollable == nullptr || _rx_pollable->get_fd() < 0) {
+        return;
+    }
+    _rx_thread->unregister_pollable(_rx_pollable);
+    _rx_pollable->set_fd(-1);
+
+    // wait for the rx thread to finish any read in progress
+    WITH_SEMAPHORE(_read_mutex);
+}
+
 void UARTDriver::_allocate_buffers(uint16_t rxS, uint16_t txS)
 {
     /* we have enough memory to have a larger transmit buffer for
@@ -214,6 +292,8 @@ void UARTDriver::_end()
         hal.scheduler->delay(1);
     }
 
+    _unregister_rx_pollable();
+
     _device->close();
     _deallocate_buffers();
 }
@@ -282,6 +362,24 @@ bool UARTDriver::_discard_input()
     return true;
 }
 
+/*
+  wait for at least n bytes of incoming data, with timeout in
+  milliseconds. Return true if n bytes are available, false if
+  timeout
+ */
+bool UARTDriver::wait_timeout(uint16_t n, uint32_t timeout_ms)
+{
+    const uint32_t start_ms = AP_HAL::millis();
+    while (_available() < n) {
+        const uint32_t elapsed_ms = AP_HAL::millis() - start_ms;
+        if (elapsed_ms >= timeout_ms) {
+            return false;
+        }
+        _rx_sem.wait((timeout_ms - elapsed_ms) * 1000UL);
+    }
+    return true;
+}
+
 /*
   write size bytes to the write buffer
  */
@@ -375,6 +473,59 @@ bool UARTDriver::_write_pending_bytes(void)
     return _writebuf.available() != available_bytes;
 }
 
+/*
+  read pending bytes from the device into the read buffer. Called from
+  the rx thread when the device becomes readable, or from the timer
+  tick for devices which have to be polled.
+ */
+void UARTDriver::_fill_read_buffer()
+{
+    WITH_SEMAPHORE(_read_mutex);
+
+    if (!_initialised) {
+        return;
+    }
+
+    bool got_data = false;
+    bool drained = false;
+    while (!drained) {
+        ByteBuffer::IoVec vec[2];
+        const auto n_vec = _readbuf.reserve(vec, _readbuf.space());
+        if (n_vec == 0) {
+            // no room; the timer tick will pick up the rest
+            break;
+        }
+        for (int i = 0; i < n_vec; i++) {
+            const int ret = _read_fd(vec[i].data, vec[i].len);
+            if (ret <= 0) {
+                drained = true;
+                break;
+            }
+            _readbuf.commit((unsigned)ret);
+            got_data = true;
+
+            // update receive timestamp
+            _receive_timestamp[_receive_timestamp_idx^1] = AP_HAL::micros64();
+            _receive_timestamp_idx ^= 1;
+
+            /*
+              a short read normally means the device is empty, which
+              is good enough when polling. When edge-triggered we must
+              read until it would block.
+             */
+            if ((unsigned)ret < vec[i].len && _rx_pollable == nullptr) {
+                drained = true;
+                break;
+            }
+        }
+    }
+    _rx_starved = !drained;
+
+    if (got_data) {
+        _rx_sem.signal();
+    }
+}
+
 /*
   push any pending bytes to/from the serial port. This is called at
   1kHz in the timer thread. Doing it this way reduces the system call
@@ -391,26 +542,15 @@ void UARTDriver::_timer_tick(void)
         num_send--;
     }
 
-    // try to fill the read buffer
-    int ret;
-    ByteBuffer::IoVec vec[2];
+    if (_connected && (_rx_pollable == nullptr || _rx_pollable->get_fd() < 0)) {
+        // the device may only just have connected
+        _register_rx_pollable();
+    }
 
-    const auto n_vec = _readbuf.reserve(vec, _readbuf.space());
-    for (int i = 0; i < n_vec; i++) {
-        ret = _read_fd(vec[i].data, vec[i].len);
-        if (ret < 0) {
-            break;
-        }
-        _readbuf.commit((unsigned)ret);
-
-        // update receive timestamp
-        _receive_timestamp[_receive_timestamp_idx^1] = AP_HAL::micros64();
-        _receive_timestamp_idx ^= 1;
-        
-        /* stop reading as we read less than we asked for */
-        if ((unsigned)ret < vec[i].len) {
-            break;
-        }
+    // reads normally happen on the rx thread as data arrives; poll
+    // devices without an fd, or if the read buffer filled up
+    if (_rx_pollable == nullptr || _rx_pollable->get_fd() < 0 || _rx_starved) {
+        _fill_read_buffer();
     }
 
     _in_timer = false;
@@ -4,6 +4,7 @@
 #include <AP_HAL/utility/RingBuffer.h>
 
 #include "AP_HAL_Linux.h"
+#include "PollerThread.h"
 #include "SerialDevice.h"
 #include "Semaphores.h"
 
@@ -58,6 +59,13 @@ public:
 
     uint32_t get_baud_rate() const override { return _baudrate; }
 
+    /*
+      wait for at least n bytes of incoming data, with timeout in
+      milliseconds. Return true if n bytes are available, false if
+      timeout
+     */
+    bool wait_timeout(uint16_t n, uint32_t timeout_ms) override;
+
 private:
     AP_HAL::OwnPtr<SerialDevice> _device;
     bool _console;
@@ -78,6 +86,33 @@ private:
     uint64_t _receive_timestamp[2];
     uint8_t _receive_timestamp_idx;
 
+    /*
+      devices with a file descriptor are read from a shared epoll
+      thread as soon as data arrives, rather than on the next UART
+      tick. The fd is owned by the SerialDevice.
+     */
+    class RxPollable : public Pollable {
+    public:
+        RxPollable(UARTDriver &uart, int fd) : Pollable(fd), _uart(uart) { }
+        ~RxPollable() { _fd = -1; }
+        void set_fd(int fd) { _fd = fd; }
+        void on_can_read() override { _uart._fill_read_buffer(); }
+    private:
+        UARTDriver &_uart;
+    };
+    RxPollable *_rx_pollable;
+    static PollerThread *_rx_thread;
+    void _register_rx_pollable();
+    void _unregister_rx_pollable();
+
+    // read from the device into _readbuf until it would block
+    void _fill_read_buffer();
+    Linux::Semaphore _read_mutex;
+    // set if _readbuf filled up with data still pending on the device
+    bool _rx_starved;
+    // signalled whenever data is added to _readbuf
+    Linux::BinarySemaphore _rx_sem;
+
 protected:
     const char *device_path;
     volatile bool _initialised;
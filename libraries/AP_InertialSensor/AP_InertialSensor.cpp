@@ -557,6 +557,12 @@ const AP_Param::GroupInfo AP_InertialSensor::var_info[] = {
     AP_SUBGROUPINFO(batchsampler, "_LOG_",  39, AP_InertialSensor, AP_InertialSensor::BatchSampler),
 #endif
 
+#if AP_INERTIALSENSOR_STREAMSAMPLER_ENABLED
+    // @Group: _STRM_
+    // @Path: ../AP_InertialSensor/StreamSampler.cpp
+    AP_SUBGROUPINFO(streamsampler, "_STRM_",  57, AP_InertialSensor, AP_InertialSensor::StreamSampler),
+#endif
+
     // @Param: _ENABLE_MASK
     // @DisplayName: IMU enable mask
     // @Description: Bitmask of IMUs to enable. It can be used to prevent startup of specific detected IMUs
@@ -962,6 +968,11 @@ AP_InertialSensor::init(uint16_t loop_rate)
     batchsampler.init();
 #endif
 
+#if AP_INERTIALSENSOR_STREAMSAMPLER_ENABLED
+    // initialise IMU sample streaming
+    streamsampler.init();
+#endif
+
 #if HAL_GYROFFT_ENABLED
     AP_GyroFFT* fft = AP::fft();
     bool fft_enabled = fft != nullptr && fft->enabled();
@@ -1002,10 +1013,12 @@ AP_InertialSensor::init(uint16_t loop_rate)
         if (!notch.params.enabled() && !fft_enabled) {
             continue;
         }
-        for (uint8_t i = 0; i < ARRAY_SIZE(notch.calculated_notch_freq_hz); i++) {
-            notch.calculated_notch_freq_hz[i] = notch.params.center_freq_hz();
+        for (uint8_t i = 0; i < INS_MAX_INSTANCES; i++) {
+            for (uint8_t j = 0; j < INS_MAX_NOTCHES; j++) {
+                notch.calculated_notch_freq_hz[i][j] = notch.params.center_freq_hz();
+            }
+            notch.num_calculated_notch_frequencies[i] = 1;
         }
-        notch.num_calculated_notch_frequencies = 1;
         notch.num_dynamic_notches = 1;
 #if APM_BUILD_COPTER_OR_HELI || APM_BUILD_TYPE(APM_BUILD_ArduPlane)
         if (notch.params.hasOption(HarmonicNotchFilterParams::Options::DynamicHarmonic)) {
@@ -1059,7 +1072,7 @@ AP_InertialSensor::init(uint16_t loop_rate)
                     notch.filter[i].allocate_filters(notch.num_dynamic_notches,
                                                      notch.params.harmonics(), double_notch ? 2 : triple_notch ? 3 : 1);
                     // initialise default settings, these will be subsequently changed in AP_InertialSensor_Backend::update_gyro()
-                    notch.filter[i].init(_gyro_raw_sample_rates[i], notch.calculated_notch_freq_hz[0],
+                    notch.filter[i].init(_gyro_raw_sample_rates[i], notch.calculated_notch_freq_hz[i][0],
                                          notch.params.bandwidth_hz(), notch.params.attenuation_dB());
                 }
             }
@@ -1331,6 +1344,9 @@ void AP_InertialSensor::periodic()
 #if AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
     batchsampler.periodic();
 #endif
+#if AP_INERTIALSENSOR_STREAMSAMPLER_ENABLED
+    streamsampler.periodic();
+#endif
 }
 
 
@@ -1783,7 +1799,7 @@ void AP_InertialSensor::_save_gyro_calibration()
  */
 void AP_InertialSensor::HarmonicNotch::update_params(uint8_t instance, bool converging, float gyro_rate)
 {
-    const float center_freq = calculated_notch_freq_hz[0];
+    const float center_freq = calculated_notch_freq_hz[instance][0];
     if (!is_equal(last_bandwidth_hz[instance], params.bandwidth_hz()) ||
         !is_equal(last_attenuation_dB[instance], params.attenuation_dB()) ||
         (params.tracking_mode() == HarmonicNotchDynamicMode::Fixed && !is_equal(last_center_freq_hz[instance], center_freq)) ||
@@ -1796,8 +1812,8 @@ void AP_InertialSensor::HarmonicNotch::update_params(uint8_t instance, bool conv
         last_bandwidth_hz[instance] = params.bandwidth_hz();
         last_attenuation_dB[instance] = params.attenuation_dB();
     } else if (params.tracking_mode() != HarmonicNotchDynamicMode::Fixed) {
-        if (num_calculated_notch_frequencies > 1) {
-            filter[instance].update(num_calculated_notch_frequencies, calculated_notch_freq_hz);
+        if (num_calculated_notch_frequencies[instance] > 1) {
+            filter[instance].update(num_calculated_notch_frequencies[instance], calculated_notch_freq_hz[instance]);
         } else {
             filter[instance].update(center_freq);
         }
@@ -2240,24 +2256,40 @@ void AP_InertialSensor::acal_update()
 
 // Update the harmonic notch frequency
 void AP_InertialSensor::HarmonicNotch::update_freq_hz(float scaled_freq)
+{
+    for (uint8_t i = 0; i < INS_MAX_INSTANCES; i++) {
+        update_freq_hz(i, scaled_freq);
+    }
+}
+
+// Update the harmonic notch frequency
+void AP_InertialSensor::HarmonicNotch::update_frequencies_hz(uint8_t num_freqs, const float scaled_freq[])
+{
+    for (uint8_t i = 0; i < INS_MAX_INSTANCES; i++) {
+        update_frequencies_hz(i, num_freqs, scaled_freq);
+    }
+}
+
+// Update the harmonic notch frequency of a single IMU
+void AP_InertialSensor::HarmonicNotch::update_freq_hz(uint8_t instance, float scaled_freq)
 {
     // protect against zero as the scaled frequency
     if (is_positive(scaled_freq)) {
-        calculated_notch_freq_hz[0] = scaled_freq;
+        calculated_notch_freq_hz[instance][0] = scaled_freq;
     }
-    num_calculated_notch_frequencies = 1;
+    num_calculated_notch_frequencies[instance] = 1;
 }
 
-// Update the harmonic notch frequency
-void AP_InertialSensor::HarmonicNotch::update_frequencies_hz(uint8_t num_freqs, const float scaled_freq[]) {
+// Update the harmonic notch frequencies of a single IMU
+void AP_InertialSensor::HarmonicNotch::update_frequencies_hz(uint8_t instance, uint8_t num_freqs, const float scaled_freq[]) {
     // protect against zero as the scaled frequency
     for (uint8_t i = 0; i < num_freqs; i++) {
         if (is_positive(scaled_freq[i])) {
-            calculated_notch_freq_hz[i] = scaled_freq[i];
+            calculated_notch_freq_hz[instance][i] = scaled_freq[i];
         }
     }
     // any uncalculated frequencies will float at the previous value or the initialized freq if none
-    num_calculated_notch_frequencies = num_freqs;
+    num_calculated_notch_frequencies[instance] = num_freqs;
 }
 
 // setup the notch for throttle based tracking, called from FFT based tuning
@@ -156,11 +156,12 @@ public:
 
     // FFT support access
 #if HAL_GYROFFT_ENABLED
-    const Vector3f& get_gyro_for_fft(void) const { return _gyro_for_fft[_primary_gyro]; }
+    const Vector3f& get_gyro_for_fft(void) const { return get_gyro_for_fft(_primary_gyro); }
+    const Vector3f& get_gyro_for_fft(uint8_t instance) const { return _gyro_for_fft[instance]; }
     FloatBuffer&  get_raw_gyro_window(uint8_t instance, uint8_t axis) { return _gyro_window[instance][axis]; }
     FloatBuffer&  get_raw_gyro_window(uint8_t axis) { return get_raw_gyro_window(_primary_gyro, axis); }
     uint16_t get_raw_gyro_rate_hz() const { return get_raw_gyro_rate_hz(_primary_gyro); }
-    uint16_t get_raw_gyro_rate_hz(uint8_t instance) const { return _gyro_raw_sample_rates[_primary_gyro]; }
+    uint16_t get_raw_gyro_rate_hz(uint8_t instance) const { return _gyro_raw_sample_rates[instance]; }
     bool has_fft_notch() const;
 #endif
     bool set_gyro_window_size(uint16_t size);
@@ -413,6 +414,78 @@ public:
     BatchSampler batchsampler{*this};
 #endif
 
+#if AP_INERTIALSENSOR_STREAMSAMPLER_ENABLED
+    /*
+      continuous export of full rate IMU samples over a serial or
+      network port for analysis on a companion computer
+     */
+    class StreamSampler {
+    public:
+        StreamSampler(const AP_InertialSensor &imu) :
+            _imu(imu) {
+            AP_Param::setup_object_defaults(this, var_info);
+        };
+
+        void init();
+        void sample(uint8_t instance, IMU_SENSOR_TYPE _type, uint64_t sample_us, const Vector3f &raw, const Vector3f &filtered) __RAMFUNC__;
+
+        // a function called by the main thread at the main loop rate:
+        void periodic();
+
+        bool enabled() const { return _sensor_mask > 0; }
+
+        // class level parameters
+        static const struct AP_Param::GroupInfo var_info[];
+
+        // Parameters
+        AP_Int8 _sensor_mask;
+        AP_Int8 _options;
+
+    private:
+
+        enum stream_opt_t {
+            STREAM_OPT_GYRO = (1<<0),
+            STREAM_OPT_ACCEL = (1<<1),
+            STREAM_OPT_POST_FILTER = (1<<2),
+        };
+
+        bool has_option(stream_opt_t option) const { return _options & uint8_t(option); }
+
+        static const uint8_t FRAME_SAMPLES = 16;
+
+        // frame sent on the port, little-endian
+        struct PACKED frame_t {
+            uint16_t magic;
+            uint16_t length;
+            uint8_t instance;
+            uint8_t type;           // IMU_SENSOR_TYPE
+            uint8_t post_filter;
+            uint16_t seqnum;        // per sensor, a gap means frames were dropped
+            uint64_t timestamp_us;  // time of the first sample
+            float sample_rate_hz;
+            uint16_t multiplier;    // samples are in SI units times this
+            int16_t data[FRAME_SAMPLES][3];
+            uint16_t crc;           // crc_xmodem of the preceding bytes
+        };
+
+        // the frame being filled by the backend thread and the
+        // completed frames waiting to be sent by the main thread
+        struct channel_t {
+            frame_t frame;
+            uint8_t count;
+            ObjectBuffer<frame_t> *queue;
+        };
+
+        bool add_channel(uint8_t instance, IMU_SENSOR_TYPE type);
+
+        channel_t *channels[INS_MAX_INSTANCES][2];
+        AP_HAL::UARTDriver *port;
+
+        const AP_InertialSensor &_imu;
+    };
+    StreamSampler streamsampler{*this};
+#endif
+
 #if HAL_EXTERNAL_AHRS_ENABLED
     // handle external AHRS data
     void handle_external(const AP_ExternalAHRS::ins_data_message_t &pkt);
@@ -438,9 +511,9 @@ public:
 
         uint8_t num_dynamic_notches;
 
-        // the current center frequency for the notch
-        float calculated_notch_freq_hz[INS_MAX_NOTCHES];
-        uint8_t num_calculated_notch_frequencies;
+        // the current center frequencies for the notch of each IMU
+        float calculated_notch_freq_hz[INS_MAX_INSTANCES][INS_MAX_NOTCHES];
+        uint8_t num_calculated_notch_frequencies[INS_MAX_INSTANCES];
 
         // Update the harmonic notch frequency
         void update_notch_freq_hz(float scaled_freq);
@@ -455,6 +528,10 @@ public:
         void update_freq_hz(float scaled_freq);
         void update_frequencies_hz(uint8_t num_freqs, const float scaled_freq[]);
 
+        // Update the harmonic notch frequencies of a single IMU
+        void update_freq_hz(uint8_t instance, float scaled_freq);
+        void update_frequencies_hz(uint8_t instance, uint8_t num_freqs, const float scaled_freq[]);
+
         // enable/disable the notch
         void set_inactive(bool _inactive) {
             inactive = _inactive;
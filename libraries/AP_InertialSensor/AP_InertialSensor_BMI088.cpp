@@ -345,12 +345,7 @@ void AP_InertialSensor_BMI088::read_fifo_accel(void)
                 int16_t(uint16_t(d[0] | (d[1]<<8))),
                 int16_t(uint16_t(d[2] | (d[3]<<8))),
                 int16_t(uint16_t(d[4] | (d[5]<<8)))};
-            Vector3f accel(xyz[0], xyz[1], xyz[2]);
-
-            accel *= scale;
-
-            _rotate_and_correct_accel(accel_instance, accel);
-            _notify_new_accel_raw_sample(accel_instance, accel);
+            _add_accel_raw_sample(accel_instance, accel_block, Vector3f(xyz[0], xyz[1], xyz[2]), scale);
             break;
         }
         case 0x40:
@@ -374,6 +369,8 @@ void AP_InertialSensor_BMI088::read_fifo_accel(void)
         fifo_length -= frame_len;
     }
 
+    _flush_accel_raw_samples(accel_instance, accel_block, scale);
+
     if (temperature_counter++ == 100) {
         temperature_counter = 0;
         uint8_t tbuf[2];
@@ -426,16 +423,15 @@ void AP_InertialSensor_BMI088::read_fifo_gyro(void)
         goto check_next;
     }
 
-    // data is 16 bits with 2000dps range
-    for (uint8_t i = 0; i < num_frames; i++) {
-        if (data[i] == bad_frame) {
-            continue;
+    {
+        // data is 16 bits with 2000dps range
+        for (uint8_t i = 0; i < num_frames; i++) {
+            if (data[i] == bad_frame) {
+                continue;
+            }
+            _add_gyro_raw_sample(gyro_instance, gyro_block, Vector3f(data[i].x, data[i].y, data[i].z), scale);
         }
-        Vector3f gyro(data[i].x, data[i].y, data[i].z);
-        gyro *= scale;
-
-        _rotate_and_correct_gyro(gyro_instance, gyro);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
+        _flush_gyro_raw_samples(gyro_instance, gyro_block, scale);
     }
 
 check_next:
@@ -81,6 +81,10 @@ private:
 
     uint8_t accel_instance;
     uint8_t gyro_instance;
+
+    // samples from the FIFOs being passed to the frontend
+    FIFOBlock accel_block;
+    FIFOBlock gyro_block;
     enum Rotation rotation;
     uint8_t temperature_counter;
     enum DevTypes _accel_devtype;
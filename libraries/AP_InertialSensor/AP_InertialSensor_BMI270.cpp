@@ -368,6 +368,18 @@ void AP_InertialSensor_BMI270::fifo_reset()
     notify_gyro_fifo_reset(_gyro_instance);
 }
 
+/*
+  the x, y and z values of an accel or gyro fifo frame
+ */
+static Vector3f parse_fifo_frame(const uint8_t* d)
+{
+    int16_t xyz[3] {
+        int16_t(uint16_t(d[0] | (d[1]<<8))),
+        int16_t(uint16_t(d[2] | (d[3]<<8))),
+        int16_t(uint16_t(d[4] | (d[5]<<8)))};
+    return Vector3f(xyz[0], xyz[1], xyz[2]);
+}
+
 /*
   read fifo
  */
@@ -412,8 +424,14 @@ void AP_InertialSensor_BMI270::read_fifo(void)
     // this means that we rarely run read_fifo() without updating the sensor data
     _dev->adjust_periodic_callback(periodic_handle, BACKEND_PERIOD_US);
 
+    // accel is configured for 16g range, gyro data is 16 bits with 2000dps range
+    const float accel_scale = (1.0/32768.0) * GRAVITY_MSS * 16.0;
+    const float gyro_scale = radians(2000.0f) / 32767.0f;
+
+    bool need_reset = false;
+
     const uint8_t *p = &data[0];
-    while (fifo_length >= 12) {
+    while (fifo_length >= 12 && !need_reset) {
         /*
           the fifo frames are variable length, with the frame type in the first byte
          */
@@ -421,16 +439,16 @@ void AP_InertialSensor_BMI270::read_fifo(void)
         switch (p[0] & 0xFC) {
         case 0x84: // accel
             frame_len = 7;
-            parse_accel_frame(p+1);
+            _add_accel_raw_sample(_accel_instance, _accel_block, parse_fifo_frame(p+1), accel_scale);
             break;
         case 0x88: // gyro
             frame_len = 7;
-            parse_gyro_frame(p+1);
+            _add_gyro_raw_sample(_gyro_instance, _gyro_block, parse_fifo_frame(p+1), gyro_scale);
             break;
         case 0x8C: // accel + gyro
             frame_len = 13;
-            parse_gyro_frame(p+1);
-            parse_accel_frame(p+7);
+            _add_gyro_raw_sample(_gyro_instance, _gyro_block, parse_fifo_frame(p+1), gyro_scale);
+            _add_accel_raw_sample(_accel_instance, _accel_block, parse_fifo_frame(p+7), accel_scale);
             break;
         case 0x40:
             // skip frame
@@ -450,13 +468,21 @@ void AP_InertialSensor_BMI270::read_fifo(void)
             break;
         case 0x80:
             // invalid frame
-            fifo_reset();
-            return;
+            need_reset = true;
+            break;
         }
         p += frame_len;
         fifo_length -= frame_len;
     }
 
+    _flush_accel_raw_samples(_accel_instance, _accel_block, accel_scale);
+    _flush_gyro_raw_samples(_gyro_instance, _gyro_block, gyro_scale);
+
+    if (need_reset) {
+        fifo_reset();
+        return;
+    }
+
     // temperature sensor updated every 10ms
     if (temperature_counter++ == 100) {
         temperature_counter = 0;
@@ -475,37 +501,6 @@ void AP_InertialSensor_BMI270::read_fifo(void)
     }
 }
 
-void AP_InertialSensor_BMI270::parse_accel_frame(const uint8_t* d)
-{
-    // assume configured for 16g range
-    const float scale = (1.0/32768.0) * GRAVITY_MSS * 16.0;
-    int16_t xyz[3] {
-        int16_t(uint16_t(d[0] | (d[1]<<8))),
-        int16_t(uint16_t(d[2] | (d[3]<<8))),
-        int16_t(uint16_t(d[4] | (d[5]<<8)))};
-    Vector3f accel(xyz[0], xyz[1], xyz[2]);
-
-    accel *= scale;
-
-    _rotate_and_correct_accel(_accel_instance, accel);
-    _notify_new_accel_raw_sample(_accel_instance, accel);
-}
-
-void AP_InertialSensor_BMI270::parse_gyro_frame(const uint8_t* d)
-{
-    // data is 16 bits with 2000dps range
-    const float scale = radians(2000.0f) / 32767.0f;
-    int16_t xyz[3] {
-        int16_t(uint16_t(d[0] | d[1]<<8)),
-        int16_t(uint16_t(d[2] | d[3]<<8)),
-        int16_t(uint16_t(d[4] | d[5]<<8)) };
-    Vector3f gyro(xyz[0], xyz[1], xyz[2]);
-    gyro *= scale;
-
-    _rotate_and_correct_gyro(_gyro_instance, gyro);
-    _notify_new_gyro_raw_sample(_gyro_instance, gyro);
-}
-
 bool AP_InertialSensor_BMI270::hardware_init()
 {
     bool init = false;
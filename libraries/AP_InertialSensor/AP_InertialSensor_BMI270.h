@@ -107,8 +107,6 @@ private:
      * Read samples from fifo.
      */
     void read_fifo();
-    void parse_accel_frame(const uint8_t* d);
-    void parse_gyro_frame(const uint8_t* d);
 
     AP_HAL::OwnPtr<AP_HAL::Device> _dev;
     AP_HAL::Device::PeriodicHandle periodic_handle;
@@ -117,6 +115,10 @@ private:
 
     uint8_t _accel_instance;
     uint8_t _gyro_instance;
+
+    // samples from the FIFO being passed to the frontend
+    FIFOBlock _accel_block;
+    FIFOBlock _gyro_block;
     uint8_t temperature_counter;
 
     static const uint8_t maximum_fifo_config_file[];
@@ -61,14 +61,14 @@ void AP_InertialSensor_Backend::_set_gyro_oversampling(uint8_t instance, uint8_t
   sensor may vary slightly from the system clock. This slowly adjusts
   the rate to the observed rate
 */
-void AP_InertialSensor_Backend::_update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz) const
+void AP_InertialSensor_Backend::_update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz, uint8_t n_samples) const
 {
     uint32_t now = AP_HAL::micros();
     if (start_us == 0) {
-        count = 0;
+        count = n_samples - 1;
         start_us = now;
     } else {
-        count++;
+        count += n_samples;
         if (now - start_us > 1000000UL) {
             float observed_rate_hz = count * 1.0e6f / (now - start_us);
 #if 0
@@ -159,6 +159,100 @@ void AP_InertialSensor_Backend::_rotate_and_correct_gyro(uint8_t instance, Vecto
     gyro.rotate(_imu._board_orientation);
 }
 
+/*
+  the same corrections as _rotate_and_correct_accel() for a block of
+  samples. The temperature correction only depends on the temperature,
+  so it is combined with the offsets
+ */
+void AP_InertialSensor_Backend::_rotate_and_correct_accel(uint8_t instance, Vector3f samples[], uint8_t n_samples, float scale)
+{
+    const enum Rotation sensor_rotation = _imu._accel_orientation[instance];
+    const enum Rotation board_rotation = _imu._board_orientation;
+
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    const float temperature = _imu.get_temperature(instance);
+#endif
+
+    const bool correct = !_imu._calibrating_accel && (_imu._acal == nullptr
+#if HAL_INS_ACCELCAL_ENABLED
+        || !_imu._acal->running()
+#endif
+    );
+
+    Vector3f offset;
+    Vector3f accel_scale { 1, 1, 1 };
+    if (correct) {
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+        _imu.tcal(instance).correct_accel(temperature, _imu.caltemp_accel(instance), offset);
+#endif
+        offset = _imu._accel_offset(instance).get() - offset;
+        accel_scale = _imu._accel_scale(instance).get();
+    }
+
+    for (uint8_t i = 0; i < n_samples; i++) {
+        Vector3f &accel = samples[i];
+        accel *= scale;
+        accel.rotate(sensor_rotation);
+
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+        if (_imu.tcal_learning) {
+            _imu.tcal(instance).update_accel_learning(accel, temperature);
+        }
+#endif
+
+        if (correct) {
+            accel -= offset;
+            accel.x *= accel_scale.x;
+            accel.y *= accel_scale.y;
+            accel.z *= accel_scale.z;
+        }
+
+        accel.rotate(board_rotation);
+    }
+}
+
+/*
+  the same corrections as _rotate_and_correct_gyro() for a block of
+  samples
+ */
+void AP_InertialSensor_Backend::_rotate_and_correct_gyro(uint8_t instance, Vector3f samples[], uint8_t n_samples, float scale)
+{
+    const enum Rotation sensor_rotation = _imu._gyro_orientation[instance];
+    const enum Rotation board_rotation = _imu._board_orientation;
+
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    const float temperature = _imu.get_temperature(instance);
+#endif
+
+    const bool correct = !_imu._calibrating_gyro;
+
+    Vector3f offset;
+    if (correct) {
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+        _imu.tcal(instance).correct_gyro(temperature, _imu.caltemp_gyro(instance), offset);
+#endif
+        offset = _imu._gyro_offset(instance).get() - offset;
+    }
+
+    for (uint8_t i = 0; i < n_samples; i++) {
+        Vector3f &gyro = samples[i];
+        gyro *= scale;
+        gyro.rotate(sensor_rotation);
+
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+        if (_imu.tcal_learning) {
+            _imu.tcal(instance).update_gyro_learning(gyro, temperature);
+        }
+#endif
+
+        if (correct) {
+            gyro -= offset;
+        }
+
+        gyro.rotate(board_rotation);
+    }
+}
+
 /*
   rotate gyro vector and add the gyro offset
  */
@@ -208,10 +302,22 @@ void AP_InertialSensor_Backend::save_gyro_window(const uint8_t instance, const V
  */
 void AP_InertialSensor_Backend::apply_gyro_filters(const uint8_t instance, const Vector3f &gyro)
 {
-    uint8_t filter_phase = 0;
-    save_gyro_window(instance, gyro, filter_phase++);
+    Vector3f gyro_filtered;
+    apply_gyro_filters(instance, &gyro, &gyro_filtered, 1);
+}
 
-    Vector3f gyro_filtered = gyro;
+/*
+  apply harmonic notch and low pass gyro filters to a block of samples,
+  running each filter over the whole block before the next
+ */
+void AP_InertialSensor_Backend::apply_gyro_filters(const uint8_t instance, const Vector3f gyro[], Vector3f filtered[], uint8_t n_samples)
+{
+    uint8_t filter_phase = 0;
+    for (uint8_t i = 0; i < n_samples; i++) {
+        save_gyro_window(instance, gyro[i], filter_phase);
+        filtered[i] = gyro[i];
+    }
+    filter_phase++;
 
     // apply the harmonic notch filters
     for (auto &notch : _imu.harmonic_notches) {
@@ -233,16 +339,25 @@ void AP_InertialSensor_Backend::apply_gyro_filters(const uint8_t instance, const
             // will be the first input sample
             notch.filter[instance].reset();
         } else {
-            gyro_filtered = notch.filter[instance].apply(gyro_filtered);
+            for (uint8_t i = 0; i < n_samples; i++) {
+                filtered[i] = notch.filter[instance].apply(filtered[i]);
+            }
+        }
+        for (uint8_t i = 0; i < n_samples; i++) {
+            save_gyro_window(instance, filtered[i], filter_phase);
         }
-        save_gyro_window(instance, gyro_filtered, filter_phase++);
+        filter_phase++;
     }
 
     // apply the low pass filter last to attenuate any notch induced noise
-    gyro_filtered = _imu._gyro_filter[instance].apply(gyro_filtered);
+    bool failed = false;
+    for (uint8_t i = 0; i < n_samples; i++) {
+        filtered[i] = _imu._gyro_filter[instance].apply(filtered[i]);
+        failed |= filtered[i].is_nan() || filtered[i].is_inf();
+    }
 
     // if the filtering failed in any way then reset the filters and keep the old value
-    if (gyro_filtered.is_nan() || gyro_filtered.is_inf()) {
+    if (failed) {
         _imu._gyro_filter[instance].reset();
 #if HAL_GYROFFT_ENABLED
         _imu._post_filter_gyro_filter[instance].reset();
@@ -250,8 +365,11 @@ void AP_InertialSensor_Backend::apply_gyro_filters(const uint8_t instance, const
         for (auto &notch : _imu.harmonic_notches) {
             notch.filter[instance].reset();
         }
+        for (uint8_t i = 0; i < n_samples; i++) {
+            filtered[i] = _imu._gyro_filtered[instance];
+        }
     } else {
-        _imu._gyro_filtered[instance] = gyro_filtered;
+        _imu._gyro_filtered[instance] = filtered[n_samples-1];
     }
 }
 
@@ -434,8 +552,117 @@ void AP_InertialSensor_Backend::_notify_new_delta_angle(uint8_t instance, const
     log_gyro_raw(instance, sample_us, gyro, _imu._gyro_filtered[instance]);
 }
 
+/*
+  handle a block of gyro samples from a FIFO based sensor. This does the
+  same work as _notify_new_gyro_raw_sample() for each sample, but the
+  sample rate, semaphore and filter setup are handled once per block
+ */
+void AP_InertialSensor_Backend::_notify_new_gyro_raw_samples(uint8_t instance, FIFOBlock &block, float scale)
+{
+    Vector3f *samples = block.samples;
+    Vector3f *filtered = block.filtered;
+    const uint8_t n_samples = block.count;
+
+    if (n_samples == 0 || ((1U<<instance) & _imu.imu_kill_mask)) {
+        return;
+    }
+
+    _rotate_and_correct_gyro(instance, samples, n_samples, scale);
+
+    _update_sensor_rate(_imu._sample_gyro_count[instance], _imu._sample_gyro_start_us[instance],
+                        _imu._gyro_raw_sample_rates[instance], n_samples);
+
+    // don't accept below 40Hz
+    if (_imu._gyro_raw_sample_rates[instance] < 40) {
+        return;
+    }
+
+    const float dt = 1.0f / _imu._gyro_raw_sample_rates[instance];
+    const uint64_t last_sample_us = _imu._gyro_last_sample_us[instance];
+    const uint64_t now = AP_HAL::micros64();
+    _imu._gyro_last_sample_us[instance] = now;
+
+    for (uint8_t i = 0; i < n_samples; i++) {
+#if AP_MODULE_SUPPORTED
+        // call gyro_sample hook if any
+        AP_Module::call_hook_gyro_sample(instance, dt, samples[i]);
+#endif
+
+        // push gyros if optical flow present
+        if (hal.opticalflow) {
+            hal.opticalflow->push_gyro(samples[i].x, samples[i].y, dt);
+        }
+    }
+
+    {
+        WITH_SEMAPHORE(_sem);
+
+        uint8_t first = 0;
+        if (AP_HAL::micros64() - last_sample_us > 100000U) {
+            // zero accumulator if sensor was unhealthy for 0.1s, and
+            // start integrating from the first sample
+            _imu._delta_angle_acc[instance].zero();
+            _imu._delta_angle_acc_dt[instance] = 0;
+            _imu._last_delta_angle[instance].zero();
+            _imu._last_raw_gyro[instance] = samples[0];
+            first = 1;
+        }
+
+        for (uint8_t i = first; i < n_samples; i++) {
+            const Vector3f &gyro = samples[i];
+
+            // compute delta angle and coning correction, as in _notify_new_gyro_raw_sample()
+            const Vector3f delta_angle = (gyro + _imu._last_raw_gyro[instance]) * 0.5f * dt;
+            Vector3f delta_coning = (_imu._delta_angle_acc[instance] +
+                                     _imu._last_delta_angle[instance] * (1.0f / 6.0f));
+            delta_coning = delta_coning % delta_angle;
+            delta_coning *= 0.5f;
+
+            // integrate delta angle accumulator
+            _imu._delta_angle_acc[instance] += delta_angle + delta_coning;
+            _imu._delta_angle_acc_dt[instance] += dt;
+
+            // save previous delta angle for coning correction
+            _imu._last_delta_angle[instance] = delta_angle;
+            _imu._last_raw_gyro[instance] = gyro;
+        }
+
+        // apply gyro filters and sample for FFT
+        apply_gyro_filters(instance, samples, filtered, n_samples);
+
+        _imu._new_gyro_data[instance] = true;
+    }
+
+    // the samples were taken at the sensor rate up to now
+    for (uint8_t i = 0; i < n_samples; i++) {
+        const uint64_t sample_us = now - uint64_t((n_samples - 1 - i) * dt * 1.0e6f);
+        log_gyro_raw(instance, sample_us, samples[i], filtered[i]);
+    }
+}
+
+/*
+  add a raw gyro sample from a FIFO read to a block
+ */
+void AP_InertialSensor_Backend::_add_gyro_raw_sample(uint8_t instance, FIFOBlock &block, const Vector3f &sample, float scale)
+{
+    block.samples[block.count++] = sample;
+    if (block.count == ARRAY_SIZE(block.samples)) {
+        _flush_gyro_raw_samples(instance, block, scale);
+    }
+}
+
+void AP_InertialSensor_Backend::_flush_gyro_raw_samples(uint8_t instance, FIFOBlock &block, float scale)
+{
+    _notify_new_gyro_raw_samples(instance, block, scale);
+    block.count = 0;
+}
+
 void AP_InertialSensor_Backend::log_gyro_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &raw_gyro, const Vector3f &filtered_gyro)
 {
+#if AP_INERTIALSENSOR_STREAMSAMPLER_ENABLED
+    _imu.streamsampler.sample(instance, AP_InertialSensor::IMU_SENSOR_TYPE_GYRO, sample_us, raw_gyro, filtered_gyro);
+#endif
+
 #if HAL_LOGGING_ENABLED
     AP_Logger *logger = AP_Logger::get_singleton();
     if (logger == nullptr) {
@@ -589,6 +816,9 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
     // assume we're doing pre-filter logging:
     log_accel_raw(instance, sample_us, accel);
 #endif
+#if AP_INERTIALSENSOR_STREAMSAMPLER_ENABLED
+    _imu.streamsampler.sample(instance, AP_InertialSensor::IMU_SENSOR_TYPE_ACCEL, sample_us, accel, _imu._accel_filtered[instance]);
+#endif
 }
 
 /*
@@ -666,9 +896,118 @@ void AP_InertialSensor_Backend::_notify_new_delta_velocity(uint8_t instance, con
     // assume we're doing pre-filter logging
     log_accel_raw(instance, sample_us, accel);
 #endif
+#if AP_INERTIALSENSOR_STREAMSAMPLER_ENABLED
+    _imu.streamsampler.sample(instance, AP_InertialSensor::IMU_SENSOR_TYPE_ACCEL, sample_us, accel, _imu._accel_filtered[instance]);
+#endif
 }
 
 
+/*
+  handle a block of accel samples from a FIFO based sensor, see
+  _notify_new_gyro_raw_samples()
+ */
+void AP_InertialSensor_Backend::_notify_new_accel_raw_samples(uint8_t instance, FIFOBlock &block, float scale)
+{
+    Vector3f *samples = block.samples;
+    Vector3f *filtered = block.filtered;
+    const uint8_t n_samples = block.count;
+
+    if (n_samples == 0 || ((1U<<instance) & _imu.imu_kill_mask)) {
+        return;
+    }
+
+    _rotate_and_correct_accel(instance, samples, n_samples, scale);
+
+    _update_sensor_rate(_imu._sample_accel_count[instance], _imu._sample_accel_start_us[instance],
+                        _imu._accel_raw_sample_rates[instance], n_samples);
+
+    // don't accept below 40Hz
+    if (_imu._accel_raw_sample_rates[instance] < 40) {
+        return;
+    }
+
+    const float dt = 1.0f / _imu._accel_raw_sample_rates[instance];
+    const uint64_t last_sample_us = _imu._accel_last_sample_us[instance];
+    const uint64_t now = AP_HAL::micros64();
+    _imu._accel_last_sample_us[instance] = now;
+
+    for (uint8_t i = 0; i < n_samples; i++) {
+#if AP_MODULE_SUPPORTED
+        // call accel_sample hook if any
+        AP_Module::call_hook_accel_sample(instance, dt, samples[i], false);
+#endif
+
+        _imu.calc_vibration_and_clipping(instance, samples[i], dt);
+    }
+
+    {
+        WITH_SEMAPHORE(_sem);
+
+        uint8_t first = 0;
+        if (AP_HAL::micros64() - last_sample_us > 100000U) {
+            // zero accumulator if sensor was unhealthy for 0.1s
+            _imu._delta_velocity_acc[instance].zero();
+            _imu._delta_velocity_acc_dt[instance] = 0;
+            first = 1;
+        }
+
+        for (uint8_t i = 0; i < n_samples; i++) {
+            const Vector3f &accel = samples[i];
+
+            // delta velocity
+            if (i >= first) {
+                _imu._delta_velocity_acc[instance] += accel * dt;
+                _imu._delta_velocity_acc_dt[instance] += dt;
+            }
+
+            _imu._accel_filtered[instance] = _imu._accel_filter[instance].apply(accel);
+            if (_imu._accel_filtered[instance].is_nan() || _imu._accel_filtered[instance].is_inf()) {
+                _imu._accel_filter[instance].reset();
+            }
+
+            _imu.set_accel_peak_hold(instance, _imu._accel_filtered[instance]);
+            filtered[i] = _imu._accel_filtered[instance];
+        }
+
+        _imu._new_accel_data[instance] = true;
+    }
+
+    // the samples were taken at the sensor rate up to now
+    for (uint8_t i = 0; i < n_samples; i++) {
+        const uint64_t sample_us = now - uint64_t((n_samples - 1 - i) * dt * 1.0e6f);
+#if AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
+        if (!_imu.batchsampler.doing_post_filter_logging()) {
+            log_accel_raw(instance, sample_us, samples[i]);
+        } else {
+            log_accel_raw(instance, sample_us, filtered[i]);
+        }
+#else
+        // assume we're doing pre-filter logging
+        log_accel_raw(instance, sample_us, samples[i]);
+#endif
+#if AP_INERTIALSENSOR_STREAMSAMPLER_ENABLED
+        _imu.streamsampler.sample(instance, AP_InertialSensor::IMU_SENSOR_TYPE_ACCEL, sample_us, samples[i], filtered[i]);
+#endif
+    }
+}
+
+/*
+  add a raw accel sample from a FIFO read to a block
+ */
+void AP_InertialSensor_Backend::_add_accel_raw_sample(uint8_t instance, FIFOBlock &block, const Vector3f &sample, float scale)
+{
+    block.samples[block.count++] = sample;
+    if (block.count == ARRAY_SIZE(block.samples)) {
+        _flush_accel_raw_samples(instance, block, scale);
+    }
+}
+
+void AP_InertialSensor_Backend::_flush_accel_raw_samples(uint8_t instance, FIFOBlock &block, float scale)
+{
+    _notify_new_accel_raw_samples(instance, block, scale);
+    block.count = 0;
+}
+
 void AP_InertialSensor_Backend::_notify_new_accel_sensor_rate_sample(uint8_t instance, const Vector3f &_accel)
 {
 #if AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
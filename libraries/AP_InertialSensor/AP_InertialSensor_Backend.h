@@ -144,11 +144,18 @@ protected:
     void _rotate_and_correct_accel(uint8_t instance, Vector3f &accel) __RAMFUNC__;
     void _rotate_and_correct_gyro(uint8_t instance, Vector3f &gyro) __RAMFUNC__;
 
+    // scale, rotate and correct a block of samples in place, looking up the
+    // orientation and calibration once for the block
+    void _rotate_and_correct_accel(uint8_t instance, Vector3f samples[], uint8_t n_samples, float scale) __RAMFUNC__;
+    void _rotate_and_correct_gyro(uint8_t instance, Vector3f samples[], uint8_t n_samples, float scale) __RAMFUNC__;
+
     // rotate gyro vector, offset and publish
     void _publish_gyro(uint8_t instance, const Vector3f &gyro) __RAMFUNC__; /* front end */
 
     // apply notch and lowpass gyro filters and sample for FFT
     void apply_gyro_filters(const uint8_t instance, const Vector3f &gyro);
+    // apply the gyro filters to a block of samples, each filter in turn
+    void apply_gyro_filters(const uint8_t instance, const Vector3f gyro[], Vector3f filtered[], uint8_t n_samples) __RAMFUNC__;
     void save_gyro_window(const uint8_t instance, const Vector3f &gyro, uint8_t phase);
 
     // this should be called every time a new gyro raw sample is
@@ -161,6 +168,21 @@ protected:
 
     // alternative interface using delta-angles. Rotation and correction is handled inside this function
     void _notify_new_delta_angle(uint8_t instance, const Vector3f &dangle);
+
+    // a block of raw samples from a FIFO, oldest first, as read from the
+    // sensor, with space for their filtered values. Drivers keep these as
+    // members rather than on the stack of the bus thread
+    struct FIFOBlock {
+        Vector3f samples[INS_MAX_FIFO_BLOCK_SAMPLES];
+        Vector3f filtered[INS_MAX_FIFO_BLOCK_SAMPLES];
+        uint8_t count;
+    };
+
+    // alternative interface for FIFO based sensors taking a block of
+    // samples. The samples are multiplied by scale, then rotated,
+    // corrected, integrated and filtered as a block. The samples are
+    // modified in place
+    void _notify_new_gyro_raw_samples(uint8_t instance, FIFOBlock &block, float scale) __RAMFUNC__;
     
     // rotate accel vector, scale, offset and publish
     void _publish_accel(uint8_t instance, const Vector3f &accel) __RAMFUNC__; /* front end */
@@ -175,6 +197,19 @@ protected:
 
     // alternative interface using delta-velocities. Rotation and correction is handled inside this function
     void _notify_new_delta_velocity(uint8_t instance, const Vector3f &dvelocity);
+
+    // alternative interface for FIFO based sensors taking a block of
+    // samples, see _notify_new_gyro_raw_samples()
+    void _notify_new_accel_raw_samples(uint8_t instance, FIFOBlock &block, float scale) __RAMFUNC__;
+
+    // add an unscaled sample to a block, passing the block to
+    // _notify_new_*_raw_samples() when it is full
+    void _add_gyro_raw_sample(uint8_t instance, FIFOBlock &block, const Vector3f &sample, float scale) __RAMFUNC__;
+    void _add_accel_raw_sample(uint8_t instance, FIFOBlock &block, const Vector3f &sample, float scale) __RAMFUNC__;
+
+    // pass any samples remaining in a block to the frontend
+    void _flush_gyro_raw_samples(uint8_t instance, FIFOBlock &block, float scale) __RAMFUNC__;
+    void _flush_accel_raw_samples(uint8_t instance, FIFOBlock &block, float scale) __RAMFUNC__;
     
     // set the amount of oversamping a accel is doing
     void _set_accel_oversampling(uint8_t instance, uint8_t n);
@@ -209,7 +244,7 @@ protected:
     }
 
     // update the sensor rate for FIFO sensors
-    void _update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz) const __RAMFUNC__;
+    void _update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz, uint8_t n_samples=1) const __RAMFUNC__;
 
     // return true if the sensors are still converging and sampling rates could change significantly
     bool sensors_converging() const { return AP_HAL::millis() < HAL_INS_CONVERGANCE_MS; }
@@ -410,8 +410,9 @@ bool AP_InertialSensor_Invensensev3::accumulate_samples(const FIFOData *data, ui
 #if INV3_ENABLE_FIFO_LOGGING
     const uint64_t tstart = AP_HAL::micros64();
 #endif
-    for (uint8_t i = 0; i < n_samples; i++) {
-        const FIFOData &d = data[i];
+    bool ret = true;
+    for (uint8_t n = 0; n < n_samples; n++) {
+        const FIFOData &d = data[n];
 
         // we have a header to confirm we don't have FIFO corruption! no more mucking
         // about with the temperature registers
@@ -419,31 +420,29 @@ bool AP_InertialSensor_Invensensev3::accumulate_samples(const FIFOData *data, ui
         // ICM42688 - HEADER_TIMESTAMP_FSYNC bit 2-3 : 10
         if ((d.header & 0xFC) != 0x68) { // ACCEL_EN | GYRO_EN | TMST_FIELD_EN
             // no or bad data
-            return false;
+            ret = false;
+            break;
         }
 
-        Vector3f accel{float(d.accel[0]), float(d.accel[1]), float(d.accel[2])};
-        Vector3f gyro{float(d.gyro[0]), float(d.gyro[1]), float(d.gyro[2])};
-
-        accel *= accel_scale;
-        gyro *= gyro_scale;
+        const Vector3f a{float(d.accel[0]), float(d.accel[1]), float(d.accel[2])};
+        const Vector3f g{float(d.gyro[0]), float(d.gyro[1]), float(d.gyro[2])};
 
 #if INV3_ENABLE_FIFO_LOGGING
-        Write_GYR(gyro_instance, tstart+(i*backend_period_us), gyro, true);
+        Write_GYR(gyro_instance, tstart+(n*backend_period_us), g * gyro_scale, true);
 #endif
 
-        const float temp = d.temperature * temp_sensitivity + temp_zero;
-
-        // these four calls are about 40us
-        _rotate_and_correct_accel(accel_instance, accel);
-        _rotate_and_correct_gyro(gyro_instance, gyro);
-
-        _notify_new_accel_raw_sample(accel_instance, accel, 0);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
+        // the good samples are scaled, corrected and filtered in blocks
+        _add_accel_raw_sample(accel_instance, accel_block, a, accel_scale);
+        _add_gyro_raw_sample(gyro_instance, gyro_block, g, gyro_scale);
 
+        const float temp = d.temperature * temp_sensitivity + temp_zero;
         temp_filtered = temp_filter.apply(temp);
     }
-    return true;
+
+    _flush_accel_raw_samples(accel_instance, accel_block, accel_scale);
+    _flush_gyro_raw_samples(gyro_instance, gyro_block, gyro_scale);
+
+    return ret;
 }
 
 #if HAL_INS_HIGHRES_SAMPLE
@@ -471,41 +470,40 @@ bool AP_InertialSensor_Invensensev3::accumulate_highres_samples(const FIFODataHi
 #if INV3_ENABLE_FIFO_LOGGING
     const uint64_t tstart = AP_HAL::micros64();
 #endif
-    for (uint8_t i = 0; i < n_samples; i++) {
-        const FIFODataHighRes &d = data[i];
+    bool ret = true;
+    for (uint8_t n = 0; n < n_samples; n++) {
+        const FIFODataHighRes &d = data[n];
 
         // we have a header to confirm we don't have FIFO corruption! no more mucking
         // about with the temperature registers
         if ((d.header & 0xFC) != 0x78) { // ACCEL_EN | GYRO_EN | HIRES_EN | TMST_FIELD_EN
             // no or bad data
-            return false;
+            ret = false;
+            break;
         }
 
-        Vector3f accel{uint20_to_float(d.accel[1], d.accel[0], d.ax),
+        const Vector3f a{uint20_to_float(d.accel[1], d.accel[0], d.ax),
             uint20_to_float(d.accel[3], d.accel[2], d.ay),
             uint20_to_float(d.accel[5], d.accel[4], d.az)};
-        Vector3f gyro{uint20_to_float(d.gyro[1], d.gyro[0], d.gx),
+        const Vector3f g{uint20_to_float(d.gyro[1], d.gyro[0], d.gx),
             uint20_to_float(d.gyro[3], d.gyro[2], d.gy),
             uint20_to_float(d.gyro[5], d.gyro[4], d.gz)};
 
-        accel *= accel_scale;
-        gyro *= gyro_scale;
-
 #if INV3_ENABLE_FIFO_LOGGING
-        Write_GYR(gyro_instance, tstart+(i*backend_period_us), gyro, true);
+        Write_GYR(gyro_instance, tstart+(n*backend_period_us), g * gyro_scale, true);
 #endif
-        const float temp = d.temperature * temp_sensitivity + temp_zero;
-
-        // these four calls are about 40us
-        _rotate_and_correct_accel(accel_instance, accel);
-        _rotate_and_correct_gyro(gyro_instance, gyro);
-
-        _notify_new_accel_raw_sample(accel_instance, accel, 0);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
 
+        // the good samples are scaled, corrected and filtered in blocks
+        _add_accel_raw_sample(accel_instance, accel_block, a, accel_scale);
+        _add_gyro_raw_sample(gyro_instance, gyro_block, g, gyro_scale);
+        const float temp = d.temperature * temp_sensitivity + temp_zero;
         temp_filtered = temp_filter.apply(temp);
     }
-    return true;
+
+    _flush_accel_raw_samples(accel_instance, accel_block, accel_scale);
+    _flush_gyro_raw_samples(gyro_instance, gyro_block, gyro_scale);
+
+    return ret;
 }
 #endif
 
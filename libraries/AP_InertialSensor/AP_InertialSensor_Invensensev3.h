@@ -78,6 +78,10 @@ private:
     uint8_t gyro_instance;
     uint8_t accel_instance;
 
+    // samples from the FIFO being passed to the frontend
+    FIFOBlock accel_block;
+    FIFOBlock gyro_block;
+
     // reset FIFO configure1 register
     uint8_t fifo_config1;
 
@@ -141,7 +141,7 @@ bool AP_InertialSensor::BatchSampler::Write_ISBD() const
 #endif
 
 // @LoggerMessage: FTN
-// @Description: Filter Tuning Message - per motor
+// @Description: Filter Tuning Message - per motor, for the notch of the primary gyro
 // @Field: TimeUS: microseconds since system startup
 // @Field: I: instance
 // @Field: NDn: number of active dynamic harmonic notches
@@ -162,7 +162,7 @@ bool AP_InertialSensor::BatchSampler::Write_ISBD() const
 // @Description: Filter Tuning Message
 // @Field: TimeUS: microseconds since system startup
 // @Field: I: instance
-// @Field: NF: dynamic harmonic notch centre frequency
+// @Field: NF: dynamic harmonic notch centre frequency of the primary gyro
 
 void AP_InertialSensor::write_notch_log_messages() const
 {
@@ -171,14 +171,16 @@ void AP_InertialSensor::write_notch_log_messages() const
         if (!notch.params.enabled()) {
             continue;
         }
-        const float* notches = notch.calculated_notch_freq_hz;
-        if (notch.num_calculated_notch_frequencies > 1) {
+        // the frequencies used by the primary gyro
+        const float* notches = notch.calculated_notch_freq_hz[_primary_gyro];
+        const uint8_t num_notches = notch.num_calculated_notch_frequencies[_primary_gyro];
+        if (num_notches > 1) {
             // log per motor center frequencies
             AP::logger().WriteStreaming(
                 "FTN", "TimeUS,I,NDn,NF1,NF2,NF3,NF4,NF5,NF6,NF7,NF8,NF9,NF10,NF11,NF12", "s#-zzzzzzzzzzzz", "F--------------", "QBBffffffffffff",
                 AP_HAL::micros64(),
                 i,
-                notch.num_calculated_notch_frequencies,
+                num_notches,
                 notches[0], notches[1], notches[2], notches[3],
                 notches[4], notches[5], notches[6], notches[7],
                 notches[8], notches[9], notches[10], notches[11]);
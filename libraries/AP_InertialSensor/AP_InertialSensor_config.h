@@ -36,6 +36,8 @@
 #define XYZ_AXIS_COUNT    3
 // The maximum we need to store is gyro-rate / loop-rate, worst case ArduCopter with BMI088 is 2000/400
 #define INS_MAX_GYRO_WINDOW_SAMPLES 8
+// The most samples from a FIFO that are processed by the frontend as a single block
+#define INS_MAX_FIFO_BLOCK_SAMPLES 4
 
 #define DEFAULT_IMU_LOG_BAT_MASK 0
 
@@ -60,6 +62,21 @@
 #define AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED (AP_INERTIALSENSOR_ENABLED && HAL_LOGGING_ENABLED)
 #endif
 
+#if defined(HAL_BUILD_AP_PERIPH)
+#define AP_INERTIALSENSOR_BUILD_AP_PERIPH 1
+#else
+#define AP_INERTIALSENSOR_BUILD_AP_PERIPH 0
+#endif
+
+#ifndef AP_INERTIALSENSOR_STREAMSAMPLER_ENABLED
+#define AP_INERTIALSENSOR_STREAMSAMPLER_ENABLED (AP_INERTIALSENSOR_ENABLED && BOARD_FLASH_SIZE > 1024 && !AP_INERTIALSENSOR_BUILD_AP_PERIPH)
+#endif
+
+// number of completed frames buffered per streamed sensor between sends
+#ifndef AP_INERTIALSENSOR_STREAMSAMPLER_QUEUE_FRAMES
+#define AP_INERTIALSENSOR_STREAMSAMPLER_QUEUE_FRAMES 32
+#endif
+
 #ifndef AP_INERTIALSENSOR_KILL_IMU_ENABLED
 #define AP_INERTIALSENSOR_KILL_IMU_ENABLED 1
 #endif
@@ -0,0 +1,155 @@
+#include "AP_InertialSensor.h"
+
+#if AP_INERTIALSENSOR_STREAMSAMPLER_ENABLED
+#include <GCS_MAVLink/GCS.h>
+#include <AP_SerialManager/AP_SerialManager.h>
+
+#define STREAM_FRAME_MAGIC 0x29c5
+
+// Class level parameters
+const AP_Param::GroupInfo AP_InertialSensor::StreamSampler::var_info[] = {
+    // @Param: MASK
+    // @DisplayName: Sensor Bitmask
+    // @Description: Bitmap of which IMUs to stream samples for on the first serial or network port with the IMU Stream protocol. This option takes effect on the next reboot.
+    // @User: Advanced
+    // @Bitmask: 0:IMU1,1:IMU2,2:IMU3
+    // @RebootRequired: True
+    AP_GROUPINFO("MASK",  1, AP_InertialSensor::StreamSampler, _sensor_mask,   0),
+
+    // @Param: OPT
+    // @DisplayName: Streaming Options Mask
+    // @Description: Options for the StreamSampler. Each streamed sensor is sent at the rate the sensor backend delivers samples, so the port must be able to carry about 8 bytes per sample.
+    // @Bitmask: 0:Stream gyros,1:Stream accelerometers,2:Stream post-filter samples
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("OPT",  2, AP_InertialSensor::StreamSampler, _options, 1),
+
+    AP_GROUPEND
+};
+
+extern const AP_HAL::HAL& hal;
+
+bool AP_InertialSensor::StreamSampler::add_channel(uint8_t instance, IMU_SENSOR_TYPE type)
+{
+    channel_t *c = new channel_t;
+    if (c == nullptr) {
+        return false;
+    }
+    c->queue = new ObjectBuffer<frame_t>(AP_INERTIALSENSOR_STREAMSAMPLER_QUEUE_FRAMES);
+    if (c->queue == nullptr || c->queue->get_size() == 0) {
+        delete c->queue;
+        delete c;
+        return false;
+    }
+
+    c->frame.magic = STREAM_FRAME_MAGIC;
+    c->frame.length = sizeof(frame_t);
+    c->frame.instance = instance;
+    c->frame.type = type;
+    c->frame.post_filter = has_option(STREAM_OPT_POST_FILTER);
+
+    channels[instance][type] = c;
+    return true;
+}
+
+void AP_InertialSensor::StreamSampler::init()
+{
+    if (_sensor_mask == 0) {
+        return;
+    }
+
+    AP_HAL::UARTDriver *_port = AP::serialmanager().find_serial(AP_SerialManager::SerialProtocol_IMUStream, 0);
+    if (_port == nullptr) {
+        return;
+    }
+
+    for (uint8_t i=0; i<INS_MAX_INSTANCES; i++) {
+        if (!(_sensor_mask & (1U<<i))) {
+            continue;
+        }
+        if ((has_option(STREAM_OPT_GYRO) && !add_channel(i, IMU_SENSOR_TYPE_GYRO)) ||
+            (has_option(STREAM_OPT_ACCEL) && !add_channel(i, IMU_SENSOR_TYPE_ACCEL))) {
+            GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "Failed to allocate IMU stream buffers");
+            break;
+        }
+    }
+
+    // the backends start taking samples once the port is set
+    port = _port;
+}
+
+/*
+  called by the main thread to send completed frames. Frames are sent
+  one per sensor in turn so that a slow port drops frames from all
+  sensors evenly
+ */
+void AP_InertialSensor::StreamSampler::periodic()
+{
+    if (port == nullptr) {
+        return;
+    }
+
+    bool sent;
+    do {
+        sent = false;
+        for (uint8_t i=0; i<INS_MAX_INSTANCES; i++) {
+            for (uint8_t t=0; t<2; t++) {
+                channel_t *c = channels[i][t];
+                if (c == nullptr || port->txspace() < sizeof(frame_t)) {
+                    continue;
+                }
+                frame_t frame;
+                if (!c->queue->pop(frame)) {
+                    continue;
+                }
+                frame.crc = crc_xmodem((const uint8_t *)&frame, sizeof(frame)-sizeof(uint16_t));
+                port->write((const uint8_t *)&frame, sizeof(frame));
+                sent = true;
+            }
+        }
+    } while (sent);
+}
+
+/*
+  called by the backend thread for each sample. Frames that do not fit
+  in the queue are dropped, which shows up as a gap in the sequence
+  numbers
+ */
+void AP_InertialSensor::StreamSampler::sample(uint8_t _instance, AP_InertialSensor::IMU_SENSOR_TYPE _type, uint64_t sample_us, const Vector3f &raw, const Vector3f &filtered)
+{
+    if (port == nullptr || _instance >= INS_MAX_INSTANCES) {
+        return;
+    }
+    channel_t *c = channels[_instance][_type];
+    if (c == nullptr) {
+        return;
+    }
+
+    frame_t &frame = c->frame;
+    if (c->count == 0) {
+        frame.timestamp_us = sample_us;
+        switch (_type) {
+        case IMU_SENSOR_TYPE_GYRO:
+            frame.sample_rate_hz = _imu._gyro_raw_sample_rates[_instance];
+            frame.multiplier = _imu._gyro_raw_sampling_multiplier[_instance];
+            break;
+        case IMU_SENSOR_TYPE_ACCEL:
+            frame.sample_rate_hz = _imu._accel_raw_sample_rates[_instance];
+            frame.multiplier = _imu._accel_raw_sampling_multiplier[_instance];
+            break;
+        }
+    }
+
+    const Vector3f v = (frame.post_filter ? filtered : raw) * frame.multiplier;
+    frame.data[c->count][0] = constrain_float(v.x, INT16_MIN, INT16_MAX);
+    frame.data[c->count][1] = constrain_float(v.y, INT16_MIN, INT16_MAX);
+    frame.data[c->count][2] = constrain_float(v.z, INT16_MIN, INT16_MAX);
+
+    if (++c->count < FRAME_SAMPLES) {
+        return;
+    }
+    c->count = 0;
+    IGNORE_RETURN(c->queue->push(frame));
+    frame.seqnum++;
+}
+#endif // AP_INERTIALSENSOR_STREAMSAMPLER_ENABLED
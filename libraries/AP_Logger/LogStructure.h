@@ -48,6 +48,7 @@ const struct UnitStructure log_Units[] = {
     { 'a', "Ah" },            // Ampere hours
     { 'd', "deg" },           // of the angular variety, -180 to 180
     { 'b', "B" },             // bytes
+    { 'B', "B/s" },           // bytes per second
     { 'k', "deg/s" },         // degrees per second. Degrees are NOT SI, but is some situations more user-friendly than radians
     { 'D', "deglatitude" },   // degrees of latitude
     { 'e', "deg/s/s" },       // degrees per second per second. Degrees are NOT SI, but is some situations more user-friendly than radians
@@ -309,6 +310,17 @@ struct PACKED log_MAV {
     uint8_t flags;
     uint16_t stream_slowdown_ms;
     uint16_t times_full;
+    uint32_t bandwidth;
+};
+
+struct PACKED log_MAV_Latency {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t chan;
+    uint8_t id;
+    uint16_t count;
+    uint16_t mean_ms;
+    uint16_t max_ms;
 };
 
 struct PACKED log_RSSI {
@@ -649,6 +661,29 @@ struct PACKED log_Scripting {
     int32_t run_mem;
 };
 
+struct PACKED log_ScriptingStats {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    char name[16];
+    uint32_t run_count;
+    uint32_t run_time;
+    uint32_t run_time_max;
+    uint32_t run_time_avg;
+    uint32_t vm_steps;
+    uint32_t vm_steps_max;
+    uint32_t alloc_bytes;
+    uint32_t gc_time;
+    uint32_t gc_time_max;
+};
+
+struct PACKED log_ScriptingProfile {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    char source[16];
+    int32_t line;
+    uint32_t samples;
+};
+
 struct PACKED log_MotBatt {
     LOG_PACKET_HEADER;
     uint64_t time_us;
@@ -847,6 +882,16 @@ struct PACKED log_VER {
 // @FieldBitmaskEnum: flags: GCS_MAVLINK::Flags
 // @Field: ss: stream slowdown is the number of ms being added to each message to fit within bandwidth
 // @Field: tf: times buffer was full when a message was going to be sent
+// @Field: bw: estimated bandwidth available for stream messages on this link, in bytes per second
+
+// @LoggerMessage: MAVL
+// @Description: GCS MAVLink per-message send latency, the time between a message becoming due and it being sent
+// @Field: TimeUS: Time since system startup
+// @Field: chan: mavlink channel number
+// @Field: id: ap_message ID
+// @Field: N: number of times this message was sent since the last MAVL
+// @Field: Mean: mean send latency
+// @Field: Max: maximum send latency
 
 // @LoggerMessage: MAVC
 // @Description: MAVLink command we have just executed
@@ -1201,6 +1246,27 @@ struct PACKED log_VER {
 // @Field: Total_mem: total memory usage of all scripts
 // @Field: Run_mem: run memory usage
 
+// @LoggerMessage: SCRS
+// @Description: Scripting per-script stats
+// @Field: TimeUS: Time since system startup
+// @Field: Name: script name
+// @Field: Runs: number of times the script has been run
+// @Field: T: run time of the last run
+// @Field: TMax: longest run time
+// @Field: TAvg: average run time
+// @Field: Steps: VM instructions executed by the last run, rounded down to a multiple of 1000
+// @Field: SMax: most VM instructions executed by a run
+// @Field: Alloc: memory allocated by the last run
+// @Field: GC: garbage collection time after the last run
+// @Field: GCMax: longest garbage collection time
+
+// @LoggerMessage: SCRP
+// @Description: Scripting profiler hot functions
+// @Field: TimeUS: Time since system startup
+// @Field: Src: file containing the function
+// @Field: Line: line the function is defined on, 0 for the main chunk
+// @Field: Samples: number of times the function was running when sampled
+
 // @LoggerMessage: MOTB
 // @Description: Motor mixer information
 // @Field: TimeUS: Time since system startup
@@ -1305,7 +1371,9 @@ LOG_STRUCTURE_FROM_FENCE \
     { LOG_RALLY_MSG, sizeof(log_Rally), \
       "RALY", "QBBLLhB", "TimeUS,Tot,Seq,Lat,Lng,Alt,Flags", "s--DUm-", "F--GGB-" },  \
     { LOG_MAV_MSG, sizeof(log_MAV),   \
-      "MAV", "QBHHHBHH",   "TimeUS,chan,txp,rxp,rxdp,flags,ss,tf", "s#----s-", "F-000-C-" },   \
+      "MAV", "QBHHHBHHI",   "TimeUS,chan,txp,rxp,rxdp,flags,ss,tf,bw", "s#----s-B", "F-000-C-0" },   \
+    { LOG_MAV_LATENCY_MSG, sizeof(log_MAV_Latency),   \
+      "MAVL", "QBBHHH",   "TimeUS,chan,id,N,Mean,Max", "s#--ss", "F---CC" },   \
 LOG_STRUCTURE_FROM_VISUALODOM \
     { LOG_OPTFLOW_MSG, sizeof(log_Optflow), \
       "OF",   "QBffff",   "TimeUS,Qual,flowX,flowY,bodyX,bodyY", "s-EEnn", "F-0000" , true }, \
@@ -1334,6 +1402,10 @@ LOG_STRUCTURE_FROM_VISUALODOM \
 LOG_STRUCTURE_FROM_AIS \
     { LOG_SCRIPTING_MSG, sizeof(log_Scripting), \
       "SCR",   "QNIii", "TimeUS,Name,Runtime,Total_mem,Run_mem", "s#sbb", "F-F--", true }, \
+    { LOG_SCRIPTING_STATS_MSG, sizeof(log_ScriptingStats), \
+      "SCRS",  "QNIIIIIIIII", "TimeUS,Name,Runs,T,TMax,TAvg,Steps,SMax,Alloc,GC,GCMax", "s#-sss--bss", "F--FFF---FF", true }, \
+    { LOG_SCRIPTING_PROFILE_MSG, sizeof(log_ScriptingProfile), \
+      "SCRP",  "QNiI", "TimeUS,Src,Line,Samples", "s#--", "F---", true }, \
     { LOG_VER_MSG, sizeof(log_VER), \
       "VER",   "QBHBBBBIZHB", "TimeUS,BT,BST,Maj,Min,Pat,FWT,GH,FWS,APJ,BU", "s----------", "F----------", false }, \
     { LOG_MOTBATT_MSG, sizeof(log_MotBatt), \
@@ -1407,6 +1479,7 @@ enum LogMessages : uint8_t {
     LOG_EVENT_MSG,
     LOG_WHEELENCODER_MSG,
     LOG_MAV_MSG,
+    LOG_MAV_LATENCY_MSG,
     LOG_ERROR_MSG,
     LOG_ADSB_MSG,
     LOG_ARM_DISARM_MSG,
@@ -1419,6 +1492,8 @@ enum LogMessages : uint8_t {
     LOG_STAK_MSG,
     LOG_FILE_MSG,
     LOG_SCRIPTING_MSG,
+    LOG_SCRIPTING_STATS_MSG,
+    LOG_SCRIPTING_PROFILE_MSG,
     LOG_VIDEO_STABILISATION_MSG,
     LOG_MOTBATT_MSG,
     LOG_VER_MSG,
@@ -0,0 +1,211 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AP_PolygonIndex.h"
+#include "AP_Math.h"
+
+#define AP_POLYGONINDEX_ENTRIES_PER_EDGE    4   // bands are reduced until the band lists hold no more than this many entries per edge
+
+// free memory and forget the polygon
+template <typename T>
+void AP_PolygonIndex<T>::clear()
+{
+    delete[] _band_start;
+    _band_start = nullptr;
+    delete[] _band_edges;
+    _band_edges = nullptr;
+    _num_bands = 0;
+    _points = nullptr;
+    _num_points = 0;
+    _num_edges = 0;
+}
+
+// build the index for polygon V with N points
+template <typename T>
+bool AP_PolygonIndex<T>::build(const Vector2<T> *V, uint16_t N)
+{
+    clear();
+    _points = V;
+    _num_points = N;
+    _num_edges = Polygon_complete(V, N) ? N - 1 : N;
+    if (_num_edges < 3) {
+        // not a polygon, leave to Polygon_outside()
+        return true;
+    }
+
+    _min = _max = V[0];
+    for (uint16_t i = 1; i < _num_edges; i++) {
+        _min.x = MIN(_min.x, V[i].x);
+        _min.y = MIN(_min.y, V[i].y);
+        _max.x = MAX(_max.x, V[i].x);
+        _max.y = MAX(_max.y, V[i].y);
+    }
+
+    // edges which span many bands are registered in each, so reduce
+    // the number of bands until memory use is reasonable
+    const uint32_t max_entries = MIN(uint32_t(_num_edges) * AP_POLYGONINDEX_ENTRIES_PER_EDGE, uint32_t(UINT16_MAX));
+    uint32_t num_entries;
+    _num_bands = MIN(_num_edges, uint16_t(MAX_BANDS));
+    while (true) {
+        if (_max.y > _min.y) {
+            _band_scale = _num_bands / float(std::is_floating_point<T>::value ? (_max.y - _min.y) : (int64_t(_max.y) - int64_t(_min.y)));
+        } else {
+            // horizontal line, no edge can be crossed
+            _band_scale = 0;
+        }
+        num_entries = 0;
+        for (uint16_t i = 0; i < _num_edges; i++) {
+            const Vector2<T> &v1 = V[i];
+            const Vector2<T> &v2 = V[(i + 1 < _num_edges) ? i + 1 : 0];
+            if (v1.y == v2.y) {
+                // horizontal edges are never crossed
+                continue;
+            }
+            num_entries += band(MAX(v1.y, v2.y)) - band(MIN(v1.y, v2.y)) + 1;
+        }
+        if (num_entries <= max_entries || _num_bands == 1) {
+            break;
+        }
+        _num_bands /= 2;
+    }
+
+    _band_start = new uint16_t[_num_bands + 1];
+    _band_edges = new uint16_t[MAX(num_entries, 1U)];
+    if (_band_start == nullptr || _band_edges == nullptr) {
+        delete[] _band_start;
+        _band_start = nullptr;
+        delete[] _band_edges;
+        _band_edges = nullptr;
+        return false;
+    }
+
+    // count entries in each band then convert counts to start offsets
+    memset(_band_start, 0, (_num_bands + 1) * sizeof(_band_start[0]));
+    for (uint16_t i = 0; i < _num_edges; i++) {
+        const Vector2<T> &v1 = V[i];
+        const Vector2<T> &v2 = V[(i + 1 < _num_edges) ? i + 1 : 0];
+        if (v1.y == v2.y) {
+            continue;
+        }
+        for (uint8_t b = band(MIN(v1.y, v2.y)); b <= band(MAX(v1.y, v2.y)); b++) {
+            _band_start[b + 1]++;
+        }
+    }
+    for (uint8_t b = 0; b < _num_bands; b++) {
+        _band_start[b + 1] += _band_start[b];
+    }
+
+    // fill band lists, using the following band's start as a cursor
+    for (uint16_t i = 0; i < _num_edges; i++) {
+        const Vector2<T> &v1 = V[i];
+        const Vector2<T> &v2 = V[(i + 1 < _num_edges) ? i + 1 : 0];
+        if (v1.y == v2.y) {
+            continue;
+        }
+        for (uint8_t b = band(MIN(v1.y, v2.y)); b <= band(MAX(v1.y, v2.y)); b++) {
+            _band_edges[_band_start[b]++] = i;
+        }
+    }
+    // cursors now hold the end of each band, shift them back to the start
+    for (uint8_t b = _num_bands; b > 0; b--) {
+        _band_start[b] = _band_start[b - 1];
+    }
+    _band_start[0] = 0;
+
+    return true;
+}
+
+// band holding y coordinate.  Must be monotonic in y so an edge spanning
+// y1..y2 is in every band a point between them may fall in
+template <typename T>
+uint8_t AP_PolygonIndex<T>::band(T y) const
+{
+    const float offset = float(std::is_floating_point<T>::value ? (y - _min.y) : (int64_t(y) - int64_t(_min.y)));
+    const float b = offset * _band_scale;
+    if (!(b > 0)) {
+        return 0;
+    }
+    return MIN(uint32_t(b), uint32_t(_num_bands - 1));
+}
+
+// returns true if P is outside the polygon
+template <typename T>
+bool AP_PolygonIndex<T>::outside(const Vector2<T> &P) const
+{
+    if (_band_start == nullptr) {
+        if (_points == nullptr) {
+            return true;
+        }
+        return Polygon_outside(P, _points, _num_points);
+    }
+
+    // an edge is only crossed if P.y lies in [min(v1.y,v2.y), max(v1.y,v2.y))
+    // so nothing outside the bounding box's y range crosses any edge.
+    // Beside or beyond the bounding box every crossed edge is on the
+    // same side of P and, as a closed polygon crosses any line an even
+    // number of times, P is outside
+    if (P.y < _min.y || P.y >= _max.y || P.x < _min.x || P.x > _max.x) {
+        return true;
+    }
+
+    const uint8_t b = band(P.y);
+    bool outside = true;
+    for (uint16_t e = _band_start[b]; e < _band_start[b + 1]; e++) {
+        const uint16_t i = _band_edges[e];
+        const uint16_t j = (i + 1 < _num_edges) ? i + 1 : 0;
+        if (Polygon_edge_crossed(P, _points[i], _points[j])) {
+            outside = !outside;
+        }
+    }
+    return outside;
+}
+
+// bytes of memory used by the index
+template <typename T>
+uint32_t AP_PolygonIndex<T>::memory_used() const
+{
+    if (_band_start == nullptr) {
+        return 0;
+    }
+    return (_num_bands + 1 + _band_start[_num_bands]) * sizeof(uint16_t);
+}
+
+// average number of edges tested by outside() for points within the bounding box
+template <typename T>
+float AP_PolygonIndex<T>::edges_tested_average() const
+{
+    if (_band_start == nullptr) {
+        return _num_edges;
+    }
+    // bands are of equal height
+    return _band_start[_num_bands] / float(_num_bands);
+}
+
+// largest number of edges tested by outside()
+template <typename T>
+uint16_t AP_PolygonIndex<T>::edges_tested_max() const
+{
+    if (_band_start == nullptr) {
+        return _num_edges;
+    }
+    uint16_t ret = 0;
+    for (uint8_t b = 0; b < _num_bands; b++) {
+        ret = MAX(ret, _band_start[b + 1] - _band_start[b]);
+    }
+    return ret;
+}
+
+template class AP_PolygonIndex<int32_t>;
+template class AP_PolygonIndex<float>;
@@ -0,0 +1,80 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <AP_Common/AP_Common.h>
+#include "vector2.h"
+
+/*
+ * Point-in-polygon index for a static polygon (e.g. a fence boundary).
+ *
+ * The polygon's bounding box is split into horizontal bands and each
+ * band holds the edges which span any part of it.  Polygon_outside()
+ * only counts edges which span the test point's y coordinate, so
+ * outside() tests just the edges in the point's band and gives the
+ * same result as Polygon_outside() on the whole polygon.  Points
+ * outside the bounding box are rejected without testing any edges.
+ */
+template <typename T>
+class AP_PolygonIndex {
+public:
+    AP_PolygonIndex() {}
+    ~AP_PolygonIndex() { clear(); }
+
+    CLASS_NO_COPY(AP_PolygonIndex);  /* Do not allow copies */
+
+    // maximum number of bands
+    static constexpr uint8_t MAX_BANDS = 64;
+
+    // free memory and forget the polygon
+    void clear();
+
+    // build the index for polygon V with N points.  Points are not
+    // copied so V must remain valid while the index is used
+    // returns false if out of memory, in which case outside() falls back to Polygon_outside()
+    bool build(const Vector2<T> *V, uint16_t N);
+
+    // returns true if P is outside the polygon, identical to Polygon_outside(P, V, N)
+    bool outside(const Vector2<T> &P) const;
+
+    // true if build() succeeded
+    bool built() const { return _band_start != nullptr; }
+
+    // bytes of memory used by the index
+    uint32_t memory_used() const;
+
+    // average and largest number of edges tested by outside() for points within the bounding box
+    float edges_tested_average() const;
+    uint16_t edges_tested_max() const;
+
+private:
+
+    // band holding y coordinate
+    uint8_t band(T y) const;
+
+    const Vector2<T> *_points = nullptr;    // polygon points, not owned
+    uint16_t _num_points = 0;       // number of points passed to build()
+    uint16_t _num_edges = 0;        // number of edges, excluding the closing edge of a complete polygon
+
+    Vector2<T> _min;                // bounding box
+    Vector2<T> _max;
+    float _band_scale;              // number of bands per unit of y
+
+    // compressed band lists: edges in band b are _band_edges[_band_start[b] .. _band_start[b+1])
+    // edge i runs from point i to point i+1 (or point 0 for the last edge)
+    uint16_t *_band_start = nullptr;
+    uint16_t *_band_edges = nullptr;
+    uint8_t _num_bands = 0;
+};
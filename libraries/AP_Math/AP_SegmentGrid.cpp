@@ -0,0 +1,340 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AP_SegmentGrid.h"
+#include "AP_Math.h"
+
+#define AP_SEGMENTGRID_EDGES_PER_CHUNK  32      // edge array grows in increments of this many edges
+#define AP_SEGMENTGRID_EDGE_PADDING     0.05f   // edge bounding boxes are padded by this fraction of a cell to absorb rounding at cell boundaries
+
+// remove all edges and free memory
+void AP_SegmentGrid::clear()
+{
+    free_index();
+    delete[] _edges;
+    _edges = nullptr;
+    _num_edges = 0;
+    _edges_allocated = 0;
+}
+
+// free the cell index only (edges are kept)
+void AP_SegmentGrid::free_index()
+{
+    delete[] _cell_start;
+    _cell_start = nullptr;
+    delete[] _cell_edges;
+    _cell_edges = nullptr;
+    _cell_edges_count = 0;
+    _cells_per_axis = 0;
+}
+
+// grow edge array to hold at least num_edges edges
+bool AP_SegmentGrid::expand_edges(uint32_t num_edges)
+{
+    if (num_edges <= _edges_allocated) {
+        return true;
+    }
+    if (num_edges > UINT16_MAX) {
+        return false;
+    }
+    const uint32_t new_size = MIN(((num_edges + AP_SEGMENTGRID_EDGES_PER_CHUNK - 1) / AP_SEGMENTGRID_EDGES_PER_CHUNK) * AP_SEGMENTGRID_EDGES_PER_CHUNK, uint32_t(UINT16_MAX));
+    Edge *new_edges = new Edge[new_size];
+    if (new_edges == nullptr) {
+        return false;
+    }
+    if (_edges != nullptr) {
+        memcpy(new_edges, _edges, sizeof(Edge) * _num_edges);
+        delete[] _edges;
+    }
+    _edges = new_edges;
+    _edges_allocated = new_size;
+    return true;
+}
+
+// add the edges of polygon V with N points
+// returns false if out of memory or too many edges
+bool AP_SegmentGrid::add_polygon(const Vector2f *V, uint16_t N)
+{
+    if (V == nullptr || N == 0) {
+        return true;
+    }
+    // match Polygon_intersects, which ignores a closing point equal to the first
+    if (Polygon_complete(V, N)) {
+        N--;
+    }
+    if (!expand_edges(uint32_t(_num_edges) + N)) {
+        return false;
+    }
+
+    // any existing index no longer covers all edges
+    free_index();
+
+    for (uint16_t i = 0; i < N; i++) {
+        const uint16_t j = (i + 1 < N) ? i + 1 : 0;
+        Edge &e = _edges[_num_edges++];
+        e.v1 = V[i];
+        e.v2 = V[j];
+    }
+    return true;
+}
+
+// convert a coordinate to a cell index along one axis, clamped to the grid
+uint8_t AP_SegmentGrid::cell_x(float x) const
+{
+    const float c = (x - _min.x) * _inv_cell_size.x;
+    if (!(c > 0)) {
+        // also catches NaN
+        return 0;
+    }
+    if (c >= _cells_per_axis - 1) {
+        return _cells_per_axis - 1;
+    }
+    return uint8_t(c);
+}
+
+uint8_t AP_SegmentGrid::cell_y(float y) const
+{
+    const float c = (y - _min.y) * _inv_cell_size.y;
+    if (!(c > 0)) {
+        return 0;
+    }
+    if (c >= _cells_per_axis - 1) {
+        return _cells_per_axis - 1;
+    }
+    return uint8_t(c);
+}
+
+// build the cell index over all edges added so far
+// returns false if out of memory
+bool AP_SegmentGrid::build()
+{
+    free_index();
+    if (_num_edges == 0) {
+        return true;
+    }
+
+    // bounding box of all edges
+    _min = _edges[0].v1;
+    _max = _edges[0].v1;
+    for (uint16_t i = 0; i < _num_edges; i++) {
+        const Edge &e = _edges[i];
+        _min.x = MIN(_min.x, MIN(e.v1.x, e.v2.x));
+        _min.y = MIN(_min.y, MIN(e.v1.y, e.v2.y));
+        _max.x = MAX(_max.x, MAX(e.v1.x, e.v2.x));
+        _max.y = MAX(_max.y, MAX(e.v1.y, e.v2.y));
+    }
+
+    // pad the grid so every edge is strictly inside it and neither axis is zero width
+    const float margin = MAX(0.01f * MAX(_max.x - _min.x, _max.y - _min.y), 0.001f);
+    _min -= Vector2f(margin, margin);
+    _max += Vector2f(margin, margin);
+
+    // aim for roughly one edge per cell
+    _cells_per_axis = constrain_int16(ceilf(sqrtf(_num_edges)), 1, MAX_CELLS_PER_AXIS);
+    const Vector2f cell_size = (_max - _min) / _cells_per_axis;
+    _inv_cell_size = Vector2f(1.0f / cell_size.x, 1.0f / cell_size.y);
+    const uint16_t num_cells = uint16_t(_cells_per_axis) * _cells_per_axis;
+
+    _cell_start = new uint16_t[num_cells + 1];
+    if (_cell_start == nullptr) {
+        free_index();
+        return false;
+    }
+    memset(_cell_start, 0, sizeof(uint16_t) * (num_cells + 1));
+
+    // find the cell range of each edge's padded bounding box and count edges per cell
+    const Vector2f pad = cell_size * AP_SEGMENTGRID_EDGE_PADDING;
+    uint32_t total = 0;
+    for (uint16_t i = 0; i < _num_edges; i++) {
+        Edge &e = _edges[i];
+        e.cell_min_x = cell_x(MIN(e.v1.x, e.v2.x) - pad.x);
+        e.cell_max_x = cell_x(MAX(e.v1.x, e.v2.x) + pad.x);
+        e.cell_min_y = cell_y(MIN(e.v1.y, e.v2.y) - pad.y);
+        e.cell_max_y = cell_y(MAX(e.v1.y, e.v2.y) + pad.y);
+        for (uint8_t y = e.cell_min_y; y <= e.cell_max_y; y++) {
+            for (uint8_t x = e.cell_min_x; x <= e.cell_max_x; x++) {
+                _cell_start[y * _cells_per_axis + x]++;
+            }
+        }
+        total += (e.cell_max_x - e.cell_min_x + 1) * (e.cell_max_y - e.cell_min_y + 1);
+    }
+    if (total > UINT16_MAX) {
+        free_index();
+        return false;
+    }
+
+    // convert counts to running totals so _cell_start[c] is the end of cell c's list
+    for (uint16_t c = 1; c < num_cells; c++) {
+        _cell_start[c] += _cell_start[c-1];
+    }
+    _cell_start[num_cells] = total;
+
+    _cell_edges = new uint16_t[MAX(total, 1U)];
+    if (_cell_edges == nullptr) {
+        free_index();
+        return false;
+    }
+    _cell_edges_count = total;
+
+    // fill cell lists from the back, leaving _cell_start[c] at the start of cell c's list
+    for (int32_t i = _num_edges - 1; i >= 0; i--) {
+        const Edge &e = _edges[i];
+        for (uint8_t y = e.cell_min_y; y <= e.cell_max_y; y++) {
+            for (uint8_t x = e.cell_min_x; x <= e.cell_max_x; x++) {
+                _cell_edges[--_cell_start[y * _cells_per_axis + x]] = i;
+            }
+        }
+    }
+
+    return true;
+}
+
+// test a single edge, with the same bounding box pre-check as Polygon_intersects
+bool AP_SegmentGrid::edge_intersects(const Edge &e, const Vector2f &p1, const Vector2f &p2)
+{
+    const Vector2f &v1 = e.v1;
+    const Vector2f &v2 = e.v2;
+    if (v1.x > p1.x && v2.x > p1.x && v1.x > p2.x && v2.x > p2.x) {
+        return false;
+    }
+    if (v1.y > p1.y && v2.y > p1.y && v1.y > p2.y && v2.y > p2.y) {
+        return false;
+    }
+    if (v1.x < p1.x && v2.x < p1.x && v1.x < p2.x && v2.x < p2.x) {
+        return false;
+    }
+    if (v1.y < p1.y && v2.y < p1.y && v1.y < p2.y && v2.y < p2.y) {
+        return false;
+    }
+    Vector2f intersection;
+    return Vector2f::segment_intersection(v1, v2, p1, p2, intersection);
+}
+
+// returns true if the segment from p1 to p2 intersects any edge
+bool AP_SegmentGrid::intersects(const Vector2f &p1, const Vector2f &p2) const
+{
+    if (_num_edges == 0) {
+        return false;
+    }
+
+    // no index, test every edge
+    if (!built()) {
+        for (uint16_t i = 0; i < _num_edges; i++) {
+            if (edge_intersects(_edges[i], p1, p2)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // clip the segment to the grid (Liang-Barsky).  All edges lie inside the grid
+    // so a segment that misses it cannot cross any of them
+    const Vector2f d = p2 - p1;
+    float t0 = 0, t1 = 1;
+    const float p[4] = { -d.x, d.x, -d.y, d.y };
+    const float q[4] = { p1.x - _min.x, _max.x - p1.x, p1.y - _min.y, _max.y - p1.y };
+    for (uint8_t k = 0; k < 4; k++) {
+        if (is_zero(p[k])) {
+            if (q[k] < 0) {
+                return false;
+            }
+            continue;
+        }
+        const float r = q[k] / p[k];
+        if (p[k] < 0) {
+            t0 = MAX(t0, r);
+        } else {
+            t1 = MIN(t1, r);
+        }
+    }
+    if (t0 > t1) {
+        return false;
+    }
+    const Vector2f a = p1 + d * t0;
+    const Vector2f b = p1 + d * t1;
+
+    // walk the cells crossed by the clipped segment.  The exact number of steps
+    // along each axis is known from the end cells, so rounding in the step
+    // choice cannot make the walk overshoot or stop short
+    uint8_t x = cell_x(a.x);
+    uint8_t y = cell_y(a.y);
+    const uint8_t end_x = cell_x(b.x);
+    const uint8_t end_y = cell_y(b.y);
+    const int8_t step_x = (end_x >= x) ? 1 : -1;
+    const int8_t step_y = (end_y >= y) ? 1 : -1;
+    uint8_t steps_x = abs(int16_t(end_x) - x);
+    uint8_t steps_y = abs(int16_t(end_y) - y);
+
+    const Vector2f cell_size(1.0f / _inv_cell_size.x, 1.0f / _inv_cell_size.y);
+    float t_delta_x = FLT_MAX, t_max_x = FLT_MAX;
+    if (!is_zero(d.x)) {
+        t_delta_x = fabsf(cell_size.x / d.x);
+        const float boundary = _min.x + (x + (step_x > 0 ? 1 : 0)) * cell_size.x;
+        t_max_x = (boundary - p1.x) / d.x;
+    }
+    float t_delta_y = FLT_MAX, t_max_y = FLT_MAX;
+    if (!is_zero(d.y)) {
+        t_delta_y = fabsf(cell_size.y / d.y);
+        const float boundary = _min.y + (y + (step_y > 0 ? 1 : 0)) * cell_size.y;
+        t_max_y = (boundary - p1.y) / d.y;
+    }
+
+    bool have_prev = false;
+    uint8_t prev_x = 0, prev_y = 0;
+    while (true) {
+        const uint16_t c = y * _cells_per_axis + x;
+        for (uint16_t k = _cell_start[c]; k < _cell_start[c+1]; k++) {
+            const Edge &e = _edges[_cell_edges[k]];
+            // the walk is monotonic in x and y so the cells it visits within an
+            // edge's cell range are contiguous. If the previous cell was in
+            // range this edge has already been tested
+            if (have_prev && edge_in_cell(e, prev_x, prev_y)) {
+                continue;
+            }
+            if (edge_intersects(e, p1, p2)) {
+                return true;
+            }
+        }
+
+        if (steps_x == 0 && steps_y == 0) {
+            break;
+        }
+        have_prev = true;
+        prev_x = x;
+        prev_y = y;
+        if (steps_x > 0 && (steps_y == 0 || t_max_x < t_max_y)) {
+            x += step_x;
+            t_max_x += t_delta_x;
+            steps_x--;
+        } else {
+            y += step_y;
+            t_max_y += t_delta_y;
+            steps_y--;
+        }
+    }
+
+    return false;
+}
+
+// bytes of memory used by the grid
+uint32_t AP_SegmentGrid::memory_used() const
+{
+    uint32_t ret = sizeof(Edge) * _edges_allocated;
+    if (built()) {
+        ret += sizeof(uint16_t) * (uint32_t(_cells_per_axis) * _cells_per_axis + 1);
+        ret += sizeof(uint16_t) * _cell_edges_count;
+    }
+    return ret;
+}
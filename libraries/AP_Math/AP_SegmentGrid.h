@@ -0,0 +1,105 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <AP_Common/AP_Common.h>
+#include "vector2.h"
+
+/*
+ * Uniform grid spatial index over a static set of line segments (e.g. the
+ * edges of polygon fences) used to answer "does this segment cross any
+ * edge" queries without testing every edge.
+ *
+ * Edges are added with add_polygon() and the index is built with build().
+ * Each edge is registered in every cell its bounding box touches, and a
+ * query walks only the cells the query segment passes through.  Results are
+ * identical to calling Polygon_intersects() on each polygon in turn.
+ */
+class AP_SegmentGrid {
+public:
+    AP_SegmentGrid() {}
+    ~AP_SegmentGrid() { clear(); }
+
+    CLASS_NO_COPY(AP_SegmentGrid);  /* Do not allow copies */
+
+    // maximum number of cells along each axis
+    static constexpr uint8_t MAX_CELLS_PER_AXIS = 32;
+
+    // remove all edges and free memory
+    void clear();
+
+    // add the edges of polygon V with N points.  A closed polygon (last
+    // point equal to first) is handled as Polygon_intersects() does.
+    // edges are copied so V need not outlive the grid
+    // returns false if out of memory or too many edges
+    bool add_polygon(const Vector2f *V, uint16_t N);
+
+    // build the cell index over all edges added so far
+    // returns false if out of memory, in which case intersects() falls back to testing every edge
+    bool build();
+
+    // returns true if the segment from p1 to p2 intersects any edge
+    bool intersects(const Vector2f &p1, const Vector2f &p2) const;
+
+    // number of edges held
+    uint16_t num_edges() const { return _num_edges; }
+
+    // true if build() has succeeded since the last change to the edges
+    bool built() const { return _cell_start != nullptr; }
+
+    // bytes of memory used by the grid
+    uint32_t memory_used() const;
+
+private:
+
+    struct Edge {
+        Vector2f v1;
+        Vector2f v2;
+        uint8_t cell_min_x, cell_min_y;     // range of cells covered by the edge's bounding box
+        uint8_t cell_max_x, cell_max_y;
+    };
+
+    // test a single edge, with a bounding box pre-check
+    static bool edge_intersects(const Edge &e, const Vector2f &p1, const Vector2f &p2);
+
+    // grow edge array to hold at least num_edges edges
+    bool expand_edges(uint32_t num_edges);
+
+    // free the cell index only (edges are kept)
+    void free_index();
+
+    // convert a coordinate to a cell index along one axis, clamped to the grid
+    uint8_t cell_x(float x) const;
+    uint8_t cell_y(float y) const;
+
+    // true if cell (x,y) lies in the edge's cell range
+    static bool edge_in_cell(const Edge &e, uint8_t x, uint8_t y) {
+        return x >= e.cell_min_x && x <= e.cell_max_x && y >= e.cell_min_y && y <= e.cell_max_y;
+    }
+
+    Edge *_edges = nullptr;
+    uint16_t _num_edges = 0;
+    uint16_t _edges_allocated = 0;
+
+    // compressed cell lists: edges in cell c are _cell_edges[_cell_start[c] .. _cell_start[c+1])
+    uint16_t *_cell_start = nullptr;
+    uint16_t *_cell_edges = nullptr;
+    uint16_t _cell_edges_count = 0;
+
+    uint8_t _cells_per_axis = 0;
+    Vector2f _min;                  // lower corner of the grid
+    Vector2f _max;                  // upper corner of the grid
+    Vector2f _inv_cell_size;        // reciprocal of the cell width and height
+};
@@ -4,6 +4,12 @@
 
 const AP_HAL::HAL& hal = AP_HAL::get_HAL();
 
+static const Matrix3f m_rot = [] {
+    Matrix3f m;
+    m.from_euler(radians(10), radians(-20), radians(30));
+    return m;
+}();
+
 static void BM_MatrixMultiplication(benchmark::State& state)
 {
     Matrix3f m1(Vector3f(1.0f, 2.0f, 3.0f),
@@ -19,6 +25,225 @@ static void BM_MatrixMultiplication(benchmark::State& state)
     }
 }
 
+static void BM_MatrixVectorMultiplication(benchmark::State& state)
+{
+    Matrix3f m = m_rot;
+    Vector3f v(1.0f, -2.0f, 3.0f);
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&m);
+        gbenchmark_escape(&v);
+        Vector3f r = m * v;
+        gbenchmark_escape(&r);
+    }
+}
+
+static void BM_MatrixMulTranspose(benchmark::State& state)
+{
+    Matrix3f m = m_rot;
+    Vector3f v(1.0f, -2.0f, 3.0f);
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&m);
+        gbenchmark_escape(&v);
+        Vector3f r = m.mul_transpose(v);
+        gbenchmark_escape(&r);
+    }
+}
+
+static void BM_MatrixTransposed(benchmark::State& state)
+{
+    Matrix3f m = m_rot;
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&m);
+        Matrix3f r = m.transposed();
+        gbenchmark_escape(&r);
+    }
+}
+
+// the rotation step of the DCM matrix_update()
+static void BM_MatrixRotate(benchmark::State& state)
+{
+    Matrix3f m = m_rot;
+    const Vector3f g(0.001f, -0.002f, 0.0005f);
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&m);
+        m.rotate(g);
+        gbenchmark_escape(&m);
+    }
+}
+
+static void BM_MatrixNormalize(benchmark::State& state)
+{
+    Matrix3f m = m_rot;
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&m);
+        m.normalize();
+        gbenchmark_escape(&m);
+    }
+}
+
+static void BM_MatrixFromEuler(benchmark::State& state)
+{
+    float roll = radians(10), pitch = radians(-20), yaw = radians(30);
+    Matrix3f m;
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&roll);
+        m.from_euler(roll, pitch, yaw);
+        gbenchmark_escape(&m);
+    }
+}
+
+static void BM_MatrixToEuler(benchmark::State& state)
+{
+    Matrix3f m = m_rot;
+    float roll, pitch, yaw;
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&m);
+        m.to_euler(&roll, &pitch, &yaw);
+        gbenchmark_escape(&roll);
+        gbenchmark_escape(&pitch);
+        gbenchmark_escape(&yaw);
+    }
+}
+
+static void BM_VectorCrossProduct(benchmark::State& state)
+{
+    Vector3f v1(1.0f, -2.0f, 3.0f);
+    Vector3f v2(-0.5f, 0.25f, 4.0f);
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&v1);
+        gbenchmark_escape(&v2);
+        Vector3f r = v1 % v2;
+        gbenchmark_escape(&r);
+    }
+}
+
+static void BM_VectorDotProduct(benchmark::State& state)
+{
+    Vector3f v1(1.0f, -2.0f, 3.0f);
+    Vector3f v2(-0.5f, 0.25f, 4.0f);
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&v1);
+        gbenchmark_escape(&v2);
+        float r = v1 * v2;
+        gbenchmark_escape(&r);
+    }
+}
+
+static void BM_VectorNormalized(benchmark::State& state)
+{
+    Vector3f v(1.0f, -2.0f, 3.0f);
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&v);
+        Vector3f r = v.normalized();
+        gbenchmark_escape(&r);
+    }
+}
+
+static void BM_QuaternionMultiplication(benchmark::State& state)
+{
+    Quaternion q1, q2;
+    q1.from_euler(radians(10), radians(-20), radians(30));
+    q2.from_euler(radians(-5), radians(15), radians(-60));
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&q1);
+        gbenchmark_escape(&q2);
+        Quaternion r = q1 * q2;
+        gbenchmark_escape(&r);
+    }
+}
+
+static void BM_QuaternionVectorMultiplication(benchmark::State& state)
+{
+    Quaternion q;
+    q.from_euler(radians(10), radians(-20), radians(30));
+    Vector3f v(1.0f, -2.0f, 3.0f);
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&q);
+        gbenchmark_escape(&v);
+        Vector3f r = q * v;
+        gbenchmark_escape(&r);
+    }
+}
+
+static void BM_QuaternionRotate(benchmark::State& state)
+{
+    Quaternion q;
+    q.from_euler(radians(10), radians(-20), radians(30));
+    const Vector3f v(0.001f, -0.002f, 0.0005f);
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&q);
+        q.rotate(v);
+        gbenchmark_escape(&q);
+    }
+}
+
+static void BM_QuaternionRotateFast(benchmark::State& state)
+{
+    Quaternion q;
+    q.from_euler(radians(10), radians(-20), radians(30));
+    const Vector3f v(0.001f, -0.002f, 0.0005f);
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&q);
+        q.rotate_fast(v);
+        gbenchmark_escape(&q);
+    }
+}
+
+static void BM_QuaternionToRotationMatrix(benchmark::State& state)
+{
+    Quaternion q;
+    q.from_euler(radians(10), radians(-20), radians(30));
+    Matrix3f m;
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&q);
+        q.rotation_matrix(m);
+        gbenchmark_escape(&m);
+    }
+}
+
+static void BM_QuaternionFromRotationMatrix(benchmark::State& state)
+{
+    Matrix3f m = m_rot;
+    Quaternion q;
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&m);
+        q.from_rotation_matrix(m);
+        gbenchmark_escape(&q);
+    }
+}
+
 BENCHMARK(BM_MatrixMultiplication);
+BENCHMARK(BM_MatrixVectorMultiplication);
+BENCHMARK(BM_MatrixMulTranspose);
+BENCHMARK(BM_MatrixTransposed);
+BENCHMARK(BM_MatrixRotate);
+BENCHMARK(BM_MatrixNormalize);
+BENCHMARK(BM_MatrixFromEuler);
+BENCHMARK(BM_MatrixToEuler);
+BENCHMARK(BM_VectorCrossProduct);
+BENCHMARK(BM_VectorDotProduct);
+BENCHMARK(BM_VectorNormalized);
+BENCHMARK(BM_QuaternionMultiplication);
+BENCHMARK(BM_QuaternionVectorMultiplication);
+BENCHMARK(BM_QuaternionRotate);
+BENCHMARK(BM_QuaternionRotateFast);
+BENCHMARK(BM_QuaternionToRotationMatrix);
+BENCHMARK(BM_QuaternionFromRotationMatrix);
 
 BENCHMARK_MAIN();
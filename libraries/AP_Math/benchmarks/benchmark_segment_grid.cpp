@@ -0,0 +1,108 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/AP_SegmentGrid.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// large fence: a star shaped inclusion polygon with state.range(0) points and
+// four small exclusion polygons inside it, in cm
+#define BENCHMARK_MAX_FENCE_POINTS      512
+#define BENCHMARK_EXCLUSION_POINTS      12
+#define BENCHMARK_NUM_EXCLUSIONS        4
+
+struct BenchmarkFence {
+    Vector2f inclusion[BENCHMARK_MAX_FENCE_POINTS];
+    uint16_t inclusion_num_points;
+    Vector2f exclusions[BENCHMARK_NUM_EXCLUSIONS][BENCHMARK_EXCLUSION_POINTS];
+};
+
+static void make_star(Vector2f *pts, uint16_t num_points, const Vector2f &center, float r_outer, float r_inner)
+{
+    for (uint16_t i = 0; i < num_points; i++) {
+        const float angle = M_2PI * i / num_points;
+        const float r = (i % 2) ? r_inner : r_outer;
+        pts[i] = center + Vector2f(cosf(angle), sinf(angle)) * r;
+    }
+}
+
+static void make_fence(BenchmarkFence &fence, uint16_t num_points)
+{
+    fence.inclusion_num_points = MIN(num_points, BENCHMARK_MAX_FENCE_POINTS);
+    make_star(fence.inclusion, fence.inclusion_num_points, Vector2f(0,0), 100000, 90000);
+    for (uint8_t i = 0; i < BENCHMARK_NUM_EXCLUSIONS; i++) {
+        const Vector2f center = Vector2f(cosf(i * M_PI_2), sinf(i * M_PI_2)) * 40000;
+        make_star(fence.exclusions[i], BENCHMARK_EXCLUSION_POINTS, center, 8000, 5000);
+    }
+}
+
+// visibility graph of every pair of inclusion points, testing each polygon in turn
+static void BM_VisGraphBruteForce(benchmark::State& state)
+{
+    BenchmarkFence fence;
+    make_fence(fence, state.range(0));
+
+    while (state.KeepRunning()) {
+        uint32_t visible = 0;
+        for (uint16_t i = 0; i < fence.inclusion_num_points; i++) {
+            for (uint16_t j = i + 1; j < fence.inclusion_num_points; j++) {
+                const Vector2f &p1 = fence.inclusion[i];
+                const Vector2f &p2 = fence.inclusion[j];
+                Vector2f intersection;
+                bool blocked = Polygon_intersects(fence.inclusion, fence.inclusion_num_points, p1, p2, intersection);
+                for (uint8_t k = 0; !blocked && k < BENCHMARK_NUM_EXCLUSIONS; k++) {
+                    blocked = Polygon_intersects(fence.exclusions[k], BENCHMARK_EXCLUSION_POINTS, p1, p2, intersection);
+                }
+                visible += blocked ? 0 : 1;
+            }
+        }
+        gbenchmark_escape(&visible);
+    }
+}
+
+// same visibility graph using the segment grid, including building the grid
+static void BM_VisGraphSegmentGrid(benchmark::State& state)
+{
+    BenchmarkFence fence;
+    make_fence(fence, state.range(0));
+
+    while (state.KeepRunning()) {
+        AP_SegmentGrid grid;
+        grid.add_polygon(fence.inclusion, fence.inclusion_num_points);
+        for (uint8_t k = 0; k < BENCHMARK_NUM_EXCLUSIONS; k++) {
+            grid.add_polygon(fence.exclusions[k], BENCHMARK_EXCLUSION_POINTS);
+        }
+        grid.build();
+
+        uint32_t visible = 0;
+        for (uint16_t i = 0; i < fence.inclusion_num_points; i++) {
+            for (uint16_t j = i + 1; j < fence.inclusion_num_points; j++) {
+                visible += grid.intersects(fence.inclusion[i], fence.inclusion[j]) ? 0 : 1;
+            }
+        }
+        gbenchmark_escape(&visible);
+    }
+}
+
+// single long segment query against a prebuilt grid
+static void BM_SegmentGridQuery(benchmark::State& state)
+{
+    BenchmarkFence fence;
+    make_fence(fence, state.range(0));
+    AP_SegmentGrid grid;
+    grid.add_polygon(fence.inclusion, fence.inclusion_num_points);
+    grid.build();
+
+    const Vector2f p1(-50000, -30000);
+    const Vector2f p2(60000, 20000);
+    while (state.KeepRunning()) {
+        bool ret = grid.intersects(p1, p2);
+        gbenchmark_escape(&ret);
+    }
+}
+
+BENCHMARK(BM_VisGraphBruteForce)->Arg(64)->Arg(128)->Arg(250);
+BENCHMARK(BM_VisGraphSegmentGrid)->Arg(64)->Arg(128)->Arg(250);
+BENCHMARK(BM_SegmentGridQuery)->Arg(64)->Arg(250)->Arg(512);
+
+BENCHMARK_MAIN();
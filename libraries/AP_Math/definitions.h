@@ -27,6 +27,17 @@
   #define MATH_CHECK_INDEXES 0
 #endif
 
+// compute float Quaternion products with GCC vector extensions, which
+// compile to SSE or NEON instructions. Each lane does the same
+// operations in the same order as the scalar code
+#ifndef AP_MATH_SIMD_ENABLED
+#if defined(__ARM_NEON) || defined(__SSE2__)
+#define AP_MATH_SIMD_ENABLED 1
+#else
+#define AP_MATH_SIMD_ENABLED 0
+#endif
+#endif
+
 #define DEG_TO_RAD      (M_PI / 180.0f)
 #define RAD_TO_DEG      (180.0f / M_PI)
 
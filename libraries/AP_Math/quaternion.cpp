@@ -825,6 +825,41 @@ T QuaternionT<T>::roll_pitch_difference(const QuaternionT<T> &v) const
     return (2.0 * asinF(vec_len_div2));
 }
 
+#if AP_MATH_SIMD_ENABLED
+/*
+  float specialisations of the quaternion product, holding q1..q4 in
+  the four lanes of a vector. The sign of each term is folded into the
+  permuted copies of v, as a + (-b) is exactly a - b
+ */
+typedef float simd_float4 __attribute__((vector_size(16), aligned(4)));
+
+static inline simd_float4 quat_product(const QuaternionT<float> &q, const QuaternionT<float> &v)
+{
+    return q.q1 * simd_float4{ v.q1,  v.q2,  v.q3,  v.q4} +
+           q.q2 * simd_float4{-v.q2,  v.q1, -v.q4,  v.q3} +
+           q.q3 * simd_float4{-v.q3,  v.q4,  v.q1, -v.q2} +
+           q.q4 * simd_float4{-v.q4, -v.q3,  v.q2,  v.q1};
+}
+
+template <>
+QuaternionT<float> QuaternionT<float>::operator*(const QuaternionT<float> &v) const
+{
+    const simd_float4 r = quat_product(*this, v);
+    return QuaternionT<float>(r[0], r[1], r[2], r[3]);
+}
+
+template <>
+QuaternionT<float> &QuaternionT<float>::operator*=(const QuaternionT<float> &v)
+{
+    const simd_float4 r = quat_product(*this, v);
+    q1 = r[0];
+    q2 = r[1];
+    q3 = r[2];
+    q4 = r[3];
+    return *this;
+}
+#endif // AP_MATH_SIMD_ENABLED
+
 // define for float and double
 template class QuaternionT<float>;
 template class QuaternionT<double>;
@@ -212,5 +212,10 @@ public:
 typedef QuaternionT<float> Quaternion;
 typedef QuaternionT<double> QuaternionD;
 
+#if AP_MATH_SIMD_ENABLED
+template<> QuaternionT<float> QuaternionT<float>::operator*(const QuaternionT<float> &v) const;
+template<> QuaternionT<float> &QuaternionT<float>::operator*=(const QuaternionT<float> &v);
+#endif
+
 
 
@@ -111,6 +111,54 @@ INSTANTIATE_TEST_CASE_P(NonInvertibleMatrices,
                         Matrix3fTest,
                         ::testing::ValuesIn(non_invertible));
 
+static float rand_range(float lo, float hi)
+{
+    return lo + (hi - lo) * (float(random()) / float(RAND_MAX));
+}
+
+// the products must give exactly the scalar results, whether or not
+// they are computed with SIMD instructions
+TEST(Matrix3Test, ProductsMatchScalar)
+{
+    for (uint16_t i = 0; i < 100; i++) {
+        Matrix3f m1, m2;
+        m1.from_euler(rand_range(-2, 2), rand_range(-2, 2), rand_range(-2, 2));
+        m2.from_euler(rand_range(-2, 2), rand_range(-2, 2), rand_range(-2, 2));
+        m1 *= 1.5f;
+        const Vector3f v{rand_range(-2, 2), rand_range(-2, 2), rand_range(-2, 2)};
+
+        const Matrix3f m = m1 * m2;
+        EXPECT_EQ(m.a.x, m1.a.x * m2.a.x + m1.a.y * m2.b.x + m1.a.z * m2.c.x);
+        EXPECT_EQ(m.a.y, m1.a.x * m2.a.y + m1.a.y * m2.b.y + m1.a.z * m2.c.y);
+        EXPECT_EQ(m.a.z, m1.a.x * m2.a.z + m1.a.y * m2.b.z + m1.a.z * m2.c.z);
+        EXPECT_EQ(m.b.x, m1.b.x * m2.a.x + m1.b.y * m2.b.x + m1.b.z * m2.c.x);
+        EXPECT_EQ(m.b.y, m1.b.x * m2.a.y + m1.b.y * m2.b.y + m1.b.z * m2.c.y);
+        EXPECT_EQ(m.b.z, m1.b.x * m2.a.z + m1.b.y * m2.b.z + m1.b.z * m2.c.z);
+        EXPECT_EQ(m.c.x, m1.c.x * m2.a.x + m1.c.y * m2.b.x + m1.c.z * m2.c.x);
+        EXPECT_EQ(m.c.y, m1.c.x * m2.a.y + m1.c.y * m2.b.y + m1.c.z * m2.c.y);
+        EXPECT_EQ(m.c.z, m1.c.x * m2.a.z + m1.c.y * m2.b.z + m1.c.z * m2.c.z);
+
+        const Vector3f mv = m1 * v;
+        EXPECT_EQ(mv.x, m1.a.x * v.x + m1.a.y * v.y + m1.a.z * v.z);
+        EXPECT_EQ(mv.y, m1.b.x * v.x + m1.b.y * v.y + m1.b.z * v.z);
+        EXPECT_EQ(mv.z, m1.c.x * v.x + m1.c.y * v.y + m1.c.z * v.z);
+
+        const Vector3f mtv = m1.mul_transpose(v);
+        EXPECT_EQ(mtv.x, m1.a.x * v.x + m1.b.x * v.y + m1.c.x * v.z);
+        EXPECT_EQ(mtv.y, m1.a.y * v.x + m1.b.y * v.y + m1.c.y * v.z);
+        EXPECT_EQ(mtv.z, m1.a.z * v.x + m1.b.z * v.y + m1.c.z * v.z);
+
+        Matrix3f r = m1;
+        r.rotate(v);
+        const Matrix3f expected = m1 + Matrix3f{m1.a % v, m1.b % v, m1.c % v};
+        for (uint8_t j = 0; j < 3; j++) {
+            for (uint8_t k = 0; k < 3; k++) {
+                EXPECT_EQ(r[j][k], expected[j][k]);
+            }
+        }
+    }
+}
+
 AP_GTEST_MAIN()
 
 #pragma GCC diagnostic pop
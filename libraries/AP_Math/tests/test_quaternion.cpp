@@ -251,4 +251,34 @@ TEST(QuaternionTest, Quaternion_length_squared)
     EXPECT_FLOAT_EQ(q.length_squared(), 1.44);
 }
 
+static float rand_range(float lo, float hi)
+{
+    return lo + (hi - lo) * (float(random()) / float(RAND_MAX));
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wfloat-equal"
+// the product must give exactly the scalar result, whether or not it
+// is computed with SIMD instructions
+TEST(QuaternionTest, QuaternionMultiplicationMatchesScalar)
+{
+    for (uint16_t i = 0; i < 100; i++) {
+        const Quaternion q1(rand_range(-1, 1), rand_range(-1, 1), rand_range(-1, 1), rand_range(-1, 1));
+        const Quaternion q2(rand_range(-1, 1), rand_range(-1, 1), rand_range(-1, 1), rand_range(-1, 1));
+
+        const Quaternion expected(q1.q1*q2.q1 - q1.q2*q2.q2 - q1.q3*q2.q3 - q1.q4*q2.q4,
+                                  q1.q1*q2.q2 + q1.q2*q2.q1 + q1.q3*q2.q4 - q1.q4*q2.q3,
+                                  q1.q1*q2.q3 - q1.q2*q2.q4 + q1.q3*q2.q1 + q1.q4*q2.q2,
+                                  q1.q1*q2.q4 + q1.q2*q2.q3 - q1.q3*q2.q2 + q1.q4*q2.q1);
+        Quaternion q = q1;
+        q *= q2;
+        const Quaternion product = q1 * q2;
+        for (uint8_t j = 0; j < 4; j++) {
+            EXPECT_EQ(product[j], expected[j]);
+            EXPECT_EQ(q[j], expected[j]);
+        }
+    }
+}
+#pragma GCC diagnostic pop
+
 AP_GTEST_MAIN()
\ No newline at end of file
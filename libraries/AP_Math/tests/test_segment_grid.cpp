@@ -0,0 +1,142 @@
+#include <AP_gtest.h>
+#include <AP_Common/AP_Common.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/AP_SegmentGrid.h>
+
+#include <stdlib.h>
+
+// star shaped polygon with num_points points, alternating between two radii
+static void make_star(Vector2f *pts, uint16_t num_points, const Vector2f &center, float r_outer, float r_inner)
+{
+    for (uint16_t i = 0; i < num_points; i++) {
+        const float angle = M_2PI * i / num_points;
+        const float r = (i % 2) ? r_inner : r_outer;
+        pts[i] = center + Vector2f(cosf(angle), sinf(angle)) * r;
+    }
+}
+
+static float rand_range(float lo, float hi)
+{
+    return lo + (hi - lo) * (float(random()) / float(RAND_MAX));
+}
+
+TEST(SegmentGridTest, Empty)
+{
+    AP_SegmentGrid grid;
+    EXPECT_TRUE(grid.build());
+    EXPECT_FALSE(grid.intersects(Vector2f(0,0), Vector2f(10,10)));
+}
+
+TEST(SegmentGridTest, Square)
+{
+    const Vector2f square[] = {{0,0}, {0,10}, {10,10}, {10,0}, {0,0}};
+    AP_SegmentGrid grid;
+    EXPECT_TRUE(grid.add_polygon(square, ARRAY_SIZE(square)));
+    EXPECT_EQ(grid.num_edges(), 4);
+    EXPECT_TRUE(grid.build());
+
+    // fully inside and fully outside
+    EXPECT_FALSE(grid.intersects(Vector2f(1,1), Vector2f(9,9)));
+    EXPECT_FALSE(grid.intersects(Vector2f(-5,-5), Vector2f(-1,20)));
+    EXPECT_FALSE(grid.intersects(Vector2f(20,20), Vector2f(30,40)));
+
+    // crossing one or two sides
+    EXPECT_TRUE(grid.intersects(Vector2f(5,5), Vector2f(15,5)));
+    EXPECT_TRUE(grid.intersects(Vector2f(-5,5), Vector2f(15,5)));
+    EXPECT_TRUE(grid.intersects(Vector2f(-5,-4), Vector2f(15,14)));
+
+    // degenerate segment
+    EXPECT_FALSE(grid.intersects(Vector2f(5,5), Vector2f(5,5)));
+}
+
+// grid must agree with Polygon_intersects for every query
+TEST(SegmentGridTest, MatchesBruteForce)
+{
+    srandom(17);
+
+    const uint16_t num_star_points = 300;
+    Vector2f star[num_star_points];
+    make_star(star, num_star_points, Vector2f(0,0), 10000, 8000);
+
+    const uint16_t num_hole_points = 40;
+    Vector2f hole[num_hole_points];
+    make_star(hole, num_hole_points, Vector2f(2000,-1500), 1500, 700);
+
+    AP_SegmentGrid grid;
+    ASSERT_TRUE(grid.add_polygon(star, num_star_points));
+    ASSERT_TRUE(grid.add_polygon(hole, num_hole_points));
+    ASSERT_TRUE(grid.build());
+    EXPECT_TRUE(grid.built());
+    EXPECT_EQ(grid.num_edges(), num_star_points + num_hole_points);
+
+    uint32_t num_intersecting = 0;
+    for (uint32_t i = 0; i < 20000; i++) {
+        const Vector2f p1(rand_range(-12000, 12000), rand_range(-12000, 12000));
+        Vector2f p2;
+        if (i % 2) {
+            // short segments
+            p2 = p1 + Vector2f(rand_range(-1000, 1000), rand_range(-1000, 1000));
+        } else {
+            p2 = Vector2f(rand_range(-12000, 12000), rand_range(-12000, 12000));
+        }
+        Vector2f intersection;
+        const bool expected = Polygon_intersects(star, num_star_points, p1, p2, intersection) ||
+                              Polygon_intersects(hole, num_hole_points, p1, p2, intersection);
+        EXPECT_EQ(grid.intersects(p1, p2), expected) << "p1=(" << p1.x << "," << p1.y << ") p2=(" << p2.x << "," << p2.y << ")";
+        if (expected) {
+            num_intersecting++;
+        }
+    }
+    // make sure both outcomes were exercised
+    EXPECT_GT(num_intersecting, 1000U);
+    EXPECT_LT(num_intersecting, 19000U);
+
+    // segments between polygon vertices, as used by visibility graphs
+    for (uint16_t i = 0; i < num_star_points; i += 7) {
+        for (uint16_t j = i + 1; j < num_star_points; j += 5) {
+            Vector2f intersection;
+            const bool expected = Polygon_intersects(star, num_star_points, star[i], star[j], intersection) ||
+                                  Polygon_intersects(hole, num_hole_points, star[i], star[j], intersection);
+            EXPECT_EQ(grid.intersects(star[i], star[j]), expected);
+        }
+    }
+
+    // axis aligned segments walk along a single row or column of cells
+    for (float v = -11000; v < 11000; v += 333) {
+        Vector2f intersection;
+        const Vector2f a(v, -11000), b(v, 11000);
+        EXPECT_EQ(grid.intersects(a, b), Polygon_intersects(star, num_star_points, a, b, intersection));
+        const Vector2f c(-11000, v), d(11000, v);
+        EXPECT_EQ(grid.intersects(c, d), Polygon_intersects(star, num_star_points, c, d, intersection));
+    }
+}
+
+// adding a polygon invalidates the index
+TEST(SegmentGridTest, AddAfterBuild)
+{
+    const Vector2f a[] = {{0,0}, {0,10}, {10,10}, {10,0}};
+    const Vector2f b[] = {{100,100}, {100,110}, {110,110}, {110,100}};
+    AP_SegmentGrid grid;
+    EXPECT_TRUE(grid.add_polygon(a, ARRAY_SIZE(a)));
+    EXPECT_TRUE(grid.build());
+    EXPECT_TRUE(grid.add_polygon(b, ARRAY_SIZE(b)));
+    EXPECT_FALSE(grid.built());
+
+    // still correct without an index
+    EXPECT_TRUE(grid.intersects(Vector2f(105,105), Vector2f(120,105)));
+
+    EXPECT_TRUE(grid.build());
+    EXPECT_TRUE(grid.intersects(Vector2f(105,105), Vector2f(120,105)));
+    EXPECT_FALSE(grid.intersects(Vector2f(20,20), Vector2f(90,90)));
+    EXPECT_GT(grid.memory_used(), 0U);
+
+    grid.clear();
+    EXPECT_EQ(grid.num_edges(), 0);
+    EXPECT_FALSE(grid.intersects(Vector2f(105,105), Vector2f(120,105)));
+}
+
+AP_GTEST_MAIN()
+
+
+int hal = 0; // bizarrely, this fixes an undefined-symbol error but doesn't raise a type exception.  Yay.
@@ -75,9 +75,10 @@ void AP_Mission::init()
     }
 #endif
 
-    // work out maximum index for our storage size
+    // work out maximum index for our storage size. The number of
+    // commands is held in a 16 bit signed parameter
     if (_storage.size() >= AP_MISSION_EEPROM_COMMAND_SIZE+4) {
-        _commands_max = (_storage.size()-4U) / AP_MISSION_EEPROM_COMMAND_SIZE;
+        _commands_max = MIN((_storage.size()-4U) / AP_MISSION_EEPROM_COMMAND_SIZE, uint32_t(INT16_MAX));
     }
     if (_cmd_total.get() > _commands_max) {
         // wipe mission if storage not available, but don't save. This allows sdcard error to be fixed and reboot
@@ -98,6 +99,7 @@ void AP_Mission::init()
         clear();
     }
 
+    invalidate_cmd_cache();
     _last_change_time_ms = AP_HAL::millis();
 }
 
@@ -109,7 +111,11 @@ void AP_Mission::start()
 
     reset(); // reset mission to the first command, resets jump tracking
 
-    // advance to the first command
+    // advance to the first command. If the commands are still being
+    // read from microSD update() advances once they are available
+    if (next_nav_cmd_pending()) {
+        return;
+    }
     if (!advance_current_nav_cmd()) {
         // on failure set mission complete
         complete();
@@ -143,8 +149,9 @@ void AP_Mission::resume()
         }
     }
 
-    // ensure cache coherence
-    if (!read_cmd_from_storage(_nav_cmd.index, _nav_cmd)) {
+    // ensure cache coherence. A command still being read from microSD
+    // is resumed as held in RAM
+    if (!read_cmd_from_storage(_nav_cmd.index, _nav_cmd) && !_storage.io_pending()) {
         // if we failed to read the command from storage, then the command may have
         // been from a previously loaded mission it is illogical to ever resume
         // flying to a command that has been excluded from the current mission
@@ -297,10 +304,23 @@ void AP_Mission::truncate(uint16_t index)
 {
     if ((unsigned)_cmd_total > index) {
         _cmd_total.set_and_save(index);
+        invalidate_cmd_cache();
         _last_change_time_ms = AP_HAL::millis();
     }
 }
 
+/// invalidate_cmd_cache - discard cached commands and the special command index
+void AP_Mission::invalidate_cmd_cache()
+{
+    WITH_SEMAPHORE(_rsem);
+
+    for (auto &entry : _cmd_cache) {
+        entry.valid = false;
+    }
+    _special_cmds_valid = false;
+    _special_cmds_next = 0;
+}
+
 /// update - ensures the command queues are loaded with the next command and calls main programs command_init and command_verify functions to progress the mission
 ///     should be called at 10hz or higher
 void AP_Mission::update()
@@ -323,6 +343,10 @@ void AP_Mission::update()
 
     // check if we have an active nav command
     if (!_flags.nav_cmd_loaded || _nav_cmd.index == AP_MISSION_CMD_INDEX_NONE) {
+        // wait for the commands if they are still being read from microSD
+        if (next_nav_cmd_pending()) {
+            return;
+        }
         // advance in mission if no active nav command
         if (!advance_current_nav_cmd()) {
             // failure to advance nav command means mission has completed
@@ -334,6 +358,10 @@ void AP_Mission::update()
         if (verify_command(_nav_cmd)) {
             // market _nav_cmd as complete (it will be started on the next iteration)
             _flags.nav_cmd_loaded = false;
+            // wait for the commands if they are still being read from microSD
+            if (next_nav_cmd_pending()) {
+                return;
+            }
             // immediately advance to the next mission command
             if (!advance_current_nav_cmd()) {
                 // failure to advance nav command means mission has completed
@@ -776,26 +804,40 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
         return false;
     }
 
-    // ensure all bytes of cmd are zeroed
-    cmd = {};
+    // commands are often read repeatedly (lookahead, landing and
+    // jump-tag searches) so avoid re-reading and decoding them
+    CmdCacheEntry &cache_entry = _cmd_cache[index % AP_MISSION_CMD_CACHE_SIZE];
+    if (cache_entry.valid && cache_entry.cmd.index == index) {
+        cmd = cache_entry.cmd;
+        return true;
+    }
 
     // Find out proper location in memory by using the start_byte position + the index
     // we can load a command, we don't process it yet
     // read WP position
-    const uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+    const uint32_t pos_in_storage = 4 + (uint32_t(index) * AP_MISSION_EEPROM_COMMAND_SIZE);
+
+    // read the whole command at once, cmd is unchanged on failure
+    uint8_t b[AP_MISSION_EEPROM_COMMAND_SIZE];
+    if (!read_storage_block(b, pos_in_storage, sizeof(b))) {
+        return false;
+    }
+
+    // ensure all bytes of cmd are zeroed
+    cmd = {};
 
     PackedContent packed_content {};
 
-    const uint8_t b1 = _storage.read_byte(pos_in_storage);
+    const uint8_t b1 = b[0];
     if (b1 == 0 || b1 == 1) {
-        cmd.id = _storage.read_uint16(pos_in_storage+1);
-        cmd.p1 = _storage.read_uint16(pos_in_storage+3);
-        _storage.read_block(packed_content.bytes, pos_in_storage+5, 10);
+        memcpy(&cmd.id, &b[1], 2);
+        memcpy(&cmd.p1, &b[3], 2);
+        memcpy(packed_content.bytes, &b[5], 10);
         format_conversion(b1, cmd, packed_content);
     } else {
         cmd.id = b1;
-        cmd.p1 = _storage.read_uint16(pos_in_storage+1);
-        _storage.read_block(packed_content.bytes, pos_in_storage+3, 12);
+        memcpy(&cmd.p1, &b[1], 2);
+        memcpy(packed_content.bytes, &b[3], 12);
     }
 
     if (stored_in_location(cmd.id)) {
@@ -834,6 +876,9 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
     // set command's index to it's position in eeprom
     cmd.index = index;
 
+    cache_entry.cmd = cmd;
+    cache_entry.valid = true;
+
     // return success
     return true;
 }
@@ -901,13 +946,16 @@ bool AP_Mission::write_cmd_to_storage(uint16_t index, const Mission_Command& cmd
     }
 
     // calculate where in storage the command should be placed
-    uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+    const uint32_t pos_in_storage = 4 + (uint32_t(index) * AP_MISSION_EEPROM_COMMAND_SIZE);
 
+    // the command is written in one block, so it is either stored
+    // completely or not at all
+    uint8_t b[AP_MISSION_EEPROM_COMMAND_SIZE];
     if (cmd.id < 256) {
         // for commands below 256 we store up to 12 bytes
-        _storage.write_byte(pos_in_storage, cmd.id);
-        _storage.write_uint16(pos_in_storage+1, cmd.p1);
-        _storage.write_block(pos_in_storage+3, packed.bytes, 12);
+        b[0] = cmd.id;
+        memcpy(&b[1], &cmd.p1, 2);
+        memcpy(&b[3], packed.bytes, 12);
     } else {
         // if the command ID is above 256 we store a tag byte followed
         // by the 16 bit command ID. The tag byte is 1 for commands
@@ -918,12 +966,20 @@ bool AP_Mission::write_cmd_to_storage(uint16_t index, const Mission_Command& cmd
         if (cmd.id == MAV_CMD_NAV_SCRIPT_TIME) {
             tag_byte = 1;
         }
-        _storage.write_byte(pos_in_storage, tag_byte);
-        _storage.write_uint16(pos_in_storage+1, cmd.id);
-        _storage.write_uint16(pos_in_storage+3, cmd.p1);
-        _storage.write_block(pos_in_storage+5, packed.bytes, 10);
+        b[0] = tag_byte;
+        memcpy(&b[1], &cmd.id, 2);
+        memcpy(&b[3], &cmd.p1, 2);
+        memcpy(&b[5], packed.bytes, 10);
+    }
+    if (!_storage.write_block(pos_in_storage, b, sizeof(b))) {
+        return false;
     }
 
+    // forget any cached copy of this command
+    _cmd_cache[index % AP_MISSION_CMD_CACHE_SIZE].valid = false;
+    _special_cmds_valid = false;
+    _special_cmds_next = 0;
+
     // remember when the mission last changed
     _last_change_time_ms = AP_HAL::millis();
 
@@ -2076,8 +2132,11 @@ void AP_Mission::advance_current_do_cmd()
     // find next do command
     Mission_Command cmd;
     if (!get_next_do_cmd(cmd_index, cmd)) {
-        // set flag to stop unnecessarily searching for do commands
-        _flags.do_cmd_all_done = true;
+        // set flag to stop unnecessarily searching for do commands,
+        // unless the command is still being read from microSD
+        if (!_storage.io_pending()) {
+            _flags.do_cmd_all_done = true;
+        }
         return;
     }
 
@@ -2087,6 +2146,29 @@ void AP_Mission::advance_current_do_cmd()
     start_command(_do_cmd);
 }
 
+/// next_nav_cmd_pending - returns true if the commands up to the next
+///     nav command are still being read from microSD. Checked before
+///     advance_current_nav_cmd() so it doesn't start do commands or count
+///     jumps and then fail part way through
+bool AP_Mission::next_nav_cmd_pending()
+{
+    if (!_storage.paged()) {
+        return false;
+    }
+    uint16_t cmd_index = _nav_cmd.index == AP_MISSION_CMD_INDEX_NONE ? AP_MISSION_FIRST_REAL_COMMAND : _nav_cmd.index+1;
+    Mission_Command cmd;
+    for (uint8_t i=0; i<255; i++) {
+        if (!get_next_cmd(cmd_index, cmd, false)) {
+            return _storage.io_pending();
+        }
+        if (is_nav_cmd(cmd)) {
+            return false;
+        }
+        cmd_index = cmd.index+1;
+    }
+    return false;
+}
+
 /// get_next_cmd - gets next command found at or after start_index
 ///     returns true if found, false if not found (i.e. mission complete)
 ///     accounts for do_jump commands
@@ -2208,11 +2290,8 @@ bool AP_Mission::jump_to_tag(const uint16_t tag)
 // Returns 0 if no appropriate JUMP_TAG match can be found.
 uint16_t AP_Mission::get_index_of_jump_tag(const uint16_t tag) const
 {
-    const auto count = num_commands();
-    for (uint16_t i = 1; i < count; i++) {
-        if (get_command_id(i) != uint16_t(MAV_CMD_JUMP_TAG)) {
-            continue;
-        }
+    StorageWait wait(*this);
+    for (uint16_t i = next_cmd_with_id(MAV_CMD_JUMP_TAG, 1); i != 0; i = next_cmd_with_id(MAV_CMD_JUMP_TAG, i+1)) {
         Mission_Command tmp;
         if (!read_cmd_from_storage(i, tmp)) {
             continue;
@@ -2324,6 +2403,7 @@ void AP_Mission::check_eeprom_version()
 // be found.
 uint16_t AP_Mission::get_landing_sequence_start()
 {
+    StorageWait wait(*this);
     Location current_loc;
 
     if (!AP::ahrs().get_location(current_loc)) {
@@ -2335,11 +2415,7 @@ uint16_t AP_Mission::get_landing_sequence_start()
     float min_distance = -1;
 
     // Go through mission looking for nearest landing start command
-    const auto count = num_commands();
-    for (uint16_t i = 1; i < count; i++) {
-        if (get_command_id(i) != uint16_t(MAV_CMD_DO_LAND_START)) {
-            continue;
-        }
+    for (uint16_t i = next_cmd_with_id(MAV_CMD_DO_LAND_START, 1); i != 0; i = next_cmd_with_id(MAV_CMD_DO_LAND_START, i+1)) {
         Mission_Command tmp;
         if (!read_cmd_from_storage(i, tmp)) {
             continue;
@@ -2396,17 +2472,14 @@ bool AP_Mission::jump_to_landing_sequence(void)
 // jumps the mission to the closest landing abort that is planned, returns false if unable to find a valid abort
 bool AP_Mission::jump_to_abort_landing_sequence(void)
 {
+    StorageWait wait(*this);
     Location current_loc;
 
     uint16_t abort_index = 0;
     if (AP::ahrs().get_location(current_loc)) {
         float min_distance = FLT_MAX;
 
-        const auto count = num_commands();
-        for (uint16_t i = 1; i < count; i++) {
-            if (get_command_id(i) != uint16_t(MAV_CMD_DO_GO_AROUND)) {
-                continue;
-            }
+        for (uint16_t i = next_cmd_with_id(MAV_CMD_DO_GO_AROUND, 1); i != 0; i = next_cmd_with_id(MAV_CMD_DO_GO_AROUND, i+1)) {
             Mission_Command tmp;
             if (!read_cmd_from_storage(i, tmp)) {
                 continue;
@@ -2724,9 +2797,9 @@ const char *AP_Mission::Mission_Command::type() const
  */
 uint16_t AP_Mission::get_command_id(uint16_t index) const
 {
-    const uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+    const uint32_t pos_in_storage = 4 + (uint32_t(index) * AP_MISSION_EEPROM_COMMAND_SIZE);
     uint8_t b[3] {};
-    if (!_storage.read_block(b, pos_in_storage, sizeof(b))) {
+    if (!read_storage_block(b, pos_in_storage, sizeof(b))) {
         return 0U;
     }
     uint16_t id = 0;
@@ -2739,15 +2812,127 @@ uint16_t AP_Mission::get_command_id(uint16_t index) const
 }
 
 /*
-  see if the mission contains a particular item
+  read from mission storage. While a StorageWait is held a read of a
+  page that is not cached yet waits for the IO thread to load it, so
+  searches don't miss commands
  */
-bool AP_Mission::contains_item(MAV_CMD command) const
+bool AP_Mission::read_storage_block(void *dst, uint32_t ofs, size_t n) const
+{
+    const uint32_t start_ms = AP_HAL::millis();
+    while (!_storage.read_block(dst, ofs, n)) {
+        if (_storage_wait == 0 || !_storage.io_pending() ||
+            AP_HAL::millis() - start_ms > AP_MISSION_STORAGE_WAIT_MS) {
+            return false;
+        }
+        hal.scheduler->delay_microseconds(500);
+    }
+    return true;
+}
+
+/*
+  return true if commands with this ID are held in the special command index
+ */
+bool AP_Mission::is_special_cmd(uint16_t id)
+{
+    switch (id) {
+    case MAV_CMD_DO_LAND_START:
+    case MAV_CMD_DO_GO_AROUND:
+    case MAV_CMD_JUMP_TAG:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*
+  record the position of every special command in the mission. Commands
+  still being read from microSD are waited for, but if the card is too
+  slow the index is completed over several calls
+ */
+void AP_Mission::build_special_cmd_index() const
 {
     const auto count = num_commands();
-    for (uint16_t i = 1; i < count; i++) {
-        if (get_command_id(i) != uint16_t(command)) {
+    if (_special_cmds_next == 0 || _special_cmds_total != count) {
+        _special_cmds_valid = false;
+        _num_special_cmds = 0;
+        _special_cmds_overflow = false;
+        _special_cmds_total = count;
+        _special_cmds_next = 1;
+    }
+
+    for (; _special_cmds_next < count; _special_cmds_next++) {
+        const uint16_t i = _special_cmds_next;
+        const uint16_t id = get_command_id(i);
+        if (id == 0 && _storage.io_pending()) {
+            // timed out, carry on from here once the command has been read
+            return;
+        }
+        if (!is_special_cmd(id)) {
             continue;
         }
+        if (_num_special_cmds >= ARRAY_SIZE(_special_cmds)) {
+            // commands after the last indexed one are found by
+            // searching storage
+            _special_cmds_overflow = true;
+            break;
+        }
+        _special_cmds[_num_special_cmds].index = i;
+        _special_cmds[_num_special_cmds].id = id;
+        _num_special_cmds++;
+    }
+
+    _special_cmds_valid = true;
+}
+
+/*
+  return the index of the first command with this ID at or after
+  start, or 0 if there is none.  Special commands come from the index,
+  anything else is found by reading command IDs from storage
+ */
+uint16_t AP_Mission::next_cmd_with_id(uint16_t id, uint16_t start) const
+{
+    WITH_SEMAPHORE(_rsem);
+    StorageWait wait(*this);
+
+    const auto count = num_commands();
+    uint16_t search_start = MAX(start, 1U);
+    if (is_special_cmd(id)) {
+        // the command total is a parameter, so may be changed without
+        // writing to the mission
+        if (!_special_cmds_valid || _special_cmds_total != count) {
+            build_special_cmd_index();
+        }
+        for (uint8_t i = 0; i < _num_special_cmds; i++) {
+            if (_special_cmds[i].id == id && _special_cmds[i].index >= search_start) {
+                return _special_cmds[i].index;
+            }
+        }
+        if (!_special_cmds_valid) {
+            // the index could not be completed from microSD in time,
+            // so search the rest of the mission directly
+            search_start = MAX(search_start, _special_cmds_next);
+        } else if (!_special_cmds_overflow) {
+            return 0;
+        } else {
+            search_start = MAX(search_start, _special_cmds[_num_special_cmds-1].index + 1U);
+        }
+    }
+
+    for (uint16_t i = search_start; i < count; i++) {
+        if (get_command_id(i) == id) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+/*
+  see if the mission contains a particular item
+ */
+bool AP_Mission::contains_item(MAV_CMD command) const
+{
+    StorageWait wait(*this);
+    for (uint16_t i = next_cmd_with_id(command, 1); i != 0; i = next_cmd_with_id(command, i+1)) {
         // confirm with full read
         Mission_Command tmp;
         if (!read_cmd_from_storage(i, tmp)) {
@@ -2787,6 +2972,7 @@ bool AP_Mission::contains_terrain_alt_items(void)
 
 bool AP_Mission::calculate_contains_terrain_alt_items(void) const
 {
+    StorageWait wait(*this);
     const auto count = num_commands();
     for (uint16_t i = 1; i < count; i++) {
         if (!stored_in_location(get_command_id(i))) {
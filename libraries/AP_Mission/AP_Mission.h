@@ -34,6 +34,22 @@
 #endif
 #endif
 
+#ifndef AP_MISSION_CMD_CACHE_SIZE
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define AP_MISSION_CMD_CACHE_SIZE           16      // number of decoded commands cached
+#else
+#define AP_MISSION_CMD_CACHE_SIZE           4
+#endif
+#endif
+
+#ifndef AP_MISSION_STORAGE_WAIT_MS
+#define AP_MISSION_STORAGE_WAIT_MS          250     // longest a mission search waits for a command to be read from microSD
+#endif
+
+#ifndef AP_MISSION_SPECIAL_CMD_INDEX_SIZE
+#define AP_MISSION_SPECIAL_CMD_INDEX_SIZE   32      // number of DO_LAND_START, DO_GO_AROUND and JUMP_TAG commands indexed
+#endif
+
 #define AP_MISSION_JUMP_REPEAT_FOREVER      -1      // when do-jump command's repeat count is -1 this means endless repeat
 
 #define AP_MISSION_CMD_ID_NONE              0       // mavlink cmd id of zero means invalid or missing command
@@ -796,6 +812,9 @@ private:
     //      returns true if command is advanced, false if failed (i.e. mission completed)
     bool advance_current_nav_cmd(uint16_t starting_index = 0);
 
+    /// next_nav_cmd_pending - returns true if the commands up to the next nav command are still being read from microSD
+    bool next_nav_cmd_pending();
+
     /// advance_current_do_cmd - moves current do command forward
     ///     accounts for do-jump commands
     ///     returns true if successfully advanced (can it ever be unsuccessful?)
@@ -894,6 +913,49 @@ private:
     // fast call to get command ID of a mission index
     uint16_t get_command_id(uint16_t index) const;
 
+    // cache of decoded commands, direct mapped by command index
+    struct CmdCacheEntry {
+        Mission_Command cmd;
+        bool valid;
+    };
+    mutable CmdCacheEntry _cmd_cache[AP_MISSION_CMD_CACHE_SIZE];
+
+    // index of commands searched for by landing and jump-tag lookups,
+    // rebuilt on first use after the mission changes
+    struct SpecialCmd {
+        uint16_t index;
+        uint16_t id;
+    };
+    mutable SpecialCmd _special_cmds[AP_MISSION_SPECIAL_CMD_INDEX_SIZE];
+    mutable uint8_t _num_special_cmds;
+    mutable bool _special_cmds_valid;
+    mutable bool _special_cmds_overflow;    // true if more commands were found than fit in the index
+    mutable uint16_t _special_cmds_total;   // number of commands in the mission when the index was built
+    mutable uint16_t _special_cmds_next;    // next command to index, 0 to start again
+    static bool is_special_cmd(uint16_t id);
+    void build_special_cmd_index() const;
+
+    // discard cached commands and the special command index
+    void invalidate_cmd_cache();
+
+    // searches over the whole mission, such as landing and jump tag
+    // lookups, hold a StorageWait so that commands still being read
+    // from microSD are waited for rather than reported as missing
+    mutable uint8_t _storage_wait;
+    class StorageWait {
+    public:
+        StorageWait(const AP_Mission &mission) : _mission(mission) { _mission._storage_wait++; }
+        ~StorageWait() { _mission._storage_wait--; }
+    private:
+        const AP_Mission &_mission;
+    };
+
+    // read from mission storage, waiting for microSD while a StorageWait is held
+    bool read_storage_block(void *dst, uint32_t ofs, size_t n) const;
+
+    // return the index of the first command with this id at or after start, 0 if there is none
+    uint16_t next_cmd_with_id(uint16_t id, uint16_t start) const;
+
     // memoisation of contains-relative:
     bool _contains_terrain_alt_items;  // true if the mission has terrain-relative items
     uint32_t _last_contains_relative_calculated_ms;  // will be equal to _last_change_time_ms if _contains_terrain_alt_items is up-to-date
@@ -210,7 +210,8 @@ float AP_MotorsMatrix::boost_ratio(float boost_value, float normal_value) const
 
 // output_armed - sends commands to the motors
 // includes new scaling stability patch
-void AP_MotorsMatrix::output_armed_stabilizing()
+template <uint8_t N, bool ALL_ENABLED>
+void AP_MotorsMatrix::output_armed_stabilizing_mix()
 {
     // apply voltage and air pressure compensation
     const float compensation_gain = thr_lin.get_compensation_gain(); // compensation for battery voltage and altitude
@@ -274,8 +275,8 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     // calculate amount of yaw we can fit into the throttle range
     // this is always equal to or less than the requested yaw from the pilot or rate controller
     float yaw_allowed = 1.0f; // amount of yaw we can fit in
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
+    for (uint8_t i = 0; i < N; i++) {
+        if (motor_used<N, ALL_ENABLED>(i)) {
             // calculate the thrust outputs for roll and pitch
             _thrust_rpyt_out[i] = roll_thrust * _roll_factor[i] + pitch_thrust * _pitch_factor[i];
 
@@ -308,7 +309,7 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     yaw_allowed = MAX(yaw_allowed, yaw_allowed_min);
 
     // Include the lost motor scaled by _thrust_boost_ratio to smoothly transition this motor in and out of the calculation
-    if (_thrust_boost && motor_enabled[_motor_lost_index]) {
+    if (_thrust_boost && motor_used<N, ALL_ENABLED>(_motor_lost_index)) {
         // Check the maximum yaw control that can be used on this channel
         // Exclude any lost motors if thrust boost is enabled
         if (!is_zero(_yaw_factor[_motor_lost_index])){
@@ -333,8 +334,8 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     // add yaw control to thrust outputs
     float rpy_low = 1.0f;   // lowest thrust value
     float rpy_high = -1.0f; // highest thrust value
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
+    for (uint8_t i = 0; i < N; i++) {
+        if (motor_used<N, ALL_ENABLED>(i)) {
             _thrust_rpyt_out[i] = _thrust_rpyt_out[i] + yaw_thrust * _yaw_factor[i];
 
             // record lowest roll + pitch + yaw command
@@ -351,7 +352,7 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     // Include the lost motor scaled by _thrust_boost_ratio to smoothly transition this motor in and out of the calculation
     if (_thrust_boost) {
         // record highest roll + pitch + yaw command
-        if (_thrust_rpyt_out[_motor_lost_index] > rpy_high && motor_enabled[_motor_lost_index]) {
+        if (_thrust_rpyt_out[_motor_lost_index] > rpy_high && motor_used<N, ALL_ENABLED>(_motor_lost_index)) {
             rpy_high = boost_ratio(rpy_high, _thrust_rpyt_out[_motor_lost_index]);
         }
     }
@@ -391,8 +392,8 @@ void AP_MotorsMatrix::output_armed_stabilizing()
 
     // add scaled roll, pitch, constrained yaw and throttle for each motor
     const float throttle_thrust_best_plus_adj = throttle_thrust_best_rpy + thr_adj;
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
+    for (uint8_t i = 0; i < N; i++) {
+        if (motor_used<N, ALL_ENABLED>(i)) {
             _thrust_rpyt_out[i] = (throttle_thrust_best_plus_adj * _throttle_factor[i]) + (rpy_scale * _thrust_rpyt_out[i]);
         }
     }
@@ -402,7 +403,19 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     _throttle_out = throttle_thrust_best_plus_adj / compensation_gain;
 
     // check for failed motor
-    check_for_failed_motor(throttle_thrust_best_plus_adj);
+    check_for_failed_motor_mix<N, ALL_ENABLED>(throttle_thrust_best_plus_adj);
+}
+
+// use the mixer specialised at compile time if the frame matches it
+void AP_MotorsMatrix::output_armed_stabilizing()
+{
+#if AP_MOTORS_MATRIX_FIXED_NUM_MOTORS > 0
+    if (_fixed_frame_mixer) {
+        output_armed_stabilizing_mix<AP_MOTORS_MATRIX_FIXED_NUM_MOTORS, true>();
+        return;
+    }
+#endif
+    output_armed_stabilizing_mix<AP_MOTORS_MAX_NUM_MOTORS, false>();
 }
 
 // check for failed motor
@@ -413,12 +426,13 @@ void AP_MotorsMatrix::output_armed_stabilizing()
 //   records filtered motor output values in _thrust_rpyt_out_filt array
 //   sets thrust_balanced to true if motors are balanced, false if a motor failure is detected
 //   sets _motor_lost_index to index of failed motor
-void AP_MotorsMatrix::check_for_failed_motor(float throttle_thrust_best_plus_adj)
+template <uint8_t N, bool ALL_ENABLED>
+void AP_MotorsMatrix::check_for_failed_motor_mix(float throttle_thrust_best_plus_adj)
 {
     // record filtered and scaled thrust output for motor loss monitoring purposes
     float alpha = _dt / (_dt + 0.5f);
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
+    for (uint8_t i = 0; i < N; i++) {
+        if (motor_used<N, ALL_ENABLED>(i)) {
             _thrust_rpyt_out_filt[i] += alpha * (_thrust_rpyt_out[i] - _thrust_rpyt_out_filt[i]);
         }
     }
@@ -426,8 +440,8 @@ void AP_MotorsMatrix::check_for_failed_motor(float throttle_thrust_best_plus_adj
     float rpyt_high = 0.0f;
     float rpyt_sum = 0.0f;
     uint8_t number_motors = 0.0f;
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
+    for (uint8_t i = 0; i < N; i++) {
+        if (motor_used<N, ALL_ENABLED>(i)) {
             number_motors += 1;
             rpyt_sum += _thrust_rpyt_out_filt[i];
             // record highest filtered thrust command
@@ -511,6 +525,9 @@ void AP_MotorsMatrix::add_motor_raw(int8_t motor_num, float roll_fac, float pitc
 
         // enable motor
         motor_enabled[motor_num] = true;
+#if AP_MOTORS_MATRIX_FIXED_NUM_MOTORS > 0
+        _fixed_frame_mixer = false;
+#endif
 
         // set roll, pitch, yaw and throttle factors
         _roll_factor[motor_num] = roll_fac;
@@ -550,6 +567,9 @@ void AP_MotorsMatrix::remove_motor(int8_t motor_num)
     if (motor_num >= 0 && motor_num < AP_MOTORS_MAX_NUM_MOTORS) {
         // disable the motor, set all factors to zero
         motor_enabled[motor_num] = false;
+#if AP_MOTORS_MATRIX_FIXED_NUM_MOTORS > 0
+        _fixed_frame_mixer = false;
+#endif
         _roll_factor[motor_num] = 0.0f;
         _pitch_factor[motor_num] = 0.0f;
         _yaw_factor[motor_num] = 0.0f;
@@ -1338,6 +1358,16 @@ void AP_MotorsMatrix::normalise_rpy_factors()
             }
         }
     }
+
+#if AP_MOTORS_MATRIX_FIXED_NUM_MOTORS > 0
+    // use the specialised mixer if the motors are exactly the first outputs
+    _fixed_frame_mixer = true;
+    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        if (motor_enabled[i] != (i < AP_MOTORS_MATRIX_FIXED_NUM_MOTORS)) {
+            _fixed_frame_mixer = false;
+        }
+    }
+#endif
 }
 
 
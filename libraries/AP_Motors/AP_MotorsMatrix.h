@@ -10,6 +10,17 @@
 #define AP_MOTORS_MATRIX_YAW_FACTOR_CW   -1
 #define AP_MOTORS_MATRIX_YAW_FACTOR_CCW   1
 
+// number of motors of a fixed frame to specialise the mixer for at
+// compile time, 0 to only use the generic mixer. The specialised mixer
+// is used while the motors are exactly the first outputs of the frame.
+// Set from a hwdef or with "waf configure --define", for example to
+// benchmark it
+#ifndef AP_MOTORS_MATRIX_FIXED_NUM_MOTORS
+#define AP_MOTORS_MATRIX_FIXED_NUM_MOTORS 0
+#endif
+
+static_assert(AP_MOTORS_MATRIX_FIXED_NUM_MOTORS <= AP_MOTORS_MAX_NUM_MOTORS, "AP_MOTORS_MATRIX_FIXED_NUM_MOTORS too large");
+
 /// @class      AP_MotorsMatrix
 class AP_MotorsMatrix : public AP_MotorsMulticopter {
 public:
@@ -109,9 +120,6 @@ protected:
     // output - sends commands to the motors
     void                output_armed_stabilizing() override;
 
-    // check for failed motor
-    void                check_for_failed_motor(float throttle_thrust_best);
-
     // add_motor using just position and yaw_factor (or prop direction)
     void                add_motor(int8_t motor_num, float angle_degrees, float yaw_factor, uint8_t testing_order);
 
@@ -155,11 +163,25 @@ protected:
     const char*         _frame_class_string = ""; // string representation of frame class
     const char*         _frame_type_string = "";  //  string representation of frame type
 
+#if AP_MOTORS_MATRIX_FIXED_NUM_MOTORS > 0
+    bool                _fixed_frame_mixer;  // true if the motors are exactly the first AP_MOTORS_MATRIX_FIXED_NUM_MOTORS outputs
+#endif
+
 private:
 
     // helper to return value scaled between boost and normal based on the value of _thrust_boost_ratio
     float boost_ratio(float boost_value, float normal_value) const;
 
+    // mixer and failed motor check over the first N outputs. If
+    // ALL_ENABLED then those motors must all be enabled, so the loops
+    // have a fixed length and no checks for disabled motors
+    template <uint8_t N, bool ALL_ENABLED>
+    void output_armed_stabilizing_mix();
+    template <uint8_t N, bool ALL_ENABLED>
+    void check_for_failed_motor_mix(float throttle_thrust_best_plus_adj);
+    template <uint8_t N, bool ALL_ENABLED>
+    bool motor_used(uint8_t i) const { return ALL_ENABLED ? i < N : motor_enabled[i]; }
+
     // setup motors matrix
     bool setup_quad_matrix(motor_frame_type frame_type);
     bool setup_hexa_matrix(motor_frame_type frame_type);
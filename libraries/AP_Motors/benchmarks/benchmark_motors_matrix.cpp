@@ -0,0 +1,82 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Motors/AP_MotorsMatrix.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+class AP_MotorsMatrixAccess : public AP_MotorsMatrix {
+public:
+    using AP_MotorsMatrix::output_armed_stabilizing;
+
+    // setup a frame and inputs as if flying at the given loop rate,
+    // returns true if the specialised mixer is in use
+    bool setup(motor_frame_class frame_class, uint16_t loop_rate_hz, bool use_fixed_mixer) {
+        init(frame_class, MOTOR_FRAME_TYPE_X);
+        set_dt(1.0 / loop_rate_hz);
+        set_throttle_avg_max(0.5);
+        _throttle_filter.reset(0.5);
+        set_roll(0.1);
+        set_pitch(-0.05);
+        set_yaw(0.2);
+#if AP_MOTORS_MATRIX_FIXED_NUM_MOTORS > 0
+        _fixed_frame_mixer = _fixed_frame_mixer && use_fixed_mixer;
+        return _fixed_frame_mixer;
+#else
+        return false;
+#endif
+    }
+};
+
+static AP_MotorsMatrixAccess motors;
+
+// frame with the number of motors the mixer is specialised for
+static AP_Motors::motor_frame_class fixed_frame_class()
+{
+    switch (AP_MOTORS_MATRIX_FIXED_NUM_MOTORS) {
+    case 6:
+        return AP_Motors::MOTOR_FRAME_HEXA;
+    case 8:
+        return AP_Motors::MOTOR_FRAME_OCTA;
+    case 10:
+        return AP_Motors::MOTOR_FRAME_DECA;
+    case 12:
+        return AP_Motors::MOTOR_FRAME_DODECAHEXA;
+    default:
+        return AP_Motors::MOTOR_FRAME_QUAD;
+    }
+}
+
+// mixer over all outputs checking for disabled motors, argument is the loop rate
+static void BM_MotorsMatrixGeneric(benchmark::State& state)
+{
+    motors.setup(fixed_frame_class(), state.range(0), false);
+
+    while (state.KeepRunning()) {
+        motors.output_armed_stabilizing();
+        gbenchmark_escape(&motors);
+    }
+}
+
+#if AP_MOTORS_MATRIX_FIXED_NUM_MOTORS > 0
+// mixer specialised for the frame, argument is the loop rate. Only built
+// when configured with --define AP_MOTORS_MATRIX_FIXED_NUM_MOTORS=<n>
+static void BM_MotorsMatrixFixed(benchmark::State& state)
+{
+    if (!motors.setup(fixed_frame_class(), state.range(0), true)) {
+        state.SkipWithError("frame does not match AP_MOTORS_MATRIX_FIXED_NUM_MOTORS");
+        return;
+    }
+
+    while (state.KeepRunning()) {
+        motors.output_armed_stabilizing();
+        gbenchmark_escape(&motors);
+    }
+}
+#endif
+
+BENCHMARK(BM_MotorsMatrixGeneric)->Arg(1000)->Arg(2000);
+#if AP_MOTORS_MATRIX_FIXED_NUM_MOTORS > 0
+BENCHMARK(BM_MotorsMatrixFixed)->Arg(1000)->Arg(2000);
+#endif
+
+BENCHMARK_MAIN();
@@ -37,3 +37,41 @@ void NavEKF_core_common::fill_scratch_variables(void)
     fill_nanf(&Kfusion[0], sizeof(Kfusion)/sizeof(ftype));
 #endif
 }
+
+bool NavEKF_core_common::sparse_covariance_update(Matrix24 &P, const ftype *K, const ftype *H,
+                                                  const uint8_t *Hidx, uint8_t Hcount,
+                                                  uint8_t stateIndexLim, bool check_variances)
+{
+    // H*P is a row vector built from the rows of P selected by the non-zero elements of H
+    ftype HP[24];
+    for (uint8_t j = 0; j<=stateIndexLim; j++) {
+        ftype res = 0;
+        if (H == nullptr) {
+            for (uint8_t k = 0; k<Hcount; k++) {
+                res += P[Hidx[k]][j];
+            }
+        } else {
+            for (uint8_t k = 0; k<Hcount; k++) {
+                res += H[Hidx[k]] * P[Hidx[k]][j];
+            }
+        }
+        HP[j] = res;
+    }
+
+    // Check that we are not going to drive any variances negative and skip the update if so
+    if (check_variances) {
+        for (uint8_t i = 0; i<=stateIndexLim; i++) {
+            if (K[i] * HP[i] > P[i][i]) {
+                return false;
+            }
+        }
+    }
+
+    // update the covariance matrix
+    for (uint8_t i = 0; i<=stateIndexLim; i++) {
+        for (uint8_t j = 0; j<=stateIndexLim; j++) {
+            P[i][j] -= K[i] * HP[j];
+        }
+    }
+    return true;
+}
@@ -54,6 +54,19 @@ protected:
     static void zero_range(ftype *v, uint8_t n1, uint8_t n2) {
         memset(&v[n1], 0, sizeof(ftype)*(1+(n2-n1)));
     }
+
+    /*
+      correct the covariance P = P - K*H*P for the fusion of a single
+      observation. Only the Hcount states listed in Hidx are read from
+      the observation Jacobian H, so H*P is formed from Hcount rows of P
+      and K*H*P is applied as an outer product. A nullptr H is a direct
+      observation of the listed states, with those elements of H equal
+      to one. If check_variances is true and the update would drive any
+      variance negative then P is left unchanged and false is returned
+     */
+    static bool sparse_covariance_update(Matrix24 &P, const ftype *K, const ftype *H,
+                                         const uint8_t *Hidx, uint8_t Hcount,
+                                         uint8_t stateIndexLim, bool check_variances=true);
 };
 
 #if HAL_WITH_EKF_DOUBLE && !defined(__clang__)
@@ -0,0 +1,153 @@
+#include <AP_gtest.h>
+
+/*
+  tests for NavEKF_core_common::sparse_covariance_update()
+ */
+
+#include <AP_NavEKF/AP_NavEKF_core_common.h>
+#include <stdlib.h>
+
+class SparseFusion : public NavEKF_core_common {
+public:
+    using NavEKF_core_common::sparse_covariance_update;
+};
+
+typedef NavEKF_core_common::Matrix24 Matrix24;
+
+static ftype rand_ftype(ftype low, ftype high)
+{
+    return low + (high - low) * (ftype(rand()) / ftype(RAND_MAX));
+}
+
+// random symmetric positive definite covariance, P = A*A' + diagonal
+static void random_covariance(Matrix24 &P)
+{
+    static ftype A[24][24];
+    for (uint8_t i = 0; i < 24; i++) {
+        for (uint8_t j = 0; j < 24; j++) {
+            A[i][j] = rand_ftype(-0.2, 0.2);
+        }
+    }
+    for (uint8_t i = 0; i < 24; i++) {
+        for (uint8_t j = 0; j < 24; j++) {
+            ftype res = 0;
+            for (uint8_t k = 0; k < 24; k++) {
+                res += A[i][k] * A[j][k];
+            }
+            P[i][j] = res;
+        }
+        P[i][i] += 1.0;
+    }
+}
+
+// the dense form of the update as previously done by each fusion step
+static bool reference_update(Matrix24 &P, const ftype *K, const ftype *H, uint8_t stateIndexLim, bool check_variances)
+{
+    static Matrix24 KH;
+    static Matrix24 KHP;
+    for (uint8_t i = 0; i<=stateIndexLim; i++) {
+        for (uint8_t j = 0; j<24; j++) {
+            KH[i][j] = K[i] * H[j];
+        }
+    }
+    for (uint8_t j = 0; j<=stateIndexLim; j++) {
+        for (uint8_t i = 0; i<=stateIndexLim; i++) {
+            ftype res = 0;
+            for (uint8_t k = 0; k<24; k++) {
+                res += KH[i][k] * P[k][j];
+            }
+            KHP[i][j] = res;
+        }
+    }
+    if (check_variances) {
+        for (uint8_t i = 0; i<=stateIndexLim; i++) {
+            if (KHP[i][i] > P[i][i]) {
+                return false;
+            }
+        }
+    }
+    for (uint8_t i = 0; i<=stateIndexLim; i++) {
+        for (uint8_t j = 0; j<=stateIndexLim; j++) {
+            P[i][j] = P[i][j] - KHP[i][j];
+        }
+    }
+    return true;
+}
+
+static void check_against_reference(const uint8_t *Hidx, uint8_t Hcount, uint8_t stateIndexLim, bool unit_H)
+{
+    static Matrix24 P;
+    static Matrix24 P_ref;
+    ftype K[24] {};
+    ftype H[24] {};
+
+    random_covariance(P);
+    memcpy(&P_ref, &P, sizeof(P));
+    for (uint8_t k = 0; k < Hcount; k++) {
+        H[Hidx[k]] = unit_H ? 1.0 : rand_ftype(-1, 1);
+    }
+    // gains small enough that no variance goes negative
+    for (uint8_t i = 0; i <= stateIndexLim; i++) {
+        K[i] = rand_ftype(-0.01, 0.01);
+    }
+
+    EXPECT_TRUE(reference_update(P_ref, K, H, stateIndexLim, true));
+    EXPECT_TRUE(SparseFusion::sparse_covariance_update(P, K, unit_H ? nullptr : H, Hidx, Hcount, stateIndexLim));
+
+    for (uint8_t i = 0; i < 24; i++) {
+        for (uint8_t j = 0; j < 24; j++) {
+            EXPECT_NEAR(P[i][j], P_ref[i][j], 1.0e-5);
+        }
+    }
+}
+
+TEST(SparseFusion, MatchesDenseUpdate)
+{
+    // the sets of non-zero observation Jacobian elements used by EKF3
+    const uint8_t vel[] {0, 1, 2, 3, 4, 5, 6};
+    const uint8_t tas[] {4, 5, 6, 22, 23};
+    const uint8_t beta[] {0, 1, 2, 3, 4, 5, 6, 22, 23};
+    const uint8_t mag[] {0, 1, 2, 3, 16, 17, 18, 19, 20, 21};
+    const uint8_t yaw[] {0, 1, 2, 3};
+    const uint8_t decl[] {16, 17};
+    const uint8_t bcn[] {7, 8, 9};
+    const uint8_t posvel[] {5};
+
+    for (uint8_t n = 0; n < 20; n++) {
+        for (uint8_t stateIndexLim : { 12, 15, 21, 23 }) {
+            check_against_reference(vel, ARRAY_SIZE(vel), stateIndexLim, false);
+            check_against_reference(tas, ARRAY_SIZE(tas), stateIndexLim, false);
+            check_against_reference(beta, ARRAY_SIZE(beta), stateIndexLim, false);
+            check_against_reference(mag, ARRAY_SIZE(mag), stateIndexLim, false);
+            check_against_reference(yaw, ARRAY_SIZE(yaw), stateIndexLim, false);
+            check_against_reference(decl, ARRAY_SIZE(decl), stateIndexLim, false);
+            check_against_reference(bcn, ARRAY_SIZE(bcn), stateIndexLim, false);
+            check_against_reference(posvel, ARRAY_SIZE(posvel), stateIndexLim, true);
+        }
+    }
+}
+
+TEST(SparseFusion, NegativeVariance)
+{
+    static Matrix24 P;
+    static Matrix24 P_start;
+    ftype K[24] {};
+    ftype H[24] {};
+    const uint8_t Hidx[] {4};
+
+    random_covariance(P);
+    memcpy(&P_start, &P, sizeof(P));
+
+    // a gain that removes more than the variance of state 4
+    H[4] = 1;
+    K[4] = 2;
+
+    EXPECT_FALSE(SparseFusion::sparse_covariance_update(P, K, H, Hidx, 1, 23));
+    EXPECT_EQ(memcmp(&P, &P_start, sizeof(P)), 0);
+
+    // without the check the update is applied anyway
+    EXPECT_TRUE(SparseFusion::sparse_covariance_update(P, K, H, Hidx, 1, 23, false));
+    EXPECT_LT(P[4][4], 0);
+}
+
+AP_GTEST_MAIN()
@@ -1252,6 +1252,15 @@ void NavEKF2::getFilterFaults(uint16_t &faults) const
     }
 }
 
+// copy the state vector and covariance matrix of a core
+uint8_t NavEKF2::getStatesAndCovariance(uint8_t instance, ftype states[28], ftype covariance[24][24]) const
+{
+    if (core == nullptr || instance >= num_cores) {
+        return 0;
+    }
+    return core[instance].getStatesAndCovariance(states, covariance);
+}
+
 /*
   return filter status flags
 */
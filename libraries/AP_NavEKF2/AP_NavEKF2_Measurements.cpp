@@ -626,9 +626,9 @@ void NavEKF2_core::readGpsData()
                 const auto &compass = dal.compass();
                 if (compass.have_scale_factor(magSelectIndex) &&
                     compass.auto_declination_enabled()) {
-                    table_earth_field_ga = AP_Declination::get_earth_field_ga(gpsloc).toftype();
-                    table_declination = radians(AP_Declination::get_declination(gpsloc.lat*1.0e-7,
-                                                                                gpsloc.lng*1.0e-7));
+                    float declination_deg;
+                    table_earth_field_ga = earth_field_table.get_earth_field_ga(gpsloc, declination_deg).toftype();
+                    table_declination = radians(declination_deg);
                     have_table_earth_field = true;
                     if (frontend->_mag_ef_limit > 0) {
                         // initialise earth field from tables
@@ -457,6 +457,23 @@ void  NavEKF2_core::getFilterFaults(uint16_t &faults) const
               !statesInitialised<<7);
 }
 
+// copy the state vector and covariance matrix
+uint8_t NavEKF2_core::getStatesAndCovariance(ftype states[28], ftype covariance[24][24]) const
+{
+    if (!statesInitialised) {
+        return 0;
+    }
+    for (uint8_t i=0; i<28; i++) {
+        states[i] = statesArray[i];
+    }
+    for (uint8_t i=0; i<24; i++) {
+        for (uint8_t j=0; j<24; j++) {
+            covariance[i][j] = P[i][j];
+        }
+    }
+    return 28;
+}
+
 /*
 return filter timeout status as a bitmasked integer
  0 = position measurement timeout
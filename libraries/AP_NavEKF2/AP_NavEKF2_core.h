@@ -30,6 +30,7 @@
 #include <AP_NavEKF/AP_NavEKF_core_common.h>
 #include <AP_NavEKF/EKF_Buffer.h>
 #include <AP_DAL/AP_DAL.h>
+#include <AP_Declination/AP_Declination.h>
 
 #include "AP_NavEKF/EKFGSF_yaw.h"
 
@@ -239,6 +240,11 @@ public:
     */
     void  getFilterFaults(uint16_t &faults) const;
 
+    // copy the state vector and covariance matrix, returning the
+    // number of states or zero if the states are not initialised.
+    // Used by Replay to check that filter output is unchanged
+    uint8_t getStatesAndCovariance(ftype states[28], ftype covariance[24][24]) const;
+
     /*
     return filter gps quality check status
     */
@@ -1173,6 +1179,7 @@ private:
     bool have_table_earth_field;   // true when we have initialised table_earth_field_ga
     Vector3F table_earth_field_ga; // earth field from WMM tables
     ftype table_declination;       // declination in radians from the tables
+    AP_Declination::Interpolator earth_field_table; // table lookup cached for the current cell
 
     // timing statistics
     struct ekf_timing timing;
@@ -282,6 +282,10 @@ public:
     */
     void getFilterFaults(uint16_t &faults) const;
 
+    // copy the state vector and covariance matrix of a core, returning
+    // the number of states or zero if the core is not running
+    uint8_t getStatesAndCovariance(uint8_t instance, ftype states[28], ftype covariance[24][24]) const;
+
     /*
     return filter status flags
     */
@@ -1458,9 +1458,9 @@ void NavEKF3_core::SampleDragData(const imu_elements &imu)
  */
 void NavEKF3_core::getEarthFieldTable(const Location &loc)
 {
-    table_earth_field_ga = AP_Declination::get_earth_field_ga(loc).toftype();
-    table_declination = radians(AP_Declination::get_declination(loc.lat*1.0e-7,
-                                                                loc.lng*1.0e-7));
+    float declination_deg;
+    table_earth_field_ga = earth_field_table.get_earth_field_ga(loc, declination_deg).toftype();
+    table_declination = radians(declination_deg);
     have_table_earth_field = true;
 }
 
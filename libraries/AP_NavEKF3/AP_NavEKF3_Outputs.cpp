@@ -543,6 +543,23 @@ void  NavEKF3_core::getFilterFaults(uint16_t &faults) const
               !statesInitialised<<7);
 }
 
+// copy the state vector and covariance matrix
+uint8_t NavEKF3_core::getStatesAndCovariance(ftype states[28], ftype covariance[24][24]) const
+{
+    if (!statesInitialised) {
+        return 0;
+    }
+    for (uint8_t i=0; i<24; i++) {
+        states[i] = statesArray[i];
+    }
+    for (uint8_t i=0; i<24; i++) {
+        for (uint8_t j=0; j<24; j++) {
+            covariance[i][j] = P[i][j];
+        }
+    }
+    return 24;
+}
+
 // Return the navigation filter status message
 void  NavEKF3_core::getFilterStatus(nav_filter_status &status) const
 {
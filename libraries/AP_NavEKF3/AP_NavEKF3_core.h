@@ -26,6 +26,7 @@
 
 #include "AP_NavEKF3_feature.h"
 #include <AP_Common/Location.h>
+#include <AP_Declination/AP_Declination.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_Math/vectorN.h>
 #include <AP_NavEKF/AP_NavEKF_core_common.h>
@@ -366,6 +367,11 @@ public:
     */
     void getFilterFaults(uint16_t &faults) const;
 
+    // copy the state vector and covariance matrix, returning the
+    // number of states or zero if the states are not initialised.
+    // Used by Replay to check that filter output is unchanged
+    uint8_t getStatesAndCovariance(ftype states[28], ftype covariance[24][24]) const;
+
     /*
     Return a filter function status that indicates:
         Which outputs are valid
@@ -1492,6 +1498,7 @@ private:
     bool have_table_earth_field;   // true when we have initialised table_earth_field_ga
     Vector3F table_earth_field_ga; // earth field from WMM tables
     ftype table_declination;       // declination in radians from the tables
+    AP_Declination::Interpolator earth_field_table; // table lookup cached for the current cell
 
     // 1Hz update
     uint32_t last_oneHz_ms;
@@ -258,8 +258,13 @@ private:
             return 1000000UL;
         }
 
+        bool udp_send_receive(void);
+
         ByteBuffer *readbuffer;
         ByteBuffer *writebuffer;
+        // buffer for UDP datagrams, so socket IO is done without
+        // holding sem
+        uint8_t *datagram_buf;
         char thread_name[10];
         uint32_t last_size_tx;
         uint32_t last_size_rx;
@@ -28,6 +28,11 @@ extern const AP_HAL::HAL& hal;
 #define AP_NETWORKING_PORT_STACK_SIZE 1024
 #endif
 
+// largest UDP payload which fits in a single 1500 byte ethernet frame
+#ifndef AP_NETWORKING_PORT_MAX_DATAGRAM
+#define AP_NETWORKING_PORT_MAX_DATAGRAM 1472
+#endif
+
 const AP_Param::GroupInfo AP_Networking::Port::var_info[] = {
     // @Param: TYPE
     // @DisplayName: Port type
@@ -105,6 +110,15 @@ void AP_Networking::Port::thread_create(AP_HAL::MemberProc proc)
         return;
     }
 
+    const NetworkPortType ptype = (NetworkPortType)type;
+    if (ptype == NetworkPortType::UDP_CLIENT || ptype == NetworkPortType::UDP_SERVER) {
+        datagram_buf = new uint8_t[AP_NETWORKING_PORT_MAX_DATAGRAM];
+        if (datagram_buf == nullptr) {
+            AP_BoardConfig::allocation_error("Failed to allocate %s buffers", thread_name);
+            return;
+        }
+    }
+
     if (!hal.scheduler->thread_create(proc, thread_name, AP_NETWORKING_PORT_STACK_SIZE, AP_HAL::Scheduler::PRIORITY_UART, 0)) {
         AP_BoardConfig::allocation_error("Failed to allocate %s client thread", thread_name);
     }
@@ -317,6 +331,9 @@ void AP_Networking::Port::tcp_client_loop(void)
  */
 bool AP_Networking::Port::send_receive(void)
 {
+    if (datagram_buf != nullptr) {
+        return udp_send_receive();
+    }
 
     bool active = false;
     uint32_t space;
@@ -391,6 +408,73 @@ bool AP_Networking::Port::send_receive(void)
     return active;
 }
 
+/*
+  run one send/receive loop for a UDP port.
+
+  Outgoing MAVLink packets are packed into datagrams of up to
+  AP_NETWORKING_PORT_MAX_DATAGRAM bytes rather than one per packet. The
+  socket calls go through datagram_buf without holding the semaphore,
+  as begin() may resize the ring buffers while a call is in progress
+ */
+bool AP_Networking::Port::udp_send_receive(void)
+{
+    bool active = false;
+
+    // handle incoming packets
+    uint32_t space;
+    {
+        WITH_SEMAPHORE(sem);
+        space = readbuffer->space();
+    }
+    if (space > 0) {
+        // receive the whole datagram and keep as much as fits
+        const auto ret = sock->recv(datagram_buf, AP_NETWORKING_PORT_MAX_DATAGRAM, 0);
+        if (ret > 0) {
+            WITH_SEMAPHORE(sem);
+            readbuffer->write(datagram_buf, ret);
+            active = true;
+            have_received = true;
+        }
+    }
+
+    if (!connected) {
+        if (type == NetworkPortType::UDP_SERVER && have_received) {
+            // connect the socket to the last receive address if we have one
+            char buf[16];
+            uint16_t last_port;
+            const char *last_addr = sock->last_recv_address(buf, sizeof(buf), last_port);
+            if (last_addr != nullptr && port != 0) {
+                connected = sock->connect(last_addr, last_port);
+            }
+        }
+        return active;
+    }
+
+    // handle outgoing packets
+    uint32_t n;
+    {
+        WITH_SEMAPHORE(sem);
+        n = MIN(uint32_t(AP_NETWORKING_PORT_MAX_DATAGRAM), writebuffer->available());
+#if HAL_GCS_ENABLED
+        if (packetise) {
+            n = mavlink_packetise_multi(*writebuffer, n);
+        }
+#endif
+        if (n == 0) {
+            return active;
+        }
+        n = writebuffer->peekbytes(datagram_buf, n);
+    }
+    const auto ret = sock->send(datagram_buf, n);
+    if (ret > 0) {
+        WITH_SEMAPHORE(sem);
+        writebuffer->advance(ret);
+        active = true;
+    }
+
+    return active;
+}
+
 /*
   available space in outgoing buffer
  */
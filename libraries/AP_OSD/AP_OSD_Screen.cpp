@@ -1443,8 +1443,13 @@ void AP_OSD_Screen::draw_altitude(uint8_t x, uint8_t y)
 {
     float alt;
     AP_AHRS &ahrs = AP::ahrs();
-    WITH_SEMAPHORE(ahrs.get_semaphore());
-    ahrs.get_relative_position_D_home(alt);
+    AP_AHRS::Snapshot snap;
+    if (ahrs.get_snapshot(snap) && snap.relpos_NED_home_ok) {
+        alt = snap.relpos_NED_home.z;
+    } else {
+        WITH_SEMAPHORE(ahrs.get_semaphore());
+        ahrs.get_relative_position_D_home(alt);
+    }
     alt = -alt;
     backend->write(x, y, false, "%4d%c", (int)u_scale(ALTITUDE, alt), u_icon(ALTITUDE));
 }
@@ -1775,13 +1780,11 @@ void AP_OSD_Screen::draw_distance(uint8_t x, uint8_t y, float distance)
 
 void AP_OSD_Screen::draw_home(uint8_t x, uint8_t y)
 {
-    AP_AHRS &ahrs = AP::ahrs();
-    WITH_SEMAPHORE(ahrs.get_semaphore());
-    Location loc;
-    if (ahrs.get_location(loc) && ahrs.home_is_set()) {
-        const Location &home_loc = ahrs.get_home();
-        float distance = home_loc.get_distance(loc);
-        int32_t angle_cd = loc.get_bearing_to(home_loc) - ahrs.yaw_sensor;
+    AP_AHRS::Snapshot snap;
+    if (AP::ahrs().get_snapshot(snap) && snap.relpos_NED_home_ok) {
+        const Vector2f to_home = -snap.relpos_NED_home.xy();
+        float distance = to_home.length();
+        int32_t angle_cd = degrees(to_home.angle() - snap.yaw) * 100;
         if (distance < 2.0f) {
             //avoid fast rotating arrow at small distances
             angle_cd = 0;
@@ -1928,16 +1931,18 @@ void AP_OSD_Screen::draw_compass(uint8_t x, uint8_t y)
 void AP_OSD_Screen::draw_wind(uint8_t x, uint8_t y)
 {
 #if !APM_BUILD_TYPE(APM_BUILD_Rover)
-    AP_AHRS &ahrs = AP::ahrs();
-    WITH_SEMAPHORE(ahrs.get_semaphore());
-    Vector3f v = ahrs.wind_estimate();
+    AP_AHRS::Snapshot snap;
+    if (!AP::ahrs().get_snapshot(snap)) {
+        snap.wind_estimate.zero();
+    }
+    const Vector3f &v = snap.wind_estimate;
     float angle = 0;
     const float length = v.length();
     if (length > 1.0f) {
         if (check_option(AP_OSD::OPTION_INVERTED_WIND)) {
             angle = M_PI;
         }
-        angle = angle + atan2f(v.y, v.x) - ahrs.get_yaw();
+        angle = angle + atan2f(v.y, v.x) - snap.yaw;
     } 
     draw_speed(x + 1, y, angle, length);
 
@@ -1966,13 +1971,11 @@ void AP_OSD_Screen::draw_aspeed(uint8_t x, uint8_t y)
 
 void AP_OSD_Screen::draw_vspeed(uint8_t x, uint8_t y)
 {
-    Vector3f v;
     float vspd;
     float vs_scaled;
-    AP_AHRS &ahrs = AP::ahrs();
-    WITH_SEMAPHORE(ahrs.get_semaphore());
-    if (ahrs.get_velocity_NED(v)) {
-        vspd = -v.z;
+    AP_AHRS::Snapshot snap;
+    if (AP::ahrs().get_snapshot(snap) && snap.velocity_NED_ok) {
+        vspd = -snap.velocity_NED.z;
     } else {
         auto &baro = AP::baro();
         WITH_SEMAPHORE(baro.get_semaphore());
@@ -2320,16 +2323,12 @@ void AP_OSD_Screen::draw_eff(uint8_t x, uint8_t y)
 void AP_OSD_Screen::draw_climbeff(uint8_t x, uint8_t y)
 {
     char unit_icon = u_icon(DISTANCE);
-    Vector3f v;
     float vspd;
     do {
-        {
-            auto &ahrs = AP::ahrs();
-            WITH_SEMAPHORE(ahrs.get_semaphore());
-            if (ahrs.get_velocity_NED(v)) {
-                vspd = -v.z;
-                break;
-            }
+        AP_AHRS::Snapshot snap;
+        if (AP::ahrs().get_snapshot(snap) && snap.velocity_NED_ok) {
+            vspd = -snap.velocity_NED.z;
+            break;
         }
         auto &baro = AP::baro();
         WITH_SEMAPHORE(baro.get_semaphore());
@@ -28,7 +28,7 @@ void AP_RPM_HarmonicNotch::update(void)
     for (const auto &notch : ins.harmonic_notches) {
         if (notch.params.enabled() &&
             notch.params.tracking_mode() != HarmonicNotchDynamicMode::Fixed) {
-            state.rate_rpm = notch.calculated_notch_freq_hz[0] * 60;
+            state.rate_rpm = notch.calculated_notch_freq_hz[ins.get_primary_gyro()][0] * 60;
             state.rate_rpm *= ap_rpm._params[state.instance].scaling;
             state.signal_quality = 0.5f;
             state.last_reading_ms = AP_HAL::millis();
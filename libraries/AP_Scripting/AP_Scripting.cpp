@@ -91,9 +91,10 @@ const AP_Param::GroupInfo AP_Scripting::var_info[] = {
     // @Bitmask: 0: No Scripts to run message if all scripts have stopped
     // @Bitmask: 1: Runtime messages for memory usage and execution time
     // @Bitmask: 2: Suppress logging scripts to dataflash
-    // @Bitmask: 3: log runtime memory usage and execution time
+    // @Bitmask: 3: log runtime memory usage and execution time, and per-script stats every 10 seconds
     // @Bitmask: 4: Disable pre-arm check
     // @Bitmask: 5: Save CRC of current scripts to loaded and running checksum parameters enabling pre-arm
+    // @Bitmask: 6: Sample hot Lua functions for profiling, shown in @SYS/scripts.txt and logged
     // @User: Advanced
     AP_GROUPINFO("DEBUG_OPTS", 4, AP_Scripting, _debug_options, 0),
 
@@ -160,6 +161,23 @@ const AP_Param::GroupInfo AP_Scripting::var_info[] = {
     // @RebootRequired: True
     // @User: Advanced
     AP_GROUPINFO("THD_PRIORITY", 14, AP_Scripting, _thd_priority, uint8_t(ThreadPriority::NORMAL)),
+
+    // @Param: GC_BUDGET
+    // @DisplayName: Scripting garbage collection budget
+    // @Description: Time spent collecting garbage incrementally after each script run and while waiting for the next script. A full collection is still done if the heap is nearly full. 0 does a full collection after every script run
+    // @Units: us
+    // @Range: 0 10000
+    // @Increment: 100
+    // @User: Advanced
+    AP_GROUPINFO("GC_BUDGET", 15, AP_Scripting, _gc_budget_us, 0),
+
+    // @Param: ALLOC_MAX
+    // @DisplayName: Scripting per-run allocation limit
+    // @Description: Memory a script may allocate in a single run. A script that allocates more has its next run delayed in proportion, so collecting its garbage does not stall the other scripts. 0 disables
+    // @Range: 0 1048576
+    // @Increment: 1024
+    // @User: Advanced
+    AP_GROUPINFO("ALLOC_MAX", 16, AP_Scripting, _alloc_max, 0),
     
     AP_GROUPEND
 };
@@ -290,7 +308,7 @@ void AP_Scripting::thread(void) {
         _restart = false;
         _init_failed = false;
 
-        lua_scripts *lua = new lua_scripts(_script_vm_exec_count, _script_heap_size, _debug_options, terminal);
+        lua_scripts *lua = new lua_scripts(_script_vm_exec_count, _script_heap_size, _debug_options, _gc_budget_us, _alloc_max, terminal);
         if (lua == nullptr || !lua->heap_allocated()) {
             GCS_SEND_TEXT(MAV_SEVERITY_CRITICAL, "Scripting: %s", "Unable to allocate memory");
             _init_failed = true;
@@ -510,6 +528,12 @@ void AP_Scripting::save_checksum() {
 
 }
 
+// fill in ExpandingString for @SYS/scripts.txt
+void AP_Scripting::script_info(ExpandingString &str)
+{
+    lua_scripts::script_info_string(str);
+}
+
 AP_Scripting *AP_Scripting::_singleton = nullptr;
 
 namespace AP {
@@ -75,6 +75,9 @@ public:
     
     void restart_all(void);
 
+    // per-script run time, VM steps and memory stats for @SYS/scripts.txt
+    void script_info(class ExpandingString &str);
+
    // User parameters for inputs into scripts 
    AP_Float _user[6];
 
@@ -177,6 +180,8 @@ private:
     AP_Int16 _dir_disable;
     AP_Int32 _required_loaded_checksum;
     AP_Int32 _required_running_checksum;
+    AP_Int16 _gc_budget_us;
+    AP_Int32 _alloc_max;
 
     AP_Enum<ThreadPriority> _thd_priority;
 
@@ -6,6 +6,11 @@
 #define AP_SCRIPTING_ENABLED (BOARD_FLASH_SIZE > 1024)
 #endif
 
+// load scripts precompiled to bytecode (.lbc) from ROMFS
+#ifndef AP_SCRIPTING_BYTECODE_ENABLED
+#define AP_SCRIPTING_BYTECODE_ENABLED AP_SCRIPTING_ENABLED
+#endif
+
 #if AP_SCRIPTING_ENABLED
     #include <AP_Filesystem/AP_Filesystem_config.h>
     #if !AP_FILESYSTEM_FILE_READING_ENABLED
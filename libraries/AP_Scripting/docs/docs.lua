@@ -702,8 +702,9 @@ local Vector2f_ud = {}
 function Vector2f() end
 
 -- copy
+---@param result? Vector2f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector2f_ud
-function Vector2f_ud:copy() end
+function Vector2f_ud:copy(result) end
 
 -- get field
 ---@return number
@@ -756,8 +757,9 @@ local Vector3f_ud = {}
 function Vector3f() end
 
 -- copy
+---@param result? Vector3f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector3f_ud
-function Vector3f_ud:copy() end
+function Vector3f_ud:copy(result) end
 
 -- get field
 ---@return number
@@ -785,13 +787,15 @@ function Vector3f_ud:x(value) end
 
 -- desc
 ---@param scale_factor number
+---@param result? Vector3f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector3f_ud
-function Vector3f_ud:scale(scale_factor) end
+function Vector3f_ud:scale(scale_factor, result) end
 
 -- desc
 ---@param vector Vector3f_ud
+---@param result? Vector3f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector3f_ud
-function Vector3f_ud:cross(vector) end
+function Vector3f_ud:cross(vector, result) end
 
 -- desc
 ---@param vector Vector3f_ud
@@ -827,8 +831,9 @@ function Vector3f_ud:angle(v2) end
 function Vector3f_ud:rotate_xy(param1) end
 
 -- desc
+---@param result? Vector2f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector2f_ud
-function Vector3f_ud:xy() end
+function Vector3f_ud:xy(result) end
 
 -- desc
 ---@class Quaternion_ud
@@ -924,8 +929,9 @@ local Location_ud = {}
 function Location() end
 
 -- copy
+---@param result? Location_ud -- optional object to return the result in, rather than creating a new one
 ---@return Location_ud
-function Location_ud:copy() end
+function Location_ud:copy(result) end
 
 -- get field
 ---@return boolean
@@ -1002,13 +1008,15 @@ function Location_ud:change_alt_frame(desired_frame) end
 
 -- desc
 ---@param loc Location_ud
+---@param result? Vector2f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector2f_ud
-function Location_ud:get_distance_NE(loc) end
+function Location_ud:get_distance_NE(loc, result) end
 
 -- desc
 ---@param loc Location_ud
+---@param result? Vector3f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector3f_ud
-function Location_ud:get_distance_NED(loc) end
+function Location_ud:get_distance_NED(loc, result) end
 
 -- desc
 ---@param loc Location_ud
@@ -3115,13 +3123,15 @@ function ahrs:get_EAS2TAS() end
 
 -- desc
 ---@param vector Vector3f_ud
+---@param result? Vector3f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector3f_ud
-function ahrs:body_to_earth(vector) end
+function ahrs:body_to_earth(vector, result) end
 
 -- desc
 ---@param vector Vector3f_ud
+---@param result? Vector3f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector3f_ud
-function ahrs:earth_to_body(vector) end
+function ahrs:earth_to_body(vector, result) end
 
 -- desc
 ---@return Vector3f_ud
@@ -3144,20 +3154,24 @@ function ahrs:home_is_set() end
 function ahrs:get_relative_position_D_home() end
 
 -- desc
+---@param result? Vector3f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector3f_ud|nil
-function ahrs:get_relative_position_NED_origin() end
+function ahrs:get_relative_position_NED_origin(result) end
 
 -- desc
+---@param result? Vector3f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector3f_ud|nil
-function ahrs:get_relative_position_NED_home() end
+function ahrs:get_relative_position_NED_home(result) end
 
 -- desc
+---@param result? Vector3f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector3f_ud|nil
-function ahrs:get_velocity_NED() end
+function ahrs:get_velocity_NED(result) end
 
 -- desc
+---@param result? Vector2f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector2f_ud
-function ahrs:groundspeed_vector() end
+function ahrs:groundspeed_vector(result) end
 
 -- desc
 ---@return Vector3f_ud
@@ -3180,24 +3194,29 @@ function ahrs:head_wind() end
 function ahrs:get_hagl() end
 
 -- desc
+---@param result? Vector3f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector3f_ud
-function ahrs:get_accel() end
+function ahrs:get_accel(result) end
 
 -- desc
+---@param result? Vector3f_ud -- optional object to return the result in, rather than creating a new one
 ---@return Vector3f_ud
-function ahrs:get_gyro() end
+function ahrs:get_gyro(result) end
 
 -- desc
+---@param result? Location_ud -- optional object to return the result in, rather than creating a new one
 ---@return Location_ud
-function ahrs:get_home() end
+function ahrs:get_home(result) end
 
 -- desc
+---@param result? Location_ud -- optional object to return the result in, rather than creating a new one
 ---@return Location_ud|nil
-function ahrs:get_location() end
+function ahrs:get_location(result) end
 
 -- same as `get_location` will be removed
+---@param result? Location_ud -- optional object to return the result in, rather than creating a new one
 ---@return Location_ud|nil
-function ahrs:get_position() end
+function ahrs:get_position(result) end
 
 -- desc
 ---@return number
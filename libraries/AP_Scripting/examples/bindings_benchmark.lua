@@ -0,0 +1,91 @@
+-- Benchmark the scripting bindings with and without result reuse
+-- Each test runs the same work as a typical applet update, once letting the
+-- bindings create a new userdata for every result and once passing in
+-- userdata created up front to hold the results. The time taken and the
+-- memory allocated for the garbage collector to clean up are reported
+
+local MAV_SEVERITY_INFO = 6
+
+local ITERATIONS = 200
+
+-- position and velocity checks, as run at 10 to 50Hz by many applets
+local function position_alloc()
+  local loc = ahrs:get_location()
+  local home = ahrs:get_home()
+  local vel = ahrs:get_velocity_NED()
+  local rel = ahrs:get_relative_position_NED_home()
+  if loc and vel and rel then
+    local dist = home:get_distance_NED(loc)
+    return dist:length() + vel:length() + rel:z()
+  end
+  return 0
+end
+
+local loc = Location()
+local home = Location()
+local vel = Vector3f()
+local rel = Vector3f()
+local dist = Vector3f()
+local function position_reuse()
+  if ahrs:get_location(loc) and ahrs:get_velocity_NED(vel) and ahrs:get_relative_position_NED_home(rel) then
+    ahrs:get_home(home)
+    home:get_distance_NED(loc, dist)
+    return dist:length() + vel:length() + rel:z()
+  end
+  return 0
+end
+
+-- vector math, as used by the attitude and guidance applets
+local function vector_alloc()
+  local gyro = ahrs:get_gyro()
+  local accel = ahrs:get_accel()
+  local cross = gyro:cross(accel)
+  local earth = ahrs:body_to_earth(cross:scale(0.5))
+  return earth:length()
+end
+
+local gyro = Vector3f()
+local accel = Vector3f()
+local cross = Vector3f()
+local earth = Vector3f()
+local function vector_reuse()
+  ahrs:get_gyro(gyro)
+  ahrs:get_accel(accel)
+  gyro:cross(accel, cross)
+  cross:scale(0.5, cross)
+  ahrs:body_to_earth(cross, earth)
+  return earth:length()
+end
+
+-- run a test, returning the time taken in us and memory allocated in kB
+local function run(test)
+  collectgarbage("collect")
+  collectgarbage("stop")
+  local mem_start = collectgarbage("count")
+  local start_us = micros()
+  for _ = 1, ITERATIONS do
+    test()
+  end
+  local time_us = (micros() - start_us):toint()
+  local mem_kb = collectgarbage("count") - mem_start
+  collectgarbage("restart")
+  return time_us, mem_kb
+end
+
+local tests = {
+  { "position", position_alloc, position_reuse },
+  { "vector", vector_alloc, vector_reuse },
+}
+
+local test_index = 1
+
+function update()
+  local test = tests[test_index]
+  local alloc_us, alloc_kb = run(test[2])
+  local reuse_us, reuse_kb = run(test[3])
+  gcs:send_text(MAV_SEVERITY_INFO, string.format("%s: %uus %.1fkB, reuse %uus %.1fkB per %u", test[1], alloc_us, alloc_kb, reuse_us, reuse_kb, ITERATIONS))
+  test_index = (test_index % #tests) + 1
+  return update, 1000
+end
+
+return update, 5000
@@ -0,0 +1,173 @@
+/*
+  Host tool to precompile a lua script to bytecode for embedding in
+  ROMFS, see Tools/ardupilotwaf/lua_bytecode.py
+
+  The output is a 16 byte header followed by the lua_dump() of the
+  script.  All header values are little endian:
+    char magic[4]     "APLB"
+    uint32_t abi      crc32 of the bindings description
+    uint32_t length   length of the bytecode
+    uint32_t crc      crc32 of the bytecode
+  The firmware checks the header in lua_scripts::load_bytecode()
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+
+#include "../../lua/src/lua.h"
+#include "../../lua/src/lauxlib.h"
+
+#define BYTECODE_MAGIC "APLB"
+#define BYTECODE_HEADER_SIZE 16
+
+struct buffer {
+  uint8_t *data;
+  size_t length;
+  size_t size;
+};
+
+// same as crc_crc32() in AP_Math
+static uint32_t crc32(uint32_t crc, const uint8_t *buf, size_t size) {
+  while (size--) {
+    crc ^= *buf++;
+    for (uint8_t i = 0; i < 8; i++) {
+      const uint32_t mask = -(crc & 1);
+      crc >>= 1;
+      crc ^= (0xEDB88320 & mask);
+    }
+  }
+  return crc;
+}
+
+static void error(const char *fmt, const char *arg) {
+  fprintf(stderr, "lua_precompile: ");
+  fprintf(stderr, fmt, arg);
+  fprintf(stderr, "\n");
+  exit(1);
+}
+
+static void append(struct buffer *b, const void *data, size_t length) {
+  if (b->length + length > b->size) {
+    b->size = (b->length + length) * 2;
+    b->data = realloc(b->data, b->size);
+    if (b->data == NULL) {
+      error("%s", "out of memory");
+    }
+  }
+  memcpy(&b->data[b->length], data, length);
+  b->length += length;
+}
+
+static void read_file(const char *path, struct buffer *b) {
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    error("unable to open %s", path);
+  }
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+    append(b, chunk, n);
+  }
+  fclose(f);
+}
+
+static void put_uint32(uint8_t *p, uint32_t v) {
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+  p[2] = (v >> 16) & 0xFF;
+  p[3] = (v >> 24) & 0xFF;
+}
+
+static int writer(lua_State *L, const void *p, size_t sz, void *ud) {
+  (void)L;
+  append((struct buffer *)ud, p, sz);
+  return 0;
+}
+
+static void *alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+  (void)ud;
+  (void)osize;
+  if (nsize == 0) {
+    free(ptr);
+    return NULL;
+  }
+  return realloc(ptr, nsize);
+}
+
+int main(int argc, char **argv) {
+  const char *abi_path = NULL;
+  const char *output_path = NULL;
+  int strip = 0;
+
+  int c;
+  while ((c = getopt(argc, argv, "a:o:s")) != -1) {
+    switch (c) {
+      case 'a':
+        abi_path = optarg;
+        break;
+      case 'o':
+        output_path = optarg;
+        break;
+      case 's':
+        strip = 1;
+        break;
+      default:
+        error("%s", "usage: lua_precompile -a bindings.desc -o output.lbc [-s] script.lua");
+    }
+  }
+  if (abi_path == NULL || output_path == NULL || optind != argc - 1) {
+    error("%s", "usage: lua_precompile -a bindings.desc -o output.lbc [-s] script.lua");
+  }
+  const char *input_path = argv[optind];
+
+  // the bytecode is tied to the bindings the firmware was built with
+  struct buffer desc = {0};
+  read_file(abi_path, &desc);
+  const uint32_t abi = crc32(0, desc.data, desc.length);
+
+  // name the chunk after the file so host paths don't end up in the firmware
+  struct buffer source = {0};
+  read_file(input_path, &source);
+  const char *base_name = strrchr(input_path, '/');
+  base_name = (base_name != NULL) ? base_name + 1 : input_path;
+  char chunk_name[256];
+  snprintf(chunk_name, sizeof(chunk_name), "@%s", base_name);
+
+  lua_State *L = lua_newstate(alloc, NULL);
+  if (L == NULL) {
+    error("%s", "unable to create lua state");
+  }
+  if (luaL_loadbufferx(L, (const char *)source.data, source.length, chunk_name, "t") != LUA_OK) {
+    error("%s", lua_tostring(L, -1));
+  }
+
+  struct buffer bytecode = {0};
+  if (lua_dump(L, writer, &bytecode, strip) != 0) {
+    error("unable to dump %s", input_path);
+  }
+  lua_close(L);
+
+  uint8_t header[BYTECODE_HEADER_SIZE];
+  memcpy(header, BYTECODE_MAGIC, 4);
+  put_uint32(&header[4], abi);
+  put_uint32(&header[8], (uint32_t)bytecode.length);
+  put_uint32(&header[12], crc32(0, bytecode.data, bytecode.length));
+
+  FILE *out = fopen(output_path, "wb");
+  if (out == NULL) {
+    error("unable to create %s", output_path);
+  }
+  if (fwrite(header, 1, sizeof(header), out) != sizeof(header) ||
+      fwrite(bytecode.data, 1, bytecode.length, out) != bytecode.length) {
+    error("unable to write %s", output_path);
+  }
+  fclose(out);
+
+  free(desc.data);
+  free(source.data);
+  free(bytecode.data);
+  return 0;
+}
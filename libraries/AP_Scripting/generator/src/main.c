@@ -31,6 +31,7 @@ char keyword_manual[]              = "manual";
 char keyword_global[]              = "global";
 char keyword_creation[]            = "creation";
 char keyword_manual_operator[]     = "manual_operator";
+char keyword_reuse[]               = "reuse";
 
 // attributes (should include the leading ' )
 char keyword_attr_enum[]    = "'enum";
@@ -87,6 +88,25 @@ FILE *docs;
 static struct generator_state state;
 static struct header * headers;
 
+// crc32 of the description file, precompiled scripts must have been built against the same bindings
+static uint32_t bindings_abi;
+
+// same as crc_crc32() in AP_Math, and crc32() in lua_precompile.c
+uint32_t crc32_file(FILE *f) {
+  uint32_t crc = 0;
+  int c;
+  while ((c = fgetc(f)) != EOF) {
+    crc ^= (uint8_t)c;
+    for (uint8_t i = 0; i < 8; i++) {
+      const uint32_t mask = -(crc & 1);
+      crc >>= 1;
+      crc ^= (0xEDB88320 & mask);
+    }
+  }
+  rewind(f);
+  return crc;
+}
+
 enum trace_level {
   TRACE_TOKENS    = (1 << 0),
   TRACE_HEADER    = (1 << 1),
@@ -348,6 +368,7 @@ struct method {
   char *sanatized_name;  // sanatized name of the C++ singleton
   char *rename; // (optional) used for scripting access
   char *deprecate; // (optional) issue deprecateion warning string on first call
+  int reuse; // (optional) accept a trailing userdata to return the result in, rather then allocating a new one
   int line; // line declared on
   struct type return_type;
   struct argument * arguments;
@@ -750,6 +771,35 @@ void handle_userdata_field(struct userdata *data) {
   field->access_flags = parse_access_flags(&(field->type));
 }
 
+// number of userdata values returned by a method, either directly or through 'Null and 'Ref arguments
+int count_userdata_results(const struct method *method) {
+  int count = (method->return_type.type == TYPE_USERDATA) ? 1 : 0;
+  const struct argument *arg = method->arguments;
+  while (arg != NULL) {
+    if ((arg->type.type == TYPE_USERDATA) && (arg->type.flags & (TYPE_FLAGS_NULLABLE | TYPE_FLAGS_REFERNCE))) {
+      count++;
+    }
+    arg = arg->next;
+  }
+  return count;
+}
+
+// the userdata returned by a method that reuses its result
+const struct type *userdata_result(const struct method *method) {
+  if (method->return_type.type == TYPE_USERDATA) {
+    return &method->return_type;
+  }
+  const struct argument *arg = method->arguments;
+  while (arg != NULL) {
+    if ((arg->type.type == TYPE_USERDATA) && (arg->type.flags & (TYPE_FLAGS_NULLABLE | TYPE_FLAGS_REFERNCE))) {
+      return &arg->type;
+    }
+    arg = arg->next;
+  }
+  error(ERROR_INTERNAL, "Method %s does not return a userdata", method->name);
+  return NULL;
+}
+
 void handle_method(struct userdata *node) {
   trace(TRACE_USERDATA, "Adding a method");
   char * parent_name = node->name;
@@ -807,6 +857,13 @@ void handle_method(struct userdata *node) {
       string_copy(&(method->dependency), dependency);
       return;
 
+    } else if (strcmp(token, keyword_reuse) == 0) {
+      if (count_userdata_results(method) != 1) {
+        error(ERROR_USERDATA, "Method %s %s must return exactly one userdata to be reused", parent_name, name);
+      }
+      method->reuse = TRUE;
+      return;
+
     }
     error(ERROR_USERDATA, "Method %s already exists for %s (declared on %d)", name, parent_name, method->line);
   }
@@ -1792,7 +1849,25 @@ void emit_singleton_fields() {
 }
 
 // emit refences functions for a call, return the number of arduments added
-int emit_references(const struct argument *arg, const char * tab) {
+// push a userdata result, copying it into the callers object at reuse_index if one was passed
+void emit_userdata_result(const struct type *type, const char *value, int reuse_index, const char *tab) {
+  char indent[32];
+  snprintf(indent, sizeof(indent), "%s%s", tab, (reuse_index != 0) ? "    " : "");
+  if (reuse_index != 0) {
+    fprintf(source, "%sif (result != nullptr) {\n", tab);
+    fprintf(source, "%s*result = %s;\n", indent, value);
+    fprintf(source, "%slua_pushvalue(L, %d);\n", indent, reuse_index);
+    fprintf(source, "%s} else {\n", tab);
+  }
+  // the container was just created, so there is no need to check its type
+  fprintf(source, "%snew_%s(L);\n", indent, type->data.ud.sanatized_name);
+  fprintf(source, "%s*static_cast<%s *>(lua_touserdata(L, -1)) = %s;\n", indent, type->data.ud.name, value);
+  if (reuse_index != 0) {
+    fprintf(source, "%s}\n", tab);
+  }
+}
+
+int emit_references(const struct argument *arg, const char * tab, int reuse_index) {
   int arg_index = NULLABLE_ARG_COUNT_BASE + 2;
   int return_count = 0;
   while (arg != NULL) {
@@ -1815,16 +1890,18 @@ int emit_references(const struct argument *arg, const char * tab) {
           break;
         case TYPE_UINT32_T:
           fprintf(source, "%snew_uint32_t(L);\n", tab);
-          fprintf(source, "%s*static_cast<uint32_t *>(luaL_checkudata(L, -1, \"uint32_t\")) = data_%d;\n", tab, arg_index);
+          fprintf(source, "%s*static_cast<uint32_t *>(lua_touserdata(L, -1)) = data_%d;\n", tab, arg_index);
           break;
         case TYPE_STRING:
           fprintf(source, "%slua_pushstring(L, data_%d);\n", tab, arg_index);
           break;
-        case TYPE_USERDATA:
-          // userdatas must allocate a new container to return
-          fprintf(source, "%snew_%s(L);\n", tab, arg->type.data.ud.sanatized_name);
-          fprintf(source, "%s*check_%s(L, -1) = data_%d;\n", tab, arg->type.data.ud.sanatized_name, arg_index);
+        case TYPE_USERDATA: {
+          // userdatas must allocate a new container to return, unless one was passed in
+          char value[20];
+          snprintf(value, sizeof(value), "data_%d", arg_index);
+          emit_userdata_result(&arg->type, value, reuse_index, tab);
           break;
+        }
         case TYPE_NONE:
           error(ERROR_INTERNAL, "Attempted to emit a nullable or reference  argument of type none");
           break;
@@ -1876,7 +1953,13 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
     }
     arg = arg->next;
   }
-  fprintf(source, "    binding_argcheck(L, %d);\n", arg_count);
+  // a reused result is passed after all the other arguments
+  const int reuse_index = method->reuse ? arg_count + 1 : 0;
+  if (method->reuse) {
+    fprintf(source, "    const bool reuse = binding_argcheck_reuse(L, %d);\n", arg_count);
+  } else {
+    fprintf(source, "    binding_argcheck(L, %d);\n", arg_count);
+  }
 
   switch (data->ud_type) {
     case UD_USERDATA:
@@ -1910,6 +1993,12 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
     arg = arg->next;
   }
 
+  if (method->reuse) {
+    // check the result before taking any semaphore, as this can error
+    const struct type *result_type = userdata_result(method);
+    fprintf(source, "    %s * result = reuse ? check_%s(L, %d) : nullptr;\n", result_type->data.ud.name, result_type->data.ud.sanatized_name, reuse_index);
+  }
+
   const char *ud_name = (data->flags & UD_FLAG_LITERAL)?data->name:"ud";
   const char *ud_access = (data->flags & UD_FLAG_REFERENCE)?".":"->";
 
@@ -2058,7 +2147,7 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
   if (method->flags & TYPE_FLAGS_REFERNCE) {
     arg = method->arguments;
     // number of arguments to return
-    return_count += emit_references(arg,"    ");
+    return_count += emit_references(arg,"    ", reuse_index);
   }
 
   switch (method->return_type.type) {
@@ -2067,7 +2156,7 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
         fprintf(source, "    if (data) {\n");
         // we need to emit out nullable arguments, iterate the args again, creating and copying objects, while keeping a new count
         arg = method->arguments;
-        return_count = emit_references(arg,"        ");
+        return_count = emit_references(arg,"        ", reuse_index);
         fprintf(source, "        return %d;\n", return_count);
         fprintf(source, "    }\n");
         fprintf(source, "    return 0;\n");
@@ -2088,15 +2177,14 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
       break;
     case TYPE_UINT32_T:
       fprintf(source, "        new_uint32_t(L);\n");
-      fprintf(source, "        *static_cast<uint32_t *>(luaL_checkudata(L, -1, \"uint32_t\")) = data;\n");
+      fprintf(source, "        *static_cast<uint32_t *>(lua_touserdata(L, -1)) = data;\n");
       break;
     case TYPE_STRING:
       fprintf(source, "    lua_pushstring(L, data);\n");
       break;
     case TYPE_USERDATA:
-      // userdatas must allocate a new container to return
-      fprintf(source, "    new_%s(L);\n", method->return_type.data.ud.sanatized_name);
-      fprintf(source, "    *check_%s(L, -1) = data;\n", method->return_type.data.ud.sanatized_name);
+      // userdatas must allocate a new container to return, unless one was passed in
+      emit_userdata_result(&method->return_type, "data", reuse_index, "    ");
       break;
     case TYPE_AP_OBJECT:
       fprintf(source, "    if (data == NULL) {\n");
@@ -2182,7 +2270,7 @@ void emit_operators(struct userdata *data) {
     fprintf(source, "    %s *ud2 = check_%s(L, 2);\n", data->name, data->sanatized_name);
     // create a container for the result
     fprintf(source, "    new_%s(L);\n", data->sanatized_name);
-    fprintf(source, "    *check_%s(L, -1) = *ud %c *ud2;\n", data->sanatized_name, op_sym);
+    fprintf(source, "    *static_cast<%s *>(lua_touserdata(L, -1)) = *ud %c *ud2;\n", data->name, op_sym);
     // return the first pointer
     fprintf(source, "    return 1;\n");
     fprintf(source, "}\n\n");
@@ -2469,6 +2557,15 @@ void emit_argcheck_helper(void) {
   fprintf(source, "    return 0;\n");
   fprintf(source, "}\n\n");
 
+  // methods that can reuse a userdata take an optional extra argument to return the result in
+  fprintf(source, "bool binding_argcheck_reuse(lua_State *L, int expected_arg_count) {\n");
+  fprintf(source, "    if (lua_gettop(L) == expected_arg_count + 1) {\n");
+  fprintf(source, "        return true;\n");
+  fprintf(source, "    }\n");
+  fprintf(source, "    binding_argcheck(L, expected_arg_count);\n");
+  fprintf(source, "    return false;\n");
+  fprintf(source, "}\n\n");
+
   // emit warning if augments are parsed
   fprintf(source, "bool userdata_zero_arg_check(lua_State *L) {\n");
   fprintf(source, "    if (lua_gettop(L) == 0) {\n");
@@ -2626,6 +2723,11 @@ void emit_docs_method(const char *name, const char *method_name, struct method *
     arg = arg->next;
   }
 
+  // optional object to return the result in
+  if (method->reuse) {
+    emit_docs_type(*userdata_result(method), "---@param result?", "\n");
+  }
+
   // return type
   if ((method->flags & TYPE_FLAGS_NULLABLE) == 0) {
     emit_docs_type(method->return_type, "---@return", "\n");
@@ -2652,6 +2754,9 @@ void emit_docs_method(const char *name, const char *method_name, struct method *
       fprintf(docs, ", ");
     }
   }
+  if (method->reuse) {
+    fprintf(docs, "%sresult", (count > 1) ? ", " : "");
+  }
   fprintf(docs, ") end\n\n");
 }
 
@@ -2845,6 +2950,7 @@ int main(int argc, char **argv) {
         if (description == NULL) {
           error(ERROR_GENERAL, "Unable to load the description file: %s", optarg);
         }
+        bindings_abi = crc32_file(description);
         break;
       case 'o':
         if (output_path != NULL) {
@@ -2984,6 +3090,7 @@ int main(int argc, char **argv) {
   emit_headers(header);
   fprintf(header, "#include <AP_Scripting/lua/src/lua.hpp>\n");
   fprintf(header, "#include <new>\n\n");
+  fprintf(header, "#define AP_SCRIPTING_BINDINGS_ABI 0x%08xU // checksum of the bindings description\n\n", bindings_abi);
 
   emit_userdata_declarations();
   emit_ap_object_declarations();
@@ -2991,6 +3098,7 @@ int main(int argc, char **argv) {
   fprintf(header, "void load_generated_bindings(lua_State *L);\n");
   fprintf(header, "void load_generated_sandbox(lua_State *L);\n");
   fprintf(header, "int binding_argcheck(lua_State *L, int expected_arg_count);\n");
+  fprintf(header, "bool binding_argcheck_reuse(lua_State *L, int expected_arg_count);\n");
   fprintf(header, "bool userdata_zero_arg_check(lua_State *L);\n");
   fprintf(header, "lua_Integer get_integer(lua_State *L, int arg_num, lua_Integer min_val, lua_Integer max_val);\n");
   fprintf(header, "int8_t get_int8_t(lua_State *L, int arg_num);\n");
@@ -772,18 +772,28 @@ static void checkmode (lua_State *L, const char *mode, const char *x) {
 }
 
 
+/*
+  binary chunks are not verified by luaU_undump, so unless binary
+  loading is enabled they are only accepted from the script loader
+  after it has checked them.  Scripts can't set this
+ */
+static int trusted_binary;
+
+void luaD_settrustedbinary (int trusted) {
+  trusted_binary = trusted;
+}
+
+
 static void f_parser (lua_State *L, void *ud) {
   LClosure *cl;
   struct SParser *p = cast(struct SParser *, ud);
   int c = zgetc(p->z);  /* read first character */
-#if LUA_SUPPORT_LOAD_BINARY
   // support loading pre-compiled luac
-  if (c == LUA_SIGNATURE[0]) {
+  if (c == LUA_SIGNATURE[0] && (LUA_SUPPORT_LOAD_BINARY || trusted_binary)) {
     checkmode(L, p->mode, "binary");
     cl = luaU_undump(L, p->z, p->name);
   }
   else
-#endif
   {
     checkmode(L, p->mode, "text");
     cl = luaY_parser(L, p->z, &p->buff, &p->dyd, p->name, c);
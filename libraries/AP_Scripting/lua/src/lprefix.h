@@ -43,8 +43,10 @@
 
 #endif
 
+#ifndef LUA_HOST_TOOL
 // load posix compatibility functions
 #include <AP_Filesystem/posix_compat.h>
+#endif
 
 #define lua_writestring(s,l) printf("%s", s)
 #define lua_writestringerror(s,l) lua_writestring(s,l)
@@ -17,7 +17,9 @@
 #ifndef LUA_SUPPORT_LOAD_BINARY
 #define LUA_SUPPORT_LOAD_BINARY 0
 #endif
+#ifndef LUA_HOST_TOOL
 #include <AP_Scripting/lua_common_defs.h>
+#endif
 
 /*
 ** ===================================================================
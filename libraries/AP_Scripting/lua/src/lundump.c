@@ -94,8 +94,11 @@ static lua_Integer LoadInteger (LoadState *S) {
 
 static TString *LoadString (LoadState *S) {
   size_t size = LoadByte(S);
-  if (size == 0xFF)
-    LoadVar(S, size);
+  if (size == 0xFF) {
+    LUAC_SIZET dsize;
+    LoadVar(S, dsize);
+    size = dsize;
+  }
   if (size == 0)
     return NULL;
   else if (--size <= LUAI_MAXSHORTLEN) {  /* short string? */
@@ -248,7 +251,7 @@ static void checkHeader (LoadState *S) {
     error(S, "format mismatch in");
   checkliteral(S, LUAC_DATA, "corrupted");
   checksize(S, int);
-  checksize(S, size_t);
+  checksize(S, LUAC_SIZET);
   checksize(S, Instruction);
   checksize(S, lua_Integer);
   checksize(S, lua_Number);
@@ -22,6 +22,12 @@
 #define LUAC_VERSION	(MYINT(LUA_VERSION_MAJOR)*16+MYINT(LUA_VERSION_MINOR))
 #define LUAC_FORMAT	0	/* this is the official format */
 
+/*
+  string sizes are always saved as 32 bits so that bytecode compiled
+  on a 64 bit host loads on 32 bit boards
+ */
+#define LUAC_SIZET	unsigned int
+
 /* load one chunk; from lundump.c */
 LUAI_FUNC LClosure* luaU_undump (lua_State* L, ZIO* Z, const char* name);
 
@@ -10,6 +10,11 @@
 extern const AP_HAL::HAL& hal;
 
 uint32_t coerce_to_uint32_t(lua_State *L, int arg) {
+    // plain integers are the common case, and are much cheaper to
+    // check for then a userdata, which needs a metatable lookup
+    if (lua_isinteger(L, arg)) {
+        return static_cast<uint32_t>(lua_tointeger(L, arg));
+    }
     { // userdata
         const uint32_t * ud = static_cast<uint32_t *>(luaL_testudata(L, arg, "uint32_t"));
         if (ud != nullptr) {
@@ -60,7 +65,7 @@ int lua_new_uint32_t(lua_State *L) {
         uint32_t v2 = coerce_to_uint32_t(L, 2); \
           \
         new_uint32_t(L); \
-        *static_cast<uint32_t *>(luaL_checkudata(L, -1, "uint32_t")) = v1 sym v2; \
+        *static_cast<uint32_t *>(lua_touserdata(L, -1)) = v1 sym v2; \
         return 1; \
     }
 
@@ -97,7 +102,7 @@ UINT32_T_BOX_OP_BOOL(le, <=)
         uint32_t v1 = coerce_to_uint32_t(L, 1); \
           \
         new_uint32_t(L); \
-        *static_cast<uint32_t *>(luaL_checkudata(L, -1, "uint32_t")) = sym v1; \
+        *static_cast<uint32_t *>(lua_touserdata(L, -1)) = sym v1; \
         return 1; \
     }
 
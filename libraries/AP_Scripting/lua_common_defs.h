@@ -26,4 +26,24 @@
   #define REPL_OUT REPL_DIRECTORY "/out"
 #endif // REPL_OUT
 
+#ifndef SCRIPTING_PROFILE_SAMPLE_STEPS
+  #define SCRIPTING_PROFILE_SAMPLE_STEPS 1000 // VM instructions between count hook calls, sets the resolution of the step counts and the profiler's sample interval
+#endif // SCRIPTING_PROFILE_SAMPLE_STEPS
+
+#ifndef SCRIPTING_PROFILE_MAX_FUNCTIONS
+  #define SCRIPTING_PROFILE_MAX_FUNCTIONS 16 // number of hot functions tracked by the profiler
+#endif // SCRIPTING_PROFILE_MAX_FUNCTIONS
+
+#ifndef SCRIPTING_STATS_LOG_PERIOD_MS
+  #define SCRIPTING_STATS_LOG_PERIOD_MS 10000 // interval between logging per-script stats and profile
+#endif // SCRIPTING_STATS_LOG_PERIOD_MS
+
+#ifndef SCRIPTING_GC_FULL_PERCENT
+  #define SCRIPTING_GC_FULL_PERCENT 75 // heap use above which a full garbage collection is done after each script run
+#endif // SCRIPTING_GC_FULL_PERCENT
+
+#ifndef SCRIPTING_THROTTLE_MAX_MS
+  #define SCRIPTING_THROTTLE_MAX_MS 5000 // longest a script's next run is delayed for allocating too much memory
+#endif // SCRIPTING_THROTTLE_MAX_MS
+
 int lua_get_current_ref();
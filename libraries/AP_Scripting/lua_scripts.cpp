@@ -21,9 +21,15 @@
 #include <AP_HAL/AP_HAL.h>
 #include "AP_Scripting.h"
 #include <AP_Logger/AP_Logger.h>
+#include <AP_Common/ExpandingString.h>
+#include <AP_Math/crc.h>
 
 #include <AP_Scripting/lua_generated_bindings.h>
 
+extern "C" {
+#include "lua/src/ldo.h"
+}
+
 #define DISABLE_INTERRUPTS_FOR_SCRIPT_RUN 0
 
 extern const AP_HAL::HAL& hal;
@@ -40,9 +46,21 @@ uint32_t lua_scripts::loaded_checksum;
 uint32_t lua_scripts::running_checksum;
 HAL_Semaphore lua_scripts::crc_sem;
 
-lua_scripts::lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_options, struct AP_Scripting::terminal_s &_terminal)
+uint32_t lua_scripts::hook_steps_max;
+uint32_t lua_scripts::hook_steps;
+lua_scripts::profile_entry lua_scripts::profile[SCRIPTING_PROFILE_MAX_FUNCTIONS];
+bool lua_scripts::profiling;
+
+lua_scripts::script_info *lua_scripts::stats_list;
+HAL_Semaphore lua_scripts::stats_sem;
+uint32_t lua_scripts::alloc_bytes;
+
+lua_scripts::lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_options, const AP_Int16 &gc_budget_us, const AP_Int32 &alloc_max, struct AP_Scripting::terminal_s &_terminal)
     : _vm_steps(vm_steps),
       _debug_options(debug_options),
+      _gc_budget_us(gc_budget_us),
+      _alloc_max(alloc_max),
+      _heap_size(heap_size),
      terminal(_terminal)
 {
     _heap.create(heap_size, 4);
@@ -53,6 +71,21 @@ lua_scripts::~lua_scripts() {
 }
 
 void lua_scripts::hook(lua_State *L, lua_Debug *ar) {
+    if (!overtime) {
+        // the hook is called every SCRIPTING_PROFILE_SAMPLE_STEPS to
+        // count steps and sample the profile, the script is only over
+        // time once it has used all of its steps
+        hook_steps += lua_gethookcount(L);
+        if (hook_steps < hook_steps_max) {
+            const uint32_t remaining = hook_steps_max - hook_steps;
+            if (remaining < uint32_t(lua_gethookcount(L))) {
+                lua_sethook(L, hook, LUA_MASKCOUNT, remaining);
+            }
+            profile_sample(L, ar);
+            return;
+        }
+    }
+
     lua_scripts::overtime = true;
 
     // we need to aggressively bail out as we are over time
@@ -121,6 +154,48 @@ void lua_scripts::set_and_print_new_error_message(MAV_SEVERITY severity, const c
     print_error(severity);
 }
 
+// record the function running when the hook was called
+void lua_scripts::profile_sample(lua_State *L, lua_Debug *ar)
+{
+    if (!profiling || !lua_getinfo(L, "S", ar)) {
+        return;
+    }
+    const char *source = strrchr(ar->short_src, '/');
+    source = (source != nullptr) ? source+1 : ar->short_src;
+
+    WITH_SEMAPHORE(stats_sem);
+
+    profile_entry *least = &profile[0];
+    for (auto &entry : profile) {
+        if ((entry.samples > 0) && (entry.line == ar->linedefined) && (strncmp(entry.source, source, sizeof(entry.source)) == 0)) {
+            entry.samples++;
+            return;
+        }
+        if (entry.samples < least->samples) {
+            least = &entry;
+        }
+    }
+
+    // replace the least sampled function, keeping its count so a
+    // newly seen function is not immediately replaced again
+    strncpy_noterm(least->source, source, sizeof(least->source));
+    least->line = ar->linedefined;
+    least->samples++;
+}
+
+#if HAL_LOGGING_ENABLED
+// shorten a script filename to fit in a log message
+static void copy_script_name(char *dest, size_t len, const char *name)
+{
+    const char * name_short = strrchr(name, '/');
+    if ((strlen(name) > len) && (name_short != nullptr)) {
+        strncpy_noterm(dest, name_short+1, len);
+    } else {
+        strncpy_noterm(dest, name, len);
+    }
+}
+#endif // HAL_LOGGING_ENABLED
+
 int lua_scripts::atpanic(lua_State *L) {
     set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "Panic: %s", lua_tostring(L, -1));
     longjmp(panic_jmp, 1);
@@ -146,19 +221,149 @@ void lua_scripts::update_stats(const char *name, uint32_t run_time, int total_me
             total_mem    : total_mem,
             run_mem      : run_mem
         };
-        const char * name_short = strrchr(name, '/');
-        if ((strlen(name) > sizeof(pkt.name)) && (name_short != nullptr)) {
-            strncpy_noterm(pkt.name, name_short+1, sizeof(pkt.name));
-        } else {
-            strncpy_noterm(pkt.name, name, sizeof(pkt.name));
-        }
+        copy_script_name(pkt.name, sizeof(pkt.name), name);
         AP::logger().WriteBlock(&pkt, sizeof(pkt));
     }
 #endif // HAL_LOGGING_ENABLED
 }
 
-lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename) {
-    if (int error = luaL_loadfile(L, filename)) {
+// periodically log the per-script stats and the profiler's hot functions
+void lua_scripts::log_stats(void)
+{
+#if HAL_LOGGING_ENABLED
+    const bool log_runtime = (_debug_options.get() & uint8_t(DebugLevel::LOG_RUNTIME)) != 0;
+    if (!log_runtime && !profiling) {
+        return;
+    }
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - last_stats_log_ms < SCRIPTING_STATS_LOG_PERIOD_MS) {
+        return;
+    }
+    last_stats_log_ms = now_ms;
+    const uint64_t now_us = AP_HAL::micros64();
+
+    WITH_SEMAPHORE(stats_sem);
+
+    if (log_runtime) {
+        for (const script_info *script = stats_list; script != nullptr; script = script->stats_next) {
+            const auto &stats = script->stats;
+            struct log_ScriptingStats pkt {
+                LOG_PACKET_HEADER_INIT(LOG_SCRIPTING_STATS_MSG),
+                time_us          : now_us,
+                name             : {},
+                run_count        : stats.run_count,
+                run_time         : stats.run_time_us,
+                run_time_max     : stats.run_time_max_us,
+                run_time_avg     : uint32_t(stats.run_time_total_us / MAX(stats.run_count, 1U)),
+                vm_steps         : stats.vm_steps,
+                vm_steps_max     : stats.vm_steps_max,
+                alloc_bytes      : stats.alloc_bytes,
+                gc_time          : stats.gc_time_us,
+                gc_time_max      : stats.gc_time_max_us
+            };
+            copy_script_name(pkt.name, sizeof(pkt.name), script->name);
+            AP::logger().WriteBlock(&pkt, sizeof(pkt));
+        }
+    }
+
+    if (profiling) {
+        for (const auto &entry : profile) {
+            if (entry.samples == 0) {
+                continue;
+            }
+            struct log_ScriptingProfile pkt {
+                LOG_PACKET_HEADER_INIT(LOG_SCRIPTING_PROFILE_MSG),
+                time_us      : now_us,
+                source       : {},
+                line         : entry.line,
+                samples      : entry.samples
+            };
+            memcpy(pkt.source, entry.source, sizeof(pkt.source));
+            AP::logger().WriteBlock(&pkt, sizeof(pkt));
+        }
+    }
+#endif // HAL_LOGGING_ENABLED
+}
+
+#if AP_SCRIPTING_BYTECODE_ENABLED
+// header written by generator/src/lua_precompile.c
+struct PACKED bytecode_header {
+    char magic[4];
+    uint32_t abi;       // checksum of the bindings description the script was compiled against
+    uint32_t length;    // length of the bytecode following the header
+    uint32_t crc;       // crc32 of the bytecode
+};
+
+struct bytecode_reader {
+    int fd;
+    uint32_t remaining;
+    char buf[128];
+};
+
+static const char *read_bytecode(lua_State *L, void *ud, size_t *size)
+{
+    (void)L;
+    bytecode_reader &reader = *(bytecode_reader *)ud;
+    const int32_t n = AP::FS().read(reader.fd, reader.buf, MIN(reader.remaining, sizeof(reader.buf)));
+    if (n <= 0) {
+        *size = 0;
+        return nullptr;
+    }
+    reader.remaining -= n;
+    *size = n;
+    return reader.buf;
+}
+
+int lua_scripts::load_bytecode(lua_State *L, const char *filename)
+{
+    bytecode_reader reader;
+    reader.fd = AP::FS().open(filename, O_RDONLY);
+    if (reader.fd == -1) {
+        lua_pushfstring(L, "cannot open %s", filename);
+        return LUA_ERRFILE;
+    }
+
+    // lua does not check bytecode as it loads it, so make sure the
+    // file is complete and was built against these bindings first
+    bytecode_header header;
+    bool valid = (AP::FS().read(reader.fd, &header, sizeof(header)) == sizeof(header)) &&
+                 (memcmp(header.magic, "APLB", sizeof(header.magic)) == 0) &&
+                 (header.abi == AP_SCRIPTING_BINDINGS_ABI);
+    if (valid) {
+        uint32_t crc = 0;
+        uint32_t length = 0;
+        int32_t n;
+        while ((n = AP::FS().read(reader.fd, reader.buf, sizeof(reader.buf))) > 0) {
+            crc = crc_crc32(crc, (const uint8_t *)reader.buf, n);
+            length += n;
+        }
+        valid = (n == 0) && (length == header.length) && (crc == header.crc) &&
+                (AP::FS().lseek(reader.fd, sizeof(header), SEEK_SET) == sizeof(header));
+    }
+    if (!valid) {
+        AP::FS().close(reader.fd);
+        lua_pushfstring(L, "%s is not bytecode for this firmware", filename);
+        return LUA_ERRSYNTAX;
+    }
+
+    reader.remaining = header.length;
+    lua_pushfstring(L, "@%s", filename);
+    luaD_settrustedbinary(1);
+    const int status = lua_load(L, read_bytecode, &reader, lua_tostring(L, -1), "b");
+    luaD_settrustedbinary(0);
+    AP::FS().close(reader.fd);
+    lua_remove(L, -2);  // chunk name
+    return status;
+}
+#endif // AP_SCRIPTING_BYTECODE_ENABLED
+
+lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename, bool bytecode) {
+#if AP_SCRIPTING_BYTECODE_ENABLED
+    const int error = bytecode ? load_bytecode(L, filename) : luaL_loadfile(L, filename);
+#else
+    const int error = luaL_loadfile(L, filename);
+#endif
+    if (error) {
         switch (error) {
             case LUA_ERRSYNTAX:
                 set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "Error: %s", lua_tostring(L, -1));
@@ -202,6 +407,14 @@ lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename)
     new_script->name = filename;
     new_script->lua_ref = luaL_ref(L, LUA_REGISTRYINDEX);   // cache the reference
     new_script->next_run_ms = AP_HAL::millis64() - 1; // force the script to be stale
+    new_script->stats = {};
+    new_script->throttle_ms = 0;
+    new_script->throttle_warned = false;
+    {
+        WITH_SEMAPHORE(stats_sem);
+        new_script->stats_next = stats_list;
+        stats_list = new_script;
+    }
 
     // Get checksum of file
     uint32_t crc = 0;
@@ -250,7 +463,7 @@ void lua_scripts::create_sandbox(lua_State *L) {
     load_generated_sandbox(L);
 }
 
-void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
+void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname, bool allow_bytecode) {
     if (dirname == nullptr) {
         return;
     }
@@ -261,7 +474,7 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
         return;
     }
 
-    // load anything that ends in .lua
+    // load anything that ends in .lua, or .lbc if bytecode is allowed
     for (struct dirent *de=AP::FS().readdir(d); de; de=AP::FS().readdir(d)) {
         uint8_t length = strlen(de->d_name);
         if (length < 5) {
@@ -269,7 +482,8 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
             continue;
         }
 
-        if (strncmp(&de->d_name[length-4], ".lua", 4)) {
+        const bool bytecode = AP_SCRIPTING_BYTECODE_ENABLED && allow_bytecode && (strncmp(&de->d_name[length-4], ".lbc", 4) == 0);
+        if (strncmp(&de->d_name[length-4], ".lua", 4) && !bytecode) {
             // doesn't end in .lua
             continue;
         }
@@ -283,7 +497,7 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
         snprintf(filename, size, "%s/%s", dirname, de->d_name);
 
         // we have something that looks like a lua file, attempt to load it
-        script_info * script = load_script(L, filename);
+        script_info * script = load_script(L, filename, bytecode);
         if (script == nullptr) {
             _heap.deallocate(filename);
             continue;
@@ -301,20 +515,24 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
 
 void lua_scripts::reset_loop_overtime(lua_State *L) {
     overtime = false;
-    // reset the hook to clear the counter
-    const int32_t vm_steps = MAX(_vm_steps, 1000);
-    lua_sethook(L, hook, LUA_MASKCOUNT, vm_steps);
+    hook_steps = 0;
+    hook_steps_max = MAX(_vm_steps, 1000);
+    // reset the hook to clear the counter, it is called more often
+    // than the step limit to count steps and sample the running function
+    profiling = (_debug_options.get() & uint8_t(DebugLevel::PROFILE)) != 0;
+    lua_sethook(L, hook, LUA_MASKCOUNT, MIN(hook_steps_max, uint32_t(SCRIPTING_PROFILE_SAMPLE_STEPS)));
 }
 
-void lua_scripts::run_next_script(lua_State *L) {
+lua_scripts::script_info *lua_scripts::run_next_script(lua_State *L) {
     if (scripts == nullptr) {
 #if defined(AP_SCRIPTING_CHECKS) && AP_SCRIPTING_CHECKS >= 1
         AP_HAL::panic("Lua: Attempted to run a script without any scripts queued");
 #endif // defined(AP_SCRIPTING_CHECKS) && AP_SCRIPTING_CHECKS >= 1
-        return;
+        return nullptr;
     }
 
     uint64_t start_time_ms = AP_HAL::millis64();
+    const uint32_t start_alloc_bytes = alloc_bytes;
     // strip the selected script out of the list
     script_info *script = scripts;
     scripts = script->next;
@@ -338,14 +556,14 @@ void lua_scripts::run_next_script(lua_State *L) {
         }
         remove_script(L, script);
         lua_pop(L, 1);
-        return;
+        return nullptr;
     } else {
         int returned = lua_gettop(L) - stack_top;
         switch (returned) {
             case 0:
                 // no time to reschedule so bail out
                 remove_script(L, script);
-                break;
+                return nullptr;
             case 2:
                 {
                     // sanity check the return types
@@ -353,23 +571,38 @@ void lua_scripts::run_next_script(lua_State *L) {
                         set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "%s did not return a delay (0x%d)", script->name, lua_type(L, -1));
                         lua_pop(L, 2);
                         remove_script(L, script);
-                        return;
+                        return nullptr;
                     }
                     if (lua_type(L, -2) != LUA_TFUNCTION) {
                         set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "%s did not return a function (0x%d)", script->name, lua_type(L, -2));
                         lua_pop(L, 2);
                         remove_script(L, script);
-                        return;
+                        return nullptr;
                     }
 
                     // types match the expectations, go ahead and reschedule
-                    script->next_run_ms = start_time_ms + (uint64_t)luaL_checknumber(L, -1);
+                    const uint64_t delay_ms = (uint64_t)luaL_checknumber(L, -1);
+
+                    // a script creating more garbage than it is allowed
+                    // is run less often, in proportion to the excess, so
+                    // collecting it doesn't stall the other scripts
+                    const uint32_t run_alloc = alloc_bytes - start_alloc_bytes;
+                    const uint32_t alloc_max = MAX(_alloc_max.get(), 0);
+                    script->throttle_ms = 0;
+                    if ((alloc_max > 0) && (run_alloc > alloc_max)) {
+                        script->throttle_ms = uint32_t(MIN(MAX(delay_ms, 1U) * (run_alloc / alloc_max), uint64_t(SCRIPTING_THROTTLE_MAX_MS)));
+                        if (!script->throttle_warned) {
+                            GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "Lua: %s allocated %u bytes, throttling", script->name, unsigned(run_alloc));
+                            script->throttle_warned = true;
+                        }
+                    }
+                    script->next_run_ms = start_time_ms + delay_ms + script->throttle_ms;
                     lua_pop(L, 1);
                     int old_ref = script->lua_ref;
                     script->lua_ref = luaL_ref(L, LUA_REGISTRYINDEX);
                     luaL_unref(L, LUA_REGISTRYINDEX, old_ref);
                     reschedule_script(script);
-                    break;
+                    return script;
                 }
             default:
                 {
@@ -377,7 +610,7 @@ void lua_scripts::run_next_script(lua_State *L) {
                     remove_script(L, script);
                     // pop all the results we got that we didn't expect
                     lua_pop(L, returned);
-                    break;
+                    return nullptr;
                  }
          }
      }
@@ -407,6 +640,17 @@ void lua_scripts::remove_script(lua_State *L, script_info *script) {
         WITH_SEMAPHORE(crc_sem);
         running_checksum ^= script->crc;
     }
+
+    {
+        // Remove from stats list
+        WITH_SEMAPHORE(stats_sem);
+        for (script_info **s = &stats_list; *s != nullptr; s = &(*s)->stats_next) {
+            if (*s == script) {
+                *s = script->stats_next;
+                break;
+            }
+        }
+    }
     
     if (L != nullptr) {
         // state could be null if we are force killing all scripts
@@ -455,9 +699,40 @@ MultiHeap lua_scripts::_heap;
 
 void *lua_scripts::alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
     (void)ud; /* not used */
+    // when ptr is null osize is the type of the object being allocated
+    const size_t old_size = (ptr == nullptr) ? 0 : osize;
+    if (nsize > old_size) {
+        alloc_bytes += nsize - old_size;
+    }
     return _heap.change_size(ptr, osize, nsize);
 }
 
+bool lua_scripts::gc_step(lua_State *L, uint32_t budget_us) {
+    const uint32_t start_us = AP_HAL::micros();
+    do {
+        if (lua_gc(L, LUA_GCSTEP, 0)) {
+            gc_cycle_alloc_bytes = alloc_bytes;
+            return true;
+        }
+    } while (AP_HAL::micros() - start_us < budget_us);
+    return false;
+}
+
+void lua_scripts::gc_after_run(lua_State *L, int mem) {
+    const uint32_t budget_us = MAX(_gc_budget_us.get(), 0);
+    if ((budget_us == 0) || (uint32_t(mem) > (_heap_size / 100U) * SCRIPTING_GC_FULL_PERCENT)) {
+        // garbage collect after each script, this shouldn't matter, but seems to resolve a memory leak
+        lua_gc(L, LUA_GCCOLLECT, 0);
+        gc_cycle_alloc_bytes = alloc_bytes;
+        return;
+    }
+    // spread collection over runs, Lua also collects incrementally
+    // as a script allocates so those allocating the most pay the most
+    if (alloc_bytes != gc_cycle_alloc_bytes) {
+        gc_step(L, budget_us);
+    }
+}
+
 void lua_scripts::repl_cleanup (void) {
     if (terminal.session) {
         terminal.session = false;
@@ -479,6 +754,12 @@ void lua_scripts::run(void) {
         return;
     }
 
+    {
+        // forget the profile from any previous run
+        WITH_SEMAPHORE(stats_sem);
+        memset(profile, 0, sizeof(profile));
+    }
+
     // panic should be hooked first
     if (setjmp(panic_jmp)) {
         if (!succeeded_initial_load) {
@@ -521,11 +802,12 @@ void lua_scripts::run(void) {
     uint16_t dir_disable = AP_Scripting::get_singleton()->get_disabled_dir();
     bool loaded = false;
     if ((dir_disable & uint16_t(AP_Scripting::SCR_DIR::SCRIPTS)) == 0) {
-        load_all_scripts_in_dir(L, SCRIPTING_DIRECTORY);
+        load_all_scripts_in_dir(L, SCRIPTING_DIRECTORY, false);
         loaded = true;
     }
     if ((dir_disable & uint16_t(AP_Scripting::SCR_DIR::ROMFS)) == 0) {
-        load_all_scripts_in_dir(L, "@ROMFS/scripts");
+        // only ROMFS is trusted to hold bytecode, as it is part of the firmware
+        load_all_scripts_in_dir(L, "@ROMFS/scripts", true);
         loaded = true;
     }
     if (!loaded) {
@@ -563,6 +845,12 @@ void lua_scripts::run(void) {
 
             // compute delay time
             uint64_t now_ms = AP_HAL::millis64();
+            if ((now_ms < scripts->next_run_ms) && (_gc_budget_us > 0) && (alloc_bytes != gc_cycle_alloc_bytes)) {
+                // use some of the time until the next script is due to
+                // collect garbage, rather than adding it to a script's run
+                gc_step(L, MIN(uint64_t(_gc_budget_us), (scripts->next_run_ms - now_ms) * 1000U));
+                now_ms = AP_HAL::millis64();
+            }
             if (now_ms < scripts->next_run_ms) {
                 hal.scheduler->delay(scripts->next_run_ms - now_ms);
             }
@@ -581,16 +869,20 @@ void lua_scripts::run(void) {
 #endif
 
             const int startMem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+            const uint32_t startAlloc = alloc_bytes;
             const uint32_t loadEnd = AP_HAL::micros();
 
             // NOTE!  the base pointer of our scripts linked list,
             // *and all its contents* may become invalid as part of
             // "run_next_script"!  So do *NOT* attempt to access
-            // anything that was in *scripts after this call.
-            run_next_script(L);
+            // anything that was in *scripts after this call.  The
+            // returned script is valid until the next call.
+            script_info *script = run_next_script(L);
 
             const uint32_t runEnd = AP_HAL::micros();
             const int endMem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+            const uint32_t vm_steps = hook_steps;
+            const uint32_t run_alloc = alloc_bytes - startAlloc;
 
 #if DISABLE_INTERRUPTS_FOR_SCRIPT_RUN
             hal.scheduler->restore_interrupts(istate);
@@ -599,8 +891,27 @@ void lua_scripts::run(void) {
             update_stats(script_name, runEnd - loadEnd, endMem, endMem - startMem);
 
 
-            // garbage collect after each script, this shouldn't matter, but seems to resolve a memory leak
-            lua_gc(L, LUA_GCCOLLECT, 0);
+            gc_after_run(L, endMem);
+            const uint32_t gcEnd = AP_HAL::micros();
+
+            if (script != nullptr) {
+                WITH_SEMAPHORE(stats_sem);
+                auto &stats = script->stats;
+                stats.run_count++;
+                stats.run_time_us = runEnd - loadEnd;
+                stats.run_time_max_us = MAX(stats.run_time_max_us, stats.run_time_us);
+                stats.run_time_total_us += stats.run_time_us;
+                stats.vm_steps = vm_steps;
+                stats.vm_steps_max = MAX(stats.vm_steps_max, vm_steps);
+                stats.alloc_bytes = run_alloc;
+                stats.gc_time_us = gcEnd - runEnd;
+                stats.gc_time_max_us = MAX(stats.gc_time_max_us, stats.gc_time_us);
+                if (script->throttle_ms > 0) {
+                    stats.throttle_count++;
+                }
+            }
+
+            log_stats();
 
         } else {
             if ((_debug_options.get() & uint8_t(DebugLevel::NO_SCRIPTS_TO_RUN)) != 0) {
@@ -649,4 +960,39 @@ uint32_t lua_scripts::get_running_checksum()
     return running_checksum;
 }
 
+// fill in ExpandingString with per-script stats and the profiler's hot functions
+void lua_scripts::script_info_string(ExpandingString &str)
+{
+    WITH_SEMAPHORE(stats_sem);
+
+    str.printf("%-24s %6s %8s %8s %8s %8s %8s %8s %6s\n", "Name", "Runs", "AvgUS", "MaxUS", "Steps", "MaxSteps", "Alloc", "MaxGCUS", "Thrtl");
+    for (const script_info *script = stats_list; script != nullptr; script = script->stats_next) {
+        const auto &stats = script->stats;
+        const char *name = strrchr(script->name, '/');
+        name = (name != nullptr) ? name+1 : script->name;
+        str.printf("%-24s %6u %8u %8u %8u %8u %8u %8u %6u\n",
+                   name,
+                   unsigned(stats.run_count),
+                   unsigned(stats.run_time_total_us / MAX(stats.run_count, 1U)),
+                   unsigned(stats.run_time_max_us),
+                   unsigned(stats.vm_steps),
+                   unsigned(stats.vm_steps_max),
+                   unsigned(stats.alloc_bytes),
+                   unsigned(stats.gc_time_max_us),
+                   unsigned(stats.throttle_count));
+    }
+
+    bool header_printed = false;
+    for (const auto &entry : profile) {
+        if (entry.samples == 0) {
+            continue;
+        }
+        if (!header_printed) {
+            str.printf("\nProfile, sampled every %u VM steps\n%-16s %6s %8s\n", unsigned(SCRIPTING_PROFILE_SAMPLE_STEPS), "Source", "Line", "Samples");
+            header_printed = true;
+        }
+        str.printf("%-16.16s %6d %8u\n", entry.source, int(entry.line), unsigned(entry.samples));
+    }
+}
+
 #endif  // AP_SCRIPTING_ENABLED
@@ -29,12 +29,14 @@
 #include <AP_Common/MultiHeap.h>
 #include "lua_common_defs.h"
 
+class ExpandingString;
+
 #include "lua/src/lua.hpp"
 
 class lua_scripts
 {
 public:
-    lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_options, struct AP_Scripting::terminal_s &_terminal);
+    lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_options, const AP_Int16 &gc_budget_us, const AP_Int32 &alloc_max, struct AP_Scripting::terminal_s &_terminal);
 
     ~lua_scripts();
 
@@ -55,6 +57,7 @@ public:
         LOG_RUNTIME = 1U << 3,
         DISABLE_PRE_ARM = 1U << 4,
         SAVE_CHECKSUM = 1U << 5,
+        PROFILE = 1U << 6,
     };
 
 private:
@@ -68,15 +71,38 @@ private:
        uint32_t crc;         // crc32 checksum
        char *name;           // filename for the script // FIXME: This information should be available from Lua
        script_info *next;
+       struct {
+           uint32_t run_count;          // number of times the script has been run
+           uint32_t run_time_us;        // time taken by the last run
+           uint32_t run_time_max_us;    // longest run
+           uint64_t run_time_total_us;  // time taken by all runs
+           uint32_t vm_steps;           // VM instructions executed by the last run, to the previous hook call
+           uint32_t vm_steps_max;       // most VM instructions executed by a run
+           uint32_t alloc_bytes;        // bytes allocated by the last run
+           uint32_t gc_time_us;         // time taken by garbage collection after the last run
+           uint32_t gc_time_max_us;     // longest garbage collection
+           uint32_t throttle_count;     // runs delayed for allocating more than SCR_ALLOC_MAX
+       } stats;
+       uint32_t throttle_ms;    // extra delay added to the next run for allocating too much, 0 if not throttled
+       bool throttle_warned;    // user has been told the script is being throttled
+       script_info *stats_next; // list of all loaded scripts, protected by stats_sem
     } script_info;
 
-    script_info *load_script(lua_State *L, char *filename);
+    script_info *load_script(lua_State *L, char *filename, bool bytecode);
+
+#if AP_SCRIPTING_BYTECODE_ENABLED
+    // load a script precompiled by lua_precompile, returns a lua
+    // error code with the message on the stack as luaL_loadfile does
+    int load_bytecode(lua_State *L, const char *filename);
+#endif
 
     void reset_loop_overtime(lua_State *L);
 
-    void load_all_scripts_in_dir(lua_State *L, const char *dirname);
+    // load all scripts in a directory, bytecode is only loaded if allowed
+    void load_all_scripts_in_dir(lua_State *L, const char *dirname, bool allow_bytecode);
 
-    void run_next_script(lua_State *L);
+    // run the first scheduled script, returns the script if it is still loaded
+    script_info *run_next_script(lua_State *L);
 
     void remove_script(lua_State *L, script_info *script);
 
@@ -103,6 +129,21 @@ private:
     // it must be static to be passed to the C API
     static void hook(lua_State *L, lua_Debug *ar);
 
+    // VM instructions the current script may use, and has used at
+    // previous hook calls
+    static uint32_t hook_steps_max;
+    static uint32_t hook_steps;
+
+    // sampling profiler, records the function running at each hook call
+    struct profile_entry {
+        char source[16];    // file the function is in
+        int32_t line;       // line the function is defined on, 0 for the main chunk
+        uint32_t samples;   // number of times the function was running when sampled
+    };
+    static profile_entry profile[SCRIPTING_PROFILE_MAX_FUNCTIONS];
+    static bool profiling;
+    static void profile_sample(lua_State *L, lua_Debug *ar);
+
     // lua panic handler, will jump back to the start of run
     static int atpanic(lua_State *L);
     static jmp_buf panic_jmp;
@@ -111,6 +152,21 @@ private:
 
     const AP_Int32 & _vm_steps;
     const AP_Int8 & _debug_options;
+    const AP_Int16 & _gc_budget_us;
+    const AP_Int32 & _alloc_max;
+
+    // size of the heap, used to decide when a full garbage collection is needed
+    const uint32_t _heap_size;
+
+    // incrementally collect garbage for up to budget_us, returns true if a collection cycle completed
+    bool gc_step(lua_State *L, uint32_t budget_us);
+
+    // collect garbage after a script has run, mem is the memory in use
+    void gc_after_run(lua_State *L, int mem);
+
+    // alloc_bytes when the last garbage collection cycle completed, if
+    // nothing has been allocated since there is nothing to collect
+    uint32_t gc_cycle_alloc_bytes;
 
     static void *alloc(void *ud, void *ptr, size_t osize, size_t nsize);
 
@@ -119,6 +175,13 @@ private:
     // helper for print and log of runtime stats
     void update_stats(const char *name, uint32_t run_time, int total_mem, int run_mem);
 
+    // per-script stats, updated in the scripting thread and read for @SYS/scripts.txt
+    static script_info *stats_list;
+    static HAL_Semaphore stats_sem;
+    static uint32_t alloc_bytes;    // bytes allocated by all scripts since boot
+    uint32_t last_stats_log_ms;
+    void log_stats(void);
+
     // must be static for use in atpanic
     static void print_error(MAV_SEVERITY severity);
     static char *error_msg_buf;
@@ -146,6 +209,9 @@ public:
     static uint32_t get_loaded_checksum();
     static uint32_t get_running_checksum();
 
+    // fill in ExpandingString with per-script stats and the profiler's hot functions
+    static void script_info_string(ExpandingString &str);
+
 };
 
 #endif  // AP_SCRIPTING_ENABLED
@@ -32,6 +32,12 @@ function test_offset(ofs_e, ofs_n)
     gcs:send_text(0, string.format("Distance NED != NE %.1f, %.1f %.1f %.1f", from_origin_NED:x(), from_origin_NED:y(), from_origin_NE:x(), from_origin_NE:y()))
     return false
   end
+  local reused = Vector3f()
+  local result = Location():get_distance_NED(manipulated_pos, reused)
+  if (result ~= reused) or (not is_equal(reused:x(), from_origin_NED:x())) or (not is_equal(reused:y(), from_origin_NED:y())) then
+    gcs:send_text(0, string.format("Failed to reuse result %.1f, %.1f %.1f %.1f", reused:x(), reused:y(), from_origin_NED:x(), from_origin_NED:y()))
+    return false
+  end
   return true
 end
 
@@ -137,6 +137,10 @@
 #define AP_SERIALMANAGER_IMUOUT_BUFSIZE_RX     128
 #define AP_SERIALMANAGER_IMUOUT_BUFSIZE_TX     2048
 
+// IMU stream protocol
+#define AP_SERIALMANAGER_IMUSTREAM_BUFSIZE_RX  128
+#define AP_SERIALMANAGER_IMUSTREAM_BUFSIZE_TX  4096
+
 // PPP protocol
 #define AP_SERIALMANAGER_PPP_BAUD           921600
 #define AP_SERIALMANAGER_PPP_BUFSIZE_RX     4096
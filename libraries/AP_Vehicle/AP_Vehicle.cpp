@@ -780,6 +780,27 @@ void AP_Vehicle::update_dynamic_notch(AP_InertialSensor::HarmonicNotch &notch)
                     notch.set_inactive(true);
                 }
             }
+            // if the FFT is analysing all IMUs then let each IMU's notch track the noise on its own gyro,
+            // an IMU without a measurement keeps the primary gyro's frequencies set above
+            if (gyro_fft.analysing_all_imus() && !notch.is_inactive()) {
+                for (uint8_t i = 0; i < ins.get_gyro_count(); i++) {
+                    if (notch.params.hasOption(HarmonicNotchFilterParams::Options::DynamicHarmonic)) {
+                        float notches[INS_MAX_NOTCHES];
+                        const uint8_t peaks = gyro_fft.get_weighted_noise_center_frequencies_hz(i, notch.num_dynamic_notches, notches);
+                        for (uint8_t j = 0; j < peaks; j++) {
+                            notches[j] = MAX(ref_freq, notches[j]);
+                        }
+                        if (peaks > 0) {
+                            notch.update_frequencies_hz(i, peaks, notches);
+                        }
+                    } else {
+                        const float center_freq = gyro_fft.get_weighted_noise_center_freq_hz(i);
+                        if (!is_zero(center_freq)) {
+                            notch.update_freq_hz(i, MAX(ref_freq, center_freq));
+                        }
+                    }
+                }
+            }
             break;
 #endif
         case HarmonicNotchDynamicMode::Fixed: // static
@@ -13,3 +13,13 @@
 #ifndef AP_FILTER_ENABLED
 #define AP_FILTER_ENABLED AP_FILTER_NUM_FILTERS > 0
 #endif
+
+// process all three axes of a Vector3f biquad bank with SIMD
+// instructions, only available with NEON or SSE2
+#ifndef AP_FILTER_BIQUAD_SIMD_ENABLED
+#if defined(__ARM_NEON) || defined(__SSE2__)
+#define AP_FILTER_BIQUAD_SIMD_ENABLED 1
+#else
+#define AP_FILTER_BIQUAD_SIMD_ENABLED 0
+#endif
+#endif
@@ -0,0 +1,131 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HAL_DEBUG_BUILD
+#define AP_INLINE_VECTOR_OPS
+#pragma GCC optimize("O2")
+#endif
+
+#include "BiquadBank.h"
+
+template <class T>
+BiquadBank<T>::~BiquadBank()
+{
+    delete[] _coeffs;
+    delete[] _history;
+}
+
+/*
+  allocate storage for the stages. Existing stages and their history
+  are kept so the bank can be expanded while running
+ */
+template <class T>
+bool BiquadBank<T>::allocate(uint16_t num_stages)
+{
+    if (num_stages <= _max_stages) {
+        return true;
+    }
+    auto coeffs = new coefficients[num_stages];
+    auto hist = new history[num_stages+1];
+    if (coeffs == nullptr || hist == nullptr) {
+        delete[] coeffs;
+        delete[] hist;
+        return false;
+    }
+    if (_max_stages > 0) {
+        memcpy(coeffs, _coeffs, sizeof(coeffs[0])*_max_stages);
+        memcpy(hist, _history, sizeof(hist[0])*(_max_stages+1));
+    }
+    for (uint16_t i = _max_stages; i < num_stages; i++) {
+        coeffs[i] = coefficients{1, 0, 0, 0, 0};
+    }
+    auto old_coeffs = _coeffs;
+    auto old_history = _history;
+    _coeffs = coeffs;
+    _history = hist;
+    _max_stages = num_stages;
+    delete[] old_coeffs;
+    delete[] old_history;
+    return true;
+}
+
+template <class T>
+void BiquadBank<T>::set_stage(uint16_t stage, float b0, float b1, float b2, float a1, float a2)
+{
+    if (stage < _max_stages) {
+        _coeffs[stage] = coefficients{b0, b1, b2, a1, a2};
+    }
+}
+
+/*
+  a passthrough stage still updates its history, so it behaves like a
+  NotchFilter that has not been initialised
+ */
+template <class T>
+void BiquadBank<T>::set_stage_passthrough(uint16_t stage)
+{
+    set_stage(stage, 1, 0, 0, 0, 0);
+}
+
+template <class T>
+void BiquadBank<T>::set_num_stages(uint16_t num_stages)
+{
+    _num_stages = MIN(num_stages, _max_stages);
+}
+
+/*
+  apply a new input sample to each stage in turn, returning the output of the last stage
+ */
+template <class T>
+T BiquadBank<T>::apply(const T &sample)
+{
+    if (_num_stages == 0) {
+        return sample;
+    }
+
+    lanes_t x = BiquadLanes<T>::load(sample);
+
+    if (_need_reset) {
+        // the history of all stages is the sample, so the output of
+        // each stage is the sample
+        for (uint16_t i = 0; i <= _num_stages; i++) {
+            _history[i].z1 = x;
+            _history[i].z2 = x;
+        }
+        _need_reset = false;
+        return sample;
+    }
+
+    for (uint16_t i = 0; i < _num_stages; i++) {
+        const coefficients &c = _coeffs[i];
+        history &in = _history[i];
+        const history &out = _history[i+1];
+        const lanes_t y = x*c.b0 + in.z1*c.b1 + in.z2*c.b2 - out.z1*c.a1 - out.z2*c.a2;
+        in.z2 = in.z1;
+        in.z1 = x;
+        x = y;
+    }
+    history &out = _history[_num_stages];
+    out.z2 = out.z1;
+    out.z1 = x;
+
+    return BiquadLanes<T>::store(x);
+}
+
+/*
+   instantiate template classes
+ */
+template class BiquadBank<float>;
+template class BiquadBank<Vector3f>;
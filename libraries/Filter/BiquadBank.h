@@ -0,0 +1,96 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+/*
+  a cascade of direct form I biquad stages applied to a sample in a
+  single pass
+
+  Neighbouring stages share their history, as the output history of one
+  stage is the input history of the next. The x, y and z axes of a
+  Vector3f are held as the lanes of a single SIMD vector where the CPU
+  supports it, so every stage filters all three axes at once.
+
+  The coefficients use the same conventions as NotchFilter, with a0
+  normalised to 1:
+    y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2
+ */
+
+#include "AP_Filter_config.h"
+#include <AP_Math/AP_Math.h>
+
+/*
+  the type used to hold a sample while it is filtered
+ */
+template <class T>
+struct BiquadLanes {
+    typedef T type;
+    static type load(const T &v) { return v; }
+    static T store(const type &v) { return v; }
+};
+
+#if AP_FILTER_BIQUAD_SIMD_ENABLED
+template <>
+struct BiquadLanes<Vector3f> {
+    // four float lanes, the last one unused. Aligned to a float so it
+    // can be stored in memory from the heap
+    typedef float type __attribute__((vector_size(16), aligned(4)));
+    static type load(const Vector3f &v) { return type{v.x, v.y, v.z, 0}; }
+    static Vector3f store(const type &v) { return Vector3f{v[0], v[1], v[2]}; }
+};
+#endif
+
+template <class T>
+class BiquadBank {
+public:
+    typedef typename BiquadLanes<T>::type lanes_t;
+
+    ~BiquadBank();
+    // allocate storage for num_stages stages, keeping existing stages and history
+    bool allocate(uint16_t num_stages);
+    // number of allocated stages
+    uint16_t max_stages() const { return _max_stages; }
+    // set the coefficients of a stage
+    void set_stage(uint16_t stage, float b0, float b1, float b2, float a1, float a2);
+    // set a stage to pass its input through unchanged
+    void set_stage_passthrough(uint16_t stage);
+    // set the number of stages applied, starting from stage 0
+    void set_num_stages(uint16_t num_stages);
+    uint16_t num_stages() const { return _num_stages; }
+    // apply a sample to each stage in turn
+    T apply(const T &sample);
+    // reset the history of all stages to the next sample
+    void reset() { _need_reset = true; }
+    // true if a reset will be done by the next call to apply()
+    bool reset_pending() const { return _need_reset; }
+
+private:
+    struct coefficients {
+        float b0, b1, b2, a1, a2;
+    };
+    // last two values of a signal
+    struct history {
+        lanes_t z1, z2;
+    };
+
+    // coefficients for each stage
+    coefficients *_coeffs;
+    // _history[i] is the input history of stage i and the output history
+    // of stage i-1, sized one larger than the number of stages
+    history *_history;
+    uint16_t _max_stages;
+    uint16_t _num_stages;
+    bool _need_reset = true;
+};
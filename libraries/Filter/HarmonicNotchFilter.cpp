@@ -34,6 +34,22 @@
 #define NOTCH_DEBUG_LOGGING 0
 #endif
 
+/*
+  a change in the center frequency of a notch smaller than this ratio
+  does not recalculate its coefficients
+ */
+#ifndef HNF_FREQ_HYSTERESIS
+#define HNF_FREQ_HYSTERESIS 0.0002f
+#endif
+
+/*
+  the maximum number of center frequencies for which the harmonics are
+  calculated by rotation rather than with trig calls for every notch
+ */
+#ifndef HNF_MAX_ROTATION_CENTERS
+#define HNF_MAX_ROTATION_CENTERS 12
+#endif
+
 
 // table of user settable parameters
 const AP_Param::GroupInfo HarmonicNotchFilterParams::var_info[] = {
@@ -148,6 +164,7 @@ void HarmonicNotchFilter<T>::init(float sample_freq_hz, float center_freq_hz, fl
         return;
     }
 
+    const float last_sample_freq_hz = _sample_freq_hz;
     _sample_freq_hz = sample_freq_hz;
 
     const float nyquist_limit = sample_freq_hz * 0.48f;
@@ -159,7 +176,13 @@ void HarmonicNotchFilter<T>::init(float sample_freq_hz, float center_freq_hz, fl
 
     // position the individual notches so that the attenuation is no worse than a single notch
     // calculate attenuation and quality from the shaping constraints
-    NotchFilter<T>::calculate_A_and_Q(center_freq_hz, bandwidth_hz / _composite_notches, attenuation_dB, _A, _Q);
+    const float last_A = _A;
+    const float last_Q = _Q;
+    NotchFilter<float>::calculate_A_and_Q(center_freq_hz, bandwidth_hz / _composite_notches, attenuation_dB, _A, _Q);
+    // new filter shaping applies to every notch
+    if (!is_equal(last_A, _A) || !is_equal(last_Q, _Q) || !is_equal(sample_freq_hz, last_sample_freq_hz)) {
+        _force_update = true;
+    }
 
     _initialised = true;
     update(center_freq_hz);
@@ -177,9 +200,11 @@ void HarmonicNotchFilter<T>::allocate_filters(uint8_t num_notches, uint32_t harm
     _harmonics = harmonics;
 
     if (_num_filters > 0) {
-        _filters = new NotchFilter<T>[_num_filters];
-        if (_filters == nullptr) {
-            GCS_SEND_TEXT(MAV_SEVERITY_ERROR, "Failed to allocate %u bytes for notch filter", (unsigned int)(_num_filters * sizeof(NotchFilter<T>)));
+        _filters = new NotchFilter<float>[_num_filters];
+        if (_filters == nullptr || !_bank.allocate(_num_filters)) {
+            GCS_SEND_TEXT(MAV_SEVERITY_ERROR, "Failed to allocate %u bytes for notch filter", (unsigned int)(_num_filters * sizeof(NotchFilter<float>)));
+            delete[] _filters;
+            _filters = nullptr;
             _num_filters = 0;
         }
     }
@@ -199,7 +224,11 @@ void HarmonicNotchFilter<T>::expand_filter_count(uint16_t total_notches)
       note that we rely on the semaphore in
       AP_InertialSensor_Backend.cpp to make this thread safe
      */
-    auto filters = new NotchFilter<T>[total_notches];
+    if (!_bank.allocate(total_notches)) {
+        _alloc_has_failed = true;
+        return;
+    }
+    auto filters = new NotchFilter<float>[total_notches];
     if (filters == nullptr) {
         _alloc_has_failed = true;
         return;
@@ -226,32 +255,23 @@ void HarmonicNotchFilter<T>::update(float center_freq_hz)
     const float nyquist_limit = _sample_freq_hz * 0.48f;
     center_freq_hz = constrain_float(center_freq_hz, 0.0f, nyquist_limit);
 
+    // the sin and cos of each harmonic, and of its composite notch spread
+    const float omega = M_2PI * center_freq_hz / _sample_freq_hz;
+    AngleMultiple harmonic { omega };
+    AngleMultiple spread { omega * _notch_spread };
+
     _num_enabled_filters = 0;
     // update all of the filters using the new center frequency and existing A & Q
     for (uint8_t i = 0; i < HNF_MAX_HARMONICS && _num_enabled_filters < _num_filters; i++) {
+        harmonic.next();
+        spread.next();
         if ((1U<<i) & _harmonics) {
-            const float notch_center = center_freq_hz * (i+1);
-            if (_composite_notches != 2) {
-                // only enable the filter if its center frequency is below the nyquist frequency
-                if (notch_center < nyquist_limit) {
-                    _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center, _A, _Q);
-                }
-            }
-            if (_composite_notches > 1) {
-                float notch_center_double;
-                // only enable the filter if its center frequency is below the nyquist frequency
-                notch_center_double = notch_center * (1.0 - _notch_spread);
-                if (notch_center_double < nyquist_limit) {
-                    _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center_double, _A, _Q);
-                }
-                // only enable the filter if its center frequency is below the nyquist frequency
-                notch_center_double = notch_center * (1.0 + _notch_spread);
-                if (notch_center_double < nyquist_limit) {
-                    _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center_double, _A, _Q);
-                }
-            }
+            update_composite_notch(center_freq_hz * (i+1), nyquist_limit, &harmonic, &spread);
         }
     }
+
+    _bank.set_num_stages(_num_enabled_filters);
+    _force_update = false;
 }
 
 /*
@@ -274,43 +294,115 @@ void HarmonicNotchFilter<T>::update(uint8_t num_centers, const float center_freq
         expand_filter_count(total_notches);
     }
 
+    // the sin and cos of each harmonic of each center, and of its
+    // composite notch spread. With more centers they are calculated
+    // for each notch
+    AngleMultiple harmonics[HNF_MAX_ROTATION_CENTERS];
+    AngleMultiple spreads[HNF_MAX_ROTATION_CENTERS];
+    const bool rotate = num_centers <= HNF_MAX_ROTATION_CENTERS;
+    if (rotate) {
+        for (uint8_t i = 0; i < num_centers; i++) {
+            const float omega = M_2PI * center_freq_hz[i] / _sample_freq_hz;
+            harmonics[i] = AngleMultiple { omega };
+            spreads[i] = AngleMultiple { omega * _notch_spread };
+        }
+    }
+
     _num_enabled_filters = 0;
 
     // update all of the filters using the new center frequencies and existing A & Q
     for (uint16_t i = 0; i < num_centers * HNF_MAX_HARMONICS && _num_enabled_filters < _num_filters; i++) {
         const uint8_t harmonic_n = i / num_centers;
         const uint8_t center_n = i % num_centers;
+        if (rotate) {
+            harmonics[center_n].next();
+            spreads[center_n].next();
+        }
         // the filters are ordered by center and then harmonic so
         // f1h1, f2h1, f3h1, f4h1, f1h2, f2h2, etc
         if (!((1U<<harmonic_n) & _harmonics)) {
             continue;
         }
 
-        const float notch_center = constrain_float(center_freq_hz[center_n] * (harmonic_n+1), 0.0f, nyquist_limit);
-        if (_composite_notches != 2) {
-            // only enable the filter if its center frequency is below the nyquist frequency
-            if (notch_center < nyquist_limit) {
-                _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center, _A, _Q);
-            }
+        const float harmonic_center = center_freq_hz[center_n] * (harmonic_n+1);
+        const float notch_center = constrain_float(harmonic_center, 0.0f, nyquist_limit);
+        if (rotate && is_equal(notch_center, harmonic_center)) {
+            update_composite_notch(notch_center, nyquist_limit, &harmonics[center_n], &spreads[center_n]);
+        } else {
+            update_composite_notch(notch_center, nyquist_limit, nullptr, nullptr);
         }
-        if (_composite_notches > 1) {
-            float notch_center_double;
-            // only enable the filter if its center frequency is below the nyquist frequency
-            notch_center_double = notch_center * (1.0 - _notch_spread);
-            if (notch_center_double < nyquist_limit) {
-                _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center_double, _A, _Q);
-            }
-            // only enable the filter if its center frequency is below the nyquist frequency
-            notch_center_double = notch_center * (1.0 + _notch_spread);
-            if (notch_center_double < nyquist_limit) {
-                _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center_double, _A, _Q);
-            }
+    }
+
+    _bank.set_num_stages(_num_enabled_filters);
+    _force_update = false;
+}
+
+/*
+  update the filters that make up the composite notch at notch_center,
+  using the sin and cos of the harmonic and its spread if known
+ */
+template <class T>
+void HarmonicNotchFilter<T>::update_composite_notch(float notch_center, float nyquist_limit, const AngleMultiple *harmonic, const AngleMultiple *spread)
+{
+    const bool have_omega = harmonic != nullptr && spread != nullptr;
+    if (_composite_notches != 2) {
+        // only enable the filter if its center frequency is below the nyquist frequency
+        if (notch_center < nyquist_limit) {
+            update_notch(notch_center, have_omega, have_omega ? harmonic->sin_angle : 0, have_omega ? harmonic->cos_angle : 0);
+        }
+    }
+    if (_composite_notches > 1) {
+        float notch_center_double;
+        // only enable the filter if its center frequency is below the nyquist frequency
+        notch_center_double = notch_center * (1.0 - _notch_spread);
+        if (notch_center_double < nyquist_limit) {
+            // sin(a-b) and cos(a-b)
+            update_notch(notch_center_double, have_omega,
+                         have_omega ? harmonic->sin_angle * spread->cos_angle - harmonic->cos_angle * spread->sin_angle : 0,
+                         have_omega ? harmonic->cos_angle * spread->cos_angle + harmonic->sin_angle * spread->sin_angle : 0);
+        }
+        // only enable the filter if its center frequency is below the nyquist frequency
+        notch_center_double = notch_center * (1.0 + _notch_spread);
+        if (notch_center_double < nyquist_limit) {
+            // sin(a+b) and cos(a+b)
+            update_notch(notch_center_double, have_omega,
+                         have_omega ? harmonic->sin_angle * spread->cos_angle + harmonic->cos_angle * spread->sin_angle : 0,
+                         have_omega ? harmonic->cos_angle * spread->cos_angle - harmonic->sin_angle * spread->sin_angle : 0);
         }
     }
 }
 
 /*
-  apply a sample to each of the underlying filters in turn and return the output
+  update the next enabled filter and its stage in the biquad bank. Small
+  changes in frequency are ignored, saving the cost of new coefficients
+ */
+template <class T>
+void HarmonicNotchFilter<T>::update_notch(float notch_center, bool have_omega, float sin_omega, float cos_omega)
+{
+    const uint16_t i = _num_enabled_filters++;
+    NotchFilter<float> &filter = _filters[i];
+
+    if (!_force_update && filter.initialised && !filter.need_reset &&
+        fabsF(notch_center - filter._center_freq_hz) < filter._center_freq_hz * HNF_FREQ_HYSTERESIS) {
+        return;
+    }
+
+    if (have_omega) {
+        filter.init_with_A_and_Q(_sample_freq_hz, notch_center, _A, _Q, sin_omega, cos_omega);
+    } else {
+        filter.init_with_A_and_Q(_sample_freq_hz, notch_center, _A, _Q);
+    }
+
+    // a filter that could not be initialised passes its input through
+    if (filter.initialised) {
+        _bank.set_stage(i, filter.b0, filter.b1, filter.b2, filter.a1, filter.a2);
+    } else {
+        _bank.set_stage_passthrough(i);
+    }
+}
+
+/*
+  apply a sample to each of the enabled filters in turn and return the output
  */
 template <class T>
 T HarmonicNotchFilter<T>::apply(const T &sample)
@@ -326,23 +418,28 @@ T HarmonicNotchFilter<T>::apply(const T &sample)
     }
 #endif
 
-    T output = sample;
-    for (uint16_t i = 0; i < _num_enabled_filters; i++) {
 #if NOTCH_DEBUG_LOGGING
+    for (uint16_t i = 0; i < _num_enabled_filters; i++) {
         if (!_filters[i].initialised) {
             ::dprintf(dfd, "------- ");
         } else {
             ::dprintf(dfd, "%.4f ", _filters[i]._center_freq_hz);
         }
-#endif
-        output = _filters[i].apply(output);
     }
-#if NOTCH_DEBUG_LOGGING
     if (_num_enabled_filters > 0) {
         ::dprintf(dfd, "\n");
     }
 #endif
-    return output;
+
+    if (_bank.reset_pending()) {
+        // the bank resets the history, clear the reset of the filters
+        // as NotchFilter::apply() would so slew limiting resumes
+        for (uint16_t i = 0; i < _num_enabled_filters; i++) {
+            _filters[i].need_reset = false;
+        }
+    }
+
+    return _bank.apply(sample);
 }
 
 /*
@@ -358,6 +455,7 @@ void HarmonicNotchFilter<T>::reset()
     for (uint16_t i = 0; i < _num_filters; i++) {
         _filters[i].reset();
     }
+    _bank.reset();
 }
 
 /*
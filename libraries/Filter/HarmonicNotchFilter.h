@@ -18,6 +18,7 @@
 #include <cmath>
 #include <AP_Param/AP_Param.h>
 #include "NotchFilter.h"
+#include "BiquadBank.h"
 
 #define HNF_MAX_HARMONICS 16
 
@@ -45,8 +46,29 @@ public:
     void reset();
 
 private:
-    // underlying bank of notch filters
-    NotchFilter<T>*  _filters;
+    // sin and cos of successive multiples of an angle, calculated by rotation
+    struct AngleMultiple {
+        AngleMultiple() {}
+        AngleMultiple(float angle) : sin_step(sinf(angle)), cos_step(cosf(angle)) {}
+        // advance to the next multiple of the angle
+        void next() {
+            const float s = sin_angle * cos_step + cos_angle * sin_step;
+            cos_angle = cos_angle * cos_step - sin_angle * sin_step;
+            sin_angle = s;
+        }
+        float sin_step = 0, cos_step = 1;
+        float sin_angle = 0, cos_angle = 1;
+    };
+
+    // update the filters of a single or composite notch
+    void update_composite_notch(float notch_center, float nyquist_limit, const AngleMultiple *harmonic, const AngleMultiple *spread);
+    // update the next enabled filter
+    void update_notch(float notch_center, bool have_omega, float sin_omega, float cos_omega);
+
+    // center frequency and coefficients of each notch
+    NotchFilter<float>*  _filters;
+    // the enabled notches as a single cascade applied to the sample
+    BiquadBank<T> _bank;
     // sample frequency for each filter
     float _sample_freq_hz;
     // base double notch bandwidth for each filter
@@ -66,6 +88,8 @@ private:
     // number of enabled filters
     uint16_t _num_enabled_filters;
     bool _initialised;
+    // update all filters on the next update, ignoring the hysteresis
+    bool _force_update;
 
     // have we failed to expand filters?
     bool _alloc_has_failed;
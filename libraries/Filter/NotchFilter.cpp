@@ -57,6 +57,22 @@ void NotchFilter<T>::init(float sample_freq_hz, float center_freq_hz, float band
 
 template <class T>
 void NotchFilter<T>::init_with_A_and_Q(float sample_freq_hz, float center_freq_hz, float A, float Q)
+{
+    init_with_omega(sample_freq_hz, center_freq_hz, A, Q, false, 0, 0);
+}
+
+/*
+  initialise the filter using the sin and cos of the center frequency,
+  saving the trig calls when the caller can calculate them more cheaply
+ */
+template <class T>
+void NotchFilter<T>::init_with_A_and_Q(float sample_freq_hz, float center_freq_hz, float A, float Q, float sin_omega, float cos_omega)
+{
+    init_with_omega(sample_freq_hz, center_freq_hz, A, Q, true, sin_omega, cos_omega);
+}
+
+template <class T>
+void NotchFilter<T>::init_with_omega(float sample_freq_hz, float center_freq_hz, float A, float Q, bool have_omega, float sin_omega, float cos_omega)
 {
     // don't update if no updates required
     if (initialised && is_equal(center_freq_hz, _center_freq_hz) && is_equal(sample_freq_hz, _sample_freq_hz)) {
@@ -67,15 +83,24 @@ void NotchFilter<T>::init_with_A_and_Q(float sample_freq_hz, float center_freq_h
 
     // constrain the new center frequency by a percentage of the old frequency
     if (initialised && !need_reset && !is_zero(_center_freq_hz)) {
-        new_center_freq = constrain_float(new_center_freq, _center_freq_hz * NOTCH_MAX_SLEW_LOWER,
-                                          _center_freq_hz * NOTCH_MAX_SLEW_UPPER);
+        const float min_freq_hz = _center_freq_hz * NOTCH_MAX_SLEW_LOWER;
+        const float max_freq_hz = _center_freq_hz * NOTCH_MAX_SLEW_UPPER;
+        // the caller's sin and cos are of the requested frequency, not the slew limited one
+        if (center_freq_hz < min_freq_hz || center_freq_hz > max_freq_hz) {
+            have_omega = false;
+        }
+        new_center_freq = constrain_float(new_center_freq, min_freq_hz, max_freq_hz);
     }
 
     if (is_positive(new_center_freq) && (new_center_freq < 0.5 * sample_freq_hz) && (Q > 0.0)) {
-        float omega = 2.0 * M_PI * new_center_freq / sample_freq_hz;
-        float alpha = sinf(omega) / (2 * Q);
+        if (!have_omega) {
+            float omega = 2.0 * M_PI * new_center_freq / sample_freq_hz;
+            sin_omega = sinf(omega);
+            cos_omega = cosf(omega);
+        }
+        float alpha = sin_omega / (2 * Q);
         b0 =  1.0 + alpha*sq(A);
-        b1 = -2.0 * cosf(omega);
+        b1 = -2.0 * cos_omega;
         b2 =  1.0 - alpha*sq(A);
         a1 = b1;
         a2 =  1.0 - alpha;
@@ -32,10 +32,12 @@ class HarmonicNotchFilter;
 template <class T>
 class NotchFilter {
 public:
-    friend class HarmonicNotchFilter<T>;
+    template <class U> friend class HarmonicNotchFilter;
     // set parameters
     void init(float sample_freq_hz, float center_freq_hz, float bandwidth_hz, float attenuation_dB);
     void init_with_A_and_Q(float sample_freq_hz, float center_freq_hz, float A, float Q);
+    // as above, with the sin and cos of the center frequency in radians per sample provided by the caller
+    void init_with_A_and_Q(float sample_freq_hz, float center_freq_hz, float A, float Q, float sin_omega, float cos_omega);
     T apply(const T &sample);
     void reset();
     float center_freq_hz() const { return _center_freq_hz; }
@@ -45,6 +47,7 @@ public:
     static void calculate_A_and_Q(float center_freq_hz, float bandwidth_hz, float attenuation_dB, float& A, float& Q); 
 
 protected:
+    void init_with_omega(float sample_freq_hz, float center_freq_hz, float A, float Q, bool have_omega, float sin_omega, float cos_omega);
 
     bool initialised, need_reset;
     float b0, b1, b2, a1, a2;
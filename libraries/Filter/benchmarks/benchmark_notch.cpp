@@ -0,0 +1,100 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <Filter/NotchFilter.h>
+#include <Filter/HarmonicNotchFilter.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// a triple notch on the first state.range(0) harmonics of 80Hz at 8kHz,
+// as used for gyro filtering of large copters
+#define BENCHMARK_RATE_HZ           8000
+#define BENCHMARK_CENTER_HZ         80
+#define BENCHMARK_BANDWIDTH_HZ      40
+#define BENCHMARK_ATTENUATION_DB    40
+#define BENCHMARK_MAX_NOTCHES       48
+
+static Vector3f gyro_sample(uint32_t i)
+{
+    return Vector3f(sinf(i * 0.063f), cosf(i * 0.031f), sinf(i * 0.127f) * 0.5f);
+}
+
+// chain of notch filters, one object per notch
+static void BM_NotchFilterChain(benchmark::State& state)
+{
+    const uint16_t num_notches = state.range(0) * 3;
+    NotchFilter<Vector3f> filters[BENCHMARK_MAX_NOTCHES] {};
+    for (uint16_t i = 0; i < num_notches; i++) {
+        const float harmonic_hz = BENCHMARK_CENTER_HZ * (i/3 + 1);
+        filters[i].init(BENCHMARK_RATE_HZ, harmonic_hz * (1.0 + 0.01 * (i%3 - 1)), BENCHMARK_BANDWIDTH_HZ, BENCHMARK_ATTENUATION_DB);
+    }
+
+    uint32_t i = 0;
+    while (state.KeepRunning()) {
+        Vector3f v = gyro_sample(i++);
+        for (uint16_t n = 0; n < num_notches; n++) {
+            v = filters[n].apply(v);
+        }
+        gbenchmark_escape(&v);
+    }
+}
+
+// the same notches applied by a harmonic notch through its biquad bank
+static void BM_HarmonicNotch(benchmark::State& state)
+{
+    HarmonicNotchFilter<Vector3f> filter {};
+    filter.allocate_filters(1, (1U<<state.range(0))-1, 3);
+    filter.init(BENCHMARK_RATE_HZ, BENCHMARK_CENTER_HZ, BENCHMARK_BANDWIDTH_HZ, BENCHMARK_ATTENUATION_DB);
+
+    uint32_t i = 0;
+    while (state.KeepRunning()) {
+        Vector3f v = filter.apply(gyro_sample(i++));
+        gbenchmark_escape(&v);
+    }
+}
+
+// new center frequencies for four motors, moving by state.range(1) mHz
+// each update, with every notch recalculated
+static void BM_NotchFilterChainUpdate(benchmark::State& state)
+{
+    const uint8_t num_centers = 4;
+    NotchFilter<Vector3f> filters[num_centers][BENCHMARK_MAX_NOTCHES] {};
+    float A, Q;
+    NotchFilter<Vector3f>::calculate_A_and_Q(BENCHMARK_CENTER_HZ, BENCHMARK_BANDWIDTH_HZ / 3, BENCHMARK_ATTENUATION_DB, A, Q);
+
+    uint32_t i = 0;
+    while (state.KeepRunning()) {
+        const float center_hz = BENCHMARK_CENTER_HZ + (i++ % 64) * state.range(1) * 0.001;
+        for (uint8_t c = 0; c < num_centers; c++) {
+            for (uint16_t n = 0; n < state.range(0) * 3; n++) {
+                const float harmonic_hz = (center_hz + c) * (n/3 + 1);
+                filters[c][n].init_with_A_and_Q(BENCHMARK_RATE_HZ, harmonic_hz * (1.0 + 0.01 * (n%3 - 1)), A, Q);
+            }
+        }
+        gbenchmark_escape(filters);
+    }
+}
+
+// the same updates of a harmonic notch
+static void BM_HarmonicNotchUpdate(benchmark::State& state)
+{
+    const uint8_t num_centers = 4;
+    HarmonicNotchFilter<Vector3f> filter {};
+    filter.allocate_filters(num_centers, (1U<<state.range(0))-1, 3);
+    filter.init(BENCHMARK_RATE_HZ, BENCHMARK_CENTER_HZ, BENCHMARK_BANDWIDTH_HZ, BENCHMARK_ATTENUATION_DB);
+
+    uint32_t i = 0;
+    while (state.KeepRunning()) {
+        const float center_hz = BENCHMARK_CENTER_HZ + (i++ % 64) * state.range(1) * 0.001;
+        const float centers[num_centers] { center_hz, center_hz + 1, center_hz + 2, center_hz + 3 };
+        filter.update(num_centers, centers);
+        gbenchmark_escape(&filter);
+    }
+}
+
+BENCHMARK(BM_NotchFilterChain)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(BM_HarmonicNotch)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(BM_NotchFilterChainUpdate)->Args({1, 500})->Args({16, 500})->Args({16, 5});
+BENCHMARK(BM_HarmonicNotchUpdate)->Args({1, 500})->Args({16, 500})->Args({16, 5});
+
+BENCHMARK_MAIN();
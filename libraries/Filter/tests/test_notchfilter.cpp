@@ -156,4 +156,155 @@ TEST(NotchFilterTest, HarmonicNotchTest)
     EXPECT_NEAR(integrals[9].get_lag_degrees(10), 112.23, 0.5);
 }
 
+/*
+  test that a harmonic notch gives the same output as the equivalent
+  chain of notch filters, including across resets and frequency changes
+ */
+TEST(NotchFilterTest, HarmonicNotchMatchesChainTest)
+{
+    const uint32_t harmonics = 0x0F;
+    const uint8_t num_harmonics = __builtin_popcount(harmonics);
+    const uint8_t composite_notches = 3;
+    const uint16_t num_filters = num_harmonics * composite_notches;
+    const float rate_hz = 2000;
+    const float bandwidth = 40;
+    const float attenuation_dB = 40;
+    const float spread = bandwidth / (32 * 80);
+    float A, Q;
+    NotchFilter<float>::calculate_A_and_Q(80, bandwidth / composite_notches, attenuation_dB, A, Q);
+
+    HarmonicNotchFilter<Vector3f> harmonic_notch {};
+    harmonic_notch.allocate_filters(1, harmonics, composite_notches);
+    harmonic_notch.init(rate_hz, 80, bandwidth, attenuation_dB);
+
+    NotchFilter<Vector3f> chain[num_filters] {};
+
+    harmonic_notch.reset();
+    for (auto &f : chain) {
+        f.reset();
+    }
+
+    float center_freq = 80;
+    const double dt = 1.0 / rate_hz;
+    for (uint32_t s=0; s<20000; s++) {
+        if (s % 500 == 0) {
+            // move the notch around, with slew limiting of large changes
+            center_freq = 60 + (s % 7000) * 0.02;
+            harmonic_notch.update(center_freq);
+            for (uint8_t h=0; h<num_harmonics; h++) {
+                const float notch_center = center_freq * (h+1);
+                chain[h*3].init_with_A_and_Q(rate_hz, notch_center, A, Q);
+                chain[h*3+1].init_with_A_and_Q(rate_hz, notch_center * (1.0 - spread), A, Q);
+                chain[h*3+2].init_with_A_and_Q(rate_hz, notch_center * (1.0 + spread), A, Q);
+            }
+        }
+        if (s == 5000 || s == 12345) {
+            harmonic_notch.reset();
+            for (auto &f : chain) {
+                f.reset();
+            }
+        }
+        const double t = s * dt;
+        const Vector3f sample { float(sin(center_freq * t * 2 * M_PI) * 0.7),
+                                float(sin(center_freq * 2 * t * 2 * M_PI) * 0.3 + 0.1),
+                                float(cos(37 * t * 2 * M_PI) * 0.5 - 0.2) };
+        Vector3f expected = sample;
+        for (auto &f : chain) {
+            expected = f.apply(expected);
+        }
+        const Vector3f v = harmonic_notch.apply(sample);
+        EXPECT_NEAR(v.x, expected.x, 1.0e-4);
+        EXPECT_NEAR(v.y, expected.y, 1.0e-4);
+        EXPECT_NEAR(v.z, expected.z, 1.0e-4);
+    }
+}
+
+/*
+  test that the harmonics of multiple centers match the equivalent chain
+  of notch filters, whose coefficients are calculated directly
+ */
+TEST(NotchFilterTest, HarmonicNotchMultiCenterTest)
+{
+    const uint32_t harmonics = 0x15;
+    const uint8_t harmonic_n[] { 0, 2, 4 };
+    const uint8_t num_harmonics = ARRAY_SIZE(harmonic_n);
+    const uint8_t num_centers = 4;
+    const uint8_t composite_notches = 2;
+    const uint16_t num_filters = num_centers * num_harmonics * composite_notches;
+    const float rate_hz = 4000;
+    const float bandwidth = 30;
+    const float attenuation_dB = 30;
+    const float spread = bandwidth / (32 * 70);
+    float A, Q;
+    NotchFilter<float>::calculate_A_and_Q(70, bandwidth / composite_notches, attenuation_dB, A, Q);
+
+    HarmonicNotchFilter<float> harmonic_notch {};
+    harmonic_notch.allocate_filters(num_centers, harmonics, composite_notches);
+    harmonic_notch.init(rate_hz, 70, bandwidth, attenuation_dB);
+    NotchFilter<float> chain[num_filters] {};
+
+    harmonic_notch.reset();
+    for (auto &f : chain) {
+        f.reset();
+    }
+
+    const double dt = 1.0 / rate_hz;
+    for (uint32_t s=0; s<8000; s++) {
+        if (s % 400 == 0) {
+            // motors at different speeds
+            float centers[num_centers];
+            for (uint8_t c=0; c<num_centers; c++) {
+                centers[c] = 70 + c * 13.1 + (s % 2400) * 0.01;
+            }
+            harmonic_notch.update(num_centers, centers);
+            uint16_t n = 0;
+            for (uint8_t h : harmonic_n) {
+                for (uint8_t c=0; c<num_centers; c++) {
+                    const float notch_center = centers[c] * (h+1);
+                    chain[n++].init_with_A_and_Q(rate_hz, notch_center * (1.0 - spread), A, Q);
+                    chain[n++].init_with_A_and_Q(rate_hz, notch_center * (1.0 + spread), A, Q);
+                }
+            }
+        }
+        const double t = s * dt;
+        const float sample = sin(83 * t * 2 * M_PI) * 0.7 + sin(437 * t * 2 * M_PI) * 0.2;
+        float expected = sample;
+        for (auto &f : chain) {
+            expected = f.apply(expected);
+        }
+        EXPECT_NEAR(harmonic_notch.apply(sample), expected, 1.0e-4);
+    }
+}
+
+/*
+  test that small changes in frequency are ignored by a harmonic notch
+ */
+TEST(NotchFilterTest, HarmonicNotchHysteresisTest)
+{
+    HarmonicNotchFilter<float> filter1 {};
+    HarmonicNotchFilter<float> filter2 {};
+    for (auto *f : { &filter1, &filter2 }) {
+        f->allocate_filters(1, 0x03, 3);
+        f->init(1000, 80, 40, 40);
+    }
+
+    for (uint32_t s=0; s<2000; s++) {
+        if (s == 500) {
+            // a change too small to update the notches
+            filter2.update(80.01);
+        }
+        if (s == 1000) {
+            filter2.update(81);
+        }
+        const float sample = sin(s * 0.37) + cos(s * 0.11);
+        const float v1 = filter1.apply(sample);
+        const float v2 = filter2.apply(sample);
+        if (s < 1000) {
+            EXPECT_FLOAT_EQ(v1, v2);
+        } else if (s == 1000) {
+            EXPECT_GT(fabsF(v1 - v2), 1.0e-6);
+        }
+    }
+}
+
 AP_GTEST_MAIN()
@@ -844,6 +844,40 @@ private:
     void find_next_bucket_to_send(uint16_t now16_ms);
     void remove_message_from_bucket(int8_t bucket, ap_message id);
 
+    // token-bucket model of the bandwidth available on this link.
+    // Stream (bucket) messages are only sent while there are tokens
+    // available, leaving space for the "special" messages above.
+    // The fill rate is measured from how quickly the port's transmit
+    // buffer drains while the link is saturated, scaled by how full
+    // the radio says its own buffer is (RADIO_STATUS.txbuf).
+    struct {
+        float bytes_per_sec;        // estimated rate the link drains at
+        float radio_scale = 1.0f;   // 0..1, from RADIO_STATUS txbuf
+        float tokens;               // bytes stream messages may use
+        uint32_t last_update_us;
+        uint32_t last_limited_ms;   // last time the link pushed back on us
+        uint16_t txspace_at_end;    // txspace at end of last update_send
+        bool saturated;             // last update_send ran out of space
+    } link_bw;
+    void update_link_bandwidth();
+    bool link_bandwidth_limited() const;
+    void consume_link_bandwidth(uint16_t nbytes);
+    float link_bandwidth_rate() const {
+        return link_bw.bytes_per_sec * link_bw.radio_scale;
+    }
+
+#if AP_MAVLINK_SEND_LATENCY_STATS_ENABLED
+    // time between an ap_message becoming due and it being sent:
+    struct send_latency_stats_t {
+        uint32_t total_ms;
+        uint16_t max_ms;
+        uint16_t count;
+    } send_latency_stats[MSG_LAST];
+    uint32_t last_send_latency_log_ms;
+    void record_send_latency(ap_message id, uint16_t now16_ms, uint16_t due16_ms);
+    void log_send_latency_stats();
+#endif
+
     // bitmask of IDs the code has spontaneously decided it wants to
     // send out.  Examples include HEARTBEAT (gcs_send_heartbeat)
     Bitmask<MSG_LAST> pushed_ap_message_ids;
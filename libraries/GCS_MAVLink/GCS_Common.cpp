@@ -845,6 +845,15 @@ void GCS_MAVLINK::handle_radio_status(const mavlink_message_t &msg, bool log_rad
 
     last_txbuf = packet.txbuf;
 
+    // multiplicative-decrease, additive-increase of the share of the
+    // link's bandwidth we allow stream messages to use:
+    if (packet.txbuf < 50) {
+        link_bw.radio_scale = MAX(link_bw.radio_scale * (packet.txbuf < 20 ? 0.5f : 0.8f), 0.05f);
+        link_bw.last_limited_ms = now;
+    } else if (packet.txbuf > 90) {
+        link_bw.radio_scale = MIN(link_bw.radio_scale + 0.05f, 1.0f);
+    }
+
     // use the state of the transmit buffer in the radio to
     // control the stream rate, giving us adaptive software
     // flow control
@@ -1165,6 +1174,9 @@ void GCS_MAVLINK::find_next_bucket_to_send(uint16_t now16_ms)
     // all done sending this bucket... find another bucket...
     sending_bucket_id = no_bucket_to_send;
     uint16_t ms_before_send_next_bucket_to_send = UINT16_MAX;
+    // lateness of the most-overdue bucket, scaled by its interval
+    // (in 1/256ths of an interval):
+    uint32_t most_overdue = 0;
     for (uint8_t i=0; i<ARRAY_SIZE(deferred_message_bucket); i++) {
         if (deferred_message_bucket[i].ap_message_ids.count() == 0) {
             // no entries
@@ -1172,13 +1184,21 @@ void GCS_MAVLINK::find_next_bucket_to_send(uint16_t now16_ms)
         }
         const uint16_t interval = get_reschedule_interval_ms(deferred_message_bucket[i]);
         const uint16_t ms_since_last_sent = now16_ms - deferred_message_bucket[i].last_sent_ms;
-        uint16_t ms_before_send_this_bucket;
         if (ms_since_last_sent > interval) {
-            // should already have sent this bucket!
-            ms_before_send_this_bucket = 0;
-        } else {
-            ms_before_send_this_bucket = interval - ms_since_last_sent;
+            // should already have sent this bucket!  If several
+            // buckets are overdue (saturated link) send the one
+            // furthest behind relative to its own interval first, so
+            // a fast stream in a low-numbered bucket can't starve
+            // the slower streams:
+            const uint32_t overdue = (uint32_t(ms_since_last_sent - interval) << 8) / MAX(interval, 1U);
+            if (ms_before_send_next_bucket_to_send != 0 || overdue > most_overdue) {
+                sending_bucket_id = i;
+                ms_before_send_next_bucket_to_send = 0;
+                most_overdue = overdue;
+            }
+            continue;
         }
+        const uint16_t ms_before_send_this_bucket = interval - ms_since_last_sent;
         if (ms_before_send_this_bucket < ms_before_send_next_bucket_to_send) {
             sending_bucket_id = i;
             ms_before_send_next_bucket_to_send = ms_before_send_this_bucket;
@@ -1237,6 +1257,7 @@ bool GCS_MAVLINK::do_try_send_message(const ap_message id)
         return false;
     }
     WITH_SEMAPHORE(comm_chan_lock(chan));
+    const uint16_t txspace_before = txspace();
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
     void *data = hal.scheduler->disable_interrupts_save();
     uint32_t start_send_message_us = AP_HAL::micros();
@@ -1257,9 +1278,108 @@ bool GCS_MAVLINK::do_try_send_message(const ap_message id)
         try_send_message_stats.longest_id = id;
     }
 #endif
+    // the port may have drained while we were sending; that's only
+    // ever an under-estimate of what we used:
+    const uint16_t txspace_after = txspace();
+    if (txspace_before > txspace_after) {
+        consume_link_bandwidth(txspace_before - txspace_after);
+    }
     return true;
 }
 
+/*
+  update the token-bucket model of this link's bandwidth.  Called at
+  the start of each update_send.
+ */
+void GCS_MAVLINK::update_link_bandwidth()
+{
+    const uint32_t now_us = AP_HAL::micros();
+    const uint32_t port_bw = _port->bw_in_bytes_per_second();
+    const uint16_t space = txspace();
+
+    if (link_bw.last_update_us == 0) {
+        link_bw.bytes_per_sec = port_bw;
+        link_bw.last_update_us = now_us;
+        return;
+    }
+
+    const float dt = (now_us - link_bw.last_update_us) * 1.0e-6f;
+    link_bw.last_update_us = now_us;
+
+    if (link_bw.saturated && dt < 0.5f && space >= link_bw.txspace_at_end) {
+        // the port was full when we last looked, so whatever space
+        // has been freed since is what the link managed to drain:
+        const float measured_bw = (space - link_bw.txspace_at_end) / MAX(dt, 0.001f);
+        link_bw.bytes_per_sec += 0.1f * (measured_bw - link_bw.bytes_per_sec);
+        link_bw.bytes_per_sec = MAX(link_bw.bytes_per_sec, 100.0f);
+        link_bw.last_limited_ms = AP_HAL::millis();
+    } else if (!link_bandwidth_limited()) {
+        // nothing has pushed back on us recently; assume the port's
+        // nominal rate is available again
+        link_bw.bytes_per_sec = port_bw;
+    }
+
+    // allow bursts of up to 100ms of data:
+    const float rate = link_bandwidth_rate();
+    const float burst = MAX(rate * 0.1f, float(MAVLINK_MAX_PACKET_LEN));
+    link_bw.tokens = MIN(link_bw.tokens + rate * dt, burst);
+}
+
+// true if we have recently seen evidence that this link can't keep
+// up with what we are trying to send
+bool GCS_MAVLINK::link_bandwidth_limited() const
+{
+    return link_bw.last_limited_ms != 0 &&
+        AP_HAL::millis() - link_bw.last_limited_ms < 2000;
+}
+
+void GCS_MAVLINK::consume_link_bandwidth(uint16_t nbytes)
+{
+    // high-priority messages may take us into debt, but not so far
+    // that streams are locked out for more than half a second:
+    link_bw.tokens = MAX(link_bw.tokens - nbytes, -0.5f * link_bandwidth_rate());
+}
+
+#if AP_MAVLINK_SEND_LATENCY_STATS_ENABLED
+void GCS_MAVLINK::record_send_latency(ap_message id, uint16_t now16_ms, uint16_t due16_ms)
+{
+    uint16_t latency_ms = now16_ms - due16_ms;
+    if (latency_ms > 0x8000) {
+        // sent before it was due (e.g. rescheduled with a shorter interval)
+        latency_ms = 0;
+    }
+    send_latency_stats_t &stats = send_latency_stats[id];
+    if (stats.count == UINT16_MAX) {
+        return;
+    }
+    stats.count++;
+    stats.total_ms += latency_ms;
+    stats.max_ms = MAX(stats.max_ms, latency_ms);
+}
+
+void GCS_MAVLINK::log_send_latency_stats()
+{
+    const uint64_t now_us = AP_HAL::micros64();
+    for (uint8_t i=0; i<ARRAY_SIZE(send_latency_stats); i++) {
+        send_latency_stats_t &stats = send_latency_stats[i];
+        if (stats.count == 0) {
+            continue;
+        }
+        const struct log_MAV_Latency pkt{
+            LOG_PACKET_HEADER_INIT(LOG_MAV_LATENCY_MSG),
+            time_us : now_us,
+            chan    : (uint8_t)chan,
+            id      : i,
+            count   : stats.count,
+            mean_ms : uint16_t(stats.total_ms / stats.count),
+            max_ms  : stats.max_ms,
+        };
+        AP::logger().WriteBlock(&pkt, sizeof(pkt));
+        stats = {};
+    }
+}
+#endif  // AP_MAVLINK_SEND_LATENCY_STATS_ENABLED
+
 int8_t GCS_MAVLINK::get_deferred_message_index(const ap_message id) const
 {
     for (uint8_t i=0; i<ARRAY_SIZE(deferred_message); i++) {
@@ -1457,6 +1577,9 @@ void GCS_MAVLINK::update_send()
     // check for any in-progress tasks; check_tasks does its own rate-limiting
     GCS_MAVLINK_InProgress::check_tasks();
 
+    update_link_bandwidth();
+    bool out_of_space = false;
+
     const uint32_t start = AP_HAL::millis();
     const uint16_t start16 = start & 0xFFFF;
     while (AP_HAL::millis() - start < 5) { // spend a max of 5ms sending messages.  This should never trigger - out_of_time() should become true
@@ -1476,11 +1599,17 @@ void GCS_MAVLINK::update_send()
             const int8_t next = deferred_message_to_send_index(start16);
             if (next != -1) {
                 if (!do_try_send_message(deferred_message[next].id)) {
+                    out_of_space = true;
                     break;
                 }
                 // we try to keep output on a regular clock to avoid
                 // user support questions:
                 const uint16_t interval_ms = deferred_message[next].interval_ms;
+#if AP_MAVLINK_SEND_LATENCY_STATS_ENABLED
+                record_send_latency(deferred_message[next].id,
+                                    AP_HAL::millis16(),
+                                    deferred_message[next].last_sent_ms + interval_ms);
+#endif
                 deferred_message[next].last_sent_ms += interval_ms;
                 // but we do not want to try to catch up too much:
                 if (uint16_t(start16 - deferred_message[next].last_sent_ms) > interval_ms) {
@@ -1505,6 +1634,7 @@ void GCS_MAVLINK::update_send()
         if (fs != -1) {
             ap_message next = (ap_message)fs;
             if (!do_try_send_message(next)) {
+                out_of_space = true;
                 break;
             }
             pushed_ap_message_ids.clear(next);
@@ -1519,11 +1649,23 @@ void GCS_MAVLINK::update_send()
             continue;
         }
 
+        if (link_bw.tokens <= 0 && link_bandwidth_limited()) {
+            // stream messages have used their share of the link;
+            // leave what space there is for the messages above
+            break;
+        }
+
         ap_message next = next_deferred_bucket_message_to_send(start16);
         if (next != no_message_to_send) {
             if (!do_try_send_message(next)) {
+                out_of_space = true;
                 break;
             }
+#if AP_MAVLINK_SEND_LATENCY_STATS_ENABLED
+            record_send_latency(next,
+                                AP_HAL::millis16(),
+                                deferred_message_bucket[sending_bucket_id].last_sent_ms + get_reschedule_interval_ms(deferred_message_bucket[sending_bucket_id]));
+#endif
             bucket_message_ids_to_send.clear(next);
             if (bucket_message_ids_to_send.count() == 0) {
                 // we sent everything in the bucket.  Reschedule it.
@@ -1558,6 +1700,9 @@ void GCS_MAVLINK::update_send()
     }
 #endif
 
+    link_bw.saturated = out_of_space && !telemetry_delayed();
+    link_bw.txspace_at_end = txspace();
+
     // update the number of packets transmitted base on seqno, making
     // the assumption that we don't send more than 256 messages
     // between the last pass through here
@@ -1958,9 +2103,18 @@ void GCS_MAVLINK::log_mavlink_stats()
     flags                  : flags,
     stream_slowdown_ms     : stream_slowdown_ms,
     times_full             : out_of_space_to_send_count,
+    bandwidth              : uint32_t(link_bandwidth_rate()),
     };
 
     AP::logger().WriteBlock(&pkt, sizeof(pkt));
+
+#if AP_MAVLINK_SEND_LATENCY_STATS_ENABLED
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - last_send_latency_log_ms > 5000) {
+        last_send_latency_log_ms = now_ms;
+        log_send_latency_stats();
+    }
+#endif
 }
 #endif
 
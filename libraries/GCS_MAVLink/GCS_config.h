@@ -3,6 +3,7 @@
 #include <AP_HAL/AP_HAL_Boards.h>
 #include <AP_Relay/AP_Relay_config.h>
 #include <AP_Mission/AP_Mission_config.h>
+#include <AP_Logger/AP_Logger_config.h>
 
 #ifndef HAL_GCS_ENABLED
 #define HAL_GCS_ENABLED 1
@@ -50,6 +51,11 @@
 #define AP_MAVLINK_MSG_RELAY_STATUS_ENABLED HAL_GCS_ENABLED && AP_RELAY_ENABLED
 #endif
 
+// per-ap_message statistics on how late messages go out, logged as MAVL:
+#ifndef AP_MAVLINK_SEND_LATENCY_STATS_ENABLED
+#define AP_MAVLINK_SEND_LATENCY_STATS_ENABLED HAL_LOGGING_ENABLED && (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
 // allow removal of developer-centric mavlink commands
 #ifndef AP_MAVLINK_FAILURE_CREATION_ENABLED
 #define AP_MAVLINK_FAILURE_CREATION_ENABLED 1
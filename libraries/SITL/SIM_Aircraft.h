@@ -36,6 +36,7 @@
 #include "SIM_Buzzer.h"
 #include "SIM_Battery.h"
 #include <Filter/Filter.h>
+#include <AP_Declination/AP_Declination.h>
 #include "SIM_JSON_Master.h"
 
 #ifndef USE_PICOJSON
@@ -339,6 +340,9 @@ private:
 
     LowPassFilterFloat servo_filter[5];
 
+    // earth field table lookup, cached for the current cell
+    AP_Declination::Interpolator mag_field_table;
+
     Buzzer *buzzer;
     Sprayer *sprayer;
     Gripper_Servo *gripper;
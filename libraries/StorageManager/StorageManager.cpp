@@ -136,18 +136,32 @@ StorageAccess::StorageAccess(StorageManager::StorageType _type) :
   base read function. The src offset is within the bytes allocated
   for the storage type of this StorageAccess object
 */
-bool StorageAccess::read_block(void *data, uint16_t addr, size_t n) const
+bool StorageAccess::read_block(void *data, uint32_t addr, size_t n) const
 {
     uint8_t *b = (uint8_t *)data;
 
 #if AP_SDCARD_STORAGE_ENABLED
     if (file != nullptr) {
         // using microSD data
+        WITH_SEMAPHORE(file->sem);
+        file->pending = false;
         if (addr > file->bufsize) {
             return false;
         }
         const size_t n2 = MIN(n, file->bufsize - addr);
-        memcpy(b, &file->buffer[addr], n2);
+        if (!file_pages_cached(addr, n2)) {
+            return false;
+        }
+        uint32_t ofs = addr;
+        const uint32_t end = addr + n2;
+        while (ofs < end) {
+            const FilePage *p = find_file_page(ofs / FILE_PAGE_SIZE);
+            const uint16_t page_ofs = ofs % FILE_PAGE_SIZE;
+            const uint16_t count = MIN(end - ofs, uint32_t(FILE_PAGE_SIZE - page_ofs));
+            memcpy(b, &p->data[page_ofs], count);
+            b += count;
+            ofs += count;
+        }
         return n == n2;
     }
 #endif
@@ -190,21 +204,33 @@ bool StorageAccess::read_block(void *data, uint16_t addr, size_t n) const
   base write function. The addr offset is within the bytes allocated
   for the storage type of this StorageAccess object
 */
-bool StorageAccess::write_block(uint16_t addr, const void *data, size_t n) const
+bool StorageAccess::write_block(uint32_t addr, const void *data, size_t n) const
 {
     const uint8_t *b = (const uint8_t *)data;
 
 #if AP_SDCARD_STORAGE_ENABLED
     if (file != nullptr) {
+        // using microSD data
+        WITH_SEMAPHORE(file->sem);
+        file->pending = false;
         if (addr > file->bufsize) {
             return false;
         }
-        // using microSD data
-        WITH_SEMAPHORE(file->sem);
         const size_t n2 = MIN(n, file->bufsize - addr);
-        memcpy(&file->buffer[addr], b, n2);
-        for (uint8_t i=addr/1024U; i<(addr+n2+1023U)/1024U; i++) {
-            file->dirty_mask |= (1ULL<<i);
+        // all pages must be cached so a write is never partly done
+        if (!file_pages_cached(addr, n2)) {
+            return false;
+        }
+        uint32_t ofs = addr;
+        const uint32_t end = addr + n2;
+        while (ofs < end) {
+            FilePage *p = find_file_page(ofs / FILE_PAGE_SIZE);
+            const uint16_t page_ofs = ofs % FILE_PAGE_SIZE;
+            const uint16_t count = MIN(end - ofs, uint32_t(FILE_PAGE_SIZE - page_ofs));
+            memcpy(&p->data[page_ofs], b, count);
+            p->dirty = true;
+            b += count;
+            ofs += count;
         }
         return n == n2;
     }
@@ -246,7 +272,7 @@ bool StorageAccess::write_block(uint16_t addr, const void *data, size_t n) const
 /*
   read a byte
  */
-uint8_t StorageAccess::read_byte(uint16_t loc) const
+uint8_t StorageAccess::read_byte(uint32_t loc) const
 {
     uint8_t v;
     read_block(&v, loc, sizeof(v));
@@ -256,7 +282,7 @@ uint8_t StorageAccess::read_byte(uint16_t loc) const
 /*
   read 16 bit value
  */
-uint16_t StorageAccess::read_uint16(uint16_t loc) const
+uint16_t StorageAccess::read_uint16(uint32_t loc) const
 {
     uint16_t v;
     read_block(&v, loc, sizeof(v));
@@ -266,7 +292,7 @@ uint16_t StorageAccess::read_uint16(uint16_t loc) const
 /*
   read 32 bit value
  */
-uint32_t StorageAccess::read_uint32(uint16_t loc) const
+uint32_t StorageAccess::read_uint32(uint32_t loc) const
 {
     uint32_t v;
     read_block(&v, loc, sizeof(v));
@@ -276,7 +302,7 @@ uint32_t StorageAccess::read_uint32(uint16_t loc) const
 /*
   read a float
  */
-float StorageAccess::read_float(uint16_t loc) const
+float StorageAccess::read_float(uint32_t loc) const
 {
     float v;
     read_block(&v, loc, sizeof(v));
@@ -286,7 +312,7 @@ float StorageAccess::read_float(uint16_t loc) const
 /*
   write a byte
  */
-void StorageAccess::write_byte(uint16_t loc, uint8_t value) const
+void StorageAccess::write_byte(uint32_t loc, uint8_t value) const
 {
     write_block(loc, &value, sizeof(value));
 }
@@ -294,7 +320,7 @@ void StorageAccess::write_byte(uint16_t loc, uint8_t value) const
 /*
   write a uint16
  */
-void StorageAccess::write_uint16(uint16_t loc, uint16_t value) const
+void StorageAccess::write_uint16(uint32_t loc, uint16_t value) const
 {
     write_block(loc, &value, sizeof(value));
 }
@@ -302,7 +328,7 @@ void StorageAccess::write_uint16(uint16_t loc, uint16_t value) const
 /*
   write a uint32
  */
-void StorageAccess::write_uint32(uint16_t loc, uint32_t value) const
+void StorageAccess::write_uint32(uint32_t loc, uint32_t value) const
 {
     write_block(loc, &value, sizeof(value));
 }
@@ -310,7 +336,7 @@ void StorageAccess::write_uint32(uint16_t loc, uint32_t value) const
 /*
   write a float
  */
-void StorageAccess::write_float(uint16_t loc, float value) const
+void StorageAccess::write_float(uint32_t loc, float value) const
 {
     write_block(loc, &value, sizeof(value));
 }
@@ -322,11 +348,11 @@ bool StorageAccess::copy_area(const StorageAccess &source) const
 {
     // we deliberately allow for copies from smaller areas. This
     // allows for a partial backup region for parameters
-    uint16_t total = MIN(source.size(), size());
-    uint16_t ofs = 0;
+    uint32_t total = MIN(source.size(), size());
+    uint32_t ofs = 0;
     while (total > 0) {
         uint8_t block[32];
-        uint16_t n = MIN(sizeof(block), total);
+        uint16_t n = MIN(uint32_t(sizeof(block)), total);
         if (!source.read_block(block, ofs, n) ||
             !write_block(ofs, block, n)) {
             return false;
@@ -337,6 +363,35 @@ bool StorageAccess::copy_area(const StorageAccess &source) const
     return true;
 }
 
+/*
+  return true if the region is larger than its cache
+ */
+bool StorageAccess::paged(void) const
+{
+#if AP_SDCARD_STORAGE_ENABLED
+    return file != nullptr && file->num_pages < file->file_pages;
+#else
+    return false;
+#endif
+}
+
+/*
+  return true if the last access failed on a page the IO thread has
+  not loaded yet
+ */
+bool StorageAccess::io_pending(void) const
+{
+#if AP_SDCARD_STORAGE_ENABLED
+    if (file == nullptr) {
+        return false;
+    }
+    WITH_SEMAPHORE(file->sem);
+    return file->pending && !StorageManager::last_io_failed;
+#else
+    return false;
+#endif
+}
+
 #if AP_SDCARD_STORAGE_ENABLED
 /*
   attach a file to a storage region
@@ -347,95 +402,248 @@ bool StorageAccess::attach_file(const char *filename, uint16_t size_kbyte)
         // only one attach per boot
         return false;
     }
-    const uint32_t size = MIN(0xFFFFU, size_kbyte * 1024U);
+    // other regions are addressed with 16 bit offsets, only the
+    // mission may be larger than 64k
+    const uint32_t max_size = type == StorageManager::StorageMission ?
+        uint32_t(FILE_PAGE_NONE - 1) * FILE_PAGE_SIZE : 0xFFFFU;
+    const uint32_t size = MIN(max_size, size_kbyte * 1024U);
+    const uint16_t file_pages = (size + FILE_PAGE_SIZE - 1) / FILE_PAGE_SIZE;
+    const uint32_t old_total_size = total_size;
     auto *newfile = new FileStorage;
     if (newfile == nullptr) {
         AP_BoardConfig::allocation_error("StorageFile");
     }
-    ssize_t nread;
+    int32_t file_size;
+    uint8_t block[64];
 
     newfile->fd = AP::FS().open(filename, O_RDWR | O_CREAT);
     if (newfile->fd == -1) {
         goto fail;
     }
-    newfile->buffer = new uint8_t[size];
-    if (newfile->buffer == nullptr) {
+    // the mission is cached a page at a time if it is larger than the
+    // cache, other regions are held completely in RAM
+    newfile->num_pages = file_pages;
+    if (type == StorageManager::StorageMission) {
+        newfile->num_pages = MIN(file_pages, uint16_t(AP_SDCARD_STORAGE_CACHE_KB * 1024UL / FILE_PAGE_SIZE));
+    }
+    newfile->pages = new FilePage[newfile->num_pages];
+    if (newfile->pages == nullptr) {
         AP_BoardConfig::allocation_error("StorageFile");
     }
+    for (uint16_t i=0; i<newfile->num_pages; i++) {
+        newfile->pages[i].page = FILE_PAGE_NONE;
+        newfile->pages[i].dirty = false;
+        newfile->pages[i].last_use = 0;
+    }
+    newfile->file_pages = file_pages;
     newfile->bufsize = size;
-    nread = AP::FS().read(newfile->fd, newfile->buffer, size);
-    if (nread == -1) {
+    newfile->use_count = 0;
+    newfile->wanted_page = FILE_PAGE_NONE;
+    newfile->readahead_page = FILE_PAGE_NONE;
+    newfile->pending = false;
+
+    file_size = AP::FS().lseek(newfile->fd, 0, SEEK_END);
+    if (file_size == -1) {
         goto fail;
     }
-    if (nread == 0) {
-        // new file, copy storage from existing to allow users to
-        // start with existing mission
-        read_block(newfile->buffer, 0, total_size);
-    }
-    if (nread < int32_t(size)) {
-        if (AP::FS().write(newfile->fd, &newfile->buffer[nread], size-nread) != int32_t(size-nread)) {
+    if (file_size < int32_t(size)) {
+        // extend the file to full size. A new file starts with a copy
+        // of the existing storage to allow users to start with
+        // existing mission
+        if (AP::FS().lseek(newfile->fd, file_size, SEEK_SET) != file_size) {
             goto fail;
         }
+        for (uint32_t ofs=file_size; ofs<size; ofs+=sizeof(block)) {
+            const uint16_t count = MIN(uint32_t(sizeof(block)), size - ofs);
+            memset(block, 0, sizeof(block));
+            if (file_size == 0 && ofs < total_size) {
+                read_block(block, ofs, MIN(uint32_t(count), total_size - ofs));
+            }
+            if (AP::FS().write(newfile->fd, block, count) != count) {
+                goto fail;
+            }
+        }
         if (AP::FS().fsync(newfile->fd) != 0) {
             goto fail;
         }
     }
 
-    hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&StorageAccess::flush_file, void));
-
     file = newfile;
     total_size = newfile->bufsize;
 
+    // fill the cache from the start of the file now, so a file that
+    // fits in the cache is never read after boot
+    for (uint16_t i=0; i<newfile->num_pages; i++) {
+        if (!load_file_page(i)) {
+            file = nullptr;
+            total_size = old_total_size;
+            goto fail;
+        }
+    }
+
+    hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&StorageAccess::flush_file, void));
+
     return true;
 
 fail:
     if (newfile->fd != -1) {
         AP::FS().close(newfile->fd);
     }
-    if (newfile->buffer != nullptr) {
-        delete[] newfile->buffer;
-    }
+    delete[] newfile->pages;
     delete newfile;
     return false;
 }
 
 /*
-  flush file changes to microSD
+  return the cached copy of a page of the file, or nullptr if it is
+  not in the cache. Caller must hold file->sem
  */
-void StorageAccess::flush_file(void)
+StorageAccess::FilePage *StorageAccess::find_file_page(uint16_t page) const
 {
-    if (file == nullptr || file->dirty_mask == 0) {
-        return;
+    for (uint16_t i=0; i<file->num_pages; i++) {
+        FilePage &p = file->pages[i];
+        if (p.page == page) {
+            p.last_use = ++file->use_count;
+            return &p;
+        }
     }
-    const uint32_t now_ms = AP_HAL::millis();
-    if (now_ms - file->last_clean_ms < 1000U) {
-        return;
+    return nullptr;
+}
+
+/*
+  check that all pages holding n bytes at addr are in the cache. On a
+  miss the IO thread is asked to load the page and the access fails, so
+  callers never wait on microSD.  Caller must hold file->sem
+ */
+bool StorageAccess::file_pages_cached(uint32_t addr, size_t n) const
+{
+    if (n == 0) {
+        return true;
     }
-    WITH_SEMAPHORE(file->sem);
+    const uint16_t last_page = (addr + n - 1) / FILE_PAGE_SIZE;
+    for (uint16_t page = addr / FILE_PAGE_SIZE; page <= last_page; page++) {
+        if (find_file_page(page) == nullptr) {
+            file->wanted_page = page;
+            file->pending = true;
+            return false;
+        }
+    }
+    // ask the IO thread to fetch the following page, as items are
+    // mostly accessed in order
+    if (last_page + 1U < file->file_pages) {
+        file->readahead_page = last_page + 1;
+    }
+    return true;
+}
 
-    if (StorageManager::last_io_failed &&
-        now_ms - file->last_io_fail_ms < 2000U) {
-        // don't retry too fast
-        return;
+/*
+  return the least recently used dirty page, or nullptr if all pages
+  are clean. Caller must hold file->sem
+ */
+StorageAccess::FilePage *StorageAccess::dirty_file_page(void) const
+{
+    FilePage *dirty = nullptr;
+    for (uint16_t i=0; i<file->num_pages; i++) {
+        FilePage &p = file->pages[i];
+        if (p.page != FILE_PAGE_NONE && p.dirty &&
+            (dirty == nullptr || p.last_use < dirty->last_use)) {
+            dirty = &p;
+        }
     }
+    return dirty;
+}
 
-    // write out 1k at a time
-    bool io_fail = false;
-    const int b = __builtin_ffsll(file->dirty_mask);
-    const uint32_t ofs = (b-1)*1024;
-    const uint32_t len = MIN(1024U, file->bufsize-ofs);
-    if (AP::FS().lseek(file->fd, ofs, SEEK_SET) != int32_t(ofs) ||
-        AP::FS().write(file->fd, &file->buffer[ofs], len) != int32_t(len)) {
-        io_fail = true;
-    } else {
-        file->dirty_mask &= ~(1ULL<<(b-1));
-    }
-    if (file->dirty_mask == 0) {
-        file->last_clean_ms = now_ms;
-        if (AP::FS().fsync(file->fd) != 0) {
-            io_fail = true;
+/*
+  read a page of the file into the least recently used clean cache
+  slot. The file is read into io_buf without holding file->sem. Only
+  the IO thread (or attach_file before it runs) replaces pages
+ */
+bool StorageAccess::load_file_page(uint16_t page)
+{
+    FilePage *dirty = nullptr;
+    {
+        WITH_SEMAPHORE(file->sem);
+        if (find_file_page(page) != nullptr) {
+            return true;
+        }
+        // keep two clean pages, so loading the second page of an
+        // access doesn't replace the first
+        uint16_t num_clean = 0;
+        for (uint16_t i=0; i<file->num_pages; i++) {
+            num_clean += !file->pages[i].dirty;
+        }
+        if (num_clean < MIN(file->num_pages, 2U)) {
+            dirty = dirty_file_page();
         }
     }
+    // make room now rather than at the usual write back rate
+    if (dirty != nullptr && !write_file_page(*dirty)) {
+        return false;
+    }
+
+    const uint32_t ofs = uint32_t(page) * FILE_PAGE_SIZE;
+    const uint32_t len = MIN(uint32_t(FILE_PAGE_SIZE), file->bufsize - ofs);
+    const bool io_fail = AP::FS().lseek(file->fd, ofs, SEEK_SET) != int32_t(ofs) ||
+                         AP::FS().read(file->fd, file->io_buf, len) != int32_t(len);
+    file_io_result(io_fail);
+    if (io_fail) {
+        return false;
+    }
+
+    WITH_SEMAPHORE(file->sem);
+    FilePage *victim = nullptr;
+    for (uint16_t i=0; i<file->num_pages; i++) {
+        FilePage &p = file->pages[i];
+        if (p.dirty) {
+            continue;
+        }
+        if (victim == nullptr ||
+            (victim->page != FILE_PAGE_NONE && (p.page == FILE_PAGE_NONE || p.last_use < victim->last_use))) {
+            victim = &p;
+        }
+    }
+    if (victim == nullptr) {
+        // every page has changes not yet in the file
+        return false;
+    }
+    memcpy(victim->data, file->io_buf, len);
+    victim->page = page;
+    victim->last_use = ++file->use_count;
+    return true;
+}
+
+/*
+  write a dirty page back to the file. The page is copied to io_buf so
+  file->sem isn't held while writing, and changes made meanwhile mark
+  it dirty again. IO thread only
+ */
+bool StorageAccess::write_file_page(FilePage &p)
+{
+    uint32_t ofs;
+    uint32_t len;
+    {
+        WITH_SEMAPHORE(file->sem);
+        ofs = uint32_t(p.page) * FILE_PAGE_SIZE;
+        len = MIN(uint32_t(FILE_PAGE_SIZE), file->bufsize - ofs);
+        memcpy(file->io_buf, p.data, len);
+        p.dirty = false;
+    }
+    const bool io_fail = AP::FS().lseek(file->fd, ofs, SEEK_SET) != int32_t(ofs) ||
+                         AP::FS().write(file->fd, file->io_buf, len) != int32_t(len);
+    file_io_result(io_fail);
+    if (io_fail) {
+        // the page can't have been replaced as only this thread does that
+        WITH_SEMAPHORE(file->sem);
+        p.dirty = true;
+    }
+    return !io_fail;
+}
+
+/*
+  report changes in microSD storage health
+ */
+void StorageAccess::file_io_result(bool io_fail) const
+{
     if (io_fail && !StorageManager::last_io_failed) {
         GCS_SEND_TEXT(MAV_SEVERITY_ERROR, "Mission storage failed");
     } else if (!io_fail && StorageManager::last_io_failed) {
@@ -443,8 +651,77 @@ void StorageAccess::flush_file(void)
     }
     StorageManager::last_io_failed = io_fail;
     if (io_fail) {
-        file->last_io_fail_ms = now_ms;
+        file->last_io_fail_ms = AP_HAL::millis();
     }
 }
-#endif // AP_SDCARD_STORAGE_ENABLED
 
+/*
+  load pages that accesses are waiting for, then flush file changes to
+  microSD. Runs in the IO thread, file->sem is only held while the
+  cache is changed, never during file IO
+ */
+void StorageAccess::flush_file(void)
+{
+    if (file == nullptr) {
+        return;
+    }
+    const uint32_t now_ms = AP_HAL::millis();
+
+    if (StorageManager::last_io_failed &&
+        now_ms - file->last_io_fail_ms < 2000U) {
+        // don't retry too fast
+        return;
+    }
+
+    uint16_t wanted_page;
+    uint16_t readahead_page;
+    {
+        WITH_SEMAPHORE(file->sem);
+        wanted_page = file->wanted_page;
+        readahead_page = file->readahead_page;
+        file->wanted_page = FILE_PAGE_NONE;
+        file->readahead_page = FILE_PAGE_NONE;
+    }
+
+    // a page an access is waiting for comes before read ahead, and
+    // only one is loaded so read ahead can't replace the wanted page
+    // before it is used
+    if (wanted_page != FILE_PAGE_NONE) {
+        if (!load_file_page(wanted_page)) {
+            // try again next time
+            WITH_SEMAPHORE(file->sem);
+            if (file->wanted_page == FILE_PAGE_NONE) {
+                file->wanted_page = wanted_page;
+            }
+            return;
+        }
+    } else if (readahead_page != FILE_PAGE_NONE && !load_file_page(readahead_page)) {
+        return;
+    }
+
+    FilePage *dirty;
+    {
+        WITH_SEMAPHORE(file->sem);
+        dirty = dirty_file_page();
+    }
+    if (dirty == nullptr) {
+        return;
+    }
+    if (now_ms - file->last_clean_ms < 1000U) {
+        return;
+    }
+
+    // write out 1k at a time
+    if (!write_file_page(*dirty)) {
+        return;
+    }
+    {
+        WITH_SEMAPHORE(file->sem);
+        if (dirty_file_page() != nullptr) {
+            return;
+        }
+    }
+    file->last_clean_ms = now_ms;
+    file_io_result(AP::FS().fsync(file->fd) != 0);
+}
+#endif // AP_SDCARD_STORAGE_ENABLED
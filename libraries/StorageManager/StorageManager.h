@@ -23,6 +23,16 @@
 #include <AP_HAL/AP_HAL.h>
 #include <AP_BoardConfig/AP_BoardConfig_config.h>
 
+#if AP_SDCARD_STORAGE_ENABLED
+#ifndef AP_SDCARD_STORAGE_CACHE_KB
+// size of the RAM cache for the mission on microSD.  Missions up to
+// this size are held completely in RAM, as they were before paging.
+// Larger missions are read from the file a page at a time by the IO
+// thread
+#define AP_SDCARD_STORAGE_CACHE_KB 64
+#endif
+#endif
+
 /*
   use just one area per storage type for boards with 4k of
   storage. Use larger areas for other boards
@@ -94,24 +104,24 @@ public:
     StorageAccess(StorageManager::StorageType _type);
 
     // return total size of this accessor
-    uint16_t size(void) const { return total_size; }
+    uint32_t size(void) const { return total_size; }
 
     // base access via block functions
-    bool read_block(void *dst, uint16_t src, size_t n) const;
-    bool write_block(uint16_t dst, const void* src, size_t n) const;    
+    bool read_block(void *dst, uint32_t src, size_t n) const;
+    bool write_block(uint32_t dst, const void* src, size_t n) const;    
 
     // helper functions
-    uint8_t  read_byte(uint16_t loc) const;
-    uint8_t  read_uint8(uint16_t loc) const { return read_byte(loc); }
-    uint16_t read_uint16(uint16_t loc) const;
-    uint32_t read_uint32(uint16_t loc) const;
-    float read_float(uint16_t loc) const;
-
-    void write_byte(uint16_t loc, uint8_t value) const;
-    void write_uint8(uint16_t loc, uint8_t value) const { return write_byte(loc, value); }
-    void write_uint16(uint16_t loc, uint16_t value) const;
-    void write_uint32(uint16_t loc, uint32_t value) const;
-    void write_float(uint16_t loc, float value) const;
+    uint8_t  read_byte(uint32_t loc) const;
+    uint8_t  read_uint8(uint32_t loc) const { return read_byte(loc); }
+    uint16_t read_uint16(uint32_t loc) const;
+    uint32_t read_uint32(uint32_t loc) const;
+    float read_float(uint32_t loc) const;
+
+    void write_byte(uint32_t loc, uint8_t value) const;
+    void write_uint8(uint32_t loc, uint8_t value) const { return write_byte(loc, value); }
+    void write_uint16(uint32_t loc, uint16_t value) const;
+    void write_uint32(uint32_t loc, uint32_t value) const;
+    void write_float(uint32_t loc, float value) const;
 
     // copy from one storage area to another
     bool copy_area(const StorageAccess &source) const;
@@ -119,26 +129,66 @@ public:
     // attach a storage file from microSD
     bool attach_file(const char *fname, uint16_t size_kbyte);
 
+    // return true if the region is larger than its RAM cache, so an
+    // access may fail with io_pending() while data is loaded
+    bool paged(void) const;
+
+    // return true if the last access failed because the data is still
+    // being read from microSD. The access should be retried later
+    bool io_pending(void) const;
+
 private:
     const StorageManager::StorageType type;
-    uint16_t total_size;
+    uint32_t total_size;
 
 #if AP_SDCARD_STORAGE_ENABLED
     /*
-      support for storage regions on microSD. Only the StorageMission
-      for now
+      support for storage regions on microSD. The mission file is
+      accessed through a cache of 1k pages, other regions are held
+      completely in RAM.  Only the IO thread reads and writes the file,
+      a cache miss fails the access and asks the IO thread for the page
      */
+    static const uint16_t FILE_PAGE_SIZE = 1024;
+    static const uint16_t FILE_PAGE_NONE = UINT16_MAX;
+    // the cache must hold the two pages a small access may span
+    static_assert(AP_SDCARD_STORAGE_CACHE_KB * 1024UL / FILE_PAGE_SIZE >= 2 &&
+                  AP_SDCARD_STORAGE_CACHE_KB * 1024UL / FILE_PAGE_SIZE < FILE_PAGE_NONE,
+                  "AP_SDCARD_STORAGE_CACHE_KB out of range");
+    struct FilePage {
+        uint8_t data[FILE_PAGE_SIZE];
+        uint16_t page;          // page of the file held, FILE_PAGE_NONE if unused
+        bool dirty;             // true if data has changed since read from the file
+        uint32_t last_use;      // value of use_count when last accessed, for least recently used replacement
+    };
     struct FileStorage {
         HAL_Semaphore sem;
         int fd;
-        uint8_t *buffer;
+        FilePage *pages;
+        uint16_t num_pages;
+        uint16_t file_pages;
         uint32_t bufsize;
+        uint32_t use_count;
+        uint16_t wanted_page;       // page an access failed on, for the IO thread to load
+        uint16_t readahead_page;    // page for the IO thread to load before it is needed
+        bool pending;               // last access failed on a page not in the cache
         uint32_t last_clean_ms;
         uint32_t last_io_fail_ms;
-        // each bit of the dirty mask covers 1k of data
-        uint64_t dirty_mask;
+        uint8_t io_buf[FILE_PAGE_SIZE];  // IO thread copy of a page, so file->sem isn't held during file IO
     } *file;
 
+    // return cached page, or nullptr if not in the cache. Caller must hold file->sem
+    FilePage *find_file_page(uint16_t page) const;
+    // check the pages for an access are cached, asking the IO thread for a missing one
+    bool file_pages_cached(uint32_t addr, size_t n) const;
+    // return least recently used dirty page. Caller must hold file->sem
+    FilePage *dirty_file_page(void) const;
+    // read a page of the file into the cache, IO thread only
+    bool load_file_page(uint16_t page);
+    // write a dirty page back to the file, IO thread only
+    bool write_file_page(FilePage &p);
+    // record success or failure of file IO
+    void file_io_result(bool io_fail) const;
+
     void flush_file(void);
 #endif
 };